@@ -0,0 +1,56 @@
+# cmake/AutoGen.cmake
+#
+# gamenet_auto_gen(<target>
+#   HEADERS <header>...
+#   [BASE_DIR <dir>]   # defaults to CMAKE_CURRENT_SOURCE_DIR
+# )
+#
+# Runs tools/auto-gen over headers annotated with GAMENET_REPLICATED_CLASS()
+# (see network/replication/replicated_property.h) and adds the generated
+# serializers to <target>: <BASE_DIR>/a/b.h becomes "a/b.gen.h", which
+# includes the header as "a/b.h". One custom command per header, so a
+# header is regenerated only when it or auto-gen changes.
+#
+# Needs the auto-gen target, i.e. ENGINE_BUILD_TOOLS in a top-level build.
+
+function(gamenet_auto_gen TARGET_NAME)
+  cmake_parse_arguments(A "" "BASE_DIR" "HEADERS" ${ARGN})
+
+  if(NOT A_HEADERS)
+    message(FATAL_ERROR "gamenet_auto_gen(${TARGET_NAME}): no HEADERS given")
+  endif()
+  if(NOT A_BASE_DIR)
+    set(A_BASE_DIR "${CMAKE_CURRENT_SOURCE_DIR}")
+  endif()
+  get_filename_component(A_BASE_DIR "${A_BASE_DIR}" ABSOLUTE)
+
+  set(_gen_dir "${CMAKE_CURRENT_BINARY_DIR}/auto-gen/${TARGET_NAME}")
+  set(_outputs "")
+  foreach(_header IN LISTS A_HEADERS)
+    get_filename_component(_abs "${_header}" ABSOLUTE)
+    file(RELATIVE_PATH _rel "${A_BASE_DIR}" "${_abs}")
+    if(_rel MATCHES "^\\.\\./")
+      message(FATAL_ERROR
+        "gamenet_auto_gen(${TARGET_NAME}): '${_header}' is outside BASE_DIR '${A_BASE_DIR}'")
+    endif()
+    string(REGEX REPLACE "\\.[^./]*$" ".gen.h" _rel_out "${_rel}")
+    set(_out "${_gen_dir}/${_rel_out}")
+
+    # An executable target as COMMAND resolves to its path and makes the
+    # command depend on it.
+    add_custom_command(
+      OUTPUT "${_out}"
+      COMMAND ${PROJECT_NAME}-auto-gen --output "${_out}" --include "${_rel}" "${_abs}"
+      DEPENDS "${_abs}" ${PROJECT_NAME}-auto-gen
+      COMMENT "auto-gen ${_rel}"
+      VERBATIM
+    )
+    list(APPEND _outputs "${_out}")
+  endforeach()
+
+  target_sources(${TARGET_NAME} PRIVATE ${_outputs})
+  target_include_directories(${TARGET_NAME} PUBLIC
+    "$<BUILD_INTERFACE:${_gen_dir}>"
+    "$<BUILD_INTERFACE:${A_BASE_DIR}>"
+  )
+endfunction()
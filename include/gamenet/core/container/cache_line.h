@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+
+namespace GameNet {
+
+// Alignment that keeps independently written data off each other's cache
+// lines. std::hardware_destructive_interference_size isn't used because
+// it varies with compiler flags, and shared memory layouts must agree
+// across processes.
+inline constexpr size_t kCacheLineSize = 64;
+
+}  // namespace GameNet
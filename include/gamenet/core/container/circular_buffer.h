@@ -2,6 +2,7 @@
 
 #include <cinttypes>
 #include <cstring>
+#include <span>
 
 namespace GameNet {
 
@@ -55,6 +56,36 @@ class CircularBuffer {
     return Peek(p, sizeof(T));
   }
 
+  /**
+   * @brief Expose the buffered data in place, oldest first, as up to
+   * maxSegments contiguous pieces (one per block touched).
+   * The segments stay valid until the next non-const call.
+   *
+   * @return the number of segments written to outSegments.
+   */
+  size_t PeekSegments(std::span<const uint8_t>* outSegments,
+                      size_t maxSegments) const;
+
+  /**
+   * @brief Drop the oldest size bytes without copying them out.
+   * Unlike Read(), the capacity is kept, so a buffer that is filled and
+   * drained every frame stops allocating once it has grown.
+   */
+  bool Discard(size_t size);
+
+  /**
+   * @brief Make room for size more bytes (growing if allowed) and expose the
+   * free space after the newest data as up to maxSegments pieces.
+   * Fill them, then Commit() the number of bytes actually written.
+   *
+   * @return the number of segments written to outSegments.
+   */
+  size_t ReserveSegments(size_t size, std::span<uint8_t>* outSegments,
+                         size_t maxSegments);
+
+  // Append size bytes previously written into ReserveSegments() space.
+  bool Commit(size_t size);
+
   bool Empty() const;
 
   size_t Size() const;
@@ -71,6 +102,9 @@ class CircularBuffer {
 
   void DecreaseTable();
 
+  // Moves the data to the start of a table of new_table_cap blocks.
+  void ResizeTable(size_t new_table_cap);
+
   buf_pointer AdvanceBufferPointer(buf_pointer pointer, size_t size) const;
 };
 
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace GameNet {
+
+/**
+ * @brief Open-addressing hash map with linear probing.
+ *
+ * Keys and values live inline in one flat array next to a one-byte control
+ * array, so a lookup is a hash, a multiply and usually a single cache line.
+ * Erase uses backward-shift deletion, so there are no tombstones and probe
+ * lengths don't degrade under churn. Nothing allocates unless the map grows;
+ * call Reserve() up front to keep a hot path allocation-free.
+ *
+ * The user hash is passed through a Fibonacci multiply, so identity hashes
+ * (e.g. std::hash of pointers) are fine.
+ *
+ * Pointers returned by Find/Insert are invalidated by Insert (on growth)
+ * and by Erase.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap {
+ public:
+  explicit FlatHashMap(size_t expectedCount = 0) { Reserve(expectedCount); }
+
+  size_t Size() const { return mSize; }
+  bool Empty() const { return mSize == 0; }
+  size_t Capacity() const { return mSlots.size(); }
+
+  // Make room for count entries without rehashing.
+  void Reserve(size_t count) {
+    size_t capacity = kMinimumCapacity;
+    while (count * kMaxLoadDenominator > capacity * kMaxLoadNumerator) {
+      capacity <<= 1;
+    }
+    if (capacity > mSlots.size()) {
+      Rehash(capacity);
+    }
+  }
+
+  Value* Find(const Key& key) {
+    const size_t index = FindIndex(key);
+    return index != kNotFound ? &mSlots[index].value : nullptr;
+  }
+
+  const Value* Find(const Key& key) const {
+    const size_t index = FindIndex(key);
+    return index != kNotFound ? &mSlots[index].value : nullptr;
+  }
+
+  bool Contains(const Key& key) const { return FindIndex(key) != kNotFound; }
+
+  /**
+   * @brief Insert key -> value unless key is already present.
+   *
+   * @return the stored value and whether it was inserted.
+   */
+  std::pair<Value*, bool> Insert(const Key& key, Value value) {
+    if ((mSize + 1) * kMaxLoadDenominator >
+        mSlots.size() * kMaxLoadNumerator) {
+      Rehash(mSlots.empty() ? kMinimumCapacity : mSlots.size() << 1);
+    }
+
+    const size_t hash = HashKey(key);
+    const uint8_t tag = TagOf(hash);
+    for (size_t index = HomeOf(hash);; index = (index + 1) & mMask) {
+      if (mControl[index] == kEmpty) {
+        mControl[index] = tag;
+        mSlots[index].key = key;
+        mSlots[index].value = std::move(value);
+        ++mSize;
+        return {&mSlots[index].value, true};
+      }
+      if (mControl[index] == tag && mEqual(mSlots[index].key, key)) {
+        return {&mSlots[index].value, false};
+      }
+    }
+  }
+
+  // Insert or overwrite.
+  Value& InsertOrAssign(const Key& key, Value value) {
+    auto [stored, inserted] = Insert(key, value);
+    if (!inserted) {
+      *stored = std::move(value);
+    }
+    return *stored;
+  }
+
+  bool Erase(const Key& key) {
+    size_t hole = FindIndex(key);
+    if (hole == kNotFound) {
+      return false;
+    }
+
+    // Backward-shift: pull later entries of the probe run into the hole
+    // when that doesn't move them in front of their home slot.
+    for (size_t next = (hole + 1) & mMask; mControl[next] != kEmpty;
+         next = (next + 1) & mMask) {
+      const size_t home = HomeOf(HashKey(mSlots[next].key));
+      if (((next - home) & mMask) >= ((next - hole) & mMask)) {
+        mControl[hole] = mControl[next];
+        mSlots[hole] = std::move(mSlots[next]);
+        hole = next;
+      }
+    }
+
+    mControl[hole] = kEmpty;
+    mSlots[hole] = Slot{};
+    --mSize;
+    return true;
+  }
+
+  void Clear() {
+    for (size_t i = 0; i < mSlots.size(); ++i) {
+      if (mControl[i] != kEmpty) {
+        mControl[i] = kEmpty;
+        mSlots[i] = Slot{};
+      }
+    }
+    mSize = 0;
+  }
+
+  // Visits (const Key&, Value&) in unspecified order.
+  template <typename Visitor>
+  void ForEach(Visitor&& visitor) {
+    for (size_t i = 0; i < mSlots.size(); ++i) {
+      if (mControl[i] != kEmpty) {
+        visitor(static_cast<const Key&>(mSlots[i].key), mSlots[i].value);
+      }
+    }
+  }
+
+ private:
+  struct Slot {
+    Key key{};
+    Value value{};
+  };
+
+  static constexpr size_t kNotFound = static_cast<size_t>(-1);
+  static constexpr size_t kMinimumCapacity = 16;
+  static constexpr size_t kMaxLoadNumerator = 7;  // max load factor 7/8.
+  static constexpr size_t kMaxLoadDenominator = 8;
+  static constexpr uint8_t kEmpty = 0;
+  static constexpr size_t kHashBits = std::numeric_limits<size_t>::digits;
+  static constexpr size_t kTagBits = 7;
+
+  size_t HashKey(const Key& key) const {
+    // Fibonacci hashing; the high bits are the best mixed, so those are kept
+    // when size_t is narrower than the product.
+    return static_cast<size_t>(
+        (static_cast<uint64_t>(mHash(key)) * 0x9E3779B97F4A7C15ull) >>
+        (64 - kHashBits));
+  }
+
+  size_t HomeOf(size_t hash) const { return hash >> mShift; }
+
+  // Non-zero 7-bit fingerprint that filters most key comparisons. Taken from
+  // the bits right below the home index: the low bits of the product only
+  // mix the low bits of the key, which for pointers are mostly zero.
+  uint8_t TagOf(size_t hash) const {
+    return static_cast<uint8_t>(((hash >> (mShift - kTagBits)) & 0x7f) | 0x80);
+  }
+
+  size_t FindIndex(const Key& key) const {
+    if (mSize == 0) {
+      return kNotFound;
+    }
+
+    const size_t hash = HashKey(key);
+    const uint8_t tag = TagOf(hash);
+    for (size_t index = HomeOf(hash);; index = (index + 1) & mMask) {
+      if (mControl[index] == kEmpty) {
+        return kNotFound;
+      }
+      if (mControl[index] == tag && mEqual(mSlots[index].key, key)) {
+        return index;
+      }
+    }
+  }
+
+  void Rehash(size_t newCapacity) {
+    std::vector<uint8_t> oldControl = std::move(mControl);
+    std::vector<Slot> oldSlots = std::move(mSlots);
+
+    mControl.assign(newCapacity, kEmpty);
+    mSlots.clear();
+    mSlots.resize(newCapacity);
+    mMask = newCapacity - 1;
+    mShift = kHashBits - static_cast<size_t>(std::countr_zero(newCapacity));
+    mSize = 0;
+
+    for (size_t i = 0; i < oldSlots.size(); ++i) {
+      if (oldControl[i] != kEmpty) {
+        Insert(oldSlots[i].key, std::move(oldSlots[i].value));
+      }
+    }
+  }
+
+  std::vector<uint8_t> mControl;
+  std::vector<Slot> mSlots;
+  size_t mSize{0};
+  size_t mMask{0};
+  size_t mShift{kHashBits};
+  [[no_unique_address]] Hash mHash;
+  [[no_unique_address]] KeyEqual mEqual;
+};
+
+}  // namespace GameNet
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "core/memory-stream/memory_bit_stream.h"
+
+namespace GameNet {
+
+/**
+ * @brief Fixed-size bit mask of kBitCount dirty flags, e.g. one per
+ * replicated property, that stays cheap however wide it gets.
+ *
+ * Flags live in leaf words, and above kWordBits flags a summary word keeps
+ * one bit per non-zero leaf. Any() reads only the summary, and merging or
+ * clearing another mask, or ForEachSet(), visits only the leaves that have
+ * bits set. Up to 32 flags the mask is a single uint32_t and up to 64 a
+ * single uint64_t, so narrow masks cost what a plain integer does.
+ *
+ * On the wire a single-word mask is its kBitCount bits. A wider one is the
+ * summary, kWordCount bits, followed by only the leaves it marks, so a mask
+ * with a few bits set stays small however wide it is.
+ */
+template <uint32_t kBitCount>
+class HierarchicalDirtyMask {
+  static_assert(kBitCount > 0 && kBitCount <= 64 * 64,
+                "a mask has 1 to 4096 bits");
+
+ public:
+  using Word = std::conditional_t<kBitCount <= 32, uint32_t, uint64_t>;
+
+  static constexpr uint32_t kBits = kBitCount;
+  static constexpr uint32_t kWordBits = sizeof(Word) * 8;
+  static constexpr uint32_t kWordCount =
+      (kBitCount + kWordBits - 1) / kWordBits;
+  // GetBlock() granularity, the same whatever the word size.
+  static constexpr uint32_t kBlockBits = 32;
+
+  constexpr HierarchicalDirtyMask() = default;
+
+  // Bits 0..63 from an integer mask, for masks written as literals.
+  constexpr HierarchicalDirtyMask(uint64_t lowBits) {
+    for (uint32_t i = 0; i < kWordCount && i * kWordBits < 64; ++i) {
+      mWords[i] = static_cast<Word>(lowBits >> (i * kWordBits));
+    }
+    mWords[kWordCount - 1] &= kLastWordMask;
+    for (uint32_t i = 0; i < kWordCount; ++i) {
+      MarkWord(i);
+    }
+  }
+
+  // Bits [0, count).
+  static constexpr HierarchicalDirtyMask FirstN(uint32_t count) {
+    HierarchicalDirtyMask mask;
+    for (uint32_t i = 0; i < kWordCount && count > i * kWordBits; ++i) {
+      const uint32_t bits = count - i * kWordBits;
+      mask.mWords[i] = bits >= kWordBits ? ~Word{0} : (Word{1} << bits) - 1;
+      mask.MarkWord(i);
+    }
+    mask.mWords[kWordCount - 1] &= kLastWordMask;
+    return mask;
+  }
+
+  constexpr bool Test(uint32_t index) const {
+    return (mWords[index / kWordBits] >> (index % kWordBits)) & 1;
+  }
+
+  constexpr void Set(uint32_t index) {
+    mWords[index / kWordBits] |= Word{1} << (index % kWordBits);
+    MarkWord(index / kWordBits);
+  }
+
+  constexpr void Reset(uint32_t index) {
+    mWords[index / kWordBits] &= ~(Word{1} << (index % kWordBits));
+    UnmarkWordIfClear(index / kWordBits);
+  }
+
+  constexpr bool Any() const {
+    if constexpr (kWordCount == 1) {
+      return mWords[0] != 0;
+    } else {
+      return mSummary != 0;
+    }
+  }
+
+  constexpr Word GetWord(uint32_t wordIndex) const {
+    return mWords[wordIndex];
+  }
+
+  // Bits [blockIndex * 32, blockIndex * 32 + 32), for code generated without
+  // knowing kWordBits, e.g. by auto-gen.
+  constexpr uint32_t GetBlock(uint32_t blockIndex) const {
+    const uint32_t firstBit = blockIndex * kBlockBits;
+    return static_cast<uint32_t>(mWords[firstBit / kWordBits] >>
+                                 (firstBit % kWordBits));
+  }
+
+  constexpr HierarchicalDirtyMask& operator|=(
+      const HierarchicalDirtyMask& other) {
+    other.ForEachSetWord([&](uint32_t wordIndex) {
+      mWords[wordIndex] |= other.mWords[wordIndex];
+    });
+    if constexpr (kWordCount > 1) {
+      mSummary |= other.mSummary;
+    }
+    return *this;
+  }
+
+  friend constexpr HierarchicalDirtyMask operator|(
+      HierarchicalDirtyMask lhs, const HierarchicalDirtyMask& rhs) {
+    return lhs |= rhs;
+  }
+
+  // Clears every bit set in other, i.e. *this &= ~other.
+  constexpr void Remove(const HierarchicalDirtyMask& other) {
+    other.ForEachSetWord([&](uint32_t wordIndex) {
+      mWords[wordIndex] &= ~other.mWords[wordIndex];
+      UnmarkWordIfClear(wordIndex);
+    });
+  }
+
+  constexpr bool Intersects(const HierarchicalDirtyMask& other) const {
+    bool intersects = false;
+    other.ForEachSetWord([&](uint32_t wordIndex) {
+      intersects |= (mWords[wordIndex] & other.mWords[wordIndex]) != 0;
+    });
+    return intersects;
+  }
+
+  // Calls visitor(index) for every set bit, in ascending order.
+  template <typename Visitor>
+  constexpr void ForEachSet(Visitor&& visitor) const {
+    ForEachSetWord([&](uint32_t wordIndex) {
+      for (Word word = mWords[wordIndex]; word != 0; word &= word - 1) {
+        visitor(wordIndex * kWordBits +
+                static_cast<uint32_t>(std::countr_zero(word)));
+      }
+    });
+  }
+
+  // Calls visitor(wordIndex) for every non-zero word, in ascending order.
+  template <typename Visitor>
+  constexpr void ForEachSetWord(Visitor&& visitor) const {
+    if constexpr (kWordCount == 1) {
+      if (mWords[0] != 0) {
+        visitor(0u);
+      }
+    } else {
+      // Iterates a copy, so the visitor clearing a word is harmless.
+      for (uint64_t summary = mSummary; summary != 0; summary &= summary - 1) {
+        visitor(static_cast<uint32_t>(std::countr_zero(summary)));
+      }
+    }
+  }
+
+  constexpr bool operator==(const HierarchicalDirtyMask& other) const {
+    return mWords == other.mWords;
+  }
+
+ private:
+  friend struct BitStreamWriter<HierarchicalDirtyMask>;
+  friend struct BitStreamReader<HierarchicalDirtyMask>;
+
+  // Bits of leaf wordIndex on the wire; the last may be partial.
+  static constexpr uint32_t GetWordBitCount(uint32_t wordIndex) {
+    return wordIndex + 1 < kWordCount ? kWordBits
+                                      : kBitCount - wordIndex * kWordBits;
+  }
+
+  static constexpr Word kLastWordMask =
+      kBitCount % kWordBits == 0
+          ? ~Word{0}
+          : (Word{1} << (kBitCount % kWordBits)) - 1;
+
+  struct NoSummary {};
+
+  constexpr void MarkWord(uint32_t wordIndex) {
+    if constexpr (kWordCount > 1) {
+      if (mWords[wordIndex] != 0) {
+        mSummary |= uint64_t{1} << wordIndex;
+      }
+    }
+  }
+
+  constexpr void UnmarkWordIfClear(uint32_t wordIndex) {
+    if constexpr (kWordCount > 1) {
+      if (mWords[wordIndex] == 0) {
+        mSummary &= ~(uint64_t{1} << wordIndex);
+      }
+    }
+  }
+
+  std::array<Word, kWordCount> mWords{};
+  // Bit i is set iff mWords[i] != 0. Absent with a single word.
+  [[no_unique_address]] std::conditional_t<(kWordCount > 1), uint64_t,
+                                           NoSummary> mSummary{};
+};
+
+template <uint32_t kBitCount>
+struct BitStreamWriter<HierarchicalDirtyMask<kBitCount>> {
+  void operator()(OutputMemoryBitStream& outStream,
+                  const HierarchicalDirtyMask<kBitCount>& inMask) const {
+    using Mask = HierarchicalDirtyMask<kBitCount>;
+    if constexpr (Mask::kWordCount == 1) {
+      outStream.Write(inMask.mWords[0], kBitCount);
+    } else {
+      outStream.Write(inMask.mSummary, Mask::kWordCount);
+      inMask.ForEachSetWord([&](uint32_t wordIndex) {
+        outStream.Write(inMask.mWords[wordIndex],
+                        Mask::GetWordBitCount(wordIndex));
+      });
+    }
+  }
+};
+
+template <uint32_t kBitCount>
+struct BitStreamReader<HierarchicalDirtyMask<kBitCount>> {
+  void operator()(InputMemoryBitStream& inStream,
+                  HierarchicalDirtyMask<kBitCount>& outMask) const {
+    using Mask = HierarchicalDirtyMask<kBitCount>;
+    outMask = Mask();
+    if constexpr (Mask::kWordCount == 1) {
+      inStream.Read(outMask.mWords[0], kBitCount);
+    } else {
+      uint64_t summary = 0;
+      inStream.Read(summary, Mask::kWordCount);
+      for (; summary != 0; summary &= summary - 1) {
+        const uint32_t wordIndex =
+            static_cast<uint32_t>(std::countr_zero(summary));
+        inStream.Read(outMask.mWords[wordIndex],
+                      Mask::GetWordBitCount(wordIndex));
+        // A zero leaf from a malformed stream must not stay marked.
+        outMask.MarkWord(wordIndex);
+      }
+    }
+  }
+};
+
+}  // namespace GameNet
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace GameNet {
+
+/**
+ * @brief FIFO queue over a power-of-two ring of slots.
+ *
+ * Used where a std::deque would allocate and free blocks as elements are
+ * pushed and popped. The ring only allocates when it is full, doubling its
+ * capacity; it never shrinks, so a queue that has reached its working size
+ * stops allocating.
+ */
+template <typename T>
+class RingQueue {
+ public:
+  explicit RingQueue(size_t initialCapacity = 16) {
+    Grow(std::bit_ceil(initialCapacity < 2 ? size_t{2} : initialCapacity));
+  }
+
+  RingQueue(const RingQueue& other) : RingQueue(other.mCapacity) {
+    for (size_t i = 0; i < other.mSize; ++i) {
+      push_back(other[i]);
+    }
+  }
+
+  RingQueue& operator=(const RingQueue& other) {
+    if (this != &other) {
+      clear();
+      for (size_t i = 0; i < other.mSize; ++i) {
+        push_back(other[i]);
+      }
+    }
+    return *this;
+  }
+
+  RingQueue(RingQueue&& other) noexcept
+      : mSlots(std::exchange(other.mSlots, nullptr)),
+        mCapacity(std::exchange(other.mCapacity, 0)),
+        mMask(std::exchange(other.mMask, 0)),
+        mHead(std::exchange(other.mHead, 0)),
+        mSize(std::exchange(other.mSize, 0)) {}
+
+  RingQueue& operator=(RingQueue&& other) noexcept {
+    std::swap(mSlots, other.mSlots);
+    std::swap(mCapacity, other.mCapacity);
+    std::swap(mMask, other.mMask);
+    std::swap(mHead, other.mHead);
+    std::swap(mSize, other.mSize);
+    return *this;
+  }
+
+  ~RingQueue() {
+    clear();
+    if (mSlots) {
+      std::allocator<T>().deallocate(mSlots, mCapacity);
+    }
+  }
+
+  // Names follow std::deque so the two can be swapped.
+  bool empty() const { return mSize == 0; }
+  size_t size() const { return mSize; }
+  size_t capacity() const { return mCapacity; }
+
+  T& front() { return mSlots[mHead]; }
+  const T& front() const { return mSlots[mHead]; }
+  T& back() { return mSlots[(mHead + mSize - 1) & mMask]; }
+  const T& back() const { return mSlots[(mHead + mSize - 1) & mMask]; }
+
+  // Index 0 is the front.
+  T& operator[](size_t index) { return mSlots[(mHead + index) & mMask]; }
+  const T& operator[](size_t index) const {
+    return mSlots[(mHead + index) & mMask];
+  }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    if (mSize == mCapacity) {
+      // A moved-from queue has no slots.
+      Grow(mCapacity > 0 ? mCapacity * 2 : 16);
+    }
+    T* slot = std::construct_at(&mSlots[(mHead + mSize) & mMask],
+                                std::forward<Args>(args)...);
+    ++mSize;
+    return *slot;
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  void pop_front() {
+    std::destroy_at(&mSlots[mHead]);
+    mHead = (mHead + 1) & mMask;
+    --mSize;
+  }
+
+  // Keeps the capacity.
+  void clear() {
+    while (mSize > 0) {
+      pop_front();
+    }
+    mHead = 0;
+  }
+
+ private:
+  void Grow(size_t newCapacity) {
+    T* newSlots = std::allocator<T>().allocate(newCapacity);
+    for (size_t i = 0; i < mSize; ++i) {
+      T& value = (*this)[i];
+      std::construct_at(&newSlots[i], std::move(value));
+      std::destroy_at(&value);
+    }
+    if (mSlots) {
+      std::allocator<T>().deallocate(mSlots, mCapacity);
+    }
+    mSlots = newSlots;
+    mCapacity = newCapacity;
+    mMask = newCapacity - 1;
+    mHead = 0;
+  }
+
+  T* mSlots{nullptr};
+  size_t mCapacity{0};
+  size_t mMask{0};
+  size_t mHead{0};
+  size_t mSize{0};
+};
+
+}  // namespace GameNet
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "core/container/cache_line.h"
+
+namespace GameNet {
+
+/**
+ * @brief Bounded lock-free single-producer/single-consumer queue.
+ *
+ * Exactly one thread may push and exactly one (other) thread may pop.
+ * The capacity is rounded up to a power of two. Each side caches the other
+ * side's index, so the shared atomics are only touched when the cached view
+ * says the queue looks full (producer) or empty (consumer).
+ */
+template <typename T>
+class SPSCQueue {
+ public:
+  explicit SPSCQueue(size_t capacity)
+      : mCapacity(std::bit_ceil(capacity < 2 ? size_t{2} : capacity)),
+        mMask(mCapacity - 1),
+        mSlots(std::make_unique<T[]>(mCapacity)) {}
+
+  SPSCQueue(const SPSCQueue&) = delete;
+  SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+  // Producer side.
+  bool TryPush(T&& value) {
+    const size_t tail = mTail.load(std::memory_order_relaxed);
+    if (tail - mCachedHead == mCapacity) {
+      mCachedHead = mHead.load(std::memory_order_acquire);
+      if (tail - mCachedHead == mCapacity) {
+        return false;  // full
+      }
+    }
+
+    mSlots[tail & mMask] = std::move(value);
+    mTail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side.
+  bool TryPop(T& outValue) {
+    const size_t head = mHead.load(std::memory_order_relaxed);
+    if (head == mCachedTail) {
+      mCachedTail = mTail.load(std::memory_order_acquire);
+      if (head == mCachedTail) {
+        return false;  // empty
+      }
+    }
+
+    outValue = std::move(mSlots[head & mMask]);
+    mHead.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Consumer side. Hands up to maxCount items to the visitor and
+   * publishes the new head once for the whole batch.
+   *
+   * @return the number of items popped.
+   */
+  template <typename Visitor>
+  size_t PopBatch(size_t maxCount, Visitor&& visitor) {
+    const size_t head = mHead.load(std::memory_order_relaxed);
+    if (mCachedTail - head < maxCount) {
+      mCachedTail = mTail.load(std::memory_order_acquire);
+    }
+
+    size_t available = mCachedTail - head;
+    if (available > maxCount) {
+      available = maxCount;
+    }
+
+    for (size_t i = 0; i < available; ++i) {
+      visitor(mSlots[(head + i) & mMask]);
+    }
+
+    if (available != 0) {
+      mHead.store(head + available, std::memory_order_release);
+    }
+    return available;
+  }
+
+  // Approximate when called concurrently with the other side.
+  bool Empty() const {
+    return mHead.load(std::memory_order_acquire) ==
+           mTail.load(std::memory_order_acquire);
+  }
+
+  size_t Capacity() const { return mCapacity; }
+
+ private:
+  const size_t mCapacity;
+  const size_t mMask;
+  std::unique_ptr<T[]> mSlots;
+
+  // Consumer-owned line.
+  alignas(kCacheLineSize) std::atomic<size_t> mHead{0};
+  size_t mCachedTail{0};
+
+  // Producer-owned line.
+  alignas(kCacheLineSize) std::atomic<size_t> mTail{0};
+  size_t mCachedHead{0};
+};
+
+}  // namespace GameNet
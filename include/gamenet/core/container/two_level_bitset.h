@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace GameNet {
+
+/**
+ * @brief Growable bitset that can list its set bits in O(set bits).
+ *
+ * Bits live in 64-bit words, and a summary level keeps one bit per word
+ * that is non-zero. ForEachSet() walks the summary with countr_zero and
+ * only touches the words that have bits set, so a scan costs
+ * size / 4096 summary words plus one step per set bit, however sparse the
+ * set is.
+ */
+class TwoLevelBitset {
+ public:
+  explicit TwoLevelBitset(size_t size = 0) { Resize(size); }
+
+  size_t Size() const { return mSize; }
+
+  // New bits are clear. Shrinking drops the bits past the new size.
+  void Resize(size_t size) {
+    mSize = size;
+    mWords.resize((size + 63) / 64, 0);
+    mSummary.resize((mWords.size() + 63) / 64, 0);
+    if (size % 64 != 0 && !mWords.empty()) {
+      mWords.back() &= (uint64_t{1} << (size % 64)) - 1;
+      if (mWords.back() == 0) {
+        ClearSummaryBit(mWords.size() - 1);
+      }
+    }
+    if (mWords.size() % 64 != 0 && !mSummary.empty()) {
+      mSummary.back() &= (uint64_t{1} << (mWords.size() % 64)) - 1;
+    }
+  }
+
+  bool Test(size_t index) const {
+    return (mWords[index / 64] >> (index % 64)) & 1;
+  }
+
+  void Set(size_t index) {
+    mWords[index / 64] |= uint64_t{1} << (index % 64);
+    mSummary[index / 4096] |= uint64_t{1} << ((index / 64) % 64);
+  }
+
+  void Reset(size_t index) {
+    uint64_t& word = mWords[index / 64];
+    word &= ~(uint64_t{1} << (index % 64));
+    if (word == 0) {
+      ClearSummaryBit(index / 64);
+    }
+  }
+
+  bool Any() const {
+    for (const uint64_t summary : mSummary) {
+      if (summary != 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Clear() {
+    ForEachSetWord([this](size_t wordIndex) { mWords[wordIndex] = 0; });
+    std::fill(mSummary.begin(), mSummary.end(), 0);
+  }
+
+  /**
+   * @brief Calls visitor(index) for every set bit, in ascending order.
+   * The visitor may Reset() the bit it is given, but must not Set() or
+   * Resize().
+   */
+  template <typename Visitor>
+  void ForEachSet(Visitor&& visitor) {
+    ForEachSetWord([this, &visitor](size_t wordIndex) {
+      for (uint64_t word = mWords[wordIndex]; word != 0; word &= word - 1) {
+        visitor(wordIndex * 64 + static_cast<size_t>(std::countr_zero(word)));
+      }
+    });
+  }
+
+ private:
+  void ClearSummaryBit(size_t wordIndex) {
+    mSummary[wordIndex / 64] &= ~(uint64_t{1} << (wordIndex % 64));
+  }
+
+  template <typename Visitor>
+  void ForEachSetWord(Visitor&& visitor) {
+    for (size_t summaryIndex = 0; summaryIndex < mSummary.size();
+         ++summaryIndex) {
+      // Iterates a copy, so the visitor clearing a word is harmless.
+      for (uint64_t summary = mSummary[summaryIndex]; summary != 0;
+           summary &= summary - 1) {
+        visitor(summaryIndex * 64 +
+                static_cast<size_t>(std::countr_zero(summary)));
+      }
+    }
+  }
+
+  std::vector<uint64_t> mWords;
+  std::vector<uint64_t> mSummary;
+  size_t mSize{0};
+};
+
+}  // namespace GameNet
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+#include "core/container/cache_line.h"
+
+namespace GameNet {
+
+/**
+ * @brief Fixed-capacity Chase-Lev work-stealing deque.
+ *
+ * The owning thread pushes and pops at the bottom, LIFO, which keeps the
+ * work it just created hot in its cache; any other thread steals from the
+ * top, FIFO, taking the oldest and usually largest pieces of work. Push
+ * and Pop are plain loads and stores except when the last element is
+ * contested; Steal is one CAS. The memory orderings follow Le et al.,
+ * "Correct and Efficient Work-Stealing for Weak Memory Models" (2013).
+ *
+ * T must be trivially copyable, typically a pointer.
+ */
+template <typename T>
+class WorkStealingDeque {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+ public:
+  explicit WorkStealingDeque(size_t capacity)
+      : mCapacity(std::bit_ceil(capacity < 2 ? size_t{2} : capacity)),
+        mMask(mCapacity - 1),
+        mSlots(std::make_unique<std::atomic<T>[]>(mCapacity)) {}
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  // Owner only. False if the deque is full.
+  bool Push(T item) {
+    const int64_t bottom = mBottom.load(std::memory_order_relaxed);
+    const int64_t top = mTop.load(std::memory_order_acquire);
+    if (bottom - top >= static_cast<int64_t>(mCapacity)) {
+      return false;
+    }
+    mSlots[bottom & mMask].store(item, std::memory_order_relaxed);
+    // Publishes the item, and whatever it points to, to thieves.
+    mBottom.store(bottom + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Owner only.
+  bool Pop(T& outItem) {
+    const int64_t bottom = mBottom.load(std::memory_order_relaxed) - 1;
+    mBottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = mTop.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+      mBottom.store(bottom + 1, std::memory_order_relaxed);
+      return false;
+    }
+
+    outItem = mSlots[bottom & mMask].load(std::memory_order_relaxed);
+    if (top != bottom) {
+      return true;
+    }
+
+    // Last element: whoever moves top first gets it.
+    const bool won = mTop.compare_exchange_strong(
+        top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    mBottom.store(bottom + 1, std::memory_order_relaxed);
+    return won;
+  }
+
+  // Any thread. May fail spuriously when racing another thief.
+  bool Steal(T& outItem) {
+    int64_t top = mTop.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = mBottom.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return false;
+    }
+
+    outItem = mSlots[top & mMask].load(std::memory_order_relaxed);
+    return mTop.compare_exchange_strong(
+        top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+  }
+
+  // Approximate when other threads are pushing or stealing.
+  bool Empty() const {
+    return mBottom.load(std::memory_order_relaxed) <=
+           mTop.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // Thieves hammer mTop and the owner mBottom; keep them apart.
+  alignas(kCacheLineSize) std::atomic<int64_t> mTop{0};
+  alignas(kCacheLineSize) std::atomic<int64_t> mBottom{0};
+  size_t mCapacity;
+  size_t mMask;
+  std::unique_ptr<std::atomic<T>[]> mSlots;
+};
+
+}  // namespace GameNet
@@ -1,6 +1,17 @@
 #pragma once
 
 #include "container/circular_buffer.h"
+#include "container/flat_hash_map.h"
+#include "container/hierarchical_dirty_mask.h"
+#include "container/ring_queue.h"
+#include "container/spsc_queue.h"
+#include "container/two_level_bitset.h"
+#include "container/work_stealing_deque.h"
+
+#include "hash/crc32c.h"
+#include "hash/siphash.h"
+
+#include "job/job_system.h"
 
 #include "logger/logger.h"
 
@@ -8,4 +19,6 @@
 
 #include "memory-stream/memory_bit_stream.h"
 
+#include "timer/clock.h"
 #include "timer/timer.h"
+#include "timer/timer_wheel.h"
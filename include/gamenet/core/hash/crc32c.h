@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GameNet {
+
+/**
+ * @brief CRC-32C (Castagnoli) of data.
+ *
+ * Uses the SSE4.2 crc32 instruction when the CPU has it (checked once at
+ * run time), the ARMv8 crc32c instructions when the target has them, and a
+ * slicing-by-8 table otherwise; all give the same result. The instructions
+ * take at most 8 bytes per cycle, so a small packet costs a few ns but a
+ * 1200-byte one still needs about 150 cycles.
+ *
+ * @param seed the CRC of whatever precedes data, so a checksum can be
+ * computed piecewise: Crc32c(b, n, Crc32c(a, m)) == CRC of a followed by b.
+ */
+uint32_t Crc32c(const void* data, size_t size, uint32_t seed = 0);
+
+bool IsCrc32cHardwareAccelerated();
+
+}  // namespace GameNet
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GameNet {
+
+struct SipHashKey {
+  uint64_t k0{0};
+  uint64_t k1{0};
+};
+
+/**
+ * @brief SipHash-2-4: a keyed 64-bit hash.
+ *
+ * Use it where an attacker controls the input and must not be able to
+ * predict or forge the output without the key, e.g. handshake cookies or
+ * hash tables exposed to network addresses.
+ */
+uint64_t SipHash24(const SipHashKey& key, const void* data, size_t size);
+
+}  // namespace GameNet
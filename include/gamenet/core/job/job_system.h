@@ -0,0 +1,201 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "core/container/work_stealing_deque.h"
+
+namespace GameNet {
+
+class JobSystem;
+
+/**
+ * @brief One unit of work. Created by JobSystem::CreateJob(), which also
+ * owns its memory.
+ */
+class Job {
+ public:
+  // Captures larger than this don't fit; capture by reference instead.
+  static constexpr size_t kStorageSize = 64;
+  static constexpr uint32_t kMaxContinuations = 8;
+
+  Job() = default;
+  Job(const Job&) = delete;
+  Job& operator=(const Job&) = delete;
+
+ private:
+  friend class JobSystem;
+
+  void (*mRun)(Job&){nullptr};
+  void (*mDestroy)(Job&){nullptr};
+  Job* mParent{nullptr};
+  // This job plus its unfinished children.
+  std::atomic<int32_t> mUnfinishedJobs{0};
+  // Unfinished dependencies, plus one until Run() is called.
+  std::atomic<int32_t> mPendingDependencies{0};
+  uint32_t mContinuationCount{0};
+  std::array<Job*, kMaxContinuations> mContinuations{};
+  alignas(std::max_align_t) std::byte mStorage[kStorageSize];
+};
+
+struct JobSystemSettings {
+  // Threads besides the owning one; with 0 every job runs on the owning
+  // thread inside Wait(). hardware_concurrency() - 1 uses the whole machine.
+  uint32_t workerCount = 0;
+  // Jobs each thread can have in flight. Job memory is a ring per thread;
+  // when it wraps, slots still in flight are skipped, and a thread with
+  // none free runs queued jobs until one is. ParallelFor() runs batches
+  // inline instead once the ring is full, but jobs created and not yet
+  // Run() never free up, so keep fewer of those than this.
+  uint32_t maxJobsPerThread = 4096;
+};
+
+/**
+ * @brief Work-stealing job system.
+ *
+ * Every thread, the owning one included, has a Chase-Lev deque. Jobs a
+ * thread runs go to its own deque; idle threads steal from the others. A
+ * thread waiting on a job keeps executing jobs instead of blocking, so jobs
+ * may create and wait on more jobs.
+ *
+ * Children are created with a parent, which counts as finished only once
+ * all of them have. AddDependency() holds a job back until another has
+ * finished. Neither allocates: job memory comes from per-thread rings.
+ *
+ * Jobs may be created, run and waited on from the thread that constructed
+ * the JobSystem and from inside jobs, not from other threads.
+ */
+class JobSystem {
+ public:
+  explicit JobSystem(const JobSystemSettings& settings = JobSystemSettings());
+  ~JobSystem();
+
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+
+  // function() runs once the job is Run() and its dependencies finished.
+  template <typename Function>
+  Job* CreateJob(Function&& function) {
+    return CreateChildJob(nullptr, std::forward<Function>(function));
+  }
+
+  // parent must not have finished, i.e. not been Run() or still have
+  // unfinished children.
+  template <typename Function>
+  Job* CreateChildJob(Job* parent, Function&& function);
+
+  // job won't start before dependency (and its children) finished. Call
+  // before running either job or any child of dependency.
+  void AddDependency(Job* job, Job* dependency);
+
+  void Run(Job* job);
+
+  // Executes other jobs until job and all its children have finished.
+  void Wait(const Job* job);
+
+  bool IsFinished(const Job* job) const {
+    return job->mUnfinishedJobs.load(std::memory_order_acquire) == 0;
+  }
+
+  /**
+   * @brief Calls function(begin, end) over [0, count) in batches of at most
+   * batchSize, on all threads, and returns when every batch is done.
+   */
+  template <typename Function>
+  void ParallelFor(uint32_t count, uint32_t batchSize, Function&& function);
+
+  uint32_t GetWorkerCount() const {
+    return static_cast<uint32_t>(mWorkers.size());
+  }
+
+ private:
+  struct ThreadState {
+    ThreadState(uint32_t maxJobs, uint32_t seed)
+        : queue(maxJobs), jobs(new Job[maxJobs]), randomState(seed | 1) {}
+
+    WorkStealingDeque<Job*> queue;
+    std::unique_ptr<Job[]> jobs;
+    uint32_t nextJob{0};
+    uint32_t randomState;
+  };
+
+  ThreadState& GetThreadState();
+  // Whether the next slot of this thread's ring is free.
+  bool HasFreeJobSlot();
+  Job* AllocateJob(Job* parent);
+  Job* FindJob(ThreadState& state);
+  void Execute(Job* job);
+  void Finish(Job* job);
+  void Push(Job* job);
+  void WorkerMain(uint32_t index);
+
+  JobSystemSettings mSettings;
+  uint32_t mJobMask;
+  // [0] belongs to the owning thread, [i + 1] to worker i.
+  std::vector<std::unique_ptr<ThreadState>> mThreadStates;
+  std::vector<std::thread> mWorkers;
+
+  std::atomic<bool> mRunning{true};
+  // Bumped on every push; idle workers sleep on it.
+  std::atomic<uint32_t> mWakeEpoch{0};
+  std::atomic<uint32_t> mSleepingWorkerCount{0};
+};
+
+template <typename Function>
+Job* JobSystem::CreateChildJob(Job* parent, Function&& function) {
+  using Callable = std::decay_t<Function>;
+  static_assert(sizeof(Callable) <= Job::kStorageSize,
+                "job function too large; capture by reference");
+  static_assert(alignof(Callable) <= alignof(std::max_align_t));
+
+  Job* job = AllocateJob(parent);
+  new (job->mStorage) Callable(std::forward<Function>(function));
+  job->mRun = [](Job& self) {
+    (*std::launder(reinterpret_cast<Callable*>(self.mStorage)))();
+  };
+  if constexpr (!std::is_trivially_destructible_v<Callable>) {
+    job->mDestroy = [](Job& self) {
+      std::launder(reinterpret_cast<Callable*>(self.mStorage))->~Callable();
+    };
+  }
+  return job;
+}
+
+template <typename Function>
+void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize,
+                            Function&& function) {
+  if (count == 0) {
+    return;
+  }
+  if (batchSize == 0) {
+    batchSize = 1;
+  }
+
+  // Batches that find this thread's ring full, e.g. deep in nested
+  // ParallelFor()s, run right here: the slots they would wait for may only
+  // free up once they have run.
+  Job* root = HasFreeJobSlot() ? CreateJob([] {}) : nullptr;
+  for (uint32_t begin = 0; begin < count; begin += batchSize) {
+    const uint32_t end = count - begin < batchSize ? count : begin + batchSize;
+    if (root && HasFreeJobSlot()) {
+      Run(CreateChildJob(root,
+                         [&function, begin, end] { function(begin, end); }));
+    } else {
+      function(begin, end);
+    }
+  }
+  if (root) {
+    Run(root);
+    Wait(root);
+  }
+}
+
+}  // namespace GameNet
@@ -1,3 +1,5 @@
+#pragma once
+
 #include <bit>
 #include <cstdint>
 #include <cstdlib>
@@ -94,6 +96,27 @@ class OutputMemoryBitStream {
   void WriteBits(uint8_t data, uint32_t bitCount);
   void WriteBits(const void* data, uint32_t bitCount);
 
+  /**
+   * @brief Appends bitCount bits laid out the way this stream writes them,
+   * starting at bit 0 of data, e.g. another stream's buffer. Unlike
+   * WriteBits() this shifts whole words into place, so it is the fast way to
+   * splice a pre-serialized blob into a packet at any bit offset.
+   */
+  void WriteBitsFrom(const uint8_t* data, uint32_t bitCount);
+  void WriteBitsFrom(const OutputMemoryBitStream& stream) {
+    WriteBitsFrom(stream.GetBuffer(), stream.GetBitLength());
+  }
+
+  // Pads with zero bits up to the next byte boundary.
+  void AlignToByte() {
+    if (mBitHead & 0x7) {
+      WriteBits(uint8_t{0}, 8 - (mBitHead & 0x7));
+    }
+  }
+
+  // Rewinds to an empty stream, keeping the buffer.
+  void Reset() { mBitHead = 0; }
+
   const uint8_t* GetBuffer() const { return mBuffer.data(); }
   uint32_t GetBitLength() const { return mBitHead; }
   uint32_t GetByteLength() const { return (mBitHead + 7) >> 3; }
@@ -200,6 +223,10 @@ class InputMemoryBitStream {
   InputMemoryBitStream(uint32_t bitCapacity);
   InputMemoryBitStream(std::vector<uint8_t>&& buffer);
 
+  // Refills the stream with a copy of data and rewinds it, so one stream can
+  // parse packet after packet; only allocates to grow its buffer.
+  void Reset(const void* data, uint32_t byteCount);
+
   void ReadBits(uint8_t& outData, uint32_t bitCount);
   void ReadBits(void* outData, uint32_t bitCount);
 
@@ -209,6 +236,8 @@ class InputMemoryBitStream {
   uint32_t GetByteLength() const { return (mBitHead + 7) >> 3; }
   uint32_t GetBitCapacity() const { return mBitCapacity; }
   uint32_t GetByteCapacity() const { return (mBitCapacity + 7) >> 3; }
+  // Set once a read ran past the end; such reads return zeros.
+  bool HasOverrun() const { return mOverrun; }
 
   void ReadBytes(void* outData, uint32_t byteCount) {
     ReadBits(outData, byteCount << 3);
@@ -279,6 +308,7 @@ class InputMemoryBitStream {
   std::vector<uint8_t> mBuffer;
   uint32_t mBitHead;
   uint32_t mBitCapacity;
+  bool mOverrun{false};
 };
 
 }  // namespace GameNet
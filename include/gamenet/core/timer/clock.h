@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+namespace GameNet {
+
+using ClockDuration = std::chrono::steady_clock::duration;
+using ClockTimePoint = std::chrono::steady_clock::time_point;
+
+/**
+ * @brief Source of monotonic time.
+ *
+ * Everything that measures elapsed time (frame timing, transport simulation,
+ * reliability timeouts) reads it through this interface, so tests and
+ * benchmarks can swap in a ManualClock and run faster than real time.
+ */
+class IClock {
+ public:
+  virtual ~IClock() = default;
+
+  virtual ClockTimePoint Now() const = 0;
+};
+
+// Wall-clock time from std::chrono::steady_clock.
+class SteadyClock final : public IClock {
+ public:
+  // The process-wide instance used when no clock is injected.
+  static SteadyClock& Get();
+
+  ClockTimePoint Now() const override {
+    return std::chrono::steady_clock::now();
+  }
+};
+
+/**
+ * @brief Virtual time that only moves when told to.
+ * Now() may be read from any thread; Advance() from one thread at a time.
+ */
+class ManualClock final : public IClock {
+ public:
+  explicit ManualClock(ClockTimePoint startTime = ClockTimePoint{})
+      : mTicks(startTime.time_since_epoch().count()) {}
+
+  ClockTimePoint Now() const override {
+    return ClockTimePoint(ClockDuration(mTicks.load(std::memory_order_acquire)));
+  }
+
+  template <typename Rep, typename Period>
+  void Advance(std::chrono::duration<Rep, Period> delta) {
+    const auto ticks =
+        std::chrono::duration_cast<ClockDuration>(delta).count();
+    mTicks.fetch_add(ticks, std::memory_order_acq_rel);
+  }
+
+  void AdvanceSeconds(double seconds) {
+    Advance(std::chrono::duration<double>(seconds));
+  }
+
+ private:
+  std::atomic<ClockDuration::rep> mTicks;
+};
+
+}  // namespace GameNet
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#include "clock.h"
+
+namespace GameNet {
+
+/**
+ * @brief Fixed-size histogram of tick durations for p50/p99 reporting.
+ *
+ * Durations are bucketed log-linearly in microseconds: every power of two
+ * is split into kSubBuckets buckets, so a reported percentile is within
+ * about 6% of the true value. Recording is a few integer operations and
+ * never allocates, so it can stay on in shipping builds.
+ */
+class TickTimeHistogram {
+ public:
+  void Record(ClockDuration duration) {
+    const auto micros =
+        std::chrono::duration_cast<std::chrono::microseconds>(duration)
+            .count();
+    ++mBuckets[GetBucketIndex(micros > 0 ? static_cast<uint64_t>(micros) : 0)];
+    ++mCount;
+    if (duration > mMax) {
+      mMax = duration;
+    }
+  }
+
+  /**
+   * @brief The duration below which the given fraction of ticks fall, e.g.
+   * 0.99 for p99. Reports the upper edge of the bucket it falls in.
+   */
+  ClockDuration GetPercentile(double fraction) const {
+    if (mCount == 0) {
+      return ClockDuration::zero();
+    }
+
+    const uint64_t rank = static_cast<uint64_t>(fraction * (mCount - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t index = 0; index < kBucketCount; ++index) {
+      seen += mBuckets[index];
+      if (seen >= rank) {
+        return std::min<ClockDuration>(
+            std::chrono::microseconds(GetBucketUpperBound(index)), mMax);
+      }
+    }
+    return mMax;
+  }
+
+  uint64_t GetCount() const { return mCount; }
+  ClockDuration GetMax() const { return mMax; }
+
+  void Reset() { *this = TickTimeHistogram(); }
+
+ private:
+  static constexpr size_t kSubBucketBits = 4;
+  static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+  // Values below kSubBuckets get one bucket each; every doubling above that
+  // gets kSubBuckets more, up to 2^40 us.
+  static constexpr size_t kBucketCount = kSubBuckets * (40 - kSubBucketBits + 1);
+
+  static size_t GetBucketIndex(uint64_t micros) {
+    if (micros < kSubBuckets) {
+      return static_cast<size_t>(micros);
+    }
+    const size_t exponent = std::bit_width(micros) - 1;
+    const size_t shift = exponent - kSubBucketBits;
+    const size_t index = (shift + 1) * kSubBuckets +
+                         static_cast<size_t>((micros >> shift) - kSubBuckets);
+    return index < kBucketCount ? index : kBucketCount - 1;
+  }
+
+  static uint64_t GetBucketUpperBound(size_t index) {
+    if (index < kSubBuckets) {
+      return index + 1;
+    }
+    const size_t shift = index / kSubBuckets - 1;
+    const uint64_t subBucket = index % kSubBuckets + kSubBuckets;
+    return (subBucket + 1) << shift;
+  }
+
+  std::array<uint64_t, kBucketCount> mBuckets{};
+  uint64_t mCount{0};
+  ClockDuration mMax{ClockDuration::zero()};
+};
+
+}  // namespace GameNet
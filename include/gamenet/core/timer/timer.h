@@ -3,18 +3,23 @@
 #include <algorithm>
 #include <chrono>
 
+#include "clock.h"
+
 namespace GameNet {
 
 class FrameClock {
-  using clock = std::chrono::steady_clock;
-  clock::time_point prev = clock::now();
+  const IClock* clock;
+  ClockTimePoint prev;
 
  public:
   double maxDelta = 0.25;  // seconds
   double timeScale = 1.0;
 
+  explicit FrameClock(const IClock& inClock = SteadyClock::Get())
+      : clock(&inClock), prev(inClock.Now()) {}
+
   double Tick() {
-    auto now = clock::now();
+    auto now = clock->Now();
     std::chrono::duration<double> d = now - prev;
     prev = now;
 
@@ -25,6 +30,8 @@ class FrameClock {
 };
 
 class FixedStepper {
+  static constexpr double kStepTolerance = 1e-9;  // seconds
+
  public:
   double fixedDelta = 1.0 / 60.0;
   double accumulator = 0.0;
@@ -32,8 +39,11 @@ class FixedStepper {
   void AddTime(double dt) { accumulator += dt; }
 
   bool Step() {
-    if (accumulator >= fixedDelta) {
-      accumulator -= fixedDelta;
+    // Clock durations are whole nanoseconds, so a clock advanced by exactly
+    // one fixed step may report slightly less. Tolerate that rounding so a
+    // ManualClock yields exactly one step per advance.
+    if (accumulator + kStepTolerance >= fixedDelta) {
+      accumulator = std::max(0.0, accumulator - fixedDelta);
       return true;
     }
     return false;
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "clock.h"
+
+namespace GameNet {
+
+/**
+ * @brief Hashed timer wheel over a fixed set of timer ids.
+ *
+ * Timers are ids in [0, capacity) chosen by the caller, e.g. a connection
+ * slot index. Schedule, Cancel and reschedule are O(1) list operations on
+ * preallocated nodes, so nothing allocates after construction. Advance()
+ * only visits the wheel slots for the elapsed ticks; with a wheel that
+ * spans the longest timeout, that is the expired timers plus the few
+ * still-pending timers hashed to the same slots.
+ *
+ * Timers fire at the first Advance() at or after their expiry, rounded up
+ * to the tick duration.
+ */
+class TimerWheel {
+ public:
+  static constexpr uint32_t kInvalidTimerId = ~0u;
+
+  TimerWheel(uint32_t timerCapacity, ClockDuration tickDuration,
+             uint32_t slotCount, ClockTimePoint startTime);
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // Schedules or reschedules timerId.
+  void Schedule(uint32_t timerId, ClockTimePoint expiryTime);
+  void Cancel(uint32_t timerId);
+
+  bool IsScheduled(uint32_t timerId) const {
+    return mNodes[timerId].slot != kUnscheduled;
+  }
+
+  /**
+   * @brief Fires every timer that expired by currTime, calling
+   * onExpired(timerId) after unscheduling it. The callback may schedule or
+   * cancel any timer, including the one that fired.
+   */
+  template <typename OnExpired>
+  void Advance(ClockTimePoint currTime, OnExpired&& onExpired);
+
+  uint32_t GetCapacity() const { return static_cast<uint32_t>(mNodes.size()); }
+
+ private:
+  static constexpr uint32_t kUnscheduled = ~0u;
+
+  struct Node {
+    uint32_t prev{kInvalidTimerId};
+    uint32_t next{kInvalidTimerId};
+    uint32_t slot{kUnscheduled};
+    uint64_t expiryTick{0};
+  };
+
+  // Ticks that have fully passed by time, and the first tick at or after it.
+  uint64_t GetElapsedTicks(ClockTimePoint time) const;
+  uint64_t GetExpiryTick(ClockTimePoint time) const;
+
+  void Link(uint32_t timerId, uint32_t slot);
+  void Unlink(uint32_t timerId);
+
+  ClockDuration mTickDuration;
+  ClockTimePoint mStartTime;
+  uint64_t mCurrentTick{0};
+  uint32_t mSlotMask;
+  // Wheel slots, plus one extra list (mExpiringSlot) that holds a slot's
+  // timers while Advance() walks them.
+  uint32_t mExpiringSlot;
+  std::vector<uint32_t> mSlotHeads;
+  std::vector<Node> mNodes;
+};
+
+template <typename OnExpired>
+void TimerWheel::Advance(ClockTimePoint currTime, OnExpired&& onExpired) {
+  const uint64_t targetTick = GetElapsedTicks(currTime);
+  if (targetTick <= mCurrentTick) {
+    return;
+  }
+
+  // Moved first, so a timer the callback schedules lands after targetTick
+  // rather than in a slot this pass has already visited.
+  const uint64_t prevTick = mCurrentTick;
+  mCurrentTick = targetTick;
+
+  // Past one full turn every slot is due, and each only once.
+  const uint64_t slotsToVisit =
+      std::min<uint64_t>(targetTick - prevTick, mSlotMask + 1);
+
+  for (uint64_t i = 1; i <= slotsToVisit; ++i) {
+    const uint32_t slot = static_cast<uint32_t>((prevTick + i) & mSlotMask);
+
+    // Move the slot's list aside so the callback can reschedule into it.
+    uint32_t timerId = mSlotHeads[slot];
+    mSlotHeads[slot] = kInvalidTimerId;
+    mSlotHeads[mExpiringSlot] = timerId;
+    for (; timerId != kInvalidTimerId; timerId = mNodes[timerId].next) {
+      mNodes[timerId].slot = mExpiringSlot;
+    }
+
+    while ((timerId = mSlotHeads[mExpiringSlot]) != kInvalidTimerId) {
+      Unlink(timerId);
+      if (mNodes[timerId].expiryTick > targetTick) {
+        // Due on a later turn of the wheel.
+        Link(timerId, slot);
+        continue;
+      }
+      onExpired(timerId);
+    }
+  }
+}
+
+}  // namespace GameNet
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/hash/siphash.h"
+#include "core/timer/clock.h"
+#include "socket/socket_address.h"
+
+namespace GameNet {
+
+struct AddressRateLimiterSettings {
+  double packetsPerSecond = 128.0;  // sustained rate per source address.
+  double burst = 64.0;              // packets allowed back to back.
+  size_t bucketCount = 4096;        // rounded up to a power of 2.
+};
+
+/**
+ * @brief Token bucket per source address, in a fixed-size table.
+ *
+ * The table never grows, so a flood from millions of spoofed addresses costs
+ * the same memory as a quiet server. Addresses are mapped to buckets with a
+ * keyed hash of their family, port and address bytes; an attacker cannot
+ * aim spoofed packets at the bucket of a particular client. Two live addresses that land in the same bucket share
+ * its budget until one of them goes quiet.
+ */
+class AddressRateLimiter {
+ public:
+  explicit AddressRateLimiter(const AddressRateLimiterSettings& settings);
+
+  // Take one token for address. Returns false if its bucket is empty.
+  bool Allow(const SocketAddress& address, ClockTimePoint currTime);
+
+ private:
+  struct Bucket {
+    uint64_t tag{0};
+    ClockTimePoint lastRefillTime{};
+    double tokens{0.0};
+  };
+
+  AddressRateLimiterSettings mSettings;
+  ClockDuration mRefillDuration;  // time for an empty bucket to fill up.
+  SipHashKey mKey;
+  size_t mBucketMask;
+  std::vector<Bucket> mBuckets;
+};
+
+}  // namespace GameNet
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "core/memory-stream/memory_bit_stream.h"
+#include "core/timer/clock.h"
+#include "endpoint/network_endpoint_interface.h"
+#include "reliability/delivery_notification_manager.h"
+
+namespace GameNet {
+
+struct ClientNetworkSettings {
+  uint64_t protocolId = 0;
+  // How often handshake packets are resent while connecting.
+  ClockDuration handshakeResendInterval = std::chrono::milliseconds(100);
+  ClockDuration connectTimeout = std::chrono::seconds(5);
+  ClockDuration timeout = std::chrono::seconds(10);
+  ClockDuration keepAliveInterval = std::chrono::seconds(1);
+};
+
+enum class ClientConnectionState {
+  Disconnected,
+  SendingRequest,
+  SendingResponse,
+  Connected,
+  Denied,
+  TimedOut,
+};
+
+/**
+ * @brief Client side of the ServerNetworkDriver handshake.
+ *
+ * Connect() starts resending ConnectionRequest; Update() receives, moves
+ * through the handshake and keeps the connection alive. Payloads are only
+ * sent and delivered while Connected, through a DeliveryNotificationManager
+ * that is reset on every Connect().
+ */
+class ClientNetworkDriver {
+ public:
+  using PayloadHandler = std::function<void(std::span<const uint8_t> payload)>;
+
+  ClientNetworkDriver(std::unique_ptr<INetworkTransportEndpoint> endpoint,
+                      const ClientNetworkSettings& settings,
+                      const IClock& clock);
+
+  ClientNetworkDriver(const ClientNetworkDriver&) = delete;
+  ClientNetworkDriver& operator=(const ClientNetworkDriver&) = delete;
+
+  void SetPayloadHandler(PayloadHandler handler) {
+    mPayloadHandler = std::move(handler);
+  }
+
+  void Connect(const SocketAddress& serverAddress);
+  void Disconnect();
+
+  void Update();
+
+  // Up to kNetcodeMaxPayloadSize bytes; transmissionData as for
+  // ServerNetworkDriver::SendPayload().
+  bool SendPayload(std::span<const uint8_t> payload,
+                   int transmissionDataKey = 0,
+                   TransmissionDataPtr transmissionData = nullptr);
+
+  ClientConnectionState GetState() const { return mState; }
+  bool IsConnected() const {
+    return mState == ClientConnectionState::Connected;
+  }
+  // Only meaningful while connected.
+  uint32_t GetClientId() const { return mClientId; }
+
+  const DeliveryNotificationManager& GetDeliveryNotificationManager() const {
+    return mDeliveryNotificationManager;
+  }
+
+ private:
+  void ProcessPacket(std::span<const uint8_t> packet, ClockTimePoint currTime);
+  void SendHandshake(ClockTimePoint currTime);
+  bool Send(std::span<const uint8_t> packet, ClockTimePoint currTime);
+
+  std::unique_ptr<INetworkTransportEndpoint> mEndpoint;
+  ClientNetworkSettings mSettings;
+  const IClock* mClock;
+
+  ClientConnectionState mState{ClientConnectionState::Disconnected};
+  SocketAddress mServerAddress{};
+  uint64_t mClientSalt{0};
+  uint32_t mChallengeEpoch{0};
+  uint64_t mChallengeCookie{0};
+  uint32_t mClientId{0};
+
+  ClockTimePoint mConnectStartTime{};
+  ClockTimePoint mLastReceiveTime{};
+  ClockTimePoint mLastSendTime{};
+
+  DeliveryNotificationManager mDeliveryNotificationManager;
+
+  NetworkReceivedPacket mReceivedPacket;
+  std::vector<uint8_t> mSendBuffer;
+  // Scratch streams for Payload headers.
+  OutputMemoryBitStream mPayloadHeaderWriter;
+  InputMemoryBitStream mPayloadHeaderReader;
+
+  PayloadHandler mPayloadHandler;
+};
+
+}  // namespace GameNet
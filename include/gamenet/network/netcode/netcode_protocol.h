@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GameNet {
+
+/**
+ * @brief First byte of every datagram exchanged by the network drivers.
+ *
+ * Connection handshake, all fields little-endian:
+ *
+ *   client -> ConnectionRequest   protocolId:u64 clientSalt:u64, zero padded
+ *                                 to kConnectionRequestSize
+ *   server -> ConnectionChallenge clientSalt:u64 epoch:u32 cookie:u64
+ *   client -> ConnectionResponse  protocolId:u64 clientSalt:u64 epoch:u32
+ *                                 cookie:u64
+ *   server -> ConnectionAccepted  clientSalt:u64 clientId:u32
+ *          or ConnectionDenied    clientSalt:u64
+ *
+ * The cookie is a keyed hash of the client address, salt and epoch, so the
+ * server keeps no state for a client until it echoes a valid cookie, which
+ * proves it can receive at the address it claims.
+ *
+ * A Payload carries the sender's DeliveryNotificationManager state, bit
+ * packed and zero padded to a byte, before the payload bytes:
+ *
+ *   Payload sequence:u16 hasAck:1 [ackStart:u16 hasCount:1 [count-1:u16]]
+ *           payload
+ *
+ * Payloads older than the newest one received are dropped, and each side
+ * learns which of its payloads arrived from the acks riding on the other's.
+ */
+enum class NetcodePacketType : uint8_t {
+  ConnectionRequest = 1,
+  ConnectionChallenge,
+  ConnectionResponse,
+  ConnectionAccepted,
+  ConnectionDenied,
+  KeepAlive,
+  Payload,
+  Disconnect,
+};
+
+// Requests are padded to be larger than any reply, so a spoofed request can
+// never make the server send more bytes than it received.
+constexpr size_t kConnectionRequestSize = 64;
+
+constexpr size_t kConnectionChallengeSize = 1 + 8 + 4 + 8;
+constexpr size_t kConnectionResponseSize = 1 + 8 + 8 + 4 + 8;
+constexpr size_t kConnectionAcceptedSize = 1 + 8 + 4;
+constexpr size_t kConnectionDeniedSize = 1 + 8;
+
+static_assert(kConnectionRequestSize >= kConnectionChallengeSize &&
+              kConnectionRequestSize >= kConnectionDeniedSize);
+
+// Largest datagram the drivers send or accept, type byte included.
+constexpr size_t kNetcodeMaxPacketSize = 1200;
+
+// Type byte and the largest delivery state a Payload starts with.
+constexpr size_t kPayloadHeaderMaxSize = 1 + (16 + 1 + 16 + 1 + 16 + 7) / 8;
+constexpr size_t kNetcodeMaxPayloadSize =
+    kNetcodeMaxPacketSize - kPayloadHeaderMaxSize;
+
+}  // namespace GameNet
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "connection_table.h"
+#include "core/timer/clock.h"
+#include "core/timer/timer_wheel.h"
+#include "reliability/delivery_notification_manager.h"
+
+namespace GameNet {
+
+struct ServerConnectionSettings {
+  uint32_t maxConnections = 1024;
+  ClockDuration timeout = std::chrono::seconds(10);
+  ClockDuration keepAliveInterval = std::chrono::seconds(1);
+  // Timeouts and keep-alives fire up to this much late.
+  ClockDuration timerResolution = std::chrono::milliseconds(10);
+};
+
+// Per-client state, one per slot.
+struct ServerConnection {
+  explicit ServerConnection(const IClock& clock)
+      : deliveryNotificationManager(true, true, clock) {}
+
+  SocketAddress address{};
+  uint64_t clientSalt{0};
+  ClockTimePoint lastReceiveTime{};
+  ClockTimePoint lastSendTime{};
+  DeliveryNotificationManager deliveryNotificationManager;
+};
+
+/**
+ * @brief Fixed-capacity table of server-side connections.
+ *
+ * Connections live in a slot array sized for maxConnections up front; the
+ * slot index is the connection id, and a freed slot is reset and reused,
+ * keeping the capacity its queues grew to. Received datagrams find their
+ * connection through a ConnectionTable, and live connections are also kept
+ * in a dense id list for iteration.
+ *
+ * Timeouts and keep-alives are timer wheel entries that are re-armed lazily:
+ * MarkReceived() and MarkSent() only store a time stamp, and a timer that
+ * fires early for a connection that has been active since is pushed back.
+ * Update() therefore costs O(expired timers) rather than O(connections),
+ * and none of this allocates once constructed.
+ */
+class ServerConnectionManager {
+ public:
+  static constexpr uint32_t kInvalidConnectionId = ~0u;
+
+  ServerConnectionManager(const ServerConnectionSettings& settings,
+                          const IClock& clock);
+
+  ServerConnectionManager(const ServerConnectionManager&) = delete;
+  ServerConnectionManager& operator=(const ServerConnectionManager&) = delete;
+
+  // Returns kInvalidConnectionId when every slot is taken.
+  uint32_t Add(const SocketAddress& address, uint64_t clientSalt,
+               ClockTimePoint currTime);
+  void Remove(uint32_t connectionId);
+
+  // Returns kInvalidConnectionId for unknown addresses.
+  uint32_t Find(const SocketAddress& address) const {
+    const uint32_t* connectionId = mConnectionIdsByAddress.Find(address);
+    return connectionId ? *connectionId : kInvalidConnectionId;
+  }
+
+  bool IsConnected(uint32_t connectionId) const {
+    return connectionId < mDenseIndices.size() &&
+           mDenseIndices[connectionId] != kInvalidConnectionId;
+  }
+
+  ServerConnection& GetConnection(uint32_t connectionId) {
+    return mConnections[connectionId];
+  }
+  const ServerConnection& GetConnection(uint32_t connectionId) const {
+    return mConnections[connectionId];
+  }
+
+  void MarkReceived(uint32_t connectionId, ClockTimePoint currTime) {
+    mConnections[connectionId].lastReceiveTime = currTime;
+  }
+  void MarkSent(uint32_t connectionId, ClockTimePoint currTime) {
+    mConnections[connectionId].lastSendTime = currTime;
+  }
+
+  /**
+   * @brief Fires due timers: onTimeout(id) for connections silent for the
+   * timeout, onKeepAlive(id) for ones that sent nothing for the keep-alive
+   * interval. onTimeout may Remove() the connection; onKeepAlive is expected
+   * to send something and MarkSent().
+   */
+  template <typename OnTimeout, typename OnKeepAlive>
+  void Update(ClockTimePoint currTime, OnTimeout&& onTimeout,
+              OnKeepAlive&& onKeepAlive);
+
+  // Ids of the live connections, in no particular order.
+  std::span<const uint32_t> GetConnectionIds() const { return mConnectionIds; }
+  uint32_t GetConnectionCount() const {
+    return static_cast<uint32_t>(mConnectionIds.size());
+  }
+  uint32_t GetMaxConnections() const { return mSettings.maxConnections; }
+
+ private:
+  // Two timers per connection.
+  static uint32_t TimeoutTimerId(uint32_t connectionId) {
+    return connectionId * 2;
+  }
+  static uint32_t KeepAliveTimerId(uint32_t connectionId) {
+    return connectionId * 2 + 1;
+  }
+
+  ServerConnectionSettings mSettings;
+
+  std::vector<ServerConnection> mConnections;
+  // Position of each slot in mConnectionIds, or kInvalidConnectionId.
+  std::vector<uint32_t> mDenseIndices;
+  std::vector<uint32_t> mConnectionIds;
+  std::vector<uint32_t> mFreeConnectionIds;
+  ConnectionTable<uint32_t> mConnectionIdsByAddress;
+
+  TimerWheel mTimers;
+};
+
+template <typename OnTimeout, typename OnKeepAlive>
+void ServerConnectionManager::Update(ClockTimePoint currTime,
+                                     OnTimeout&& onTimeout,
+                                     OnKeepAlive&& onKeepAlive) {
+  mTimers.Advance(currTime, [&](uint32_t timerId) {
+    const uint32_t connectionId = timerId / 2;
+    const ServerConnection& connection = mConnections[connectionId];
+
+    if (timerId == TimeoutTimerId(connectionId)) {
+      const ClockTimePoint expiryTime =
+          connection.lastReceiveTime + mSettings.timeout;
+      if (currTime < expiryTime) {
+        mTimers.Schedule(timerId, expiryTime);
+        return;
+      }
+      // Re-armed first, in case the callback keeps the connection.
+      mTimers.Schedule(timerId, currTime + mSettings.timeout);
+      onTimeout(connectionId);
+      return;
+    }
+
+    if (currTime >= connection.lastSendTime + mSettings.keepAliveInterval) {
+      onKeepAlive(connectionId);
+    }
+    if (IsConnected(connectionId)) {
+      mTimers.Schedule(timerId,
+                       connection.lastSendTime + mSettings.keepAliveInterval);
+    }
+  });
+}
+
+}  // namespace GameNet
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "address_rate_limiter.h"
+#include "core/hash/siphash.h"
+#include "core/memory-stream/memory_bit_stream.h"
+#include "core/timer/clock.h"
+#include "endpoint/network_endpoint_interface.h"
+#include "server_connection_manager.h"
+
+namespace GameNet {
+
+struct ServerNetworkSettings {
+  uint64_t protocolId = 0;
+  uint32_t maxClients = 1024;
+  // A challenge cookie stays valid for one to two lifetimes.
+  ClockDuration cookieLifetime = std::chrono::seconds(10);
+  ClockDuration clientTimeout = std::chrono::seconds(10);
+  ClockDuration keepAliveInterval = std::chrono::seconds(1);
+  // Timeouts and keep-alives fire up to this much late.
+  ClockDuration timerResolution = std::chrono::milliseconds(10);
+  // Datagrams pulled from the endpoint per PollPackets() call.
+  size_t receiveBatchSize = 64;
+  AddressRateLimiterSettings rateLimiter{};
+};
+
+struct ServerNetworkStats {
+  uint64_t receivedPacketCount{0};
+  uint64_t rateLimitedPacketCount{0};
+  uint64_t malformedPacketCount{0};
+  // Payloads that arrived after a newer one and were dropped.
+  uint64_t stalePayloadCount{0};
+  uint64_t challengeSentCount{0};
+  uint64_t invalidCookieCount{0};
+  uint64_t deniedConnectionCount{0};
+  uint64_t acceptedConnectionCount{0};
+  uint64_t timedOutClientCount{0};
+};
+
+/**
+ * @brief Accepts clients over a datagram endpoint and exchanges payloads
+ * with them.
+ *
+ * Datagrams from addresses without a connection first pass a per-address
+ * token bucket, so a flood is dropped after one hash and two table probes.
+ * Connection requests are answered with a stateless cookie (see
+ * NetcodePacketType); a client only gets a slot, and callers only hear about
+ * it, once it echoes the cookie.
+ *
+ * Client state lives in a ServerConnectionManager; client ids are its slot
+ * indices in [0, maxClients) and are reused after a disconnect. Payloads in
+ * both directions go through the connection's DeliveryNotificationManager,
+ * which drops stale ones and reports which sent ones were delivered.
+ * Receiving, dispatching, sending and Update() do not allocate in steady
+ * state.
+ */
+class ServerNetworkDriver {
+ public:
+  using PayloadHandler =
+      std::function<void(uint32_t clientId, std::span<const uint8_t> payload)>;
+  using ClientHandler = std::function<void(uint32_t clientId)>;
+
+  ServerNetworkDriver(std::unique_ptr<INetworkTransportEndpoint> endpoint,
+                      const ServerNetworkSettings& settings,
+                      const IClock& clock);
+
+  ServerNetworkDriver(const ServerNetworkDriver&) = delete;
+  ServerNetworkDriver& operator=(const ServerNetworkDriver&) = delete;
+
+  void SetPayloadHandler(PayloadHandler handler) {
+    mPayloadHandler = std::move(handler);
+  }
+  void SetClientConnectedHandler(ClientHandler handler) {
+    mClientConnectedHandler = std::move(handler);
+  }
+  void SetClientDisconnectedHandler(ClientHandler handler) {
+    mClientDisconnectedHandler = std::move(handler);
+  }
+
+  // Drains the endpoint, handling handshakes and dispatching payloads.
+  void ReceivePackets();
+
+  // Times out silent clients and sends keep-alives to idle ones; costs
+  // O(expired timers), not O(clients).
+  void Update();
+
+  /**
+   * @brief Sends up to kNetcodeMaxPayloadSize bytes.
+   * @param transmissionData if set, is told whether this packet arrived once
+   * the client acks it or it times out; see InFlightPacket for the key.
+   */
+  bool SendPayload(uint32_t clientId, std::span<const uint8_t> payload,
+                   int transmissionDataKey = 0,
+                   TransmissionDataPtr transmissionData = nullptr);
+
+  void DisconnectClient(uint32_t clientId);
+
+  bool IsClientConnected(uint32_t clientId) const {
+    return mConnections.IsConnected(clientId);
+  }
+  uint32_t GetClientCount() const { return mConnections.GetConnectionCount(); }
+
+  // Per-client state, including its DeliveryNotificationManager.
+  ServerConnectionManager& GetConnections() { return mConnections; }
+  const ServerConnectionManager& GetConnections() const {
+    return mConnections;
+  }
+  const ServerNetworkStats& GetStats() const { return mStats; }
+
+  SocketAddress GetLocalSocketAddress() const {
+    return mEndpoint->GetLocalSocketAddress();
+  }
+
+ private:
+  void ProcessPacket(const NetworkReceivedPacket& packet,
+                     ClockTimePoint currTime);
+  void ProcessConnectionRequest(const SocketAddress& address,
+                                std::span<const uint8_t> packet,
+                                ClockTimePoint currTime);
+  void ProcessConnectionResponse(const SocketAddress& address,
+                                 std::span<const uint8_t> packet,
+                                 ClockTimePoint currTime);
+  void ProcessClientPacket(uint32_t clientId, std::span<const uint8_t> packet,
+                           ClockTimePoint currTime);
+
+  uint32_t GetEpoch(ClockTimePoint currTime) const;
+  uint64_t MakeCookie(const SocketAddress& address, uint64_t clientSalt,
+                      uint32_t epoch) const;
+
+  void SendAccepted(uint32_t clientId);
+  void SendDenied(const SocketAddress& address, uint64_t clientSalt);
+  bool SendToClient(uint32_t clientId, std::span<const uint8_t> packet);
+  void RemoveClient(uint32_t clientId);
+
+  std::unique_ptr<INetworkTransportEndpoint> mEndpoint;
+  ServerNetworkSettings mSettings;
+  const IClock* mClock;
+
+  AddressRateLimiter mRateLimiter;
+  SipHashKey mCookieKey;
+
+  ServerConnectionManager mConnections;
+
+  std::vector<NetworkReceivedPacket> mReceiveBatch;
+  std::vector<uint8_t> mSendBuffer;
+  // Scratch streams for Payload headers.
+  OutputMemoryBitStream mPayloadHeaderWriter;
+  InputMemoryBitStream mPayloadHeaderReader;
+
+  PayloadHandler mPayloadHandler;
+  ClientHandler mClientConnectedHandler;
+  ClientHandler mClientDisconnectedHandler;
+
+  ServerNetworkStats mStats;
+};
+
+}  // namespace GameNet
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace GameNet {
+
+/**
+ * @brief Reads little-endian fields written by PacketWriter.
+ *
+ * Reading past the end yields zeros and clears IsValid(), so a parser can
+ * read every field and check once at the end instead of after each read.
+ */
+class PacketReader {
+ public:
+  explicit PacketReader(std::span<const uint8_t> buffer) : mBuffer(buffer) {}
+
+  template <typename T, std::enable_if_t<std::is_integral_v<T> ||
+                                             std::is_enum_v<T>,
+                                         bool> = true>
+  T Read() {
+    using Unsigned = std::make_unsigned_t<
+        typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>,
+                                    std::type_identity<T>>::type>;
+    if (!Consume(sizeof(T))) {
+      return T{};
+    }
+    Unsigned bits = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+      bits |= static_cast<Unsigned>(mBuffer[mOffset - sizeof(T) + i]) << (8 * i);
+    }
+    return static_cast<T>(bits);
+  }
+
+  // The next size bytes, in place. Empty if fewer remain.
+  std::span<const uint8_t> ReadBytes(size_t size) {
+    if (!Consume(size)) {
+      return {};
+    }
+    return mBuffer.subspan(mOffset - size, size);
+  }
+
+  std::span<const uint8_t> GetRemainingBytes() const {
+    return mBuffer.subspan(mOffset);
+  }
+
+  size_t GetOffset() const { return mOffset; }
+  bool IsValid() const { return mValid; }
+
+ private:
+  bool Consume(size_t size) {
+    if (!mValid || size > mBuffer.size() - mOffset) {
+      mValid = false;
+      return false;
+    }
+    mOffset += size;
+    return true;
+  }
+
+  std::span<const uint8_t> mBuffer;
+  size_t mOffset{0};
+  bool mValid{true};
+};
+
+}  // namespace GameNet
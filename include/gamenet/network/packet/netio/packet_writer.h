@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace GameNet {
+
+/**
+ * @brief Writes little-endian fields into a caller-owned buffer.
+ *
+ * Meant for small fixed-layout control packets (handshakes, keep-alives)
+ * that are built on the stack without allocating. Writing past the end of
+ * the buffer writes nothing and sets HasOverflowed().
+ */
+class PacketWriter {
+ public:
+  explicit PacketWriter(std::span<uint8_t> buffer) : mBuffer(buffer) {}
+
+  template <typename T, std::enable_if_t<std::is_integral_v<T> ||
+                                             std::is_enum_v<T>,
+                                         bool> = true>
+  void Write(T value) {
+    using Unsigned = std::make_unsigned_t<
+        typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>,
+                                    std::type_identity<T>>::type>;
+    if (!Reserve(sizeof(T))) {
+      return;
+    }
+    Unsigned bits = static_cast<Unsigned>(value);
+    for (size_t i = 0; i < sizeof(T); ++i) {
+      mBuffer[mSize++] = static_cast<uint8_t>(bits >> (8 * i));
+    }
+  }
+
+  void WriteBytes(std::span<const uint8_t> bytes) {
+    if (!Reserve(bytes.size())) {
+      return;
+    }
+    if (!bytes.empty()) {
+      memcpy(mBuffer.data() + mSize, bytes.data(), bytes.size());
+    }
+    mSize += bytes.size();
+  }
+
+  // Pad with zeros up to size bytes in total.
+  void PadTo(size_t size) {
+    if (size <= mSize || !Reserve(size - mSize)) {
+      return;
+    }
+    memset(mBuffer.data() + mSize, 0, size - mSize);
+    mSize = size;
+  }
+
+  size_t GetSize() const { return mSize; }
+  bool HasOverflowed() const { return mOverflowed; }
+  std::span<const uint8_t> GetWrittenBytes() const {
+    return mBuffer.first(mSize);
+  }
+
+ private:
+  bool Reserve(size_t size) {
+    if (mOverflowed || size > mBuffer.size() - mSize) {
+      mOverflowed = true;
+      return false;
+    }
+    return true;
+  }
+
+  std::span<uint8_t> mBuffer;
+  size_t mSize{0};
+  bool mOverflowed{false};
+};
+
+}  // namespace GameNet
@@ -1,2 +1,4 @@
 #pragma once
 
+#include "netio/packet_reader.h"
+#include "netio/packet_writer.h"
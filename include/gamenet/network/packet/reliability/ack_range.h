@@ -14,7 +14,7 @@ class AckRange {
   bool MaybePushBack(PacketSequenceNumber sequenceNumber);
 
   PacketSequenceNumber GetStart() const { return mStart; }
-  uint8_t GetCount() const { return mCount; }
+  uint16_t GetCount() const { return mCount; }
 
   void WriteBitStream(OutputMemoryBitStream& outputStream) const;
   void ReadBitStream(InputMemoryBitStream& inputStream);
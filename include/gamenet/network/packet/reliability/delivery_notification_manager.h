@@ -3,6 +3,7 @@
 // UDP reliability layer.
 
 #include "ack_range.h"
+#include "core/container/ring_queue.h"
 #include "in_flight_packet.h"
 #include "reliability_common.h"
 
@@ -10,19 +11,35 @@ namespace GameNet {
 
 class DeliveryNotificationManager {
  public:
-  DeliveryNotificationManager(bool inShouldSendAcks, bool inShouldProcessAcks);
+  static constexpr ClockDuration kDefaultAckTimeout =
+      std::chrono::milliseconds(500);
+
+  /**
+   * @param inClock stamps dispatched packets and decides when they time out.
+   * Inject a ManualClock to make timeouts deterministic.
+   */
+  DeliveryNotificationManager(bool inShouldSendAcks, bool inShouldProcessAcks,
+                              const IClock& inClock = SteadyClock::Get());
   ~DeliveryNotificationManager();
 
+  // The returned packet is valid until the next WriteState() call.
   inline InFlightPacket* WriteState(OutputMemoryBitStream& inOutputStream);
   inline bool ReadAndProcessState(InputMemoryBitStream& inInputStream);
 
+  // Reports packets that have not been acked within the ack timeout as lost.
   void ProcessTimedOutPackets();
 
+  // Back to the state of a new connection, keeping the queue capacity so a
+  // reused connection slot doesn't allocate.
+  void Reset();
+
+  void SetAckTimeout(ClockDuration inAckTimeout) { mAckTimeout = inAckTimeout; }
+
   uint32_t GetDroppedPacketCount() const { return mDroppedPacketCount; }
   uint32_t GetDeliveredPacketCount() const { return mDeliveredPacketCount; }
   uint32_t GetDispatchedPacketCount() const { return mDispatchedPacketCount; }
 
-  const std::deque<InFlightPacket>& GetInFlightPackets() const {
+  const RingQueue<InFlightPacket>& GetInFlightPackets() const {
     return mInFlightPackets;
   }
 
@@ -41,8 +58,9 @@ class DeliveryNotificationManager {
   PacketSequenceNumber mNextOutgoingSequenceNumber;
   PacketSequenceNumber mNextExpectedSequenceNumber;
 
-  std::deque<InFlightPacket> mInFlightPackets;
-  std::deque<AckRange> mPendingAcks;
+  // Ring queues stop allocating once they reach the working set size.
+  RingQueue<InFlightPacket> mInFlightPackets;
+  RingQueue<AckRange> mPendingAcks;
 
   bool mShouldSendAcks;
   bool mShouldProcessAcks;
@@ -50,6 +68,9 @@ class DeliveryNotificationManager {
   uint32_t mDeliveredPacketCount;
   uint32_t mDroppedPacketCount;
   uint32_t mDispatchedPacketCount;
+
+  const IClock* mClock;
+  ClockDuration mAckTimeout;
 };
 
 inline InFlightPacket* DeliveryNotificationManager::WriteState(
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+
 #include "reliability_common.h"
 #include "transmission_data.h"
 
@@ -8,18 +11,20 @@ class DeliveryNotificationManager;
 
 class InFlightPacket {
  public:
-  InFlightPacket(PacketSequenceNumber inSequenceNumber);
+  // Subsystems that can attach data to one packet. Kept inline so sending a
+  // packet doesn't allocate.
+  static constexpr size_t kMaxTransmissionDataCount = 4;
+
+  InFlightPacket(PacketSequenceNumber inSequenceNumber,
+                 ClockTimePoint inTimeDispatched);
 
   PacketSequenceNumber GetSequenceNumber() const { return mSequenceNumber; }
-  float GetTimeDispatched() const { return mTimeDispatched; }
+  ClockTimePoint GetTimeDispatched() const { return mTimeDispatched; }
 
-  void SetTransmissionData(int inKey, TransmissionDataPtr inTransmissionData) {
-    mTransmissionDataMap[inKey] = inTransmissionData;
-  }
-  const TransmissionDataPtr GetTransmissionData(int inKey) const {
-    auto it = mTransmissionDataMap.find(inKey);
-    return (it != mTransmissionDataMap.end()) ? it->second : nullptr;
-  }
+  // Replaces the data already set for inKey. Logs an error and drops the
+  // data if kMaxTransmissionDataCount keys are already set.
+  void SetTransmissionData(int inKey, TransmissionDataPtr inTransmissionData);
+  const TransmissionDataPtr GetTransmissionData(int inKey) const;
 
   void HandleDeliveryFailure(
       DeliveryNotificationManager* inDeliveryNotificationManager) const;
@@ -28,8 +33,15 @@ class InFlightPacket {
 
  private:
   PacketSequenceNumber mSequenceNumber;
-  float mTimeDispatched;
+  ClockTimePoint mTimeDispatched;
+
+  struct TransmissionDataEntry {
+    int key{0};
+    TransmissionDataPtr data;
+  };
 
-  std::unordered_map<int, TransmissionDataPtr> mTransmissionDataMap;
+  std::array<TransmissionDataEntry, kMaxTransmissionDataCount>
+      mTransmissionData{};
+  uint8_t mTransmissionDataCount{0};
 };
 }  // namespace GameNet
\ No newline at end of file
@@ -4,7 +4,24 @@
 #include <unordered_map>
 
 #include "core/memory-stream/memory_bit_stream.h"
+#include "core/timer/clock.h"
 
 // in case we decide to change the type of the sequence number to use fewer or
 // more bits
 using PacketSequenceNumber = uint16_t;
+
+namespace GameNet {
+
+// Wrap-around aware ordering: a is "after" b if it is less than half the
+// sequence space ahead of it.
+inline bool IsSequenceGreaterThan(PacketSequenceNumber a,
+                                  PacketSequenceNumber b) {
+  return a != b && static_cast<PacketSequenceNumber>(a - b) < 0x8000u;
+}
+
+inline bool IsSequenceLessThan(PacketSequenceNumber a,
+                               PacketSequenceNumber b) {
+  return IsSequenceGreaterThan(b, a);
+}
+
+}  // namespace GameNet
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+
+#include "core/container/flat_hash_map.h"
+#include "core/container/two_level_bitset.h"
+#include "core/math/math.h"
+#include "linking_context.h"
+
+namespace GameNet {
+
+struct InterestManagerSettings {
+  uint32_t maxConnections = 64;
+  uint32_t expectedObjectCount = 1024;
+  // Edge of a grid cell. About the typical view radius keeps a query to a
+  // few cells.
+  float cellSize = 32.0f;
+  // An object enters a view within its radius and only leaves it beyond the
+  // radius plus this, so one moving along the edge doesn't flicker.
+  float leaveMargin = 4.0f;
+};
+
+/**
+ * @brief Decides which objects each connection can see.
+ *
+ * Objects are kept in a uniform grid hashed by cell coordinate, so only
+ * occupied cells cost memory and the world needs no bounds. Moving an object
+ * touches the grid only when it crosses into another cell, in O(1).
+ *
+ * Each connection has a spherical view. Update() gathers the objects in the
+ * cells its view overlaps and diffs them against what it saw last time,
+ * reporting onEnter(connectionId, networkId) and onLeave(connectionId,
+ * networkId); these map to ReplicationManager::StartReplicating() and
+ * StopReplicating(), with replicateToAllConnections off. The cost per view
+ * is the objects near it, not every object.
+ *
+ * RemoveObject() reports no leave events: a removed object is destroyed for
+ * everyone through ReplicationManager::ReplicateDestroy().
+ */
+class InterestManager {
+ public:
+  explicit InterestManager(
+      const InterestManagerSettings& settings = InterestManagerSettings());
+
+  InterestManager(const InterestManager&) = delete;
+  InterestManager& operator=(const InterestManager&) = delete;
+
+  void AddObject(uint32_t inNetworkId, const glm::vec3& position);
+  void MoveObject(uint32_t inNetworkId, const glm::vec3& position);
+  void RemoveObject(uint32_t inNetworkId);
+
+  void SetView(uint32_t connectionId, const glm::vec3& position, float radius);
+  // Forgets what the connection saw, without leave events.
+  void RemoveView(uint32_t connectionId);
+
+  template <typename OnEnter, typename OnLeave>
+  void Update(OnEnter&& onEnter, OnLeave&& onLeave);
+
+  bool IsVisible(uint32_t connectionId, uint32_t inNetworkId) const;
+
+ private:
+  static constexpr uint32_t kInvalidRow = ~0u;
+  static constexpr uint32_t kInvalidCell = ~0u;
+
+  struct CellEntry {
+    glm::vec3 position;
+    uint32_t row;
+  };
+
+  struct Cell {
+    std::vector<CellEntry> entries;
+  };
+
+  struct ObjectEntry {
+    uint32_t networkId{LinkingContext::kInvalidNetworkId};
+    uint32_t cell{kInvalidCell};
+    uint32_t indexInCell{0};
+  };
+
+  struct View {
+    bool active{false};
+    glm::vec3 position{0.0f};
+    float radius{0.0f};
+    // Bit per object row, and the network ids behind the set bits.
+    TwoLevelBitset visibleRows;
+    std::vector<uint32_t> visibleIds;
+  };
+
+  static uint64_t GetCellKey(int32_t x, int32_t y, int32_t z);
+  glm::ivec3 GetCellCoord(const glm::vec3& position) const;
+
+  // Returns kInvalidRow for unknown or stale ids.
+  uint32_t FindRow(uint32_t inNetworkId) const;
+  uint32_t FindOrAddCell(const glm::vec3& position);
+  void LinkToCell(uint32_t row, uint32_t cell, const glm::vec3& position);
+  void UnlinkFromCell(uint32_t row);
+
+  template <typename OnEnter, typename OnLeave>
+  void UpdateView(uint32_t connectionId, View& view, OnEnter& onEnter,
+                  OnLeave& onLeave);
+
+  InterestManagerSettings mSettings;
+  float mInverseCellSize;
+
+  std::vector<ObjectEntry> mObjects;
+  std::vector<Cell> mCells;
+  FlatHashMap<uint64_t, uint32_t> mCellsByKey;
+
+  std::vector<View> mViews;
+
+  // Rows gathered for the view being updated; cleared after each view.
+  TwoLevelBitset mGathered;
+  std::vector<uint32_t> mNextVisibleIds;
+};
+
+template <typename OnEnter, typename OnLeave>
+void InterestManager::Update(OnEnter&& onEnter, OnLeave&& onLeave) {
+  for (uint32_t connectionId = 0; connectionId < mViews.size();
+       ++connectionId) {
+    if (mViews[connectionId].active) {
+      UpdateView(connectionId, mViews[connectionId], onEnter, onLeave);
+    }
+  }
+}
+
+template <typename OnEnter, typename OnLeave>
+void InterestManager::UpdateView(uint32_t connectionId, View& view,
+                                 OnEnter& onEnter, OnLeave& onLeave) {
+  if (view.visibleRows.Size() < mObjects.size()) {
+    view.visibleRows.Resize(mObjects.size());
+  }
+
+  const float enterRadiusSquared = view.radius * view.radius;
+  const float leaveRadius = view.radius + mSettings.leaveMargin;
+  const float leaveRadiusSquared = leaveRadius * leaveRadius;
+  const glm::ivec3 minCell =
+      GetCellCoord(view.position - glm::vec3(leaveRadius));
+  const glm::ivec3 maxCell =
+      GetCellCoord(view.position + glm::vec3(leaveRadius));
+
+  mNextVisibleIds.clear();
+  for (int32_t z = minCell.z; z <= maxCell.z; ++z) {
+    for (int32_t y = minCell.y; y <= maxCell.y; ++y) {
+      for (int32_t x = minCell.x; x <= maxCell.x; ++x) {
+        const uint32_t* cell = mCellsByKey.Find(GetCellKey(x, y, z));
+        if (!cell) {
+          continue;
+        }
+        for (const CellEntry& entry : mCells[*cell].entries) {
+          const glm::vec3 offset = entry.position - view.position;
+          const float distanceSquared = glm::dot(offset, offset);
+          if (distanceSquared > leaveRadiusSquared) {
+            continue;
+          }
+          const bool wasVisible = view.visibleRows.Test(entry.row);
+          if (!wasVisible && distanceSquared > enterRadiusSquared) {
+            continue;
+          }
+
+          const uint32_t networkId = mObjects[entry.row].networkId;
+          mGathered.Set(entry.row);
+          mNextVisibleIds.push_back(networkId);
+          if (!wasVisible) {
+            view.visibleRows.Set(entry.row);
+            onEnter(connectionId, networkId);
+          }
+        }
+      }
+    }
+  }
+
+  for (const uint32_t networkId : view.visibleIds) {
+    const uint32_t row = LinkingContext::GetIndex(networkId);
+    // Rows cleared by RemoveObject() have already left.
+    if (!mGathered.Test(row) && view.visibleRows.Test(row)) {
+      view.visibleRows.Reset(row);
+      onLeave(connectionId, networkId);
+    }
+  }
+
+  for (const uint32_t networkId : mNextVisibleIds) {
+    mGathered.Reset(LinkingContext::GetIndex(networkId));
+  }
+  view.visibleIds.swap(mNextVisibleIds);
+}
+
+}  // namespace GameNet
@@ -1,51 +1,94 @@
 #pragma once
 
 #include <cinttypes>
-#include <unordered_map>
+#include <vector>
+
+#include "core/container/flat_hash_map.h"
 
 class GameObject;
 
+namespace GameNet {
+
+/**
+ * @brief Maps network ids to game objects and back.
+ *
+ * A network id packs a slot index (low kIndexBits) and the slot's generation
+ * (the remaining high bits). Objects live in a dense slot array; a removed
+ * object's slot goes on a freelist and its generation is bumped, so a stale
+ * id held by a late packet resolves to nullptr instead of whatever object
+ * reuses the slot. Id -> object is an array index and a generation compare;
+ * object -> id goes through a flat hash map. Neither allocates once the
+ * context has grown to its peak object count.
+ *
+ * Id 0 is never handed out and means "no object".
+ *
+ * A context either assigns ids (GetNetworkId() with create, on the server)
+ * or mirrors ids it is given (AddGameObject(), on the client); it may do
+ * both, but then a slot mirrored from a remote id is skipped when it comes
+ * off the freelist.
+ */
 class LinkingContext {
  public:
-  LinkingContext() : mNextNetworkId(1) {}
-
-  uint32_t GetNetworkId(GameObject* inGameObject,
-                        bool inShouldCreateIfNotFound) {
-    auto it = mGameObjectToNetworkIdMap.find(inGameObject);
-    if (it != mGameObjectToNetworkIdMap.end()) {
-      return it->second;
-    } else if (inShouldCreateIfNotFound) {
-      uint32_t newNetworkId = mNextNetworkId++;
-      AddGameObject(inGameObject, newNetworkId);
-      return newNetworkId;
-    } else {
-      return 0;
-    }
+  static constexpr uint32_t kInvalidNetworkId = 0;
+  static constexpr uint32_t kIndexBits = 20;
+  static constexpr uint32_t kMaxObjects = 1u << kIndexBits;
+
+  static uint32_t GetIndex(uint32_t inNetworkId) {
+    return inNetworkId & (kMaxObjects - 1);
   }
+  static uint32_t GetGeneration(uint32_t inNetworkId) {
+    return inNetworkId >> kIndexBits;
+  }
+
+  LinkingContext() = default;
+  explicit LinkingContext(uint32_t inExpectedObjectCount);
+
+  /**
+   * @brief The object's network id; if it has none and
+   * inShouldCreateIfNotFound, assigns one. Returns kInvalidNetworkId when
+   * the object is unknown, or when all kMaxObjects slots are taken.
+   */
+  uint32_t GetNetworkId(const GameObject* inGameObject,
+                        bool inShouldCreateIfNotFound);
 
   GameObject* GetGameObject(uint32_t inNetworkId) const {
-    auto it = mNetworkIdToGameObjectMap.find(inNetworkId);
-    if (it != mNetworkIdToGameObjectMap.end()) {
-      return it->second;
-    } else {
+    const uint32_t index = GetIndex(inNetworkId);
+    if (index >= mSlots.size()) {
       return nullptr;
     }
+    const Slot& slot = mSlots[index];
+    return slot.generation == GetGeneration(inNetworkId) ? slot.gameObject
+                                                         : nullptr;
   }
 
-  void AddGameObject(GameObject* inGameObject, uint32_t inNetworkId) {
-    mNetworkIdToGameObjectMap[inNetworkId] = inGameObject;
-    mGameObjectToNetworkIdMap[inGameObject] = inNetworkId;
-  }
+  // Links inGameObject to an id assigned elsewhere, replacing whatever the
+  // id's slot held.
+  void AddGameObject(GameObject* inGameObject, uint32_t inNetworkId);
+
+  // Does nothing for objects without a network id.
+  void RemoveGameObject(const GameObject* inGameObject);
 
-  void RemoveGameObject(GameObject* inGameObject) {
-    uint32_t networkId = mGameObjectToNetworkIdMap[inGameObject];
-    mGameObjectToNetworkIdMap.erase(inGameObject);
-    mNetworkIdToGameObjectMap.erase(networkId);
+  uint32_t GetObjectCount() const {
+    return static_cast<uint32_t>(mNetworkIds.Size());
   }
 
  private:
-  std::unordered_map<uint32_t, GameObject*> mNetworkIdToGameObjectMap;
-  std::unordered_map<const GameObject*, uint32_t> mGameObjectToNetworkIdMap;
+  struct Slot {
+    GameObject* gameObject{nullptr};
+    // Generation of the id that currently owns the slot. Never 0 once the
+    // slot has been used, so id 0 never matches.
+    uint32_t generation{0};
+  };
+
+  static uint32_t MakeNetworkId(uint32_t inIndex, uint32_t inGeneration) {
+    return (inGeneration << kIndexBits) | inIndex;
+  }
+
+  void Unlink(uint32_t inIndex);
 
-  uint32_t mNextNetworkId;
+  std::vector<Slot> mSlots;
+  std::vector<uint32_t> mFreeIndices;
+  FlatHashMap<const GameObject*, uint32_t> mNetworkIds;
 };
+
+}  // namespace GameNet
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <cinttypes>
+#include <limits>
+#include <type_traits>
+
+#include "core/memory-stream/memory_bit_stream.h"
+#include "replication_command.h"
+
+/**
+ * Annotations read by tools/auto-gen; see gamenet_auto_gen() in
+ * cmake/AutoGen.cmake. Inside the class body:
+ *
+ *   struct TransformComponent {
+ *     GAMENET_REPLICATED_CLASS();
+ *
+ *     GAMENET_REPLICATED(bits = 18, min = -4096, max = 4096)
+ *     float x;
+ *     GAMENET_REPLICATED(bits = 7)
+ *     uint8_t health;
+ *     GAMENET_REPLICATED()
+ *     bool grounded;
+ *   };
+ *
+ * With min and max the value is quantized to bits, at most 32, over that
+ * range; integers are sent as the offset from min, so max - min must fit.
+ * bits alone sends the low bits of an unsigned integer or enum, and no
+ * arguments send the value whole, or through its own BitStreamWriter/Reader.
+ * Property i is dirty bit i. The generated code static_asserts what only
+ * the member's type can tell, e.g. bits without min and max on a float.
+ */
+#define GAMENET_REPLICATED_CLASS()                                  \
+  template <typename>                                               \
+  friend struct ::GameNet::ReplicatedProperties;                    \
+  template <typename>                                               \
+  friend struct ::GameNet::BitStreamWriter;                         \
+  template <typename>                                               \
+  friend struct ::GameNet::BitStreamReader
+
+#define GAMENET_REPLICATED(...)
+
+namespace GameNet {
+
+struct ReplicatedProperty {
+  const char* name;
+  uint32_t offset;
+  // 0 for types with their own serializer.
+  uint32_t bitCount;
+  // Not quantized if equal.
+  double minValue;
+  double maxValue;
+  uint32_t dirtyBit;
+};
+
+/**
+ * @brief Specialized by auto-gen for every annotated class T with
+ * kProperties, a constexpr array of ReplicatedProperty, and
+ * kAllDirtyState. The generated BitStreamWriter<T> and BitStreamReader<T>
+ * also take a ReplicationDirtyState to send only the dirty properties.
+ */
+template <typename T>
+struct ReplicatedProperties;
+
+namespace detail {
+
+template <typename T>
+constexpr uint32_t GetDefaultPropertyBitCount() {
+  if constexpr (std::is_same_v<T, bool>) {
+    return 1;
+  } else if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+    return sizeof(T) << 3;
+  } else {
+    return 0;
+  }
+}
+
+template <typename T>
+constexpr bool IsIntegerProperty() {
+  return (std::is_integral_v<T> && !std::is_same_v<T, bool>) ||
+         std::is_enum_v<T>;
+}
+
+// bits alone: the low bits of an integer or enum at least that wide.
+template <typename T>
+constexpr bool CanSendLowBits(uint32_t bitCount) {
+  return IsIntegerProperty<T>() && bitCount <= sizeof(T) << 3;
+}
+
+// min and max: a float quantized to a uint32_t, or an integer whose values
+// in [min, max] and their offsets from min all fit.
+template <typename T>
+constexpr bool CanQuantize(uint32_t bitCount, double minValue,
+                           double maxValue) {
+  if constexpr (std::is_floating_point_v<T>) {
+    return bitCount <= 32;
+  } else if constexpr (IsIntegerProperty<T>()) {
+    using Integer = std::conditional_t<std::is_enum_v<T>,
+                                       std::underlying_type<T>,
+                                       std::type_identity<T>>::type;
+    return bitCount <= sizeof(T) << 3 && bitCount <= 32 &&
+           minValue >= static_cast<double>(
+                           std::numeric_limits<Integer>::lowest()) &&
+           maxValue <= static_cast<double>(
+                           std::numeric_limits<Integer>::max()) &&
+           maxValue - minValue <=
+               static_cast<double>((uint64_t{1} << bitCount) - 1);
+  } else {
+    return false;
+  }
+}
+
+// In T's precision: for float, double arithmetic only costs time.
+template <typename T>
+inline uint32_t QuantizeFloat(T value, double minValue, double maxValue,
+                              uint32_t bitCount) {
+  const T steps = static_cast<T>((uint64_t{1} << bitCount) - 1);
+  const T clamped = std::clamp(value, static_cast<T>(minValue),
+                               static_cast<T>(maxValue));
+  return static_cast<uint32_t>(
+      (clamped - static_cast<T>(minValue)) *
+          (steps / static_cast<T>(maxValue - minValue)) +
+      T(0.5));
+}
+
+template <typename T>
+inline T DequantizeFloat(uint32_t quantized, double minValue, double maxValue,
+                         uint32_t bitCount) {
+  const T steps = static_cast<T>((uint64_t{1} << bitCount) - 1);
+  return static_cast<T>(minValue) +
+         static_cast<T>(quantized) *
+             (static_cast<T>(maxValue - minValue) / steps);
+}
+
+// Generated serializers call these with literal arguments, so once inlined
+// only the branch for T and the annotation remains.
+template <typename T>
+inline void WriteProperty(OutputMemoryBitStream& outStream, const T& value,
+                          uint32_t bitCount, double minValue,
+                          double maxValue) {
+  if constexpr (std::is_same_v<T, bool>) {
+    outStream.Write(value);
+  } else if constexpr (std::is_floating_point_v<T>) {
+    if (minValue < maxValue) {
+      outStream.Write(QuantizeFloat(value, minValue, maxValue, bitCount),
+                      bitCount);
+    } else {
+      outStream.Write(value);
+    }
+  } else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+    if (minValue < maxValue) {
+      const int64_t clamped = std::clamp(
+          static_cast<int64_t>(value), static_cast<int64_t>(minValue),
+          static_cast<int64_t>(maxValue));
+      outStream.Write(
+          static_cast<uint64_t>(clamped - static_cast<int64_t>(minValue)),
+          bitCount);
+    } else {
+      outStream.Write(value, bitCount ? bitCount : sizeof(T) << 3);
+    }
+  } else {
+    outStream.Write(value);
+  }
+}
+
+template <typename T>
+inline void ReadProperty(InputMemoryBitStream& inStream, T& outValue,
+                         uint32_t bitCount, double minValue, double maxValue) {
+  if constexpr (std::is_same_v<T, bool>) {
+    inStream.Read(outValue);
+  } else if constexpr (std::is_floating_point_v<T>) {
+    if (minValue < maxValue) {
+      uint32_t quantized = 0;
+      inStream.Read(quantized, bitCount);
+      outValue = DequantizeFloat<T>(quantized, minValue, maxValue, bitCount);
+    } else {
+      inStream.Read(outValue);
+    }
+  } else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+    if (minValue < maxValue) {
+      uint64_t offset = 0;
+      inStream.Read(offset, bitCount);
+      outValue = static_cast<T>(static_cast<int64_t>(offset) +
+                                static_cast<int64_t>(minValue));
+    } else {
+      // Bits beyond bitCount stay zero.
+      T value{};
+      inStream.Read(value, bitCount ? bitCount : sizeof(T) << 3);
+      outValue = value;
+    }
+  } else {
+    inStream.Read(outValue);
+  }
+}
+
+}  // namespace detail
+
+}  // namespace GameNet
@@ -2,19 +2,32 @@
 
 #include <cinttypes>
 
+#include "core/container/hierarchical_dirty_mask.h"
 #include "core/memory-stream/memory_bit_stream.h"
 
+// Set through the GAMENET_REPLICATION_DIRTY_STATE_BITS CMake cache variable
+// so that every target agrees on it.
+#ifndef GAMENET_REPLICATION_DIRTY_STATE_BITS
+#define GAMENET_REPLICATION_DIRTY_STATE_BITS 32
+#endif
+
 namespace GameNet {
 
 enum ReplicationAction { RA_Create, RA_Update, RA_Destroy, RA_RPC, RA_MAX };
 
+// One bit per replicated property of an object. Wider masks let big objects
+// track properties individually; adding and clearing state only touches the
+// words that have bits set.
+using ReplicationDirtyState =
+    HierarchicalDirtyMask<GAMENET_REPLICATION_DIRTY_STATE_BITS>;
+
 class ReplicationManagerTransmissionData;
 
 struct ReplicationCommand {
  public:
   ReplicationCommand() {}
-  ReplicationCommand(uint32_t inInitialDirtyState)
-      : mAction(RA_Create), mDirtyState(inInitialDirtyState) {}
+  ReplicationCommand(ReplicationDirtyState inInitialDirtyState)
+      : mDirtyState(inInitialDirtyState), mAction(RA_Create) {}
 
   // if the create is ack'd, we can demote to just an update...
   void HandleCreateAckd() {
@@ -22,16 +35,18 @@ struct ReplicationCommand {
       mAction = RA_Update;
     }
   }
-  void AddDirtyState(uint32_t inState) { mDirtyState |= inState; }
+  void AddDirtyState(const ReplicationDirtyState& inState) {
+    mDirtyState |= inState;
+  }
   void SetDestroy() { mAction = RA_Destroy; }
 
   bool HasDirtyState() const {
-    return (mAction == RA_Destroy) || (mDirtyState != 0);
+    return (mAction == RA_Destroy) || mDirtyState.Any();
   }
 
   ReplicationAction GetAction() const { return mAction; }
-  uint32_t GetDirtyState() const { return mDirtyState; }
-  inline void ClearDirtyState(uint32_t inStateToClear);
+  const ReplicationDirtyState& GetDirtyState() const { return mDirtyState; }
+  inline void ClearDirtyState(const ReplicationDirtyState& inStateToClear);
 
   // write is not const because we actually clear the dirty state after writing
   // it....
@@ -40,12 +55,14 @@ struct ReplicationCommand {
   void Read(InputMemoryBitStream& inStream, int inNetworkId);
 
  private:
-  uint32_t mDirtyState;
-  ReplicationAction mAction;
+  ReplicationDirtyState mDirtyState;
+  // RA_MAX while the command holds nothing, e.g. default-constructed.
+  ReplicationAction mAction{RA_MAX};
 };
 
-inline void ReplicationCommand::ClearDirtyState(uint32_t inStateToClear) {
-  mDirtyState &= ~inStateToClear;
+inline void ReplicationCommand::ClearDirtyState(
+    const ReplicationDirtyState& inStateToClear) {
+  mDirtyState.Remove(inStateToClear);
 
   if (mAction == RA_Destroy) {
     mAction = RA_Update;
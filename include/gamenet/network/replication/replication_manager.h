@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+
+#include "core/container/two_level_bitset.h"
+#include "linking_context.h"
+#include "replication_command.h"
+
+namespace GameNet {
+
+struct ReplicationManagerSettings {
+  // Connection ids are in [0, maxConnections), e.g. ServerConnectionManager
+  // slot ids.
+  uint32_t maxConnections = 64;
+  uint32_t expectedObjectCount = 1024;
+  // When false, an object is only sent to the connections it is
+  // StartReplicating()ed for, e.g. by an InterestManager.
+  bool replicateToAllConnections = true;
+};
+
+/**
+ * @brief Server-side replication state of every object for every connection.
+ *
+ * Objects are rows indexed by their LinkingContext slot. Each connection
+ * owns a column: its ReplicationCommands in one array indexed by row, next
+ * to a TwoLevelBitset with a bit per row whose command has something to
+ * send. ForEachDirty() walks only the set bits of one column, so finding
+ * what a connection needs costs O(changed objects), not O(objects), and
+ * builds for different connections never write the same cache lines.
+ *
+ * A change to an object is fanned out in one pass over the live
+ * connections, each an index into its column with no lookups; that is
+ * O(connections) per change, and O(changed x connections) for the tick.
+ *
+ * A slot reused by the LinkingContext under a new generation simply gets a
+ * fresh create; the client replaces whatever it held under that slot.
+ *
+ * Calls that take a connection id touch only that connection's column and
+ * bitsets, so ForEachDirty() and the other per-connection calls may run
+ * concurrently for different connections. Object-wide calls may not.
+ */
+class ReplicationManager {
+ public:
+  explicit ReplicationManager(const ReplicationManagerSettings& settings =
+                                  ReplicationManagerSettings());
+
+  ReplicationManager(const ReplicationManager&) = delete;
+  ReplicationManager& operator=(const ReplicationManager&) = delete;
+
+  // A new connection is sent a create for every live object, unless
+  // replicateToAllConnections is off.
+  void AddConnection(uint32_t connectionId);
+  void RemoveConnection(uint32_t connectionId);
+
+  // inInitialDirtyState is also what late-joining connections are sent.
+  void ReplicateCreate(uint32_t inNetworkId,
+                       const ReplicationDirtyState& inInitialDirtyState);
+  void ReplicateDestroy(uint32_t inNetworkId);
+
+  // Fans the change out to every connection the object is replicated to.
+  void AddDirtyState(uint32_t inNetworkId,
+                     const ReplicationDirtyState& inState);
+
+  // Sends one connection a create (with the initial dirty state) or a
+  // destroy for a live object, e.g. as it enters or leaves its view.
+  void StartReplicating(uint32_t connectionId, uint32_t inNetworkId);
+  void StopReplicating(uint32_t connectionId, uint32_t inNetworkId);
+
+  /**
+   * @brief Marks state as dirty for one connection again, e.g. after the
+   * packet carrying it was lost. For a destroyed object this resends the
+   * destroy.
+   */
+  void AddDirtyState(uint32_t connectionId, uint32_t inNetworkId,
+                     const ReplicationDirtyState& inState);
+
+  void HandleCreateAckd(uint32_t connectionId, uint32_t inNetworkId);
+  // The object is gone on the client; its command is dropped. Only call for
+  // a destroy that was sent.
+  void HandleDestroyAckd(uint32_t connectionId, uint32_t inNetworkId);
+
+  /**
+   * @brief Calls visitor(networkId, ReplicationCommand&) for every object
+   * with something to send to the connection. The visitor writes what it
+   * can and ClearDirtyState()s it; objects left with nothing to send drop
+   * out of the dirty set. Commands cleared outside the visitor, e.g. by the
+   * ReplicationScheduler, drop out on the next pass without a visit.
+   */
+  template <typename Visitor>
+  void ForEachDirty(uint32_t connectionId, Visitor&& visitor);
+
+  bool HasDirty(uint32_t connectionId) const {
+    return mConnections[connectionId].dirtyObjects.Any();
+  }
+
+  uint32_t GetMaxConnections() const { return mSettings.maxConnections; }
+  // One past the highest LinkingContext slot seen so far.
+  uint32_t GetRowCount() const {
+    return static_cast<uint32_t>(mObjects.size());
+  }
+
+ private:
+  struct ObjectEntry {
+    uint32_t networkId{LinkingContext::kInvalidNetworkId};
+    ReplicationDirtyState initialDirtyState;
+    bool alive{false};
+  };
+
+  struct ConnectionState {
+    bool active{false};
+    // Indexed by row; empty while inactive.
+    std::vector<ReplicationCommand> commands;
+    TwoLevelBitset dirtyObjects;
+    // Objects the connection should have, i.e. created and not since
+    // stopped or destroyed; only these receive fanned-out dirty state.
+    TwoLevelBitset replicatedObjects;
+  };
+
+  static constexpr uint32_t kInvalidRow = ~0u;
+
+  // Returns kInvalidRow if the id is stale or unknown.
+  uint32_t FindRow(uint32_t inNetworkId) const;
+  uint32_t EnsureRow(uint32_t inNetworkId);
+
+  ReplicationCommand& GetCommand(uint32_t row, uint32_t connectionId) {
+    return mConnections[connectionId].commands[row];
+  }
+
+  ReplicationManagerSettings mSettings;
+
+  std::vector<ObjectEntry> mObjects;
+
+  std::vector<ConnectionState> mConnections;
+  std::vector<uint32_t> mConnectionIds;
+};
+
+template <typename Visitor>
+void ReplicationManager::ForEachDirty(uint32_t connectionId,
+                                      Visitor&& visitor) {
+  ConnectionState& connection = mConnections[connectionId];
+  TwoLevelBitset& dirtyObjects = connection.dirtyObjects;
+  dirtyObjects.ForEachSet([&](size_t row) {
+    ReplicationCommand& command = connection.commands[row];
+    if (command.HasDirtyState()) {
+      visitor(mObjects[row].networkId, command);
+    }
+    if (!command.HasDirtyState()) {
+      dirtyObjects.Reset(row);
+    }
+  });
+}
+
+}  // namespace GameNet
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <vector>
+
+#include "core/container/flat_hash_map.h"
+#include "core/memory-stream/memory_bit_stream.h"
+#include "replication_command.h"
+
+namespace GameNet {
+
+/**
+ * @brief Serializes an object's dirty state once per tick for all clients.
+ *
+ * Clients that need the same dirty state of the same object, relative to
+ * the same baseline, get the same bits. Add() runs the serializer for such
+ * a key once, into a per-tick arena; Write() splices the cached bits into
+ * each client's stream with WriteBitsFrom(), a word-wide shifted copy.
+ * Serialization cost thus scales with distinct (object, dirty state,
+ * baseline) keys instead of with clients.
+ *
+ * A different dirty mask or baseline is a different key. Write() returns
+ * false for a key nobody added, e.g. for a client still owed state from a
+ * lost packet, and the caller serializes that one itself.
+ *
+ * BeginTick() and Add() modify the cache, so they run on one thread with
+ * no build in flight. ServerManager calls BeginTick() right before its
+ * PacketBuildPrepare, which is where the game adds what the tick made
+ * dirty. Write() only reads, so PacketBuilders on every worker may call it
+ * at once. Don't change replicated state until the packets are built.
+ */
+class ReplicationPayloadCache {
+ public:
+  // Baseline of a full, non-delta payload.
+  static constexpr uint32_t kNoBaseline = 0;
+
+  explicit ReplicationPayloadCache(uint32_t expectedEntryCount = 1024);
+
+  ReplicationPayloadCache(const ReplicationPayloadCache&) = delete;
+  ReplicationPayloadCache& operator=(const ReplicationPayloadCache&) = delete;
+
+  // Drops every cached payload, keeping the memory.
+  void BeginTick();
+
+  /**
+   * @brief Unless the key is cached already, runs
+   * serialize(OutputMemoryBitStream&) to cache its payload. The payload
+   * must depend only on the key.
+   */
+  template <typename Serialize>
+  void Add(uint32_t inNetworkId, const ReplicationDirtyState& inDirtyState,
+           uint32_t inBaseline, Serialize&& serialize);
+
+  // Appends the cached payload for the key to outStream; false on a miss,
+  // with outStream untouched.
+  bool Write(OutputMemoryBitStream& outStream, uint32_t inNetworkId,
+             const ReplicationDirtyState& inDirtyState,
+             uint32_t inBaseline) const;
+
+  uint32_t GetEntryCount() const {
+    return static_cast<uint32_t>(mEntries.Size());
+  }
+
+ private:
+  struct Key {
+    uint32_t networkId;
+    ReplicationDirtyState dirtyState;
+    uint32_t baseline;
+
+    bool operator==(const Key& other) const = default;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    // Byte-aligned start in mArena.
+    uint32_t byteOffset;
+    uint32_t bitCount;
+  };
+
+  FlatHashMap<Key, Entry, KeyHash> mEntries;
+  OutputMemoryBitStream mArena;
+};
+
+template <typename Serialize>
+void ReplicationPayloadCache::Add(uint32_t inNetworkId,
+                                  const ReplicationDirtyState& inDirtyState,
+                                  uint32_t inBaseline, Serialize&& serialize) {
+  const Key key{inNetworkId, inDirtyState, inBaseline};
+  if (mEntries.Find(key)) {
+    return;
+  }
+
+  // Blobs start on a byte so WriteBitsFrom() can take a plain pointer.
+  mArena.AlignToByte();
+  const uint32_t startBit = mArena.GetBitLength();
+  serialize(mArena);
+  mEntries.Insert(key,
+                  Entry{startBit >> 3, mArena.GetBitLength() - startBit});
+}
+
+}  // namespace GameNet
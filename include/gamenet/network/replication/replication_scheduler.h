@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <vector>
+
+#include "core/timer/clock.h"
+#include "replication_manager.h"
+
+namespace GameNet {
+
+struct ReplicationSchedulerSettings {
+  // Payload bits per packet: a 1200-byte datagram less transport headers.
+  uint32_t packetBudgetBits = 1100 * 8;
+  // Sustained replication rate per connection.
+  uint32_t bandwidthBitsPerSecond = 512 * 1000;
+  // Unused bandwidth saved up while idle, at most this much.
+  uint32_t burstBits = 1100 * 8;
+};
+
+/**
+ * @brief Decides which dirty objects go into a connection's next packet.
+ *
+ * Every (object, connection) pair has a priority accumulator. Each Schedule()
+ * adds the object's weight for that connection, e.g. relevance over
+ * distance, to the accumulators of all its dirty objects, and sends the
+ * highest ones first until the budget is used up. A sent object's
+ * accumulator restarts at zero while the others keep growing, so anything
+ * with a positive weight is eventually sent, just less often.
+ *
+ * The budget is the smaller of one packet and what the connection's token
+ * bucket holds, refilled at bandwidthBitsPerSecond and capped at burstBits,
+ * so a connection that has been quiet can't dump a backlog at once.
+ *
+ * Smaller objects may skip a bigger one to fill up the packet, but not the
+ * most urgent one: if that doesn't fit, nothing is sent and the bucket
+ * fills up for it. An object estimated larger than the biggest possible
+ * budget is scheduled as if it took exactly that, so it goes out alone once
+ * the bucket is full and write() sends what fits. Either way, no object
+ * waits forever.
+ *
+ * Only as many candidates as can possibly fit (budget / smallest size) are
+ * ordered. A histogram of the priorities finds a threshold that keeps a
+ * little more than that many, nth_element trims those to size and only the
+ * survivors are sorted, so the pass is O(dirty objects) plus a small sort.
+ *
+ * Schedule() for different connections may run concurrently, e.g. one job
+ * per connection, as long as nothing else modifies the ReplicationManager.
+ */
+class ReplicationScheduler {
+ public:
+  ReplicationScheduler(
+      uint32_t maxConnections, ClockTimePoint startTime,
+      const ReplicationSchedulerSettings& settings =
+          ReplicationSchedulerSettings());
+
+  // Call when a connection id is (re)assigned.
+  void ResetConnection(uint32_t connectionId, ClockTimePoint currTime);
+
+  /**
+   * @brief Schedules the connection's next packet.
+   *
+   * weight(networkId, const ReplicationCommand&) returns the priority gained
+   * per tick, estimateBits(networkId, const ReplicationCommand&) the size
+   * the object will take in the packet. write(networkId, ReplicationCommand&)
+   * is then called for the chosen objects in priority order and is expected
+   * to write and ClearDirtyState() them.
+   *
+   * @return the estimated bits scheduled.
+   */
+  template <typename Weight, typename EstimateBits, typename Write>
+  uint32_t Schedule(ReplicationManager& replicationManager,
+                    uint32_t connectionId, ClockTimePoint currTime,
+                    Weight&& weight, EstimateBits&& estimateBits,
+                    Write&& write);
+
+  // What the connection's token bucket holds, in bits.
+  uint32_t GetAvailableBits(uint32_t connectionId) const {
+    return static_cast<uint32_t>(mConnections[connectionId].availableBits);
+  }
+
+ private:
+  static constexpr size_t kPriorityBuckets = 256;
+
+  struct Candidate {
+    float priority;
+    uint32_t sizeBits;
+    uint32_t networkId;
+    ReplicationCommand* command;
+  };
+
+  struct ConnectionState {
+    // Indexed by LinkingContext slot.
+    std::vector<float> priorities;
+    // Reused every call; per connection so calls for different ones don't
+    // share anything.
+    std::vector<Candidate> candidates;
+    double availableBits{0};
+    ClockTimePoint lastRefillTime{};
+  };
+
+  // Refills the token bucket and returns this packet's budget.
+  uint32_t Refill(ConnectionState& connection, ClockTimePoint currTime);
+
+  ReplicationSchedulerSettings mSettings;
+  std::vector<ConnectionState> mConnections;
+};
+
+template <typename Weight, typename EstimateBits, typename Write>
+uint32_t ReplicationScheduler::Schedule(ReplicationManager& replicationManager,
+                                        uint32_t connectionId,
+                                        ClockTimePoint currTime,
+                                        Weight&& weight,
+                                        EstimateBits&& estimateBits,
+                                        Write&& write) {
+  ConnectionState& connection = mConnections[connectionId];
+  const uint32_t budgetBits = Refill(connection, currTime);
+  const uint32_t maxBudgetBits = std::max<uint32_t>(
+      std::min(mSettings.packetBudgetBits, mSettings.burstBits), 1);
+  std::vector<Candidate>& candidates = connection.candidates;
+
+  if (connection.priorities.size() < replicationManager.GetRowCount()) {
+    connection.priorities.resize(replicationManager.GetRowCount(), 0.0f);
+  }
+
+  // Priorities grow whether or not anything can be sent this tick.
+  candidates.clear();
+  uint32_t minSizeBits = ~0u;
+  float maxPriority = 0.0f;
+  replicationManager.ForEachDirty(
+      connectionId, [&](uint32_t networkId, ReplicationCommand& command) {
+        float& priority =
+            connection.priorities[LinkingContext::GetIndex(networkId)];
+        priority += weight(networkId, static_cast<const ReplicationCommand&>(
+                                          command));
+
+        const uint32_t sizeBits = std::clamp<uint32_t>(
+            estimateBits(networkId,
+                         static_cast<const ReplicationCommand&>(command)),
+            1, maxBudgetBits);
+        minSizeBits = std::min(minSizeBits, sizeBits);
+        maxPriority = std::max(maxPriority, priority);
+        candidates.push_back({priority, sizeBits, networkId, &command});
+      });
+
+  if (candidates.empty() || budgetBits < minSizeBits) {
+    return 0;
+  }
+
+  const auto byPriority = [](const Candidate& lhs, const Candidate& rhs) {
+    return lhs.priority > rhs.priority;
+  };
+  const size_t fitCount =
+      std::min<size_t>(candidates.size(), budgetBits / minSizeBits);
+  if (fitCount < candidates.size()) {
+    auto selectedEnd = candidates.end();
+    if (maxPriority > 0.0f) {
+      // Narrow down to the top buckets first; nth_element over all of them
+      // costs about twice as much.
+      const float scale = (kPriorityBuckets - 1) / maxPriority;
+      const auto bucketOf = [scale](const Candidate& candidate) {
+        return static_cast<size_t>(std::max(candidate.priority, 0.0f) * scale);
+      };
+      std::array<uint32_t, kPriorityBuckets> histogram{};
+      for (const Candidate& candidate : candidates) {
+        ++histogram[bucketOf(candidate)];
+      }
+      size_t bucket = kPriorityBuckets - 1;
+      for (size_t count = histogram[bucket]; count < fitCount && bucket > 0;
+           count += histogram[--bucket]) {
+      }
+      selectedEnd = std::partition(candidates.begin(), candidates.end(),
+                                   [&](const Candidate& candidate) {
+                                     return bucketOf(candidate) >= bucket;
+                                   });
+    }
+    std::nth_element(candidates.begin(), candidates.begin() + fitCount,
+                     selectedEnd, byPriority);
+  }
+  std::sort(candidates.begin(), candidates.begin() + fitCount, byPriority);
+
+  uint32_t usedBits = 0;
+  for (size_t i = 0; i < fitCount && budgetBits - usedBits >= minSizeBits;
+       ++i) {
+    const Candidate& candidate = candidates[i];
+    if (candidate.sizeBits > budgetBits - usedBits) {
+      // The most urgent object waits for the bucket to fill up rather than
+      // leave its bandwidth to smaller ones; after it, something smaller
+      // further down may still fit.
+      if (i == 0) {
+        break;
+      }
+      continue;
+    }
+    usedBits += candidate.sizeBits;
+    connection.priorities[LinkingContext::GetIndex(candidate.networkId)] = 0;
+    write(candidate.networkId, *candidate.command);
+  }
+
+  connection.availableBits -= usedBits;
+  return usedBits;
+}
+
+}  // namespace GameNet
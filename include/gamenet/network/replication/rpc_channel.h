@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cinttypes>
+#include <concepts>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "core/memory-stream/memory_bit_stream.h"
+
+namespace GameNet {
+
+// An RPC id on the wire; ids are in [0, 1 << kRpcIdBits).
+constexpr uint32_t kRpcIdBits = 10;
+// The RPC count that starts a batch.
+constexpr uint32_t kRpcCountBits = 16;
+
+/**
+ * An RPC is a type whose members are its arguments, with a stable id:
+ *
+ *   struct FireWeaponRpc {
+ *     static constexpr uint16_t kRpcId = 3;
+ *     GAMENET_REPLICATED_CLASS();
+ *
+ *     GAMENET_REPLICATED(bits = 4)
+ *     uint8_t weapon;
+ *   };
+ *
+ * Arguments go through Write()/Read(), so annotated ones get auto-gen's
+ * serializers. The id is what goes on the wire: don't renumber or reuse
+ * one that has shipped.
+ */
+template <typename Rpc>
+concept RpcType = requires {
+  { Rpc::kRpcId } -> std::convertible_to<uint16_t>;
+} && (Rpc::kRpcId < (1u << kRpcIdBits));
+
+struct RpcChannelSettings {
+  // Connection ids are in [0, maxConnections).
+  uint32_t maxConnections = 64;
+  // The most room WriteBatch() is given. An RPC that can't fit a batch of
+  // its own this size is rejected when sent rather than left to block its
+  // queue.
+  uint32_t maxBatchBits = ~0u;
+  // Size of one arena region; see RpcChannel.
+  uint32_t arenaRegionBytes = 4096;
+};
+
+/**
+ * @brief Queues outgoing RPCs per connection and writes each connection's
+ * as one batch per packet.
+ *
+ * An RPC is serialized once, into a shared arena, when it is sent; a
+ * connection's queue only references it. Multicast() thus costs one
+ * serialization however many recipients there are, and WriteBatch()
+ * splices the stored bits with WriteBitsFrom().
+ *
+ * The arena is a list of regions, each counting the queued records that
+ * point into it. Sending fills one region until it is arenaRegionBytes
+ * long, then moves to one whose records have all been written or dropped,
+ * rewinding it, or adds a region if none has. A connection that stops
+ * draining thus only pins the regions its own records are in.
+ *
+ * Where a batch goes in a packet is up to the caller; RpcDispatcher reads
+ * it back. WriteBatch() for different connections may run concurrently,
+ * but not alongside Send() or Multicast().
+ */
+class RpcChannel {
+ public:
+  explicit RpcChannel(
+      const RpcChannelSettings& settings = RpcChannelSettings());
+
+  RpcChannel(const RpcChannel&) = delete;
+  RpcChannel& operator=(const RpcChannel&) = delete;
+
+  // false, with nothing queued, if the RPC is too large for maxBatchBits.
+  template <RpcType Rpc>
+  bool Send(uint32_t connectionId, const Rpc& rpc) {
+    const Record record = Serialize(rpc);
+    if (!IsSendable(record)) {
+      return false;
+    }
+    Enqueue(connectionId, record);
+    return true;
+  }
+
+  template <RpcType Rpc>
+  bool Multicast(std::span<const uint32_t> connectionIds, const Rpc& rpc) {
+    if (connectionIds.empty()) {
+      return true;
+    }
+    const Record record = Serialize(rpc);
+    if (!IsSendable(record)) {
+      return false;
+    }
+    for (const uint32_t connectionId : connectionIds) {
+      Enqueue(connectionId, record);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Writes the connection's queued RPCs, oldest first, as a count
+   * followed by (id, arguments) records. Stops before the first RPC that
+   * would take the batch past maxBits; it stays queued. With maxBits at
+   * least the channel's maxBatchBits, at least one RPC is always written.
+   *
+   * @return the number of RPCs written. With 0, nothing was written.
+   */
+  uint32_t WriteBatch(uint32_t connectionId, OutputMemoryBitStream& outStream,
+                      uint32_t maxBits = ~0u);
+
+  bool HasPending(uint32_t connectionId) const {
+    return mQueues[connectionId].head < mQueues[connectionId].records.size();
+  }
+
+  // Drops what is queued for the connection, e.g. on disconnect.
+  void ClearConnection(uint32_t connectionId);
+
+ private:
+  struct Record {
+    uint32_t region;
+    // Byte-aligned start in the region.
+    uint32_t byteOffset;
+    uint32_t bitCount;
+  };
+
+  struct ConnectionQueue {
+    std::vector<Record> records;
+    size_t head{0};
+  };
+
+  struct ArenaRegion {
+    explicit ArenaRegion(uint32_t byteCapacity) : stream(byteCapacity << 3) {}
+
+    OutputMemoryBitStream stream;
+    // Queued records across all connections that point into stream.
+    std::atomic<size_t> recordCount{0};
+  };
+
+  template <typename Rpc>
+  Record Serialize(const Rpc& rpc);
+  // Picks the region the next RPC is serialized into.
+  OutputMemoryBitStream& PrepareArena();
+  bool IsSendable(const Record& record) const;
+  void Enqueue(uint32_t connectionId, const Record& record);
+  void Release(ConnectionQueue& queue, size_t count);
+
+  RpcChannelSettings mSettings;
+  std::vector<ConnectionQueue> mQueues;
+  // Only added to, by Send() and Multicast().
+  std::vector<std::unique_ptr<ArenaRegion>> mRegions;
+  uint32_t mCurrentRegion{0};
+};
+
+template <typename Rpc>
+RpcChannel::Record RpcChannel::Serialize(const Rpc& rpc) {
+  OutputMemoryBitStream& arena = PrepareArena();
+  const uint32_t startBit = arena.GetBitLength();
+  arena.Write(static_cast<uint16_t>(Rpc::kRpcId), kRpcIdBits);
+  arena.Write(rpc);
+  return {mCurrentRegion, startBit >> 3, arena.GetBitLength() - startBit};
+}
+
+/**
+ * @brief Reads batches written by RpcChannel::WriteBatch() and hands each
+ * RPC to receiver.OnRpc(connectionId, const Rpc&).
+ *
+ * The id-to-handler table is a flat array built at compile time from
+ * Rpcs..., so dispatching is one bounds check and one indirect call; ids
+ * must be unique.
+ */
+template <typename Receiver, RpcType... Rpcs>
+class RpcDispatcher {
+ public:
+  /**
+   * @brief Dispatches one batch.
+   *
+   * @return false at an unknown id or truncated input. The rest of the
+   * stream can't be parsed then, so the caller should drop the packet.
+   */
+  static bool Dispatch(Receiver& receiver, uint32_t connectionId,
+                       InputMemoryBitStream& inStream);
+
+ private:
+  using Handler = bool (*)(Receiver&, uint32_t, InputMemoryBitStream&);
+
+  static constexpr size_t kTableSize =
+      std::max({static_cast<size_t>(Rpcs::kRpcId)...}) + 1;
+
+  template <typename Rpc>
+  static bool Invoke(Receiver& receiver, uint32_t connectionId,
+                     InputMemoryBitStream& inStream) {
+    Rpc rpc{};
+    inStream.Read(rpc);
+    if (inStream.HasOverrun()) {
+      return false;
+    }
+    receiver.OnRpc(connectionId, static_cast<const Rpc&>(rpc));
+    return true;
+  }
+
+  static constexpr bool HasUniqueIds() {
+    const std::array<size_t, sizeof...(Rpcs)> ids{Rpcs::kRpcId...};
+    for (size_t i = 0; i < ids.size(); ++i) {
+      for (size_t j = i + 1; j < ids.size(); ++j) {
+        if (ids[i] == ids[j]) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+  static_assert(HasUniqueIds(), "two RPCs share an id");
+
+  static constexpr std::array<Handler, kTableSize> BuildHandlers() {
+    std::array<Handler, kTableSize> handlers{};
+    ((handlers[Rpcs::kRpcId] = &Invoke<Rpcs>), ...);
+    return handlers;
+  }
+
+  static constexpr std::array<Handler, kTableSize> kHandlers = BuildHandlers();
+};
+
+template <typename Receiver, RpcType... Rpcs>
+bool RpcDispatcher<Receiver, Rpcs...>::Dispatch(
+    Receiver& receiver, uint32_t connectionId, InputMemoryBitStream& inStream) {
+  uint32_t count = 0;
+  inStream.Read(count, kRpcCountBits);
+  for (uint32_t i = 0; i < count; ++i) {
+    uint16_t id = 0;
+    inStream.Read(id, kRpcIdBits);
+    if (inStream.HasOverrun() || id >= kTableSize || !kHandlers[id] ||
+        !kHandlers[id](receiver, connectionId, inStream)) {
+      return false;
+    }
+  }
+  return !inStream.HasOverrun();
+}
+
+}  // namespace GameNet
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "core/container/flat_hash_map.h"
+#include "socket/socket_address.h"
+
+namespace GameNet {
+
+/**
+ * @brief Maps the source address of a received datagram to its connection.
+ *
+ * A flat open-addressing table: O(1) lookups that touch one or two cache
+ * lines and never allocate once Reserve()d for the maximum client count.
+ * Typically TConnection is a slot index into the server's connection array.
+ */
+template <typename TConnection>
+using ConnectionTable = FlatHashMap<SocketAddress, TConnection>;
+
+}  // namespace GameNet
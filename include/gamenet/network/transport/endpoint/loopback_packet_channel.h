@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "core/container/spsc_queue.h"
+#include "endpoint/network_endpoint_interface.h"
+
+namespace GameNet {
+
+/**
+ * @brief One direction of an in-process link.
+ *
+ * Packets travel from the sender thread to the receiver thread through a
+ * lock-free SPSC queue. Payload buffers travel back through a second queue,
+ * so after warm-up a buffer is never allocated again; it just bounces between
+ * the two threads.
+ *
+ * Send* may only be called from one thread and Poll* from one other thread.
+ */
+class LoopbackPacketChannel {
+ public:
+  static constexpr size_t kDefaultCapacity = 1024;  // in packets.
+
+  explicit LoopbackPacketChannel(size_t capacity = kDefaultCapacity);
+
+  LoopbackPacketChannel(const LoopbackPacketChannel&) = delete;
+  LoopbackPacketChannel& operator=(const LoopbackPacketChannel&) = delete;
+
+  // Copies the payload into a pooled buffer.
+  bool Send(const SocketAddress& source, std::span<const uint8_t> payload);
+
+  // Copies the payload into a pooled buffer and keeps the packet's kernel
+  // receive metadata.
+  bool Send(const NetworkReceivedPacket& packet);
+
+  // Hands the buffer itself to the receiver; nothing is copied.
+  bool Send(const SocketAddress& source, std::vector<uint8_t>&& payload);
+
+  /**
+   * @brief Swaps the next packet's payload into outPacket.
+   * The buffer previously held by outPacket goes back to the sender's pool.
+   */
+  bool Poll(NetworkReceivedPacket& outPacket);
+
+  size_t PollBatch(std::span<NetworkReceivedPacket> outPackets);
+
+ private:
+  std::vector<uint8_t> AcquireBuffer();
+  void RecycleBuffer(std::vector<uint8_t>&& buffer);
+
+  SPSCQueue<NetworkReceivedPacket> mPackets;
+  SPSCQueue<std::vector<uint8_t>> mFreeBuffers;
+};
+
+}  // namespace GameNet
@@ -1,10 +1,10 @@
 #pragma once
 
-#include <deque>
 #include <memory>
-#include <mutex>
 #include <span>
+#include <vector>
 
+#include "endpoint/loopback_packet_channel.h"
 #include "endpoint/network_endpoint_interface.h"
 
 namespace GameNet {
@@ -15,7 +15,11 @@ namespace GameNet {
  * It wires up two LoopbackTransportEndpoints.
  * This is useful for listen-server mode, Play-In_Editor, unit tests, and etc.
  *
- * (multiple endpoints need to be wired up to make a listen server)
+ * Each direction is a lock-free SPSC channel, so the client and the server
+ * may run on different threads as long as each endpoint is driven by one
+ * thread at a time.
+ *
+ * For one server and many clients, use LoopbackTransportHub.
  */
 class LoopbackTransportEndpoint final : public INetworkTransportEndpoint {
  public:
@@ -25,7 +29,8 @@ class LoopbackTransportEndpoint final : public INetworkTransportEndpoint {
   };
 
   static ConnectedEndpoints CreateConnectedEndpoints(
-      const SocketAddress& clientAddress, const SocketAddress& serverAddress);
+      const SocketAddress& clientAddress, const SocketAddress& serverAddress,
+      size_t queueCapacity = LoopbackPacketChannel::kDefaultCapacity);
 
   LoopbackTransportEndpoint(const LoopbackTransportEndpoint&) = delete;
   LoopbackTransportEndpoint& operator=(const LoopbackTransportEndpoint&) =
@@ -34,29 +39,35 @@ class LoopbackTransportEndpoint final : public INetworkTransportEndpoint {
   bool SendPacket(const SocketAddress& dest,
                   std::span<const uint8_t> payload) override;
 
+  /**
+   * @brief Zero-copy send: the buffer itself is handed to the peer.
+   */
+  bool SendPacket(const SocketAddress& dest, std::vector<uint8_t>&& payload);
+
   bool PollPacket(NetworkReceivedPacket& packet) override;
 
+  size_t PollPackets(std::span<NetworkReceivedPacket> outPackets) override;
+
   SocketAddress GetLocalSocketAddress() const override { return mLocalAddress; }
 
  private:
-  enum class EndpointSide { ClientSide, ServerSide };
+  struct SharedChannels {
+    explicit SharedChannels(size_t queueCapacity)
+        : packetsForClient(queueCapacity), packetsForServer(queueCapacity) {}
 
-  struct SharedMemoryBuffer {
-    std::mutex m;
-    std::deque<NetworkReceivedPacket> packetsForClient;
-    std::deque<NetworkReceivedPacket> packetsForServer;
+    LoopbackPacketChannel packetsForClient;
+    LoopbackPacketChannel packetsForServer;
   };
 
-  LoopbackTransportEndpoint(std::shared_ptr<SharedMemoryBuffer> sharedBuffer,
-                            EndpointSide side,
+  LoopbackTransportEndpoint(std::shared_ptr<SharedChannels> sharedChannels,
+                            LoopbackPacketChannel& incomingChannel,
+                            LoopbackPacketChannel& outgoingChannel,
                             const SocketAddress& localAddress,
                             const SocketAddress& peerAddress);
 
-  std::deque<NetworkReceivedPacket>& GetIncomingQueueToRead();
-  std::deque<NetworkReceivedPacket>& GetPeerIncomingQueueToWrite();
-
-  std::shared_ptr<SharedMemoryBuffer> mSharedBuffer;
-  EndpointSide mSide;
+  std::shared_ptr<SharedChannels> mSharedChannels;
+  LoopbackPacketChannel& mIncomingChannel;
+  LoopbackPacketChannel& mOutgoingChannel;
   SocketAddress mLocalAddress;
   SocketAddress mPeerAddress;
 };
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "endpoint/loopback_packet_channel.h"
+#include "endpoint/network_endpoint_interface.h"
+
+namespace GameNet {
+
+/**
+ * @brief In-process switchboard between one server and many clients.
+ *
+ * The server endpoint demultiplexes sends by destination SocketAddress to
+ * per-client SPSC channels, and drains all client channels round-robin in
+ * batches when polled. This lets the editor and benchmarks run many bot
+ * clients in one process against a real server loop without sockets.
+ *
+ * Threading: the server endpoint is driven by one thread. Each client
+ * endpoint is driven by one thread, which may be shared by several clients.
+ * ConnectClient() may be called from any thread at any time.
+ */
+class LoopbackTransportHub final
+    : public std::enable_shared_from_this<LoopbackTransportHub> {
+ public:
+  static constexpr size_t kDefaultMaximumClientCount = 256;
+  static constexpr size_t kDefaultQueueCapacity = 256;  // per direction.
+
+  static std::shared_ptr<LoopbackTransportHub> Create(
+      const SocketAddress& serverAddress,
+      size_t maximumClientCount = kDefaultMaximumClientCount,
+      size_t queueCapacity = kDefaultQueueCapacity);
+
+  LoopbackTransportHub(const LoopbackTransportHub&) = delete;
+  LoopbackTransportHub& operator=(const LoopbackTransportHub&) = delete;
+
+  /**
+   * @brief Create the server side of the hub. Only one may exist at a time;
+   * another can be created once it is destroyed.
+   */
+  std::unique_ptr<INetworkTransportEndpoint> CreateServerEndpoint();
+
+  /**
+   * @brief Wire a new client to the server.
+   * Destroying the returned endpoint disconnects the client. Its address can
+   * be connected again right away, and its slot is reused once the server
+   * endpoint has noticed the disconnect (immediately if there is none).
+   *
+   * @return nullptr if the hub is full or the address is already taken.
+   */
+  std::unique_ptr<INetworkTransportEndpoint> ConnectClient(
+      const SocketAddress& clientAddress);
+
+  // Clients currently connected.
+  size_t GetClientCount() const {
+    return mClientCount.load(std::memory_order_relaxed);
+  }
+
+ private:
+  class ServerEndpoint;
+  class ClientEndpoint;
+
+  enum class SlotState : uint8_t {
+    kFree,
+    kConnected,
+    // The client endpoint is gone but the server may still send to it.
+    kDisconnected,
+  };
+
+  struct ClientSlot {
+    explicit ClientSlot(size_t queueCapacity)
+        : packetsForServer(queueCapacity), packetsForClient(queueCapacity) {}
+
+    SocketAddress address;
+    LoopbackPacketChannel packetsForServer;
+    LoopbackPacketChannel packetsForClient;
+    SlotState state{SlotState::kFree};
+  };
+
+  LoopbackTransportHub(const SocketAddress& serverAddress,
+                       size_t maximumClientCount, size_t queueCapacity);
+
+  // Called by the endpoints' destructors.
+  void DisconnectClient(size_t slotIndex);
+  void DestroyServerEndpoint();
+
+  SocketAddress mServerAddress;
+  size_t mQueueCapacity;
+
+  // Sized once; slots are allocated on first use and never moved, so the
+  // server may poll a slot's channels without the lock.
+  std::vector<std::unique_ptr<ClientSlot>> mClientSlots;
+  std::atomic<size_t> mClientCount{0};
+  // Bumped on every connect and disconnect so the server endpoint knows to
+  // resync its view of the slots.
+  std::atomic<uint64_t> mSlotVersion{0};
+
+  // Guards slot addresses and states, and mHasServerEndpoint.
+  std::mutex mConnectMutex;
+  bool mHasServerEndpoint{false};
+};
+
+}  // namespace GameNet
@@ -4,6 +4,7 @@
 #include <span>
 #include <vector>
 
+#include "core/timer/clock.h"
 #include "socket/socket_address.h"
 
 namespace GameNet {
@@ -13,6 +14,14 @@ struct NetworkReceivedPacket {
   SocketAddress sourceAddress{};
   std::vector<uint8_t> payload;
 
+  // When the kernel received the datagram, on the clock the endpoint was
+  // created with. That clock's Now() minus this is the time it sat in
+  // queues on this machine. Left at the epoch by endpoints that can't tell.
+  ClockTimePoint kernelTimestamp{};
+  // Datagrams the socket had dropped for a full receive buffer by the time
+  // this one arrived (cumulative), or 0 if unknown.
+  uint32_t kernelDropCount{0};
+
   void Clear() { payload.clear(); }
 };
 
@@ -39,6 +48,20 @@ class INetworkTransportEndpoint {
    */
   virtual bool PollPacket(NetworkReceivedPacket& outPacket) = 0;
 
+  /**
+   * @brief Polls up to outPackets.size() received datagrams at once.
+   * Endpoints backed by a queue override this to drain it in one pass.
+   * 
+   * @return the number of datagrams written to the front of outPackets.
+   */
+  virtual size_t PollPackets(std::span<NetworkReceivedPacket> outPackets) {
+    size_t count = 0;
+    while (count < outPackets.size() && PollPacket(outPackets[count])) {
+      ++count;
+    }
+    return count;
+  }
+
   virtual SocketAddress GetLocalSocketAddress() const = 0;
 };
 
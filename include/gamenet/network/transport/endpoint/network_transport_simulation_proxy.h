@@ -1,26 +1,86 @@
 #pragma once
 
 #include <chrono>
-#include <deque>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <random>
 #include <span>
+#include <string>
+#include <string_view>
+#include <vector>
 
+#include "core/timer/clock.h"
 #include "endpoint/network_endpoint_interface.h"
 
 namespace GameNet {
 
+/**
+ * @brief Impairments applied to every packet passing through the proxy.
+ * Each direction (send and receive) is impaired independently.
+ */
 struct NetworkTransportSimulationSettings {
   double baseLatency = 0.0; // in milliseconds
   double jitter = 0.0;  // in milliseconds
   double packetLossProbability = 0.0;  // in the range [0.0, 1.0].
+
+  // Gilbert-Elliott burst loss. packetLossProbability applies in the good
+  // state and burstLossProbability in the bad state. Disabled while
+  // burstEnterProbability is 0.
+  double burstEnterProbability = 0.0;  // good -> bad, per packet.
+  double burstExitProbability = 1.0;   // bad -> good, per packet.
+  double burstLossProbability = 1.0;
+
+  double duplicateProbability = 0.0;
+  double reorderProbability = 0.0;
+  double reorderDelay = 0.0;  // extra delay of reordered packets, in ms.
+
+  double bandwidth = 0.0;  // in kbit/s, 0 means unlimited.
+  size_t maximumQueuedBytes = 0;  // tail-drop limit, 0 means unlimited.
+
+  uint64_t randomSeed = 0;  // 0 seeds from std::random_device.
+
+  /**
+   * @brief Built-in profiles: "lan", "wifi", "wifi-congested", "lte", "3g"
+   * and "satellite".
+   */
+  static std::optional<NetworkTransportSimulationSettings> FromProfile(
+      std::string_view profileName);
+
+  /**
+   * @brief Applies "key = value" lines (field names as above) on top of
+   * baseSettings. Blank lines and lines starting with '#' are skipped.
+   *
+   * @return std::nullopt on an unknown key or a malformed value.
+   */
+  static std::optional<NetworkTransportSimulationSettings> Parse(
+      std::string_view text,
+      const NetworkTransportSimulationSettings& baseSettings);
+  static std::optional<NetworkTransportSimulationSettings> Parse(
+      std::string_view text);
+
+  /**
+   * @brief Loads the "[profileName]" section of a profile file.
+   * A section may start with "profile = <built-in>" to inherit from it.
+   */
+  static std::optional<NetworkTransportSimulationSettings> LoadProfile(
+      const std::string& filePath, std::string_view profileName);
 };
 
 class NetworkTransportSimulationProxy final : public INetworkTransportEndpoint {
   public:
+  /**
+   * @brief Wrap an endpoint.
+   *
+   * @param endpoint
+   * @param settings
+   * @param clock drives every delay; pass a ManualClock to run a seeded
+   * simulation faster than real time and reproducibly.
+   */
   explicit NetworkTransportSimulationProxy(
     std::unique_ptr<INetworkTransportEndpoint> endpoint,
-    NetworkTransportSimulationSettings settings
+    NetworkTransportSimulationSettings settings,
+    const IClock& clock = SteadyClock::Get()
   );
 
   NetworkTransportSimulationProxy(const NetworkTransportSimulationProxy&) = delete;
@@ -30,41 +90,83 @@ class NetworkTransportSimulationProxy final : public INetworkTransportEndpoint {
 
   bool PollPacket(NetworkReceivedPacket& recvPacket) override;
 
+  size_t PollPackets(std::span<NetworkReceivedPacket> outPackets) override;
+
   SocketAddress GetLocalSocketAddress() const override {
     return mEndpoint->GetLocalSocketAddress();
   }
 
   private:
-  using steady_clock = std::chrono::steady_clock;
-
-  struct ScheduledOutgoingPacket {
-    steady_clock::time_point sendTime;
-    SocketAddress dest;
-    std::vector<uint8_t> payload;
+  using steady_clock = std::chrono::steady_clock;  // time base of IClock.
+
+  /**
+   * @brief Min-heap of packets keyed by (due time, arrival order).
+   * Payload buffers are pooled, so steady-state scheduling doesn't allocate.
+   */
+  class PacketSchedule {
+   public:
+    void Push(steady_clock::time_point dueTime, const SocketAddress& address,
+              std::span<const uint8_t> payload);
+
+    bool HasDue(steady_clock::time_point currTime) const {
+      return !mHeap.empty() && mHeap.front().dueTime <= currTime;
+    }
+
+    // Moves the earliest packet into outPacket. HasDue() must be true.
+    void PopInto(NetworkReceivedPacket& outPacket);
+
+    bool Empty() const { return mHeap.empty(); }
+
+   private:
+    struct Entry {
+      steady_clock::time_point dueTime;
+      uint64_t order;
+      uint32_t packetIndex;
+
+      // std::*_heap build max-heaps; invert to keep the earliest on top.
+      bool operator<(const Entry& other) const {
+        return dueTime != other.dueTime ? dueTime > other.dueTime
+                                        : order > other.order;
+      }
+    };
+
+    std::vector<Entry> mHeap;
+    std::vector<NetworkReceivedPacket> mPackets;
+    std::vector<uint32_t> mFreePacketIndices;
+    uint64_t mNextOrder{0};
   };
 
-  struct ScheduledIncomingPacket {
-    steady_clock::time_point deliverTime;
-    NetworkReceivedPacket recvPacket;
+  struct Direction {
+    PacketSchedule schedule;
+    steady_clock::time_point linkFreeTime{};  // when the bottleneck is idle.
+    bool inBurstLoss{false};
   };
 
   void FlushScheduledOutgoingPackets();
   void PumpUnderlyingIncomingPackets();
-  
+
+  // Runs one packet through loss, bandwidth, delay and duplication.
+  void Impair(Direction& direction, const SocketAddress& address,
+              std::span<const uint8_t> payload);
+
   steady_clock::time_point GetCurrentTimePoint() const;
-  steady_clock::time_point ComputeDeliveryTimePoint();
+  steady_clock::duration ComputeDelay();
 
-  bool ShouldDropPacket();
+  bool ShouldDropPacket(Direction& direction);
+  bool RollProbability(double probability);
 
   std::unique_ptr<INetworkTransportEndpoint> mEndpoint;
   NetworkTransportSimulationSettings mSettings;
+  const IClock* mClock;
 
-  std::deque<ScheduledOutgoingPacket> mScheduledOutgoingPackets;
-  std::deque<ScheduledIncomingPacket> mScheduledIncomingPackets;
+  Direction mOutgoing;
+  Direction mIncoming;
+  std::vector<NetworkReceivedPacket> mPumpBatch;
+  NetworkReceivedPacket mFlushPacket;
 
-  std::mt19937 mRandomNumberGenerator;
+  std::mt19937_64 mRandomNumberGenerator;
   std::uniform_real_distribution<double> mProbabilityDistribution;
   std::uniform_real_distribution<double> mJitterDistribution;
 };
 
-}
\ No newline at end of file
+}
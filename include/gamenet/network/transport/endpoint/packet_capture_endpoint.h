@@ -0,0 +1,110 @@
+#pragma once
+
+#if !defined(_WIN32)
+
+#include <memory>
+#include <span>
+
+#include "core/timer/clock.h"
+#include "endpoint/network_endpoint_interface.h"
+#include "endpoint/packet_capture_file.h"
+
+namespace GameNet {
+
+/**
+ * @brief Records every datagram that passes through an endpoint.
+ *
+ * Sends the wrapped endpoint accepted and every received datagram are
+ * appended to the capture with their time and peer address. Feed the file
+ * to PacketReplayEndpoint to run the same traffic through the server again.
+ */
+class PacketCaptureEndpoint final : public INetworkTransportEndpoint {
+ public:
+  PacketCaptureEndpoint(std::unique_ptr<INetworkTransportEndpoint> endpoint,
+                        std::unique_ptr<PacketCaptureWriter> writer,
+                        const IClock& clock = SteadyClock::Get());
+
+  PacketCaptureEndpoint(const PacketCaptureEndpoint&) = delete;
+  PacketCaptureEndpoint& operator=(const PacketCaptureEndpoint&) = delete;
+
+  bool SendPacket(const SocketAddress& dest,
+                  std::span<const uint8_t> payload) override;
+
+  bool PollPacket(NetworkReceivedPacket& outPacket) override;
+
+  size_t PollPackets(std::span<NetworkReceivedPacket> outPackets) override;
+
+  SocketAddress GetLocalSocketAddress() const override {
+    return mEndpoint->GetLocalSocketAddress();
+  }
+
+ private:
+  ClockDuration GetElapsedTime() const { return mClock->Now() - mStartTime; }
+
+  // The packet itself still goes through when it can't be recorded.
+  void Record(PacketCaptureDirection direction, const SocketAddress& address,
+              std::span<const uint8_t> payload, ClockDuration timestamp);
+
+  std::unique_ptr<INetworkTransportEndpoint> mEndpoint;
+  std::unique_ptr<PacketCaptureWriter> mWriter;
+  const IClock* mClock;
+  ClockTimePoint mStartTime;
+};
+
+enum class PacketReplaySpeed {
+  Recorded,  // datagrams arrive with their original spacing.
+  Maximum,   // every datagram is available at once.
+};
+
+/**
+ * @brief Plays the received side of a capture back as an endpoint.
+ *
+ * PollPacket() returns the captured incoming datagrams in order, each from
+ * its original source address. Sends are accepted and discarded, so the
+ * server under test runs its full decode, reliability and replication path
+ * with no clients attached.
+ */
+class PacketReplayEndpoint final : public INetworkTransportEndpoint {
+ public:
+  PacketReplayEndpoint(std::unique_ptr<PacketCaptureReader> reader,
+                       PacketReplaySpeed speed,
+                       const IClock& clock = SteadyClock::Get());
+
+  PacketReplayEndpoint(const PacketReplayEndpoint&) = delete;
+  PacketReplayEndpoint& operator=(const PacketReplayEndpoint&) = delete;
+
+  bool SendPacket(const SocketAddress& dest,
+                  std::span<const uint8_t> payload) override;
+
+  bool PollPacket(NetworkReceivedPacket& outPacket) override;
+
+  SocketAddress GetLocalSocketAddress() const override {
+    return mReader->GetLocalSocketAddress();
+  }
+
+  // True once every captured datagram has been returned.
+  bool IsFinished() const { return mFinished; }
+
+  // Start over from the first datagram; the recorded clock restarts too.
+  void Rewind();
+
+  uint64_t GetSentPacketCount() const { return mSentPacketCount; }
+
+ private:
+  bool LoadNextReceivedRecord();
+
+  std::unique_ptr<PacketCaptureReader> mReader;
+  PacketReplaySpeed mSpeed;
+  const IClock* mClock;
+
+  PacketCaptureRecord mNextRecord;
+  bool mHasNextRecord{false};
+  bool mFinished{false};
+  bool mStarted{false};
+  ClockTimePoint mStartTime{};
+  uint64_t mSentPacketCount{0};
+};
+
+}  // namespace GameNet
+
+#endif
@@ -0,0 +1,98 @@
+#pragma once
+
+#if !defined(_WIN32)
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+#include "core/timer/clock.h"
+#include "socket/socket_address.h"
+
+namespace GameNet {
+
+enum class PacketCaptureDirection : uint8_t { Sent = 0, Received = 1 };
+
+// One datagram read back from a capture. payload points into the mapping.
+struct PacketCaptureRecord {
+  ClockDuration timestamp{};  // since the capture started.
+  PacketCaptureDirection direction{PacketCaptureDirection::Received};
+  SocketAddress address{};  // destination if Sent, source if Received.
+  std::span<const uint8_t> payload;
+};
+
+/**
+ * @brief Appends datagrams to a memory-mapped capture file.
+ *
+ * Layout: a fixed file header, then one record per datagram (timestamp,
+ * direction, address, size) followed by its payload, padded to 8 bytes.
+ * Fields are in host byte order; captures are meant to be replayed on the
+ * same kind of machine that recorded them.
+ * The file header's record count is kept current after every append, so a
+ * crashed process still leaves a readable capture. POSIX only.
+ */
+class PacketCaptureWriter {
+ public:
+  static constexpr size_t kDefaultGrowSize = 16 * 1024 * 1024;  // in bytes.
+
+  static std::unique_ptr<PacketCaptureWriter> Create(
+      const std::string& path, const SocketAddress& localAddress,
+      size_t growSize = kDefaultGrowSize);
+
+  // Trims the file to the bytes actually written.
+  ~PacketCaptureWriter();
+
+  PacketCaptureWriter(const PacketCaptureWriter&) = delete;
+  PacketCaptureWriter& operator=(const PacketCaptureWriter&) = delete;
+
+  bool Append(PacketCaptureDirection direction, const SocketAddress& address,
+              std::span<const uint8_t> payload, ClockDuration timestamp);
+
+  uint64_t GetRecordCount() const;
+
+ private:
+  PacketCaptureWriter(int fileDescriptor, size_t growSize);
+
+  bool Map(size_t size);
+
+  int mFileDescriptor;
+  size_t mGrowSize;
+  uint8_t* mMapping{nullptr};
+  size_t mMappedSize{0};
+  size_t mWriteOffset{0};
+};
+
+// Reads a capture written by PacketCaptureWriter through a read-only mapping.
+class PacketCaptureReader {
+ public:
+  static std::unique_ptr<PacketCaptureReader> Open(const std::string& path);
+
+  ~PacketCaptureReader();
+
+  PacketCaptureReader(const PacketCaptureReader&) = delete;
+  PacketCaptureReader& operator=(const PacketCaptureReader&) = delete;
+
+  // The next record in file order, or false at the end.
+  bool Next(PacketCaptureRecord& outRecord);
+
+  void Rewind();
+
+  uint64_t GetRecordCount() const { return mRecordCount; }
+  SocketAddress GetLocalSocketAddress() const { return mLocalAddress; }
+
+ private:
+  PacketCaptureReader(const uint8_t* mapping, size_t mappedSize);
+
+  const uint8_t* mMapping;
+  size_t mMappedSize;
+  size_t mDataEnd;
+  size_t mReadOffset;
+  uint64_t mRecordCount;
+  SocketAddress mLocalAddress;
+};
+
+}  // namespace GameNet
+
+#endif
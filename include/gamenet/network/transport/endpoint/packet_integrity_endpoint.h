@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "endpoint/network_endpoint_interface.h"
+
+namespace GameNet {
+
+/**
+ * @brief Appends a CRC32C trailer to every datagram and drops incoming ones
+ * whose trailer does not match.
+ *
+ * The CRC is seeded with a protocol id, so packets from another game,
+ * another build or a port scanner fail the check just like corrupt ones.
+ * Rejected datagrams never reach the caller, so nothing downstream spends
+ * time deserializing them. Both peers must wrap their endpoints with the
+ * same protocol id.
+ */
+class PacketIntegrityEndpoint final : public INetworkTransportEndpoint {
+ public:
+  static constexpr size_t kTrailerSize = sizeof(uint32_t);
+
+  PacketIntegrityEndpoint(std::unique_ptr<INetworkTransportEndpoint> endpoint,
+                          uint64_t protocolId);
+
+  PacketIntegrityEndpoint(const PacketIntegrityEndpoint&) = delete;
+  PacketIntegrityEndpoint& operator=(const PacketIntegrityEndpoint&) = delete;
+
+  bool SendPacket(const SocketAddress& dest,
+                  std::span<const uint8_t> payload) override;
+
+  bool PollPacket(NetworkReceivedPacket& outPacket) override;
+
+  size_t PollPackets(std::span<NetworkReceivedPacket> outPackets) override;
+
+  SocketAddress GetLocalSocketAddress() const override {
+    return mEndpoint->GetLocalSocketAddress();
+  }
+
+  uint64_t GetRejectedPacketCount() const { return mRejectedPacketCount; }
+
+ private:
+  // Checks and strips the trailer.
+  bool Verify(NetworkReceivedPacket& packet);
+
+  std::unique_ptr<INetworkTransportEndpoint> mEndpoint;
+  uint32_t mSeed;
+  std::vector<uint8_t> mSendBuffer;
+  uint64_t mRejectedPacketCount{0};
+};
+
+}  // namespace GameNet
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "endpoint/udp_transport_endpoint.h"
+
+namespace GameNet {
+
+/**
+ * @brief N UDP sockets bound to the same address with SO_REUSEPORT.
+ *
+ * The kernel spreads incoming datagrams across the shards, so receive work
+ * can run on one network worker thread per shard instead of a single core.
+ * Each shard is a plain UDPTransportEndpoint. A worker should own its shard
+ * together with the connection state of the clients steered to it; the
+ * receive path then never touches another thread's data and needs no locks.
+ *
+ * With flow steering on, a classic BPF program keeps every client on the
+ * same shard for as long as the group is alive.
+ */
+class ShardedUDPTransportEndpoint final {
+ public:
+  /**
+   * @brief Create shardCount non-blocking UDP sockets, all bound to address.
+   *
+   * @param address the local address; the port must not be 0
+   * @param shardCount the number of sockets in the reuseport group
+   * @param steerFlowsByAddress attach the flow steering program so a client
+   * always maps to the same shard
+   * @param maximumPacketSize
+   * @param options applied to every shard socket
+   * @param clock the clock every shard converts kernel timestamps onto
+   * @return std::unique_ptr<ShardedUDPTransportEndpoint>
+   */
+  static std::unique_ptr<ShardedUDPTransportEndpoint> Create(
+      const SocketAddress& address, int shardCount,
+      bool steerFlowsByAddress = true,
+      int maximumPacketSize = UDPTransportEndpoint::kDefaultMaximumPacketSize,
+      const UDPTransportOptions& options = UDPTransportOptions(),
+      const IClock& clock = SteadyClock::Get());
+
+  ShardedUDPTransportEndpoint(const ShardedUDPTransportEndpoint&) = delete;
+  ShardedUDPTransportEndpoint& operator=(const ShardedUDPTransportEndpoint&) =
+      delete;
+
+  int GetShardCount() const { return static_cast<int>(mShards.size()); }
+
+  /**
+   * @brief The endpoint of one shard.
+   * Only the worker that owns the shard should poll it.
+   */
+  UDPTransportEndpoint& GetShard(int shardIndex) {
+    return *mShards[static_cast<size_t>(shardIndex)];
+  }
+
+  SocketAddress GetLocalSocketAddress() const { return mAddress; }
+
+ private:
+  ShardedUDPTransportEndpoint(
+      std::vector<std::unique_ptr<UDPTransportEndpoint>> shards,
+      const SocketAddress& address);
+
+  std::vector<std::unique_ptr<UDPTransportEndpoint>> mShards;
+  SocketAddress mAddress;
+};
+
+}  // namespace GameNet
@@ -0,0 +1,137 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include "endpoint/network_endpoint_interface.h"
+
+namespace GameNet {
+
+/**
+ * @brief A point-to-point datagram link between two processes on one host,
+ * carried by a pair of SPSC rings in a memfd shared-memory segment.
+ *
+ * A datagram is copied straight into the peer's ring and out of it again;
+ * no syscall is made on the send or poll path. Callers that hold the
+ * concrete type can skip those copies: ReserveSend()/CommitSend() build a
+ * datagram in place in the ring, and PeekPacket()/ReleasePacket() read one
+ * where it lies. A receiver that wants to
+ * sleep calls WaitForPacket(), which parks on a futex the sender only wakes
+ * when someone is actually waiting.
+ *
+ * Semantics follow UDPTransportEndpoint: datagrams keep their boundaries,
+ * SendPacket() fails when the peer's ring is full, and received packets
+ * carry the peer's SocketAddress. Only the one peer address is reachable;
+ * a server with several co-located peers creates one link per peer.
+ *
+ * One side calls Create() and hands GetFileDescriptor() to the other
+ * (fork() inheritance or SCM_RIGHTS), which calls Attach(). Linux only.
+ */
+class SharedMemoryTransportEndpoint final : public INetworkTransportEndpoint {
+ public:
+  static constexpr int kDefaultMaximumPacketSize = 1200;  // in bytes.
+  static constexpr uint32_t kDefaultSlotCount = 1024;
+
+  /**
+   * @param localAddress the address this side reports to its peer
+   * @param remoteAddress the peer's address
+   * @param slotCount datagrams each ring can hold; rounded up to a power of 2
+   */
+  static std::unique_ptr<SharedMemoryTransportEndpoint> Create(
+      const SocketAddress& localAddress, const SocketAddress& remoteAddress,
+      uint32_t slotCount = kDefaultSlotCount,
+      int maximumPacketSize = kDefaultMaximumPacketSize);
+
+  // Map the segment behind fileDescriptor; takes ownership of it.
+  static std::unique_ptr<SharedMemoryTransportEndpoint> Attach(
+      int fileDescriptor);
+
+  ~SharedMemoryTransportEndpoint() override;
+
+  SharedMemoryTransportEndpoint(const SharedMemoryTransportEndpoint&) = delete;
+  SharedMemoryTransportEndpoint& operator=(
+      const SharedMemoryTransportEndpoint&) = delete;
+
+  bool SendPacket(const SocketAddress& dest,
+                  std::span<const uint8_t> payload) override;
+
+  bool PollPacket(NetworkReceivedPacket& outPacket) override;
+
+  /**
+   * @brief The next free slot of the peer's ring, to write a datagram into.
+   *
+   * @return maximum-packet-size bytes, or an empty span if the ring is full.
+   * Nothing is sent until CommitSend().
+   */
+  std::span<uint8_t> ReserveSend();
+
+  // Send the first length bytes of the span from ReserveSend().
+  bool CommitSend(size_t length);
+
+  /**
+   * @brief The next received datagram, in place in the ring.
+   *
+   * @return an empty span if nothing is pending. The bytes stay valid, and
+   * the slot stays taken, until ReleasePacket().
+   */
+  std::span<const uint8_t> PeekPacket();
+
+  void ReleasePacket();
+
+  SocketAddress GetLocalSocketAddress() const override { return mLocalAddress; }
+
+  SocketAddress GetRemoteSocketAddress() const { return mRemoteAddress; }
+
+  /**
+   * @brief Block until a datagram is pending or the timeout passes.
+   *
+   * @param timeoutMs -1 to wait forever
+   * @return true if a datagram is pending.
+   */
+  bool WaitForPacket(int timeoutMs);
+
+  int GetFileDescriptor() const { return mFileDescriptor; }
+
+ private:
+  struct SegmentHeader;
+  struct Ring;
+
+  // The layout values are passed in, already validated, rather than read
+  // from the segment, which the peer can still write to.
+  SharedMemoryTransportEndpoint(int fileDescriptor, uint8_t* segment,
+                                size_t segmentSize, int side,
+                                uint32_t slotCount, uint32_t slotStride,
+                                uint32_t maximumPacketSize);
+
+  // False if the size doesn't fit in a size_t.
+  static bool GetSegmentSize(uint32_t slotCount, uint32_t slotStride,
+                             size_t& outSegmentSize);
+
+  int mFileDescriptor;
+  uint8_t* mSegment;
+  size_t mSegmentSize;
+  // 0 for the creator, 1 for the attacher. Side i sends on ring i.
+  int mSide;
+
+  SegmentHeader* mHeader;
+  Ring* mSendRing;
+  Ring* mReceiveRing;
+  uint8_t* mSendSlots;
+  uint8_t* mReceiveSlots;
+
+  // Copied out of the segment once, so a misbehaving peer cannot make us
+  // index outside the mapping.
+  uint32_t mSlotMask;
+  uint32_t mSlotStride;
+  uint32_t mMaximumPacketSize;
+  SocketAddress mLocalAddress;
+  SocketAddress mRemoteAddress;
+};
+
+}  // namespace GameNet
+
+#endif
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "core/timer/clock.h"
+#include "endpoint/loopback_packet_channel.h"
+#include "endpoint/network_endpoint_interface.h"
+
+namespace GameNet {
+
+struct ThreadedTransportSettings {
+  // Packets buffered per direction; a full queue drops like a full socket.
+  size_t queueCapacity = 4096;
+  // Datagrams pulled from the endpoint per PollPackets() call.
+  size_t receiveBatchSize = 64;
+  // How long the I/O thread sleeps when a pass found nothing to do.
+  ClockDuration idleSleep = std::chrono::microseconds(100);
+};
+
+struct ThreadedTransportStats {
+  uint64_t sentPacketCount{0};
+  uint64_t receivedPacketCount{0};
+  // Sends the simulation thread made while the outgoing queue was full.
+  uint64_t droppedOutgoingPacketCount{0};
+  // Datagrams received while the simulation thread was not polling.
+  uint64_t droppedIncomingPacketCount{0};
+  uint64_t failedSendCount{0};
+};
+
+/**
+ * @brief Runs another endpoint on a dedicated network I/O thread.
+ *
+ * The wrapped endpoint is only touched by the I/O thread, which sends what
+ * the simulation thread queued and receives in batches. Packets cross
+ * between the threads through two LoopbackPacketChannels, lock-free SPSC
+ * queues that recycle their buffers, so SendPacket() and PollPackets() on
+ * this endpoint cost a copy and never make a system call.
+ *
+ * Stateless per-datagram work can move to the I/O thread too: wrap the
+ * socket endpoint in a PacketIntegrityEndpoint (or any other decorator)
+ * before handing it over, and its checks run there.
+ *
+ * SendPacket() and Poll*() must be called from one thread, the simulation
+ * thread.
+ */
+class ThreadedTransportEndpoint final : public INetworkTransportEndpoint {
+ public:
+  ThreadedTransportEndpoint(
+      std::unique_ptr<INetworkTransportEndpoint> endpoint,
+      const ThreadedTransportSettings& settings = ThreadedTransportSettings());
+  ~ThreadedTransportEndpoint() override;
+
+  ThreadedTransportEndpoint(const ThreadedTransportEndpoint&) = delete;
+  ThreadedTransportEndpoint& operator=(const ThreadedTransportEndpoint&) =
+      delete;
+
+  // Queues the datagram; false if the outgoing queue is full.
+  bool SendPacket(const SocketAddress& dest,
+                  std::span<const uint8_t> payload) override;
+
+  bool PollPacket(NetworkReceivedPacket& outPacket) override;
+
+  size_t PollPackets(std::span<NetworkReceivedPacket> outPackets) override;
+
+  SocketAddress GetLocalSocketAddress() const override { return mLocalAddress; }
+
+  // Safe to call from any thread; the counters are updated independently.
+  ThreadedTransportStats GetStats() const;
+
+ private:
+  void Run();
+  // One pass of the I/O loop. Returns false if there was nothing to do.
+  bool Pump();
+
+  std::unique_ptr<INetworkTransportEndpoint> mEndpoint;
+  ThreadedTransportSettings mSettings;
+  SocketAddress mLocalAddress;
+
+  // Simulation thread -> I/O thread. The packet address is the destination.
+  LoopbackPacketChannel mOutgoing;
+  // I/O thread -> simulation thread.
+  LoopbackPacketChannel mIncoming;
+
+  // Owned by the I/O thread.
+  std::vector<NetworkReceivedPacket> mReceiveBatch;
+  NetworkReceivedPacket mOutgoingPacket;
+
+  std::atomic<uint64_t> mSentPacketCount{0};
+  std::atomic<uint64_t> mReceivedPacketCount{0};
+  std::atomic<uint64_t> mDroppedOutgoingPacketCount{0};
+  std::atomic<uint64_t> mDroppedIncomingPacketCount{0};
+  std::atomic<uint64_t> mFailedSendCount{0};
+
+  std::atomic<bool> mRunning{true};
+  std::thread mThread;
+};
+
+}  // namespace GameNet
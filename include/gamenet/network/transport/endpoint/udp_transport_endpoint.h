@@ -5,11 +5,30 @@
 #include <span>
 #include <vector>
 
+#include "core/timer/clock.h"
 #include "endpoint/network_endpoint_interface.h"
 #include "socket/udp_socket.h"
 
 namespace GameNet {
 
+struct UDPTransportOptions {
+  // SO_RCVBUF / SO_SNDBUF in bytes; 0 keeps the system default.
+  int receiveBufferSize = 0;
+  int sendBufferSize = 0;
+  // Fill NetworkReceivedPacket::kernelTimestamp and kernelDropCount.
+  bool kernelTimestamps = true;
+  bool kernelDropCounter = true;
+};
+
+struct UDPTransportEndpointStats {
+  uint64_t sentPacketCount{0};
+  uint64_t receivedPacketCount{0};
+  uint64_t sendErrorCount{0};
+  uint64_t receiveErrorCount{0};
+  // Datagrams the kernel dropped because the receive buffer was full.
+  uint32_t kernelDropCount{0};
+};
+
 /**
  * @brief A UDP-backed transport endpoint.
  *
@@ -28,11 +47,17 @@ class UDPTransportEndpoint final : public INetworkTransportEndpoint {
    * 
    * @param address the local address foe the socket to be bound
    * @param maximumPacketSize 
+   * @param options socket buffer sizes and kernel instrumentation; options
+   * the platform doesn't support are skipped with a warning
+   * @param clock kernel timestamps are converted onto this clock; pass the
+   * one the driver reading the endpoint runs on
    * @return std::unique_ptr<UDPTransportEndpoint> 
    */
   static std::unique_ptr<UDPTransportEndpoint> Create(
       const SocketAddress& address,
-      int maximumPacketSize = kDefaultMaximumPacketSize);
+      int maximumPacketSize = kDefaultMaximumPacketSize,
+      const UDPTransportOptions& options = UDPTransportOptions(),
+      const IClock& clock = SteadyClock::Get());
 
   UDPTransportEndpoint(const UDPTransportEndpoint&) = delete;
   UDPTransportEndpoint& operator=(const UDPTransportEndpoint&) = delete;
@@ -46,14 +71,24 @@ class UDPTransportEndpoint final : public INetworkTransportEndpoint {
     return mAddress;
   }
 
+  const UDPTransportEndpointStats& GetStats() const { return mStats; }
+
  private:
+  friend class ShardedUDPTransportEndpoint;
+
+  // Set before bind, so no datagram arrives while the defaults apply.
+  static void ApplyOptions(UDPSocket& socket,
+                           const UDPTransportOptions& options);
+
   explicit UDPTransportEndpoint(UDPSocketPtr socket,
                                 const SocketAddress& address,
-                                int maximumPacketSize);
+                                int maximumPacketSize, const IClock& clock);
 
   UDPSocketPtr mSocket;
   SocketAddress mAddress;
   std::vector<uint8_t> mReceivedBuffer;
+  UDPTransportEndpointStats mStats;
+  const IClock* mClock;
 };
 
 }  // namespace GameNet
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#if !defined(_WIN32)
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "endpoint/network_endpoint_interface.h"
+
+namespace GameNet {
+
+/**
+ * @brief An AF_UNIX SOCK_DGRAM endpoint for processes on the same host.
+ *
+ * Behaves like UDPTransportEndpoint: datagrams keep their boundaries, peers
+ * are named by SocketAddress, and sends to a peer that is not listening are
+ * silently lost. The kernel skips the IP and UDP stack entirely.
+ *
+ * Each SocketAddress maps to a socket file in a shared directory
+ * ("<directory>/gamenet-<address>.sock"), so the layers above keep using
+ * the same addresses they would use over UDP. POSIX only.
+ */
+class UnixDatagramTransportEndpoint final : public INetworkTransportEndpoint {
+ public:
+  static constexpr int kDefaultMaximumPacketSize = 1200;  // in bytes.
+  static constexpr const char* kDefaultDirectory = "/tmp";
+
+  /**
+   * @brief Create a socket bound to the path for address. Fails if another
+   * endpoint is bound to it; a stale socket file left by a crashed process
+   * is replaced.
+   *
+   * @param address the address peers use to reach this endpoint
+   * @param directory where the socket files of all peers live
+   */
+  static std::unique_ptr<UnixDatagramTransportEndpoint> Create(
+      const SocketAddress& address,
+      const std::string& directory = kDefaultDirectory,
+      int maximumPacketSize = kDefaultMaximumPacketSize);
+
+  ~UnixDatagramTransportEndpoint() override;
+
+  UnixDatagramTransportEndpoint(const UnixDatagramTransportEndpoint&) = delete;
+  UnixDatagramTransportEndpoint& operator=(
+      const UnixDatagramTransportEndpoint&) = delete;
+
+  bool SendPacket(const SocketAddress& dest,
+                  std::span<const uint8_t> payload) override;
+
+  bool PollPacket(NetworkReceivedPacket& outPacket) override;
+
+  SocketAddress GetLocalSocketAddress() const override { return mAddress; }
+
+  static std::string GetSocketPath(const std::string& directory,
+                                   const SocketAddress& address);
+
+ private:
+  UnixDatagramTransportEndpoint(SOCKET socket, const SocketAddress& address,
+                                const std::string& directory,
+                                int maximumPacketSize);
+
+  SOCKET mSocket;
+  SocketAddress mAddress;
+  std::string mDirectory;
+  std::string mPath;
+  std::vector<uint8_t> mReceivedBuffer;
+};
+
+}  // namespace GameNet
+
+#endif
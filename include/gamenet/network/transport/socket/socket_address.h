@@ -3,43 +3,118 @@
 
 namespace GameNet {
 
+/**
+ * @brief An IPv4 or IPv6 address and port, stored as a sockaddr_storage.
+ */
 class SocketAddress {
  public:
   SocketAddress() {
+    memset(&mSockAddr, 0, sizeof(mSockAddr));
     GetAsSockAddrIn()->sin_family = AF_INET;
-    GetIP4Ref() = INADDR_ANY;
+    GetAsSockAddrIn()->sin_addr.s_addr = htonl(INADDR_ANY);
     GetAsSockAddrIn()->sin_port = 0;
   }
 
+  // IPv4 address and port in host byte order.
   SocketAddress(uint32_t address, uint16_t port) {
+    memset(&mSockAddr, 0, sizeof(mSockAddr));
     GetAsSockAddrIn()->sin_family = AF_INET;  // IPv4
-    GetIP4Ref() = htonl(address);
+    GetAsSockAddrIn()->sin_addr.s_addr = htonl(address);
     GetAsSockAddrIn()->sin_port = htons(port);
   }
 
+  // IPv6 address in network byte order, port in host byte order.
+  SocketAddress(const uint8_t (&address)[16], uint16_t port,
+                uint32_t scopeId = 0) {
+    memset(&mSockAddr, 0, sizeof(mSockAddr));
+    GetAsSockAddrIn6()->sin6_family = AF_INET6;
+    memcpy(&GetAsSockAddrIn6()->sin6_addr, address, sizeof(address));
+    GetAsSockAddrIn6()->sin6_port = htons(port);
+    GetAsSockAddrIn6()->sin6_scope_id = scopeId;
+  }
+
   SocketAddress(const sockaddr& sockAddr) {
-    memcpy(&mSockAddr, &sockAddr, sizeof(sockaddr));
+    memset(&mSockAddr, 0, sizeof(mSockAddr));
+    const size_t size = (sockAddr.sa_family == AF_INET6)
+                            ? sizeof(sockaddr_in6)
+                            : sizeof(sockaddr_in);
+    memcpy(&mSockAddr, &sockAddr, size);
   }
 
   bool operator==(const SocketAddress& other) const {
-    return mSockAddr.sa_family == AF_INET &&
-           GetAsSockAddrIn()->sin_port == other.GetAsSockAddrIn()->sin_port &&
-           GetIP4Ref() == other.GetIP4Ref();
+    if (mSockAddr.ss_family != other.mSockAddr.ss_family) {
+      return false;
+    }
+
+    if (IsIPv6()) {
+      const sockaddr_in6* a = GetAsSockAddrIn6();
+      const sockaddr_in6* b = other.GetAsSockAddrIn6();
+      return a->sin6_port == b->sin6_port &&
+             a->sin6_scope_id == b->sin6_scope_id &&
+             memcmp(&a->sin6_addr, &b->sin6_addr, sizeof(a->sin6_addr)) == 0;
+    }
+
+    return GetAsSockAddrIn()->sin_port == other.GetAsSockAddrIn()->sin_port &&
+           GetIP4() == other.GetIP4();
   }
 
+  /**
+   * @brief Mixes address, port and family through a 64-bit finalizer, so
+   * clients behind one NAT (same IP, different ports) spread evenly.
+   */
   size_t GetHash() const {
-    return std::hash<std::remove_cvref_t<decltype(GetIP4Ref())>>()(
-               GetIP4Ref()) |
-           std::hash<
-               std::remove_cvref_t<decltype(GetAsSockAddrIn()->sin_port)>>()(
-               GetAsSockAddrIn()->sin_port)
-               << 13 |
-           std::hash<std::remove_cvref_t<decltype(mSockAddr.sa_family)>>()(
-               mSockAddr.sa_family);
+    uint64_t key;
+    if (IsIPv6()) {
+      const sockaddr_in6* in6 = GetAsSockAddrIn6();
+      uint64_t high, low;
+      memcpy(&high, &in6->sin6_addr, sizeof(high));
+      memcpy(&low, reinterpret_cast<const uint8_t*>(&in6->sin6_addr) + 8,
+             sizeof(low));
+      key = Mix64(high ^ Mix64(low ^ in6->sin6_scope_id)) ^
+            (static_cast<uint64_t>(in6->sin6_port) << 48) ^ AF_INET6;
+    } else {
+      key = (static_cast<uint64_t>(GetIP4()) << 32) |
+            (static_cast<uint64_t>(GetAsSockAddrIn()->sin_port) << 16) |
+            AF_INET;
+    }
+    return static_cast<size_t>(Mix64(key));
+  }
+
+  SocketAddressFamily GetFamily() const {
+    return static_cast<SocketAddressFamily>(mSockAddr.ss_family);
+  }
+  bool IsIPv4() const { return mSockAddr.ss_family == AF_INET; }
+  bool IsIPv6() const { return mSockAddr.ss_family == AF_INET6; }
+
+  uint16_t GetPort() const {
+    return ntohs(IsIPv6() ? GetAsSockAddrIn6()->sin6_port
+                          : GetAsSockAddrIn()->sin_port);
+  }
+
+  void SetPort(uint16_t port) {
+    if (IsIPv6()) {
+      GetAsSockAddrIn6()->sin6_port = htons(port);
+    } else {
+      GetAsSockAddrIn()->sin_port = htons(port);
+    }
+  }
+
+  // Host byte order. Only meaningful for IPv4 addresses.
+  uint32_t GetIPv4Address() const { return ntohl(GetIP4()); }
+
+  // Network byte order. Only meaningful for IPv6 addresses.
+  void GetIPv6Address(uint8_t (&outAddress)[16]) const {
+    memcpy(outAddress, &GetAsSockAddrIn6()->sin6_addr, sizeof(outAddress));
   }
 
   socklen_t GetSockAddrSize() const {
-    return static_cast<socklen_t>(sizeof(sockaddr));
+    return static_cast<socklen_t>(IsIPv6() ? sizeof(sockaddr_in6)
+                                           : sizeof(sockaddr_in));
+  }
+
+  // Enough room for any family, e.g. for recvfrom().
+  static constexpr socklen_t GetSockAddrCapacity() {
+    return static_cast<socklen_t>(sizeof(sockaddr_storage));
   }
 
   std::string ToString() const;
@@ -48,23 +123,29 @@ class SocketAddress {
   friend class UDPSocket;
   friend class TCPSocket;
 
-  sockaddr mSockAddr;
+  sockaddr_storage mSockAddr;
 
-#if _WIN32
-  uint32_t& GetIP4Ref() {
-    return *reinterpret_cast<uint32_t*>(
-        &GetAsSockAddrIn()->sin_addr.S_un.S_addr);
+  static uint64_t Mix64(uint64_t x) {
+    // MurmurHash3 fmix64.
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
   }
-  const uint32_t& GetIP4Ref() const {
-    return *reinterpret_cast<const uint32_t*>(
-        &GetAsSockAddrIn()->sin_addr.S_un.S_addr);
+
+  // Network byte order.
+  uint32_t GetIP4() const {
+    uint32_t ip;
+    memcpy(&ip, &GetAsSockAddrIn()->sin_addr, sizeof(ip));
+    return ip;
   }
-#else
-  uint32_t& GetIP4Ref() { return GetAsSockAddrIn()->sin_addr.s_addr; }
-  const uint32_t& GetIP4Ref() const {
-    return GetAsSockAddrIn()->sin_addr.s_addr;
+
+  sockaddr* GetAsSockAddr() { return reinterpret_cast<sockaddr*>(&mSockAddr); }
+  const sockaddr* GetAsSockAddr() const {
+    return reinterpret_cast<const sockaddr*>(&mSockAddr);
   }
-#endif
 
   sockaddr_in* GetAsSockAddrIn() {
     return reinterpret_cast<sockaddr_in*>(&mSockAddr);
@@ -72,6 +153,13 @@ class SocketAddress {
   const sockaddr_in* GetAsSockAddrIn() const {
     return reinterpret_cast<const sockaddr_in*>(&mSockAddr);
   }
+
+  sockaddr_in6* GetAsSockAddrIn6() {
+    return reinterpret_cast<sockaddr_in6*>(&mSockAddr);
+  }
+  const sockaddr_in6* GetAsSockAddrIn6() const {
+    return reinterpret_cast<const sockaddr_in6*>(&mSockAddr);
+  }
 };
 
 using SocketAddressOpt = std::optional<SocketAddress>;
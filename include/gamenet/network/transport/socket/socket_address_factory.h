@@ -7,6 +7,31 @@ namespace GameNet {
 class SocketAddressFactory {
  public:
   static SocketAddressOpt CreateIPv4FromString(const std::string& str);
+
+  /**
+   * @brief Resolve "host:port", "a.b.c.d:port", "[v6 address]:port" or a
+   * bare host into an IPv4 or IPv6 address.
+   *
+   * @param family INET or INET6 to restrict the result, AF_UNSPEC for either.
+   */
+  static SocketAddressOpt CreateFromString(const std::string& str,
+                                           int family = AF_UNSPEC);
+
+  /**
+   * @brief Parse a numeric IPv4/IPv6 address with a numeric port, without
+   * any resolver call.
+   *
+   * @return std::nullopt if str is not numeric (e.g. a host name).
+   */
+  static SocketAddressOpt CreateFromNumericString(const std::string& str,
+                                                  int family = AF_UNSPEC);
+
+  /**
+   * @brief Split "host:port" / "[v6]:port" into its parts.
+   * The service defaults to "0" when absent.
+   */
+  static void SplitHostAndService(const std::string& str, std::string& outHost,
+                                  std::string& outService);
 };
 
 }  // namespace GameNet
@@ -0,0 +1,117 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "core/timer/clock.h"
+#include "socket_address.h"
+
+namespace GameNet {
+
+/**
+ * @brief Asynchronous, cached front end to SocketAddressFactory.
+ *
+ * Host names are resolved by a small pool of worker threads, so
+ * getaddrinfo() never blocks the game loop. Lookups go through, in order:
+ * numeric parsing (no resolver at all), static host entries (LoadHostsFile /
+ * AddHostEntry), the TTL cache, and finally a worker. Concurrent requests for
+ * the same name share one resolver call.
+ *
+ * getaddrinfo() does not report record TTLs, so cached results live for a
+ * fixed Settings::cacheTimeToLive (failures for negativeCacheTimeToLive).
+ * The cache holds at most Settings::maximumCacheSize names; inserting into
+ * a full cache drops the expired entries, or else the one closest to
+ * expiring.
+ */
+class SocketAddressResolver {
+ public:
+  // Invoked once per request. Runs inline on the calling thread for numeric
+  // addresses, host entries and cache hits; on a worker thread otherwise.
+  using Callback = std::function<void(SocketAddressOpt)>;
+  // Blocking lookup run on the workers: (request string, family).
+  using ResolveFunction = SocketAddressOpt (*)(const std::string&, int);
+
+  struct Settings {
+    size_t workerCount = 2;
+    std::chrono::seconds cacheTimeToLive{60};
+    std::chrono::seconds negativeCacheTimeToLive{5};
+    size_t maximumCacheSize = 1024;
+    // INET, INET6 or AF_UNSPEC for either.
+    int family = AF_UNSPEC;
+    // SocketAddressFactory::CreateFromString when null. Tests swap in a
+    // fake to stay offline.
+    ResolveFunction resolve = nullptr;
+  };
+
+  explicit SocketAddressResolver(const IClock& clock = SteadyClock::Get());
+  explicit SocketAddressResolver(const Settings& settings,
+                                 const IClock& clock = SteadyClock::Get());
+
+  // Stops the workers. Requests still queued complete with std::nullopt.
+  ~SocketAddressResolver();
+
+  SocketAddressResolver(const SocketAddressResolver&) = delete;
+  SocketAddressResolver& operator=(const SocketAddressResolver&) = delete;
+
+  std::future<SocketAddressOpt> Resolve(const std::string& str);
+  void Resolve(const std::string& str, Callback callback);
+
+  /**
+   * @brief Load "address name [aliases...]" lines in /etc/hosts format.
+   * Entries never expire and take precedence over the system resolver,
+   * which makes offline tests deterministic. A name keeps one address per
+   * family; only those of Settings::family are returned, the first listed
+   * for AF_UNSPEC. Names without one go to the system resolver.
+   *
+   * @return false if the file could not be opened.
+   */
+  bool LoadHostsFile(const std::string& path);
+  void AddHostEntry(const std::string& host, const SocketAddress& address);
+
+  // Drop cached results. Host entries are kept.
+  void ClearCache();
+
+ private:
+  struct CacheEntry {
+    SocketAddressOpt address;
+    ClockTimePoint expiryTime;
+  };
+
+  // Port 0; the request's port is applied on lookup.
+  struct HostEntry {
+    SocketAddressOpt ipv4;
+    SocketAddressOpt ipv6;
+    bool ipv6First{false};
+  };
+
+  using Callbacks = std::vector<Callback>;
+
+  bool TryResolveImmediately(const std::string& str, SocketAddressOpt& outAddress);
+  void WorkerLoop();
+  void Complete(const std::string& str, SocketAddressOpt address);
+  void InsertIntoCache(const std::string& str, const CacheEntry& entry);
+  const SocketAddressOpt& SelectHostAddress(const HostEntry& entry) const;
+
+  const IClock& mClock;
+  Settings mSettings;
+
+  std::mutex mMutex;
+  std::condition_variable mWorkAvailable;
+  bool mStopping{false};
+  std::deque<std::string> mQueue;
+  // Keyed by the request string; one entry per outstanding resolver call.
+  std::unordered_map<std::string, Callbacks> mPending;
+  std::unordered_map<std::string, CacheEntry> mCache;
+  // Keyed by lower-case host name.
+  std::unordered_map<std::string, HostEntry> mHostEntries;
+
+  std::vector<std::thread> mWorkers;
+};
+
+}  // namespace GameNet
@@ -0,0 +1,57 @@
+#pragma once
+#include <span>
+
+#include "socket_includes.h"
+
+namespace GameNet {
+
+struct SocketPollEvent {
+  void* userData{nullptr};
+  bool readable{false};
+  bool writable{false};
+  // Error or hang-up; the owner should read to find out which.
+  bool error{false};
+};
+
+using SocketPollerPtr = std::unique_ptr<class SocketPoller>;
+
+/**
+ * @brief Level-triggered readiness poller for many non-blocking sockets.
+ *
+ * epoll on Linux, poll()/WSAPoll() elsewhere. Register a socket with a
+ * user pointer (usually its connection); Wait() reports which are ready.
+ * Ask for writability only while there is something queued to send, and
+ * for readability only while the owner will read, otherwise every Wait()
+ * returns at once. Errors and hang-ups are reported either way.
+ */
+class SocketPoller {
+ public:
+  ~SocketPoller();
+
+  static SocketPollerPtr Create();
+
+  int Add(SOCKET socket, void* userData, bool wantWritable = false,
+          bool wantReadable = true);
+  int Modify(SOCKET socket, void* userData, bool wantWritable,
+             bool wantReadable = true);
+  int Remove(SOCKET socket);
+
+  /**
+   * @param timeoutMs -1 to block until something is ready, 0 to return at
+   * once.
+   * @return the number of events written, or a negative error.
+   */
+  int Wait(std::span<SocketPollEvent> outEvents, int timeoutMs);
+
+ private:
+#if defined(__linux__)
+  SocketPoller(int epollFd) : mEpollFd(epollFd) {}
+  int mEpollFd;
+#else
+  SocketPoller() = default;
+  std::vector<pollfd> mPollFds;
+  std::vector<void*> mUserData;
+#endif
+};
+
+}  // namespace GameNet
@@ -1,4 +1,6 @@
 #pragma once
+#include <span>
+
 #include "socket_includes.h"
 
 namespace GameNet {
@@ -20,6 +22,35 @@ class TCPSocket {
   int Send(const void* buf, int len);
   int Receive(void* buf, int maxLen);
 
+  // Upper bound on segments per SendV()/ReceiveV() call; extra ones are
+  // left for the next call.
+  static constexpr int kMaxSegments = 16;
+
+  /**
+   * @brief Gathered send: all segments go out in one syscall
+   * (sendmsg on POSIX, WSASend on Windows).
+   *
+   * @return bytes sent, -WSAEWOULDBLOCK when the send buffer is full, or a
+   * negative error.
+   */
+  int SendV(const std::span<const uint8_t>* segments, int segmentCount);
+
+  /**
+   * @brief Scattered receive into the segments (recvmsg / WSARecv).
+   *
+   * @return bytes received, 0 once the peer closed, -WSAEWOULDBLOCK when
+   * nothing is pending, or a negative error.
+   */
+  int ReceiveV(const std::span<uint8_t>* segments, int segmentCount);
+
+  int SetNonBlockingMode(bool nonBlocking);
+  int SetNoDelay(bool noDelay);
+
+  // Result of a non-blocking Connect(): NO_ERROR once established.
+  int GetPendingError() const;
+
+  SOCKET GetNativeHandle() const { return mSocket; }
+
  private:
   TCPSocket(SOCKET socket) : mSocket(socket) {}
   SOCKET mSocket;
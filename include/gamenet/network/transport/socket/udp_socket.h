@@ -7,6 +7,20 @@ class SocketAddress;
 
 using UDPSocketPtr = std::unique_ptr<class UDPSocket>;
 
+// Ancillary data returned by UDPSocket::ReceiveMessage().
+struct UDPReceiveInfo {
+  // When the kernel received the datagram, as CLOCK_REALTIME since the Unix
+  // epoch. Only set with EnableReceiveTimestamps().
+  bool hasKernelTimestamp{false};
+  std::chrono::nanoseconds kernelTimestamp{0};
+
+  // Datagrams this socket has dropped so far because its receive buffer
+  // was full. Only set with EnableDropCounter(), and only once something
+  // has been dropped.
+  bool hasDropCount{false};
+  uint32_t dropCount{0};
+};
+
 class UDPSocket {
  public:
   ~UDPSocket();
@@ -17,10 +31,56 @@ class UDPSocket {
   int SendTo(const void* buf, int len, const SocketAddress& toAddr);
   int ReceiveFrom(void* buf, int maxLen, SocketAddress& fromAddress);
 
+  /**
+   * @brief ReceiveFrom() through recvmsg, also returning the kernel receive
+   * timestamp and drop count when they are enabled. Falls back to
+   * ReceiveFrom() with an empty outInfo where recvmsg is unavailable.
+   */
+  int ReceiveMessage(void* buf, int maxLen, SocketAddress& fromAddress,
+                     UDPReceiveInfo& outInfo);
+
   int SetNonBlockingMode(bool nonBlocking);
 
+  // SO_RCVBUF / SO_SNDBUF in bytes. Linux doubles the value and caps it at
+  // net.core.rmem_max / wmem_max.
+  int SetReceiveBufferSize(int size);
+  int SetSendBufferSize(int size);
+
+  /**
+   * @brief Stamp every received datagram with the time the kernel got it
+   * (SO_TIMESTAMPNS), so time spent queued in the socket can be told apart
+   * from time on the network. Linux only.
+   */
+  int EnableReceiveTimestamps(bool enable);
+
+  /**
+   * @brief Report how many datagrams the socket dropped because its receive
+   * buffer was full (SO_RXQ_OVFL). Linux only.
+   */
+  int EnableDropCounter(bool enable);
+
+  /**
+   * @brief Let several sockets bind the same address and port (SO_REUSEPORT).
+   * The kernel then spreads incoming datagrams across the group.
+   * Must be called before Bind().
+   */
+  int SetReusePort(bool reusePort);
+
+  /**
+   * @brief Attach a classic BPF program (SO_ATTACH_REUSEPORT_CBPF) that picks
+   * the socket in the reuseport group from the source address and port.
+   * A given client then always lands on the same socket, no matter how the
+   * kernel orders the group. Linux only; IPv4 only.
+   *
+   * @param groupSize the number of sockets bound to the address
+   */
+  int AttachReusePortFlowSteering(uint32_t groupSize);
+
  private:
   UDPSocket(SOCKET socket) : mSocket(socket) {}
+
+  int SetIntOption(int level, int option, int value, const char* name);
+
   SOCKET mSocket;
 };
 
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "core/container/circular_buffer.h"
+#include "socket/socket_address.h"
+#include "socket/tcp_socket.h"
+
+namespace GameNet {
+
+using TCPStreamConnectionPtr = std::unique_ptr<class TCPStreamConnection>;
+
+struct TCPStreamSettings {
+  size_t maximumMessageSize = 64 * 1024;
+  // Must fit at least one framed message of maximumMessageSize.
+  size_t sendHighWaterMark = 256 * 1024;
+  size_t receiveHighWaterMark = 256 * 1024;
+  // Bytes offered to each scattered read.
+  size_t receiveChunkSize = 16 * 1024;
+  // CircularBuffer block size; a gathered send covers up to
+  // TCPSocket::kMaxSegments blocks.
+  size_t bufferBlockSize = 16 * 1024;
+  bool noDelay = true;
+};
+
+/**
+ * @brief A non-blocking TCP stream of length-prefixed messages.
+ *
+ * For lobby, matchmaking and admin channels, where many reliable message
+ * streams share one thread. Each message goes on the wire as a 4-byte
+ * big-endian length followed by the payload.
+ *
+ * SendMessage() only appends to the send queue; Flush() hands the whole
+ * queue to the kernel in one gathered send, so many small messages cost a
+ * single syscall. Receive() reads straight into the receive queue with a
+ * scattered read, and PollMessage() cuts complete messages out of it.
+ *
+ * Backpressure: SendMessage() refuses a message that would take the send
+ * queue above sendHighWaterMark, and Receive() stops reading while the
+ * receive queue is above receiveHighWaterMark, which closes the peer's TCP
+ * window.
+ *
+ * Drive it from a SocketPoller: register GetNativeHandle(), call Receive()
+ * when readable and Flush() when writable, and ask for writability only
+ * while HasPendingSend() and for readability only while WantsReceive().
+ * Above the receive high-water mark Receive() leaves the data in the
+ * socket, so a level-triggered poller still asking for readability would
+ * report it on every Wait(). Closing releases the socket at once, so remove
+ * the handle from the poller as soon as the connection is Closed, before
+ * the thread opens other sockets that could reuse the handle.
+ */
+class TCPStreamConnection {
+ public:
+  static constexpr size_t kMessageHeaderSize = sizeof(uint32_t);
+
+  enum class State { Connecting, Connected, Closed };
+
+  // Start a non-blocking connect. The connection is usable once Flush()
+  // (called on writability) moves it to Connected. Connect() and Adopt()
+  // return nullptr on invalid settings.
+  static TCPStreamConnectionPtr Connect(const SocketAddress& address,
+                                        const TCPStreamSettings& settings = {});
+
+  // Wrap an accepted socket.
+  static TCPStreamConnectionPtr Adopt(TCPSocketPtr socket,
+                                      const TCPStreamSettings& settings = {});
+
+  /**
+   * @brief Queue one message.
+   *
+   * @return false if the connection is closed, the message is larger than
+   * maximumMessageSize, or queueing it would take the send queue above its
+   * high-water mark.
+   */
+  bool SendMessage(std::span<const uint8_t> message);
+
+  /**
+   * @brief Send as much of the send queue as the kernel takes.
+   *
+   * @return bytes sent (0 if the kernel buffer is full) or a negative error,
+   * after which the connection is Closed.
+   */
+  int Flush();
+
+  /**
+   * @brief Read what the socket has into the receive queue.
+   *
+   * @return bytes read (0 if nothing was pending or the queue is above its
+   * high-water mark) or a negative error. A peer close moves the connection
+   * to Closed; messages already received can still be polled.
+   *
+   * Once WantsReceive() turns false, drop read interest for the socket
+   * until PollMessage() has drained the queue and it turns true again.
+   */
+  int Receive();
+
+  // Pop one complete message. outMessage is resized to fit.
+  bool PollMessage(std::vector<uint8_t>& outMessage);
+
+  // Drops unsent data and closes the socket. Received messages can still
+  // be polled.
+  void Close();
+
+  State GetState() const { return mState; }
+  // Whether a message of messageSize bytes would be accepted now.
+  bool IsWritable(size_t messageSize = 0) const {
+    return mState != State::Closed &&
+           mSendQueue.Size() + kMessageHeaderSize + messageSize <=
+               mSettings.sendHighWaterMark;
+  }
+  bool HasPendingSend() const {
+    return mState == State::Connecting || !mSendQueue.Empty();
+  }
+  // False while the receive queue is at its high-water mark or Closed.
+  bool WantsReceive() const {
+    return mState != State::Closed &&
+           mReceiveQueue.Size() < mSettings.receiveHighWaterMark;
+  }
+  size_t GetSendQueueSize() const { return mSendQueue.Size(); }
+  size_t GetReceiveQueueSize() const { return mReceiveQueue.Size(); }
+  // Still the former handle once Closed, for SocketPoller::Remove().
+  SOCKET GetNativeHandle() const { return mNativeHandle; }
+
+ private:
+  TCPStreamConnection(TCPSocketPtr socket, const TCPStreamSettings& settings,
+                      State state);
+
+  static bool ValidateSettings(const TCPStreamSettings& settings);
+  bool FinishConnect();
+
+  TCPSocketPtr mSocket;  // null once Closed.
+  SOCKET mNativeHandle;
+  TCPStreamSettings mSettings;
+  State mState;
+
+  CircularBuffer mSendQueue;
+  CircularBuffer mReceiveQueue;
+};
+
+}  // namespace GameNet
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace GameNet {
+
+template <typename T>
+class ComponentStorage;
+
+namespace detail {
+
+template <typename T>
+struct ComponentChunk {
+  static constexpr uint32_t kSize = 64;
+
+  std::array<T, kSize> values{};
+  // Bit i: values[i] was written during epoch.
+  uint64_t changed{0};
+  uint64_t epoch{0};
+};
+
+}  // namespace detail
+
+/**
+ * @brief Immutable view of a ComponentStorage at the moment it was frozen.
+ *
+ * Holds the storage's chunks, not a copy of them, and stays valid however
+ * the storage changes afterwards. It can be read, copied and dropped on
+ * any thread, e.g. by a job serializing it while the next tick simulates.
+ */
+template <typename T>
+class ComponentSnapshot {
+ public:
+  ComponentSnapshot() = default;
+
+  uint32_t Size() const { return mSize; }
+
+  const T& Get(uint32_t index) const {
+    return mChunks[index / Chunk::kSize]->values[index % Chunk::kSize];
+  }
+
+  // Whether the element was Edit()ed between the previous Freeze() and the
+  // one that produced this snapshot.
+  bool IsChanged(uint32_t index) const {
+    const Chunk& chunk = *mChunks[index / Chunk::kSize];
+    return chunk.epoch == mEpoch &&
+           ((chunk.changed >> (index % Chunk::kSize)) & 1);
+  }
+
+  // Calls visitor(index, const T&) for every changed element, in ascending
+  // order. Chunks nobody wrote to are skipped with one compare.
+  template <typename Visitor>
+  void ForEachChanged(Visitor&& visitor) const {
+    for (uint32_t chunkIndex = 0; chunkIndex < mChunks.size(); ++chunkIndex) {
+      const Chunk& chunk = *mChunks[chunkIndex];
+      if (chunk.epoch != mEpoch) {
+        continue;
+      }
+      for (uint64_t changed = chunk.changed; changed != 0;
+           changed &= changed - 1) {
+        const uint32_t offset =
+            static_cast<uint32_t>(std::countr_zero(changed));
+        visitor(chunkIndex * Chunk::kSize + offset, chunk.values[offset]);
+      }
+    }
+  }
+
+  // Counts Freeze() calls on the storage, starting at 0.
+  uint64_t GetEpoch() const { return mEpoch; }
+
+ private:
+  friend class ComponentStorage<T>;
+  using Chunk = detail::ComponentChunk<T>;
+
+  std::vector<std::shared_ptr<const Chunk>> mChunks;
+  uint32_t mSize{0};
+  uint64_t mEpoch{0};
+};
+
+/**
+ * @brief Dense array of components that can be frozen into a
+ * ComponentSnapshot without copying it.
+ *
+ * Elements live in chunks of 64. Freeze() hands out the current chunks and
+ * starts a new epoch; the first Edit() of a chunk in the new epoch copies
+ * it, so a frozen chunk is never written again. Freezing thus costs a
+ * pointer per chunk, and each tick copies only the chunks it touches.
+ *
+ * The usual split is to Freeze() at the end of a tick and serialize the
+ * snapshot on other threads while the next tick Edit()s the storage. Only
+ * one thread may use the storage itself.
+ */
+template <typename T>
+class ComponentStorage {
+ public:
+  explicit ComponentStorage(uint32_t size = 0) { Resize(size); }
+
+  ComponentStorage(const ComponentStorage&) = delete;
+  ComponentStorage& operator=(const ComponentStorage&) = delete;
+
+  uint32_t Size() const { return mSize; }
+
+  // New elements are value-initialized. Shrinking resets the dropped
+  // elements, so growing again doesn't bring them back.
+  void Resize(uint32_t size);
+
+  const T& Get(uint32_t index) const {
+    return mChunks[index / Chunk::kSize]->values[index % Chunk::kSize];
+  }
+
+  // Returns the element for writing and marks it changed in this epoch.
+  T& Edit(uint32_t index) {
+    Chunk& chunk = EditChunk(index / Chunk::kSize);
+    chunk.changed |= uint64_t{1} << (index % Chunk::kSize);
+    return chunk.values[index % Chunk::kSize];
+  }
+
+  ComponentSnapshot<T> Freeze();
+
+ private:
+  using Chunk = detail::ComponentChunk<T>;
+
+  Chunk& EditChunk(uint32_t chunkIndex);
+
+  // Chunks of past epochs may be held by snapshots and are copied before
+  // they are written.
+  std::vector<std::shared_ptr<Chunk>> mChunks;
+  uint32_t mSize{0};
+  uint64_t mEpoch{0};
+};
+
+template <typename T>
+void ComponentStorage<T>::Resize(uint32_t size) {
+  for (uint32_t index = size; index < mSize; ++index) {
+    Chunk& chunk = EditChunk(index / Chunk::kSize);
+    chunk.values[index % Chunk::kSize] = T{};
+    chunk.changed &= ~(uint64_t{1} << (index % Chunk::kSize));
+  }
+
+  const size_t chunkCount = (size + Chunk::kSize - 1) / Chunk::kSize;
+  mChunks.resize(chunkCount);
+  for (std::shared_ptr<Chunk>& chunk : mChunks) {
+    if (!chunk) {
+      chunk = std::make_shared<Chunk>();
+      chunk->epoch = mEpoch;
+    }
+  }
+  mSize = size;
+}
+
+template <typename T>
+ComponentSnapshot<T> ComponentStorage<T>::Freeze() {
+  ComponentSnapshot<T> snapshot;
+  snapshot.mChunks.assign(mChunks.begin(), mChunks.end());
+  snapshot.mSize = mSize;
+  snapshot.mEpoch = mEpoch;
+  ++mEpoch;
+  return snapshot;
+}
+
+template <typename T>
+typename ComponentStorage<T>::Chunk& ComponentStorage<T>::EditChunk(
+    uint32_t chunkIndex) {
+  std::shared_ptr<Chunk>& chunk = mChunks[chunkIndex];
+  if (chunk->epoch != mEpoch) {
+    // Copied even when no snapshot holds it any more: use_count() can't
+    // tell whether another thread has finished reading it.
+    std::shared_ptr<Chunk> copy = std::make_shared<Chunk>(*chunk);
+    copy->changed = 0;
+    copy->epoch = mEpoch;
+    chunk = std::move(copy);
+  }
+  return *chunk;
+}
+
+}  // namespace GameNet
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "core/job/job_system.h"
+#include "core/memory-stream/memory_bit_stream.h"
+#include "core/timer/clock.h"
+#include "core/timer/tick_time_histogram.h"
+#include "network/netcode/server_network_driver.h"
+#include "network/replication/replication_payload_cache.h"
+#include "network/transport/endpoint/threaded_transport_endpoint.h"
+
+namespace GameNet {
+
+struct ServerManagerSettings {
+  ServerNetworkSettings network{};
+  // Move socket I/O off the tick onto a dedicated thread.
+  bool useNetworkThread = false;
+  ThreadedTransportSettings networkThread{};
+  // Threads besides the ticking one that build client packets; with 0 the
+  // ticking thread builds them all.
+  uint32_t workerThreadCount = 0;
+  // Clients per job when building packets.
+  uint32_t packetBuildBatchSize = 4;
+  // Build packets in the background while the game simulates the next tick
+  // and send them at the start of the next Tick(). Needs worker threads to
+  // overlap anything, and delays packets by one tick.
+  bool pipelinePacketBuild = false;
+  // Distinct payloads the game expects to put in GetPayloadCache() per tick.
+  uint32_t payloadCacheEntryCount = 1024;
+};
+
+/**
+ * @brief Runs the server side of the network for one process.
+ *
+ * Owns the ServerNetworkDriver and drives it once per server tick; game
+ * code registers its handlers on GetNetworkDriver() and reads per-client
+ * state from its connection manager. With useNetworkThread the endpoint is
+ * wrapped in a ThreadedTransportEndpoint, so Tick() only drains and fills
+ * in-memory queues.
+ *
+ * Outgoing packets come from the PacketBuilder, which Tick() runs for every
+ * client concurrently on a JobSystem, each into its own stream. The builder
+ * must only read state shared between clients; the per-connection calls of
+ * ReplicationManager and ReplicationScheduler qualify. The streams are sent
+ * afterwards on the ticking thread in a fixed order, so the output does not
+ * depend on how the work was split across threads.
+ *
+ * With pipelinePacketBuild the build runs while Tick() has returned and the
+ * game simulates, so the builder must read a frozen world instead, e.g.
+ * ComponentSnapshots, and the game must leave the replication state alone
+ * until the next Tick(). The PacketBuildPrepare callback is where that
+ * state changes hands: it runs on the ticking thread with no build in
+ * flight, right before a build starts, to freeze snapshots and feed what
+ * changed into the ReplicationManager.
+ *
+ * It is also where GetPayloadCache() gets filled. Tick() empties the cache
+ * before PacketBuildPrepare; adding what the tick made dirty there lets
+ * every builder splice those payloads in with a read-only Write() instead
+ * of serializing them once per client.
+ */
+class ServerManager {
+ public:
+  using PacketBuilder =
+      std::function<void(uint32_t clientId, OutputMemoryBitStream& outStream)>;
+  using PacketBuildPrepare = std::function<void()>;
+
+  ServerManager(std::unique_ptr<INetworkTransportEndpoint> endpoint,
+                const ServerManagerSettings& settings,
+                const IClock& clock = SteadyClock::Get());
+
+  // Waits for a pipelined build still in flight.
+  ~ServerManager();
+
+  ServerManager(const ServerManager&) = delete;
+  ServerManager& operator=(const ServerManager&) = delete;
+
+  // Receives and dispatches everything pending, fires due timeouts and
+  // keep-alives, then builds and sends every client's packet. Pipelined,
+  // it sends the previous tick's packets first and returns with the build
+  // still running.
+  void Tick();
+
+  // Nothing is sent for a client whose stream stays empty.
+  void SetPacketBuilder(PacketBuilder builder) {
+    mPacketBuilder = std::move(builder);
+  }
+
+  void SetPacketBuildPrepare(PacketBuildPrepare prepare) {
+    mPacketBuildPrepare = std::move(prepare);
+  }
+
+  ServerNetworkDriver& GetNetworkDriver() { return mNetworkDriver; }
+  const ServerNetworkDriver& GetNetworkDriver() const { return mNetworkDriver; }
+
+  // Only modify it in PacketBuildPrepare; builders only Write() from it.
+  ReplicationPayloadCache& GetPayloadCache() { return mPayloadCache; }
+
+  // Also available to game code for its own parallel work during the tick.
+  JobSystem& GetJobSystem() { return mJobSystem; }
+
+  uint64_t GetTickCount() const { return mTickCount; }
+
+  // Wall time spent in Tick(), for p50/p99 reporting.
+  const TickTimeHistogram& GetTickTimes() const { return mTickTimes; }
+  void ResetTickTimes() { mTickTimes.Reset(); }
+
+ private:
+  struct PacketTarget {
+    uint32_t clientId;
+    // Tells a client from a new one that took its slot during the build.
+    uint64_t clientSalt;
+  };
+
+  void StartPacketBuild();
+  // Waits for the build, if any, and sends what it produced.
+  void SendBuiltPackets();
+
+  ServerNetworkDriver mNetworkDriver;
+  JobSystem mJobSystem;
+  uint32_t mPacketBuildBatchSize;
+  bool mPipelinePacketBuild;
+  PacketBuilder mPacketBuilder;
+  PacketBuildPrepare mPacketBuildPrepare;
+  ReplicationPayloadCache mPayloadCache;
+  // Indexed by client id.
+  std::vector<OutputMemoryBitStream> mPacketStreams;
+  // The clients of the build in flight.
+  std::vector<PacketTarget> mPacketTargets;
+  Job* mPacketBuildJob{nullptr};
+  uint64_t mTickCount{0};
+  TickTimeHistogram mTickTimes;
+};
+
+}  // namespace GameNet
@@ -10,7 +10,10 @@ GameNet::CircularBuffer::CircularBuffer(size_t blockSize, bool growable)
 GameNet::CircularBuffer::~CircularBuffer() { CleanupTable(); }
 
 GameNet::CircularBuffer::CircularBuffer(const GameNet::CircularBuffer& other)
-    : kBlockSize(other.kBlockSize), kGrowable(other.kGrowable) {
+    : kBlockSize(other.kBlockSize),
+      kGrowable(other.kGrowable),
+      _tableCapacity(0),
+      _table(nullptr) {
   if (this != &other) {
     Copy(other);
   }
@@ -101,7 +104,7 @@ bool GameNet::CircularBuffer::Write(const void* p, size_t size) {
     memcpy(&_table[_hd.n][_hd.m], src + bytes_copied, bytes_to_copy);
 
     bytes_copied += bytes_to_copy;
-    _hd = AdvanceBufferPointer(_hd, bytes_copied);
+    _hd = AdvanceBufferPointer(_hd, bytes_to_copy);
   }
 
   _totalSize += size;
@@ -112,26 +115,11 @@ bool GameNet::CircularBuffer::Write(const void* p, size_t size) {
 bool GameNet::CircularBuffer::Read(void* p, size_t size) {
   if (size == 0) return false;
 
-  uint8_t* dst = reinterpret_cast<uint8_t*>(p);
-
-  // Check overflow.
-  if (_totalSize < size) {
+  if (!Peek(p, size)) {
     return false;
   }
 
-  // Copy the table data to the user dst.
-  size_t bytes_copied = 0;
-  while (bytes_copied < size) {
-    size_t in_block = kBlockSize - _tl.m;
-    size_t bytes_to_copy = std::min(in_block, size - bytes_copied);
-
-    memcpy(dst + bytes_copied, &_table[_tl.n][_tl.m], bytes_to_copy);
-
-    bytes_copied += bytes_to_copy;
-    _tl = AdvanceBufferPointer(_tl, bytes_copied);
-  }
-
-  _totalSize -= size;
+  Discard(size);
 
   // Decrease the table by 2 if usage rate is under 1/4.
   double usage_rate = (double)_totalSize / _totalCapacity;
@@ -159,12 +147,72 @@ bool GameNet::CircularBuffer::Peek(void* p, size_t size) const {
     size_t in_block = kBlockSize - tmp_tl.m;
     size_t bytes_to_copy = std::min(in_block, size - bytes_copied);
 
-    memcpy(dst + bytes_copied, &_table[_tl.n][_tl.m], bytes_to_copy);
+    memcpy(dst + bytes_copied, &_table[tmp_tl.n][tmp_tl.m], bytes_to_copy);
 
     bytes_copied += bytes_to_copy;
-    tmp_tl = AdvanceBufferPointer(tmp_tl, bytes_copied);
+    tmp_tl = AdvanceBufferPointer(tmp_tl, bytes_to_copy);
+  }
+
+  return true;
+}
+
+size_t GameNet::CircularBuffer::PeekSegments(
+    std::span<const uint8_t>* outSegments, size_t maxSegments) const {
+  buf_pointer tmp_tl = _tl;
+  size_t bytes_left = _totalSize;
+  size_t count = 0;
+  while (bytes_left > 0 && count < maxSegments) {
+    size_t in_block = std::min(kBlockSize - tmp_tl.m, bytes_left);
+    outSegments[count++] = {&_table[tmp_tl.n][tmp_tl.m], in_block};
+
+    bytes_left -= in_block;
+    tmp_tl = AdvanceBufferPointer(tmp_tl, in_block);
   }
 
+  return count;
+}
+
+bool GameNet::CircularBuffer::Discard(size_t size) {
+  if (_totalSize < size) {
+    return false;
+  }
+
+  _tl = AdvanceBufferPointer(_tl, size);
+  _totalSize -= size;
+
+  return true;
+}
+
+size_t GameNet::CircularBuffer::ReserveSegments(
+    size_t size, std::span<uint8_t>* outSegments, size_t maxSegments) {
+  if (kGrowable) {
+    while (size > _totalCapacity - _totalSize) {
+      IncreaseTable();
+    }
+  }
+
+  buf_pointer tmp_hd = _hd;
+  size_t bytes_left = std::min(size, _totalCapacity - _totalSize);
+  size_t count = 0;
+  while (bytes_left > 0 && count < maxSegments) {
+    size_t in_block = std::min(kBlockSize - tmp_hd.m, bytes_left);
+    outSegments[count++] = {&_table[tmp_hd.n][tmp_hd.m], in_block};
+
+    bytes_left -= in_block;
+    tmp_hd = AdvanceBufferPointer(tmp_hd, in_block);
+  }
+
+  return count;
+}
+
+bool GameNet::CircularBuffer::Commit(size_t size) {
+  if (size > _totalCapacity - _totalSize) {
+    return false;
+  }
+
+  _hd = AdvanceBufferPointer(_hd, size);
+  _totalSize += size;
+
   return true;
 }
 
@@ -235,85 +283,56 @@ void GameNet::CircularBuffer::Copy(const GameNet::CircularBuffer& other) {
            bytes_to_copy);
 
     bytes_copied += bytes_to_copy;
-    tmp_tl = AdvanceBufferPointer(tmp_tl, bytes_copied);
+    tmp_tl = AdvanceBufferPointer(tmp_tl, bytes_to_copy);
   }
 }
 
 void GameNet::CircularBuffer::IncreaseTable() {
   // 1, 2, 4, 8, ...
-  // Create a new memory table.
-  size_t new_table_cap = _tableCapacity << 1;
-  uint8_t** new_table = (uint8_t**)malloc(new_table_cap * sizeof(uint8_t*));
-  for (size_t i = 0; i < new_table_cap; ++i) {
-    new_table[i] = (uint8_t*)malloc(kBlockSize);
-  }
-
-  // Copy the previous table.
-  size_t bytes_copied = 0;
-  buf_pointer new_hd{0, 0};
-  while (bytes_copied < _totalSize) {
-    size_t in_block = kBlockSize - _tl.m;
-    size_t bytes_to_copy = std::min(in_block, _totalSize - bytes_copied);
-
-    memcpy(&new_table[new_hd.n][new_hd.m], &_table[_tl.n][_tl.m],
-           bytes_to_copy);
-
-    bytes_copied += bytes_to_copy;
-    _tl = AdvanceBufferPointer(_tl, bytes_to_copy);
-    new_hd = AdvanceBufferPointer(new_hd, bytes_to_copy);
-  }
-
-  // Free the previous table.
-  for (size_t i = 0; i < _tableCapacity; ++i) {
-    free(_table[i]);
-  }
-  free(_table);
-
-  // Re-calculate the total capacity.
-  _totalCapacity = kBlockSize * new_table_cap;
-  // Reorder the hd and tl.
-  _hd = new_hd;
-  _tl = {0, 0};
-
-  // Use the new table.
-  _tableCapacity = new_table_cap;
-  _table = new_table;
+  ResizeTable(_tableCapacity << 1);
 }
 
 void GameNet::CircularBuffer::DecreaseTable() {
   if (_tableCapacity == 1) return;
   // If usage rate is 1/4 -> decrease to 1/2.
-  size_t new_table_cap = _tableCapacity >> 1;
+  ResizeTable(_tableCapacity >> 1);
+}
+
+void GameNet::CircularBuffer::ResizeTable(size_t new_table_cap) {
+  // Create a new memory table.
   uint8_t** new_table = (uint8_t**)malloc(new_table_cap * sizeof(uint8_t*));
   for (size_t i = 0; i < new_table_cap; ++i) {
     new_table[i] = (uint8_t*)malloc(kBlockSize);
   }
 
-  // Copy the previous table.
+  // Copy the data to the start of the new table. Each copy stops at the
+  // end of a block on either side, since the data rarely starts on a block
+  // boundary.
   size_t bytes_copied = 0;
-  buf_pointer new_hd{0, 0};
   while (bytes_copied < _totalSize) {
-    size_t in_block = kBlockSize - _tl.m;
-    size_t bytes_to_copy = std::min(in_block, _totalSize - bytes_copied);
+    const size_t dst_n = bytes_copied / kBlockSize;
+    const size_t dst_m = bytes_copied % kBlockSize;
+    size_t bytes_to_copy =
+        std::min({kBlockSize - _tl.m, kBlockSize - dst_m,
+                  _totalSize - bytes_copied});
 
-    memcpy(&new_table[new_hd.n][new_hd.m], &_table[_tl.n][_tl.m],
-           bytes_to_copy);
+    memcpy(&new_table[dst_n][dst_m], &_table[_tl.n][_tl.m], bytes_to_copy);
 
     bytes_copied += bytes_to_copy;
     _tl = AdvanceBufferPointer(_tl, bytes_to_copy);
-    new_hd = AdvanceBufferPointer(new_hd, bytes_to_copy);
   }
 
   // Free the previous table.
-  for (int i = 0; i < _tableCapacity; ++i) {
+  for (size_t i = 0; i < _tableCapacity; ++i) {
     free(_table[i]);
   }
   free(_table);
 
   // Re-calculate the total capacity.
   _totalCapacity = kBlockSize * new_table_cap;
-  // Reorder the hd and tl.
-  _hd = new_hd;
+  // Reorder the hd and tl. The head is past the end of the old capacity
+  // when the buffer was full, so it wraps by the new one.
+  _hd = {(_totalSize / kBlockSize) % new_table_cap, _totalSize % kBlockSize};
   _tl = {0, 0};
 
   // Use the new table.
@@ -0,0 +1,296 @@
+#include "hash/crc32c.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define GAMENET_CRC32C_X64 1
+#include <nmmintrin.h>
+#include <wmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define GAMENET_CRC32C_ARM64 1
+#include <arm_acle.h>
+#endif
+
+namespace {
+
+// Reflected form of the Castagnoli polynomial 0x1EDC6F41.
+constexpr uint32_t kPolynomial = 0x82F63B78;
+
+using SliceTable = std::array<std::array<uint32_t, 256>, 8>;
+
+constexpr SliceTable MakeSliceTable() {
+  SliceTable table{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ ((crc & 1) ? kPolynomial : 0);
+    }
+    table[0][i] = crc;
+  }
+  for (uint32_t i = 0; i < 256; ++i) {
+    for (size_t slice = 1; slice < 8; ++slice) {
+      const uint32_t prev = table[slice - 1][i];
+      table[slice][i] = (prev >> 8) ^ table[0][prev & 0xFF];
+    }
+  }
+  return table;
+}
+
+constexpr SliceTable kSliceTable = MakeSliceTable();
+
+// Both implementations work on the inverted register; Crc32c() inverts.
+uint32_t Crc32cSoftware(const uint8_t* p, size_t size, uint32_t crc) {
+  while (size >= 8) {
+    uint32_t low, high;
+    memcpy(&low, p, sizeof(low));
+    memcpy(&high, p + 4, sizeof(high));
+    low ^= crc;
+    crc = kSliceTable[7][low & 0xFF] ^ kSliceTable[6][(low >> 8) & 0xFF] ^
+          kSliceTable[5][(low >> 16) & 0xFF] ^ kSliceTable[4][low >> 24] ^
+          kSliceTable[3][high & 0xFF] ^ kSliceTable[2][(high >> 8) & 0xFF] ^
+          kSliceTable[1][(high >> 16) & 0xFF] ^ kSliceTable[0][high >> 24];
+    p += 8;
+    size -= 8;
+  }
+
+  while (size-- > 0) {
+    crc = (crc >> 8) ^ kSliceTable[0][(crc ^ *p++) & 0xFF];
+  }
+  return crc;
+}
+
+#if defined(GAMENET_CRC32C_X64)
+
+// crc32 has a 3-cycle latency but 1-cycle throughput, so large inputs are
+// split into three interleaved streams of kStreamBytes each and recombined.
+constexpr size_t kStreamBytes = 128;
+
+// Advances a register over kStreamBytes zero bytes. The CRC is linear, so
+// f(a, X || Y) == Shift(f(a, X)) ^ f(0, Y) when Y is kStreamBytes long.
+struct ShiftTable {
+  std::array<std::array<uint32_t, 256>, 4> table;
+
+  ShiftTable() {
+    const uint8_t zeros[kStreamBytes] = {};
+    for (uint32_t byte = 0; byte < 4; ++byte) {
+      for (uint32_t value = 0; value < 256; ++value) {
+        table[byte][value] =
+            Crc32cSoftware(zeros, kStreamBytes, value << (8 * byte));
+      }
+    }
+  }
+
+  uint32_t Shift(uint32_t crc) const {
+    return table[0][crc & 0xFF] ^ table[1][(crc >> 8) & 0xFF] ^
+           table[2][(crc >> 16) & 0xFF] ^ table[3][crc >> 24];
+  }
+};
+
+const ShiftTable kShiftTable;
+
+#if defined(__GNUC__)
+__attribute__((target("sse4.2")))
+#endif
+uint32_t Crc32cHardware(const uint8_t* p, size_t size, uint32_t crc) {
+  uint64_t crc64 = crc;
+  while (size >= 3 * kStreamBytes) {
+    uint64_t crcB = 0;
+    uint64_t crcC = 0;
+    for (size_t offset = 0; offset < kStreamBytes; offset += 8) {
+      uint64_t wordA, wordB, wordC;
+      memcpy(&wordA, p + offset, sizeof(wordA));
+      memcpy(&wordB, p + kStreamBytes + offset, sizeof(wordB));
+      memcpy(&wordC, p + 2 * kStreamBytes + offset, sizeof(wordC));
+      crc64 = _mm_crc32_u64(crc64, wordA);
+      crcB = _mm_crc32_u64(crcB, wordB);
+      crcC = _mm_crc32_u64(crcC, wordC);
+    }
+    const uint32_t crcAB =
+        kShiftTable.Shift(static_cast<uint32_t>(crc64)) ^
+        static_cast<uint32_t>(crcB);
+    crc64 = kShiftTable.Shift(crcAB) ^ static_cast<uint32_t>(crcC);
+
+    p += 3 * kStreamBytes;
+    size -= 3 * kStreamBytes;
+  }
+
+  while (size >= 8) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    crc64 = _mm_crc32_u64(crc64, word);
+    p += 8;
+    size -= 8;
+  }
+
+  crc = static_cast<uint32_t>(crc64);
+  while (size-- > 0) {
+    crc = _mm_crc32_u8(crc, *p++);
+  }
+  return crc;
+}
+
+// With pclmulqdq the streams can be recombined after any length, so the
+// input is split into three equal streams in one pass and the register is
+// only recombined once per packet instead of once per 384 bytes.
+constexpr size_t kMinClmulStreamWords = 8;
+constexpr size_t kMaxClmulStreamWords = 256;
+
+// Multiplies a reflected register by x.
+constexpr uint32_t MultiplyByX(uint32_t value) {
+  return (value >> 1) ^ ((value & 1) ? kPolynomial : 0);
+}
+
+using ClmulShiftConstants = std::array<uint32_t, 2 * kMaxClmulStreamWords + 1>;
+
+// Entry n is x^(64n - 33) mod P: clmul by it, then crc32 of the product
+// (which multiplies by x^33), advances a register over n zero words.
+constexpr ClmulShiftConstants MakeClmulShiftConstants() {
+  ClmulShiftConstants constants{};
+  uint32_t value = 0x80000000;  // x^0
+  size_t exponent = 0;
+  for (size_t words = 1; words < constants.size(); ++words) {
+    for (; exponent < 64 * words - 33; ++exponent) {
+      value = MultiplyByX(value);
+    }
+    constants[words] = value;
+  }
+  return constants;
+}
+
+constexpr ClmulShiftConstants kClmulShiftConstants = MakeClmulShiftConstants();
+
+#if defined(__GNUC__)
+__attribute__((target("sse4.2,pclmul")))
+#endif
+uint32_t ClmulShift(uint32_t crc, size_t words) {
+  const __m128i product =
+      _mm_clmulepi64_si128(_mm_cvtsi32_si128(static_cast<int>(crc)),
+                           _mm_cvtsi32_si128(static_cast<int>(
+                               kClmulShiftConstants[words])),
+                           0);
+  return static_cast<uint32_t>(
+      _mm_crc32_u64(0, static_cast<uint64_t>(_mm_cvtsi128_si64(product))));
+}
+
+#if defined(__GNUC__)
+__attribute__((target("sse4.2,pclmul")))
+#endif
+uint32_t Crc32cHardwareClmul(const uint8_t* p, size_t size, uint32_t crc) {
+  uint64_t crc64 = crc;
+  while (size >= 3 * 8 * kMinClmulStreamWords) {
+    const size_t words = std::min(size / 24, kMaxClmulStreamWords);
+    const uint8_t* streamB = p + 8 * words;
+    const uint8_t* streamC = p + 16 * words;
+    uint64_t crcB = 0;
+    uint64_t crcC = 0;
+    for (size_t offset = 0; offset < 8 * words; offset += 8) {
+      uint64_t wordA, wordB, wordC;
+      memcpy(&wordA, p + offset, sizeof(wordA));
+      memcpy(&wordB, streamB + offset, sizeof(wordB));
+      memcpy(&wordC, streamC + offset, sizeof(wordC));
+      crc64 = _mm_crc32_u64(crc64, wordA);
+      crcB = _mm_crc32_u64(crcB, wordB);
+      crcC = _mm_crc32_u64(crcC, wordC);
+    }
+    crc64 = ClmulShift(static_cast<uint32_t>(crc64), 2 * words) ^
+            ClmulShift(static_cast<uint32_t>(crcB), words) ^
+            static_cast<uint32_t>(crcC);
+
+    p += 24 * words;
+    size -= 24 * words;
+  }
+
+  while (size >= 8) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    crc64 = _mm_crc32_u64(crc64, word);
+    p += 8;
+    size -= 8;
+  }
+
+  crc = static_cast<uint32_t>(crc64);
+  while (size-- > 0) {
+    crc = _mm_crc32_u8(crc, *p++);
+  }
+  return crc;
+}
+
+bool HasSse42() {
+#if defined(_MSC_VER)
+  int registers[4];
+  __cpuid(registers, 1);
+  return (registers[2] & (1 << 20)) != 0;
+#else
+  return __builtin_cpu_supports("sse4.2");
+#endif
+}
+
+bool HasPclmul() {
+#if defined(_MSC_VER)
+  int registers[4];
+  __cpuid(registers, 1);
+  return (registers[2] & (1 << 1)) != 0;
+#else
+  return __builtin_cpu_supports("pclmul");
+#endif
+}
+
+#elif defined(GAMENET_CRC32C_ARM64)
+
+// The crc32c instructions are part of the target (__ARM_FEATURE_CRC32), so
+// there is nothing to check at run time.
+uint32_t Crc32cHardware(const uint8_t* p, size_t size, uint32_t crc) {
+  while (size >= 8) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    crc = __crc32cd(crc, word);
+    p += 8;
+    size -= 8;
+  }
+
+  while (size-- > 0) {
+    crc = __crc32cb(crc, *p++);
+  }
+  return crc;
+}
+
+#endif
+
+using Crc32cFunction = uint32_t (*)(const uint8_t*, size_t, uint32_t);
+
+Crc32cFunction SelectImplementation() {
+#if defined(GAMENET_CRC32C_X64)
+  if (HasSse42()) {
+    return HasPclmul() ? Crc32cHardwareClmul : Crc32cHardware;
+  }
+#elif defined(GAMENET_CRC32C_ARM64)
+  return Crc32cHardware;
+#endif
+  return Crc32cSoftware;
+}
+
+const Crc32cFunction kCrc32c = SelectImplementation();
+
+}  // namespace
+
+uint32_t GameNet::Crc32c(const void* data, size_t size, uint32_t seed) {
+  // Resolved during static initialisation; a caller running before that
+  // (another static initialiser) gets the table version, which is identical.
+  const Crc32cFunction crc32c = kCrc32c ? kCrc32c : Crc32cSoftware;
+  return ~crc32c(static_cast<const uint8_t*>(data), size, ~seed);
+}
+
+bool GameNet::IsCrc32cHardwareAccelerated() {
+#if defined(GAMENET_CRC32C_X64)
+  return HasSse42();
+#elif defined(GAMENET_CRC32C_ARM64)
+  return true;
+#else
+  return false;
+#endif
+}
@@ -0,0 +1,69 @@
+#include "hash/siphash.h"
+
+#include <bit>
+#include <cstring>
+
+namespace {
+
+inline uint64_t LoadLittleEndian64(const uint8_t* p) {
+  uint64_t value = 0;
+  for (int i = 0; i < 8; ++i) {
+    value |= static_cast<uint64_t>(p[i]) << (8 * i);
+  }
+  return value;
+}
+
+inline void SipRound(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3) {
+  v0 += v1;
+  v1 = std::rotl(v1, 13);
+  v1 ^= v0;
+  v0 = std::rotl(v0, 32);
+  v2 += v3;
+  v3 = std::rotl(v3, 16);
+  v3 ^= v2;
+  v0 += v3;
+  v3 = std::rotl(v3, 21);
+  v3 ^= v0;
+  v2 += v1;
+  v1 = std::rotl(v1, 17);
+  v1 ^= v2;
+  v2 = std::rotl(v2, 32);
+}
+
+}  // namespace
+
+uint64_t GameNet::SipHash24(const SipHashKey& key, const void* data,
+                            size_t size) {
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+
+  uint64_t v0 = 0x736f6d6570736575ULL ^ key.k0;
+  uint64_t v1 = 0x646f72616e646f6dULL ^ key.k1;
+  uint64_t v2 = 0x6c7967656e657261ULL ^ key.k0;
+  uint64_t v3 = 0x7465646279746573ULL ^ key.k1;
+
+  const size_t blockBytes = size & ~static_cast<size_t>(7);
+  for (size_t offset = 0; offset < blockBytes; offset += 8) {
+    const uint64_t m = LoadLittleEndian64(p + offset);
+    v3 ^= m;
+    SipRound(v0, v1, v2, v3);
+    SipRound(v0, v1, v2, v3);
+    v0 ^= m;
+  }
+
+  // Last block: remaining bytes plus the length in the top byte.
+  uint64_t last = static_cast<uint64_t>(size) << 56;
+  for (size_t i = 0; i < (size & 7); ++i) {
+    last |= static_cast<uint64_t>(p[blockBytes + i]) << (8 * i);
+  }
+  v3 ^= last;
+  SipRound(v0, v1, v2, v3);
+  SipRound(v0, v1, v2, v3);
+  v0 ^= last;
+
+  v2 ^= 0xff;
+  for (int i = 0; i < 4; ++i) {
+    SipRound(v0, v1, v2, v3);
+  }
+
+  return v0 ^ v1 ^ v2 ^ v3;
+}
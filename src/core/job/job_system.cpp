@@ -0,0 +1,208 @@
+#include "job/job_system.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace {
+
+// Which JobSystem the current thread works for, and its state there.
+thread_local const GameNet::JobSystem* tJobSystem = nullptr;
+thread_local void* tThreadState = nullptr;
+
+// Failed rounds of stealing before an idle worker goes to sleep.
+constexpr uint32_t kIdleSpinCount = 64;
+
+uint32_t NextRandom(uint32_t& state) {
+  // xorshift32; only spreads thieves over victims.
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+}  // namespace
+
+GameNet::JobSystem::JobSystem(const JobSystemSettings& settings)
+    : mSettings(settings) {
+  mSettings.maxJobsPerThread = std::bit_ceil(
+      mSettings.maxJobsPerThread < 2 ? 2u : mSettings.maxJobsPerThread);
+  mJobMask = mSettings.maxJobsPerThread - 1;
+
+  const uint32_t threadCount = mSettings.workerCount + 1;
+  mThreadStates.reserve(threadCount);
+  for (uint32_t i = 0; i < threadCount; ++i) {
+    mThreadStates.push_back(std::make_unique<ThreadState>(
+        mSettings.maxJobsPerThread, 0x9E3779B9u * (i + 1)));
+  }
+
+  mWorkers.reserve(mSettings.workerCount);
+  for (uint32_t i = 0; i < mSettings.workerCount; ++i) {
+    mWorkers.emplace_back([this, i] { WorkerMain(i + 1); });
+  }
+}
+
+GameNet::JobSystem::~JobSystem() {
+  mRunning.store(false, std::memory_order_seq_cst);
+  mWakeEpoch.fetch_add(1, std::memory_order_seq_cst);
+  mWakeEpoch.notify_all();
+  for (std::thread& worker : mWorkers) {
+    worker.join();
+  }
+}
+
+void GameNet::JobSystem::AddDependency(Job* job, Job* dependency) {
+  assert(dependency->mContinuationCount < Job::kMaxContinuations);
+  job->mPendingDependencies.fetch_add(1, std::memory_order_relaxed);
+  dependency->mContinuations[dependency->mContinuationCount++] = job;
+}
+
+void GameNet::JobSystem::Run(Job* job) {
+  if (job->mPendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    Push(job);
+  }
+}
+
+void GameNet::JobSystem::Wait(const Job* job) {
+  ThreadState& state = GetThreadState();
+  while (!IsFinished(job)) {
+    if (Job* next = FindJob(state)) {
+      Execute(next);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+GameNet::JobSystem::ThreadState& GameNet::JobSystem::GetThreadState() {
+  if (tJobSystem == this) {
+    return *static_cast<ThreadState*>(tThreadState);
+  }
+  return *mThreadStates[0];
+}
+
+bool GameNet::JobSystem::HasFreeJobSlot() {
+  ThreadState& state = GetThreadState();
+  return IsFinished(&state.jobs[state.nextJob & mJobMask]);
+}
+
+GameNet::Job* GameNet::JobSystem::AllocateJob(Job* parent) {
+  ThreadState& state = GetThreadState();
+  Job* job = &state.jobs[state.nextJob++ & mJobMask];
+  // The ring wrapped onto a job still in flight, e.g. a parent that isn't
+  // Run() until all its children are created. Skip it, and once a whole
+  // lap found no free slot, help with queued work before looking again.
+  for (uint32_t busyCount = 0; !IsFinished(job);) {
+    if (++busyCount > mJobMask) {
+      busyCount = 0;
+      if (Job* next = FindJob(state)) {
+        Execute(next);
+      } else {
+        std::this_thread::yield();
+      }
+    }
+    job = &state.jobs[state.nextJob++ & mJobMask];
+  }
+
+  job->mRun = nullptr;
+  job->mDestroy = nullptr;
+  job->mParent = parent;
+  job->mUnfinishedJobs.store(1, std::memory_order_relaxed);
+  job->mPendingDependencies.store(1, std::memory_order_relaxed);
+  job->mContinuationCount = 0;
+  if (parent) {
+    parent->mUnfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+  }
+  return job;
+}
+
+GameNet::Job* GameNet::JobSystem::FindJob(ThreadState& state) {
+  Job* job = nullptr;
+  if (state.queue.Pop(job)) {
+    return job;
+  }
+
+  const uint32_t threadCount = static_cast<uint32_t>(mThreadStates.size());
+  const uint32_t start = NextRandom(state.randomState) % threadCount;
+  for (uint32_t i = 0; i < threadCount; ++i) {
+    ThreadState& victim = *mThreadStates[(start + i) % threadCount];
+    if (&victim != &state && victim.queue.Steal(job)) {
+      return job;
+    }
+  }
+  return nullptr;
+}
+
+void GameNet::JobSystem::Execute(Job* job) {
+  job->mRun(*job);
+  if (job->mDestroy) {
+    job->mDestroy(*job);
+  }
+  Finish(job);
+}
+
+void GameNet::JobSystem::Finish(Job* job) {
+  // Once the count hits zero a waiter may return and the slot be reused, so
+  // everything needed afterwards is read first. None of it changes after
+  // Run().
+  Job* parent = job->mParent;
+  const uint32_t continuationCount = job->mContinuationCount;
+  std::array<Job*, Job::kMaxContinuations> continuations;
+  std::copy_n(job->mContinuations.begin(), continuationCount,
+              continuations.begin());
+
+  if (job->mUnfinishedJobs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+
+  for (uint32_t i = 0; i < continuationCount; ++i) {
+    Run(continuations[i]);
+  }
+  if (parent) {
+    Finish(parent);
+  }
+}
+
+void GameNet::JobSystem::Push(Job* job) {
+  if (!GetThreadState().queue.Push(job)) {
+    // Full: running it here is slower but keeps every job making progress.
+    Execute(job);
+    return;
+  }
+
+  // Pairs with the sleeping count and epoch re-check in WorkerMain(): either
+  // a worker about to sleep sees the new epoch, or this sees it sleeping.
+  mWakeEpoch.fetch_add(1, std::memory_order_seq_cst);
+  if (mSleepingWorkerCount.load(std::memory_order_seq_cst) != 0) {
+    mWakeEpoch.notify_all();
+  }
+}
+
+void GameNet::JobSystem::WorkerMain(uint32_t index) {
+  ThreadState& state = *mThreadStates[index];
+  tJobSystem = this;
+  tThreadState = &state;
+
+  uint32_t idleCount = 0;
+  while (mRunning.load(std::memory_order_relaxed)) {
+    const uint32_t epoch = mWakeEpoch.load(std::memory_order_seq_cst);
+    if (Job* job = FindJob(state)) {
+      Execute(job);
+      idleCount = 0;
+      continue;
+    }
+
+    if (++idleCount < kIdleSpinCount) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    mSleepingWorkerCount.fetch_add(1, std::memory_order_seq_cst);
+    mWakeEpoch.wait(epoch, std::memory_order_seq_cst);
+    mSleepingWorkerCount.fetch_sub(1, std::memory_order_relaxed);
+    idleCount = 0;
+  }
+
+  tJobSystem = nullptr;
+  tThreadState = nullptr;
+}
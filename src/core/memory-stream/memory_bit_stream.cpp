@@ -1,6 +1,7 @@
 #include "memory-stream/memory_bit_stream.h"
 
 #include <cassert>  // TODO: Replace it with custom assert.
+#include <cstring>
 
 GameNet::OutputMemoryBitStream::OutputMemoryBitStream()
     : OutputMemoryBitStream(1200 << 3) {}
@@ -68,6 +69,61 @@ void GameNet::OutputMemoryBitStream::WriteBits(const void* data,
   }
 }
 
+void GameNet::OutputMemoryBitStream::WriteBitsFrom(const uint8_t* data,
+                                                   uint32_t bitCount) {
+  if (bitCount == 0) {
+    return;
+  }
+
+  const uint32_t nextBitHead = mBitHead + bitCount;
+  if (nextBitHead > mBitCapacity) {
+    ReallocBuffer(std::max(mBitCapacity << 1, nextBitHead));
+  }
+
+  uint8_t* dst = mBuffer.data() + (mBitHead >> 3);
+  const uint32_t shift = mBitHead & 0x7;
+  const uint32_t byteCount = bitCount >> 3;
+  const uint32_t tailBitCount = bitCount & 0x7;
+
+  // Bits already written to the first destination byte; the source bytes
+  // are shifted up by as much and the bits shifted out carry into the next.
+  uint32_t carry = dst[0] & ((1u << shift) - 1u);
+  uint32_t byteIndex = 0;
+
+  if constexpr (std::endian::native == std::endian::little) {
+    // Eight bytes at a time: on a little-endian machine the stream's bit
+    // order is the integer's bit order.
+    for (; byteIndex + 8 <= byteCount; byteIndex += 8) {
+      uint64_t word;
+      std::memcpy(&word, data + byteIndex, sizeof(word));
+      const uint64_t shifted = (word << shift) | carry;
+      std::memcpy(dst + byteIndex, &shifted, sizeof(shifted));
+      carry = shift ? static_cast<uint32_t>(word >> (64 - shift)) : 0u;
+    }
+  }
+  for (; byteIndex < byteCount; ++byteIndex) {
+    const uint32_t byte = data[byteIndex];
+    dst[byteIndex] = static_cast<uint8_t>((byte << shift) | carry);
+    carry = byte >> (8 - shift);
+  }
+
+  // carry holds `shift` pending bits; the tail adds up to 7 more.
+  uint32_t pending = carry;
+  uint32_t pendingBitCount = shift;
+  if (tailBitCount) {
+    pending |= (data[byteCount] & ((1u << tailBitCount) - 1u)) << shift;
+    pendingBitCount += tailBitCount;
+  }
+  if (pendingBitCount) {
+    dst[byteCount] = static_cast<uint8_t>(pending);
+    if (pendingBitCount > 8) {
+      dst[byteCount + 1] = static_cast<uint8_t>(pending >> 8);
+    }
+  }
+
+  mBitHead = nextBitHead;
+}
+
 void GameNet::OutputMemoryBitStream::ReallocBuffer(uint32_t newBitCapacity) {
   std::vector<uint8_t> newBuffer((newBitCapacity + 7) >> 3, 0u);
   std::copy(mBuffer.begin(), mBuffer.end(), newBuffer.begin());
@@ -79,15 +135,30 @@ GameNet::InputMemoryBitStream::InputMemoryBitStream()
     : InputMemoryBitStream(1200 << 3) {}
 
 GameNet::InputMemoryBitStream::InputMemoryBitStream(uint32_t bitCapacity)
-    : mBitHead(0),
-      mBitCapacity(bitCapacity),
-      mBuffer(((mBitCapacity + 7) >> 3), 0u) {}
+    : mBuffer(((bitCapacity + 7) >> 3), 0u),
+      mBitHead(0),
+      mBitCapacity(bitCapacity) {}
 
+// mBuffer is initialized first, so the capacity must come from it rather
+// than from the moved-from argument.
 GameNet::InputMemoryBitStream::InputMemoryBitStream(
     std::vector<uint8_t>&& buffer)
-    : mBitHead(0),
-      mBitCapacity(static_cast<uint32_t>(buffer.size()) << 3),
-      mBuffer(std::move(buffer)) {}
+    : mBuffer(std::move(buffer)),
+      mBitHead(0),
+      mBitCapacity(static_cast<uint32_t>(mBuffer.size()) << 3) {}
+
+void GameNet::InputMemoryBitStream::Reset(const void* data,
+                                          uint32_t byteCount) {
+  if (mBuffer.size() < byteCount) {
+    mBuffer.resize(byteCount);
+  }
+  if (byteCount != 0) {
+    memcpy(mBuffer.data(), data, byteCount);
+  }
+  mBitHead = 0;
+  mBitCapacity = byteCount << 3;
+  mOverrun = false;
+}
 
 void GameNet::InputMemoryBitStream::ReadBits(uint8_t& outData,
                                              uint32_t bitCount) {
@@ -99,6 +170,7 @@ void GameNet::InputMemoryBitStream::ReadBits(uint8_t& outData,
   if (nextBitHead > mBitCapacity) {
     outData = 0;
     mBitHead = mBitCapacity;  // clamp
+    mOverrun = true;
     return;
   }
 
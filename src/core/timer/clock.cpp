@@ -0,0 +1,6 @@
+#include "timer/clock.h"
+
+GameNet::SteadyClock& GameNet::SteadyClock::Get() {
+  static SteadyClock clock;
+  return clock;
+}
@@ -0,0 +1,78 @@
+#include "timer/timer_wheel.h"
+
+#include <bit>
+
+GameNet::TimerWheel::TimerWheel(uint32_t timerCapacity,
+                                ClockDuration tickDuration, uint32_t slotCount,
+                                ClockTimePoint startTime)
+    : mTickDuration(tickDuration > ClockDuration::zero()
+                        ? tickDuration
+                        : ClockDuration(1)),
+      mStartTime(startTime) {
+  const uint32_t wheelSize = std::bit_ceil(std::max<uint32_t>(slotCount, 1));
+  mSlotMask = wheelSize - 1;
+  mExpiringSlot = wheelSize;
+  mSlotHeads.assign(wheelSize + 1, kInvalidTimerId);
+  mNodes.resize(timerCapacity);
+}
+
+void GameNet::TimerWheel::Schedule(uint32_t timerId,
+                                   ClockTimePoint expiryTime) {
+  if (IsScheduled(timerId)) {
+    Unlink(timerId);
+  }
+
+  // Never in the past: an overdue timer fires on the next tick.
+  const uint64_t expiryTick = std::max(GetExpiryTick(expiryTime), mCurrentTick + 1);
+  mNodes[timerId].expiryTick = expiryTick;
+  Link(timerId, static_cast<uint32_t>(expiryTick & mSlotMask));
+}
+
+void GameNet::TimerWheel::Cancel(uint32_t timerId) {
+  if (IsScheduled(timerId)) {
+    Unlink(timerId);
+  }
+}
+
+uint64_t GameNet::TimerWheel::GetElapsedTicks(ClockTimePoint time) const {
+  if (time <= mStartTime) {
+    return 0;
+  }
+  return static_cast<uint64_t>((time - mStartTime) / mTickDuration);
+}
+
+uint64_t GameNet::TimerWheel::GetExpiryTick(ClockTimePoint time) const {
+  if (time <= mStartTime) {
+    return 0;
+  }
+  // Rounded up, so a timer never fires early.
+  const ClockDuration elapsed = time - mStartTime;
+  return static_cast<uint64_t>((elapsed + mTickDuration - ClockDuration(1)) /
+                               mTickDuration);
+}
+
+void GameNet::TimerWheel::Link(uint32_t timerId, uint32_t slot) {
+  Node& node = mNodes[timerId];
+  node.slot = slot;
+  node.prev = kInvalidTimerId;
+  node.next = mSlotHeads[slot];
+  if (node.next != kInvalidTimerId) {
+    mNodes[node.next].prev = timerId;
+  }
+  mSlotHeads[slot] = timerId;
+}
+
+void GameNet::TimerWheel::Unlink(uint32_t timerId) {
+  Node& node = mNodes[timerId];
+  if (node.prev != kInvalidTimerId) {
+    mNodes[node.prev].next = node.next;
+  } else {
+    mSlotHeads[node.slot] = node.next;
+  }
+  if (node.next != kInvalidTimerId) {
+    mNodes[node.next].prev = node.prev;
+  }
+  node.prev = kInvalidTimerId;
+  node.next = kInvalidTimerId;
+  node.slot = kUnscheduled;
+}
@@ -0,0 +1,66 @@
+#include "address_rate_limiter.h"
+
+#include <algorithm>
+#include <bit>
+#include <random>
+
+#include "hashed_address.h"
+
+GameNet::AddressRateLimiter::AddressRateLimiter(
+    const AddressRateLimiterSettings& settings)
+    : mSettings(settings) {
+  mSettings.packetsPerSecond = std::max(mSettings.packetsPerSecond, 1e-3);
+  mSettings.burst = std::max(mSettings.burst, 1.0);
+
+  mRefillDuration = std::chrono::duration_cast<ClockDuration>(
+      std::chrono::duration<double>(mSettings.burst /
+                                    mSettings.packetsPerSecond));
+
+  std::random_device randomDevice;
+  mKey.k0 = (static_cast<uint64_t>(randomDevice()) << 32) | randomDevice();
+  mKey.k1 = (static_cast<uint64_t>(randomDevice()) << 32) | randomDevice();
+
+  const size_t bucketCount =
+      std::bit_ceil(std::max<size_t>(mSettings.bucketCount, 1));
+  mBucketMask = bucketCount - 1;
+  mBuckets.resize(bucketCount);
+}
+
+bool GameNet::AddressRateLimiter::Allow(const SocketAddress& address,
+                                        ClockTimePoint currTime) {
+  uint8_t addressBytes[kHashedAddressSize];
+  PacketWriter writer(addressBytes);
+  WriteHashedAddress(writer, address);
+  const uint64_t hash = SipHash24(mKey, addressBytes, writer.GetSize());
+  // The index comes from the high bits, the tag keeps the low ones; forcing
+  // the tag's low bit keeps it non-zero, so an untouched bucket never
+  // matches, without biasing the index.
+  const uint64_t tag = hash | 1;
+  Bucket& bucket = mBuckets[(hash >> 32) & mBucketMask];
+
+  if (bucket.tag != tag) {
+    if (bucket.tag != 0 && currTime - bucket.lastRefillTime < mRefillDuration) {
+      // The current owner is still active; share its budget below.
+    } else {
+      bucket.tag = tag;
+      bucket.tokens = mSettings.burst;
+      bucket.lastRefillTime = currTime;
+    }
+  }
+
+  const double elapsedSeconds =
+      std::chrono::duration<double>(currTime - bucket.lastRefillTime).count();
+  if (elapsedSeconds > 0.0) {
+    bucket.tokens =
+        std::min(mSettings.burst,
+                 bucket.tokens + elapsedSeconds * mSettings.packetsPerSecond);
+    bucket.lastRefillTime = currTime;
+  }
+
+  if (bucket.tokens < 1.0) {
+    return false;
+  }
+
+  bucket.tokens -= 1.0;
+  return true;
+}
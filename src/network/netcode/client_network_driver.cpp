@@ -0,0 +1,194 @@
+#include "client_network_driver.h"
+
+#include <random>
+
+#include "netcode_protocol.h"
+#include "netio/packet_reader.h"
+#include "netio/packet_writer.h"
+#include "payload_packet.h"
+
+GameNet::ClientNetworkDriver::ClientNetworkDriver(
+    std::unique_ptr<INetworkTransportEndpoint> endpoint,
+    const ClientNetworkSettings& settings, const IClock& clock)
+    : mEndpoint(std::move(endpoint)),
+      mSettings(settings),
+      mClock(&clock),
+      mDeliveryNotificationManager(true, true, clock),
+      mPayloadHeaderWriter(kPayloadHeaderMaxSize << 3),
+      mPayloadHeaderReader(kPayloadHeaderMaxSize << 3) {
+  mReceivedPacket.payload.reserve(kNetcodeMaxPacketSize);
+  mSendBuffer.reserve(kNetcodeMaxPacketSize);
+}
+
+void GameNet::ClientNetworkDriver::Connect(const SocketAddress& serverAddress) {
+  Disconnect();
+
+  std::random_device randomDevice;
+  mClientSalt = (static_cast<uint64_t>(randomDevice()) << 32) | randomDevice();
+  mServerAddress = serverAddress;
+  mState = ClientConnectionState::SendingRequest;
+  mDeliveryNotificationManager.Reset();
+
+  const ClockTimePoint currTime = mClock->Now();
+  mConnectStartTime = currTime;
+  mLastReceiveTime = currTime;
+  SendHandshake(currTime);
+}
+
+void GameNet::ClientNetworkDriver::Disconnect() {
+  if (mState == ClientConnectionState::Connected) {
+    const uint8_t disconnect =
+        static_cast<uint8_t>(NetcodePacketType::Disconnect);
+    Send(std::span<const uint8_t>(&disconnect, 1), mClock->Now());
+  }
+  mState = ClientConnectionState::Disconnected;
+}
+
+void GameNet::ClientNetworkDriver::Update() {
+  while (mEndpoint->PollPacket(mReceivedPacket)) {
+    if (mState == ClientConnectionState::Disconnected ||
+        !(mReceivedPacket.sourceAddress == mServerAddress) ||
+        mReceivedPacket.payload.empty()) {
+      continue;
+    }
+    ProcessPacket(mReceivedPacket.payload, mClock->Now());
+  }
+
+  const ClockTimePoint currTime = mClock->Now();
+  switch (mState) {
+    case ClientConnectionState::SendingRequest:
+    case ClientConnectionState::SendingResponse:
+      if (currTime - mConnectStartTime >= mSettings.connectTimeout) {
+        mState = ClientConnectionState::TimedOut;
+      } else if (currTime - mLastSendTime >=
+                 mSettings.handshakeResendInterval) {
+        SendHandshake(currTime);
+      }
+      break;
+    case ClientConnectionState::Connected:
+      if (currTime - mLastReceiveTime >= mSettings.timeout) {
+        mState = ClientConnectionState::TimedOut;
+      } else if (currTime - mLastSendTime >= mSettings.keepAliveInterval) {
+        const uint8_t keepAlive =
+            static_cast<uint8_t>(NetcodePacketType::KeepAlive);
+        Send(std::span<const uint8_t>(&keepAlive, 1), currTime);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+bool GameNet::ClientNetworkDriver::SendPayload(
+    std::span<const uint8_t> payload, int transmissionDataKey,
+    TransmissionDataPtr transmissionData) {
+  if (!IsConnected() || payload.size() > kNetcodeMaxPayloadSize) {
+    return false;
+  }
+
+  mDeliveryNotificationManager.ProcessTimedOutPackets();
+  InFlightPacket* inFlightPacket =
+      WritePayloadPacket(mDeliveryNotificationManager, payload,
+                         mPayloadHeaderWriter, mSendBuffer);
+  if (transmissionData) {
+    inFlightPacket->SetTransmissionData(transmissionDataKey,
+                                        std::move(transmissionData));
+  }
+  return Send(mSendBuffer, mClock->Now());
+}
+
+void GameNet::ClientNetworkDriver::ProcessPacket(
+    std::span<const uint8_t> packet, ClockTimePoint currTime) {
+  PacketReader reader(packet);
+  const NetcodePacketType type = reader.Read<NetcodePacketType>();
+
+  switch (type) {
+    case NetcodePacketType::ConnectionChallenge: {
+      const uint64_t clientSalt = reader.Read<uint64_t>();
+      const uint32_t epoch = reader.Read<uint32_t>();
+      const uint64_t cookie = reader.Read<uint64_t>();
+      if (!reader.IsValid() || clientSalt != mClientSalt ||
+          mState != ClientConnectionState::SendingRequest) {
+        return;
+      }
+      mChallengeEpoch = epoch;
+      mChallengeCookie = cookie;
+      mState = ClientConnectionState::SendingResponse;
+      mLastReceiveTime = currTime;
+      SendHandshake(currTime);
+      return;
+    }
+    case NetcodePacketType::ConnectionAccepted: {
+      const uint64_t clientSalt = reader.Read<uint64_t>();
+      const uint32_t clientId = reader.Read<uint32_t>();
+      if (!reader.IsValid() || clientSalt != mClientSalt ||
+          mState != ClientConnectionState::SendingResponse) {
+        return;
+      }
+      mClientId = clientId;
+      mState = ClientConnectionState::Connected;
+      mLastReceiveTime = currTime;
+      return;
+    }
+    case NetcodePacketType::ConnectionDenied: {
+      const uint64_t clientSalt = reader.Read<uint64_t>();
+      if (!reader.IsValid() || clientSalt != mClientSalt ||
+          mState == ClientConnectionState::Connected) {
+        return;
+      }
+      mState = ClientConnectionState::Denied;
+      return;
+    }
+    default:
+      break;
+  }
+
+  if (mState != ClientConnectionState::Connected) {
+    return;
+  }
+
+  mLastReceiveTime = currTime;
+  switch (type) {
+    case NetcodePacketType::Payload: {
+      std::span<const uint8_t> payload;
+      if (ReadPayloadPacket(mDeliveryNotificationManager, packet,
+                            mPayloadHeaderReader,
+                            payload) == PayloadReadResult::Ok &&
+          mPayloadHandler) {
+        mPayloadHandler(payload);
+      }
+      break;
+    }
+    case NetcodePacketType::Disconnect:
+      mState = ClientConnectionState::Disconnected;
+      break;
+    default:
+      break;
+  }
+}
+
+void GameNet::ClientNetworkDriver::SendHandshake(ClockTimePoint currTime) {
+  uint8_t buffer[kConnectionRequestSize];
+  PacketWriter writer(buffer);
+
+  if (mState == ClientConnectionState::SendingRequest) {
+    writer.Write(NetcodePacketType::ConnectionRequest);
+    writer.Write(mSettings.protocolId);
+    writer.Write(mClientSalt);
+    writer.PadTo(kConnectionRequestSize);
+  } else {
+    writer.Write(NetcodePacketType::ConnectionResponse);
+    writer.Write(mSettings.protocolId);
+    writer.Write(mClientSalt);
+    writer.Write(mChallengeEpoch);
+    writer.Write(mChallengeCookie);
+  }
+
+  Send(writer.GetWrittenBytes(), currTime);
+}
+
+bool GameNet::ClientNetworkDriver::Send(std::span<const uint8_t> packet,
+                                        ClockTimePoint currTime) {
+  mLastSendTime = currTime;
+  return mEndpoint->SendPacket(mServerAddress, packet);
+}
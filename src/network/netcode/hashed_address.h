@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+
+#include "netio/packet_writer.h"
+#include "socket/socket_address.h"
+
+namespace GameNet {
+
+// Keyed hashes of a source address (handshake cookies, rate limiter
+// buckets) cover its raw bytes: family:u8 port:u16 address:16 bytes, an
+// IPv4 address zero padded. SocketAddress::GetHash() is unkeyed and
+// invertible, so an attacker could build many addresses that collide
+// before the keyed hash ever sees them.
+constexpr size_t kHashedAddressSize = 1 + 2 + 16;
+
+inline void WriteHashedAddress(PacketWriter& writer,
+                               const SocketAddress& address) {
+  const size_t startSize = writer.GetSize();
+  writer.Write(static_cast<uint8_t>(address.IsIPv6() ? 6 : 4));
+  writer.Write(address.GetPort());
+  if (address.IsIPv6()) {
+    uint8_t ipv6Address[16];
+    address.GetIPv6Address(ipv6Address);
+    writer.WriteBytes(ipv6Address);
+  } else {
+    writer.Write(address.GetIPv4Address());
+    writer.PadTo(startSize + kHashedAddressSize);
+  }
+}
+
+}  // namespace GameNet
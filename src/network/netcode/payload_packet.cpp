@@ -0,0 +1,51 @@
+#include "payload_packet.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "netcode_protocol.h"
+
+GameNet::InFlightPacket* GameNet::WritePayloadPacket(
+    DeliveryNotificationManager& manager, std::span<const uint8_t> payload,
+    OutputMemoryBitStream& headerStream, std::vector<uint8_t>& outPacket) {
+  headerStream.Reset();
+  headerStream.Write(static_cast<uint8_t>(NetcodePacketType::Payload));
+  InFlightPacket* inFlightPacket = manager.WriteState(headerStream);
+  headerStream.AlignToByte();
+
+  const size_t headerSize = headerStream.GetByteLength();
+  outPacket.resize(headerSize + payload.size());
+  memcpy(outPacket.data(), headerStream.GetBuffer(), headerSize);
+  if (!payload.empty()) {
+    memcpy(outPacket.data() + headerSize, payload.data(), payload.size());
+  }
+  return inFlightPacket;
+}
+
+GameNet::PayloadReadResult GameNet::ReadPayloadPacket(
+    DeliveryNotificationManager& manager, std::span<const uint8_t> packet,
+    InputMemoryBitStream& headerStream, std::span<const uint8_t>& outPayload) {
+  // Type byte, sequence number and ack flag, checked up front so a truncated
+  // packet can't move the sequence number.
+  constexpr size_t kPayloadHeaderMinSize = 1 + (16 + 1 + 7) / 8;
+  if (packet.size() < kPayloadHeaderMinSize) {
+    return PayloadReadResult::Malformed;
+  }
+
+  // The header is never longer than this, so only it is copied.
+  const size_t copySize = std::min(packet.size(), kPayloadHeaderMaxSize);
+  headerStream.Reset(packet.data(), static_cast<uint32_t>(copySize));
+
+  uint8_t type{0};
+  headerStream.Read(type);
+  const bool isNew = manager.ReadAndProcessState(headerStream);
+  if (headerStream.HasOverrun()) {
+    return PayloadReadResult::Malformed;
+  }
+  if (!isNew) {
+    return PayloadReadResult::Stale;
+  }
+
+  outPayload = packet.subspan(headerStream.GetByteLength());
+  return PayloadReadResult::Ok;
+}
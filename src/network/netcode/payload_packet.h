@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "core/memory-stream/memory_bit_stream.h"
+#include "reliability/delivery_notification_manager.h"
+
+namespace GameNet {
+
+// Shared by the server and client drivers; see NetcodePacketType::Payload
+// for the layout. The streams are scratch space kept by the caller, so
+// neither call allocates once they have grown to a packet.
+
+// Fills outPacket with a Payload packet and returns the manager's record of
+// it, to attach TransmissionData to.
+InFlightPacket* WritePayloadPacket(DeliveryNotificationManager& manager,
+                                   std::span<const uint8_t> payload,
+                                   OutputMemoryBitStream& headerStream,
+                                   std::vector<uint8_t>& outPacket);
+
+enum class PayloadReadResult {
+  Ok,
+  Malformed,
+  // Older than a payload already received.
+  Stale,
+};
+
+// Processes the delivery state of a Payload packet and, if Ok, points
+// outPayload at its payload bytes.
+PayloadReadResult ReadPayloadPacket(DeliveryNotificationManager& manager,
+                                    std::span<const uint8_t> packet,
+                                    InputMemoryBitStream& headerStream,
+                                    std::span<const uint8_t>& outPayload);
+
+}  // namespace GameNet
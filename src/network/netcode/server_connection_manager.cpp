@@ -0,0 +1,88 @@
+#include "server_connection_manager.h"
+
+#include <algorithm>
+
+namespace {
+
+// Enough slots that a full timeout fits in one turn of the wheel, so each
+// pending timer is visited about once before it is due.
+uint32_t GetTimerSlotCount(const GameNet::ServerConnectionSettings& settings) {
+  if (settings.timerResolution <= GameNet::ClockDuration::zero()) {
+    return 1;
+  }
+  const GameNet::ClockDuration span =
+      std::max(settings.timeout, settings.keepAliveInterval);
+  const auto slotCount = span / settings.timerResolution + 1;
+  return static_cast<uint32_t>(
+      std::min<decltype(slotCount)>(slotCount, 1 << 16));
+}
+
+}  // namespace
+
+GameNet::ServerConnectionManager::ServerConnectionManager(
+    const ServerConnectionSettings& settings, const IClock& clock)
+    : mSettings(settings),
+      mConnectionIdsByAddress(settings.maxConnections),
+      mTimers(settings.maxConnections * 2, settings.timerResolution,
+              GetTimerSlotCount(settings), clock.Now()) {
+  mConnections.reserve(mSettings.maxConnections);
+  for (uint32_t i = 0; i < mSettings.maxConnections; ++i) {
+    mConnections.emplace_back(clock);
+  }
+  mDenseIndices.assign(mSettings.maxConnections, kInvalidConnectionId);
+  mConnectionIds.reserve(mSettings.maxConnections);
+
+  mFreeConnectionIds.reserve(mSettings.maxConnections);
+  // Hand out low ids first.
+  for (uint32_t connectionId = mSettings.maxConnections; connectionId > 0;
+       --connectionId) {
+    mFreeConnectionIds.push_back(connectionId - 1);
+  }
+}
+
+uint32_t GameNet::ServerConnectionManager::Add(const SocketAddress& address,
+                                               uint64_t clientSalt,
+                                               ClockTimePoint currTime) {
+  if (mFreeConnectionIds.empty()) {
+    return kInvalidConnectionId;
+  }
+
+  const uint32_t connectionId = mFreeConnectionIds.back();
+  mFreeConnectionIds.pop_back();
+
+  ServerConnection& connection = mConnections[connectionId];
+  connection.address = address;
+  connection.clientSalt = clientSalt;
+  connection.lastReceiveTime = currTime;
+  connection.lastSendTime = currTime;
+  connection.deliveryNotificationManager.Reset();
+
+  mDenseIndices[connectionId] = static_cast<uint32_t>(mConnectionIds.size());
+  mConnectionIds.push_back(connectionId);
+  mConnectionIdsByAddress.Insert(address, connectionId);
+
+  mTimers.Schedule(TimeoutTimerId(connectionId), currTime + mSettings.timeout);
+  mTimers.Schedule(KeepAliveTimerId(connectionId),
+                   currTime + mSettings.keepAliveInterval);
+  return connectionId;
+}
+
+void GameNet::ServerConnectionManager::Remove(uint32_t connectionId) {
+  if (!IsConnected(connectionId)) {
+    return;
+  }
+
+  mTimers.Cancel(TimeoutTimerId(connectionId));
+  mTimers.Cancel(KeepAliveTimerId(connectionId));
+  mConnectionIdsByAddress.Erase(mConnections[connectionId].address);
+
+  // Swap-remove from the dense list.
+  const uint32_t denseIndex = mDenseIndices[connectionId];
+  const uint32_t lastConnectionId = mConnectionIds.back();
+  mConnectionIds[denseIndex] = lastConnectionId;
+  mDenseIndices[lastConnectionId] = denseIndex;
+  mConnectionIds.pop_back();
+  mDenseIndices[connectionId] = kInvalidConnectionId;
+
+  mFreeConnectionIds.push_back(connectionId);
+}
@@ -0,0 +1,318 @@
+#include "server_network_driver.h"
+
+#include <algorithm>
+#include <random>
+
+#include "hashed_address.h"
+#include "netcode_protocol.h"
+#include "netio/packet_reader.h"
+#include "netio/packet_writer.h"
+#include "payload_packet.h"
+
+namespace {
+
+GameNet::ServerConnectionSettings MakeConnectionSettings(
+    const GameNet::ServerNetworkSettings& settings) {
+  GameNet::ServerConnectionSettings connectionSettings;
+  connectionSettings.maxConnections = settings.maxClients;
+  connectionSettings.timeout = settings.clientTimeout;
+  connectionSettings.keepAliveInterval = settings.keepAliveInterval;
+  connectionSettings.timerResolution = settings.timerResolution;
+  return connectionSettings;
+}
+
+}  // namespace
+
+GameNet::ServerNetworkDriver::ServerNetworkDriver(
+    std::unique_ptr<INetworkTransportEndpoint> endpoint,
+    const ServerNetworkSettings& settings, const IClock& clock)
+    : mEndpoint(std::move(endpoint)),
+      mSettings(settings),
+      mClock(&clock),
+      mRateLimiter(settings.rateLimiter),
+      mConnections(MakeConnectionSettings(settings), clock),
+      mPayloadHeaderWriter(kPayloadHeaderMaxSize << 3),
+      mPayloadHeaderReader(kPayloadHeaderMaxSize << 3) {
+  if (mSettings.cookieLifetime <= ClockDuration::zero()) {
+    mSettings.cookieLifetime = std::chrono::seconds(10);
+  }
+  mSettings.receiveBatchSize = std::max<size_t>(mSettings.receiveBatchSize, 1);
+
+  std::random_device randomDevice;
+  mCookieKey.k0 =
+      (static_cast<uint64_t>(randomDevice()) << 32) | randomDevice();
+  mCookieKey.k1 =
+      (static_cast<uint64_t>(randomDevice()) << 32) | randomDevice();
+
+  mReceiveBatch.resize(mSettings.receiveBatchSize);
+  for (NetworkReceivedPacket& packet : mReceiveBatch) {
+    packet.payload.reserve(kNetcodeMaxPacketSize);
+  }
+  mSendBuffer.reserve(kNetcodeMaxPacketSize);
+}
+
+void GameNet::ServerNetworkDriver::ReceivePackets() {
+  for (;;) {
+    const size_t count = mEndpoint->PollPackets(mReceiveBatch);
+    if (count == 0) {
+      return;
+    }
+
+    // One clock read per batch.
+    const ClockTimePoint currTime = mClock->Now();
+    for (size_t i = 0; i < count; ++i) {
+      ProcessPacket(mReceiveBatch[i], currTime);
+    }
+
+    if (count < mReceiveBatch.size()) {
+      return;
+    }
+  }
+}
+
+void GameNet::ServerNetworkDriver::Update() {
+  const uint8_t keepAlive = static_cast<uint8_t>(NetcodePacketType::KeepAlive);
+
+  mConnections.Update(
+      mClock->Now(),
+      [this](uint32_t clientId) {
+        ++mStats.timedOutClientCount;
+        RemoveClient(clientId);
+      },
+      [this, &keepAlive](uint32_t clientId) {
+        SendToClient(clientId, std::span<const uint8_t>(&keepAlive, 1));
+      });
+}
+
+bool GameNet::ServerNetworkDriver::SendPayload(
+    uint32_t clientId, std::span<const uint8_t> payload,
+    int transmissionDataKey, TransmissionDataPtr transmissionData) {
+  if (!IsClientConnected(clientId) ||
+      payload.size() > kNetcodeMaxPayloadSize) {
+    return false;
+  }
+
+  // Timed out packets are reported here rather than in Update(), so only
+  // clients that are sent to pay for it.
+  DeliveryNotificationManager& deliveryNotificationManager =
+      mConnections.GetConnection(clientId).deliveryNotificationManager;
+  deliveryNotificationManager.ProcessTimedOutPackets();
+
+  InFlightPacket* inFlightPacket =
+      WritePayloadPacket(deliveryNotificationManager, payload,
+                         mPayloadHeaderWriter, mSendBuffer);
+  if (transmissionData) {
+    inFlightPacket->SetTransmissionData(transmissionDataKey,
+                                        std::move(transmissionData));
+  }
+  return SendToClient(clientId, mSendBuffer);
+}
+
+void GameNet::ServerNetworkDriver::DisconnectClient(uint32_t clientId) {
+  if (!IsClientConnected(clientId)) {
+    return;
+  }
+
+  const uint8_t disconnect =
+      static_cast<uint8_t>(NetcodePacketType::Disconnect);
+  SendToClient(clientId, std::span<const uint8_t>(&disconnect, 1));
+  RemoveClient(clientId);
+}
+
+void GameNet::ServerNetworkDriver::ProcessPacket(
+    const NetworkReceivedPacket& packet, ClockTimePoint currTime) {
+  ++mStats.receivedPacketCount;
+
+  if (packet.payload.empty() ||
+      packet.payload.size() > kNetcodeMaxPacketSize) {
+    ++mStats.malformedPacketCount;
+    return;
+  }
+
+  const uint32_t clientId = mConnections.Find(packet.sourceAddress);
+  if (clientId != ServerConnectionManager::kInvalidConnectionId) {
+    ProcessClientPacket(clientId, packet.payload, currTime);
+    return;
+  }
+
+  // Only unknown addresses are limited: a spoofed flood that lands in the
+  // bucket of a connected client must not starve it.
+  if (!mRateLimiter.Allow(packet.sourceAddress, currTime)) {
+    ++mStats.rateLimitedPacketCount;
+    return;
+  }
+
+  switch (static_cast<NetcodePacketType>(packet.payload[0])) {
+    case NetcodePacketType::ConnectionRequest:
+      ProcessConnectionRequest(packet.sourceAddress, packet.payload, currTime);
+      break;
+    case NetcodePacketType::ConnectionResponse:
+      ProcessConnectionResponse(packet.sourceAddress, packet.payload, currTime);
+      break;
+    default:
+      // Traffic from an address without a connection.
+      ++mStats.malformedPacketCount;
+      break;
+  }
+}
+
+void GameNet::ServerNetworkDriver::ProcessConnectionRequest(
+    const SocketAddress& address, std::span<const uint8_t> packet,
+    ClockTimePoint currTime) {
+  if (packet.size() < kConnectionRequestSize) {
+    ++mStats.malformedPacketCount;
+    return;
+  }
+
+  PacketReader reader(packet.subspan(1));
+  const uint64_t protocolId = reader.Read<uint64_t>();
+  const uint64_t clientSalt = reader.Read<uint64_t>();
+  if (!reader.IsValid() || protocolId != mSettings.protocolId) {
+    ++mStats.malformedPacketCount;
+    return;
+  }
+
+  const uint32_t epoch = GetEpoch(currTime);
+
+  uint8_t buffer[kConnectionChallengeSize];
+  PacketWriter writer(buffer);
+  writer.Write(NetcodePacketType::ConnectionChallenge);
+  writer.Write(clientSalt);
+  writer.Write(epoch);
+  writer.Write(MakeCookie(address, clientSalt, epoch));
+
+  mEndpoint->SendPacket(address, writer.GetWrittenBytes());
+  ++mStats.challengeSentCount;
+}
+
+void GameNet::ServerNetworkDriver::ProcessConnectionResponse(
+    const SocketAddress& address, std::span<const uint8_t> packet,
+    ClockTimePoint currTime) {
+  PacketReader reader(packet.subspan(1));
+  const uint64_t protocolId = reader.Read<uint64_t>();
+  const uint64_t clientSalt = reader.Read<uint64_t>();
+  const uint32_t epoch = reader.Read<uint32_t>();
+  const uint64_t cookie = reader.Read<uint64_t>();
+  if (!reader.IsValid() || protocolId != mSettings.protocolId) {
+    ++mStats.malformedPacketCount;
+    return;
+  }
+
+  // A cookie from the current or previous epoch is accepted, so one issued
+  // just before the epoch rolls over still works.
+  const uint32_t currEpoch = GetEpoch(currTime);
+  if ((epoch != currEpoch && epoch + 1 != currEpoch) ||
+      cookie != MakeCookie(address, clientSalt, epoch)) {
+    ++mStats.invalidCookieCount;
+    return;
+  }
+
+  const uint32_t clientId = mConnections.Add(address, clientSalt, currTime);
+  if (clientId == ServerConnectionManager::kInvalidConnectionId) {
+    ++mStats.deniedConnectionCount;
+    SendDenied(address, clientSalt);
+    return;
+  }
+  ++mStats.acceptedConnectionCount;
+
+  SendAccepted(clientId);
+
+  if (mClientConnectedHandler) {
+    mClientConnectedHandler(clientId);
+  }
+}
+
+void GameNet::ServerNetworkDriver::ProcessClientPacket(
+    uint32_t clientId, std::span<const uint8_t> packet,
+    ClockTimePoint currTime) {
+  mConnections.MarkReceived(clientId, currTime);
+
+  switch (static_cast<NetcodePacketType>(packet[0])) {
+    case NetcodePacketType::Payload: {
+      std::span<const uint8_t> payload;
+      switch (ReadPayloadPacket(
+          mConnections.GetConnection(clientId).deliveryNotificationManager,
+          packet, mPayloadHeaderReader, payload)) {
+        case PayloadReadResult::Ok:
+          if (mPayloadHandler) {
+            mPayloadHandler(clientId, payload);
+          }
+          break;
+        case PayloadReadResult::Malformed:
+          ++mStats.malformedPacketCount;
+          break;
+        case PayloadReadResult::Stale:
+          ++mStats.stalePayloadCount;
+          break;
+      }
+      break;
+    }
+    case NetcodePacketType::KeepAlive:
+      break;
+    case NetcodePacketType::ConnectionResponse:
+      // The client missed our ConnectionAccepted and is still retrying.
+      SendAccepted(clientId);
+      break;
+    case NetcodePacketType::Disconnect:
+      RemoveClient(clientId);
+      break;
+    case NetcodePacketType::ConnectionRequest:
+      // A restarted client on the same address; it can connect again once
+      // the old connection times out.
+      break;
+    default:
+      ++mStats.malformedPacketCount;
+      break;
+  }
+}
+
+uint32_t GameNet::ServerNetworkDriver::GetEpoch(ClockTimePoint currTime) const {
+  return static_cast<uint32_t>(currTime.time_since_epoch() /
+                               mSettings.cookieLifetime);
+}
+
+uint64_t GameNet::ServerNetworkDriver::MakeCookie(const SocketAddress& address,
+                                                  uint64_t clientSalt,
+                                                  uint32_t epoch) const {
+  // address salt:u64 epoch:u32
+  uint8_t buffer[kHashedAddressSize + 8 + 4] = {};
+  PacketWriter writer(buffer);
+  WriteHashedAddress(writer, address);
+  writer.Write(clientSalt);
+  writer.Write(epoch);
+
+  return SipHash24(mCookieKey, buffer, writer.GetSize());
+}
+
+void GameNet::ServerNetworkDriver::SendAccepted(uint32_t clientId) {
+  uint8_t buffer[kConnectionAcceptedSize];
+  PacketWriter writer(buffer);
+  writer.Write(NetcodePacketType::ConnectionAccepted);
+  writer.Write(mConnections.GetConnection(clientId).clientSalt);
+  writer.Write(clientId);
+  SendToClient(clientId, writer.GetWrittenBytes());
+}
+
+void GameNet::ServerNetworkDriver::SendDenied(const SocketAddress& address,
+                                              uint64_t clientSalt) {
+  uint8_t buffer[kConnectionDeniedSize];
+  PacketWriter writer(buffer);
+  writer.Write(NetcodePacketType::ConnectionDenied);
+  writer.Write(clientSalt);
+  mEndpoint->SendPacket(address, writer.GetWrittenBytes());
+}
+
+bool GameNet::ServerNetworkDriver::SendToClient(
+    uint32_t clientId, std::span<const uint8_t> packet) {
+  mConnections.MarkSent(clientId, mClock->Now());
+  return mEndpoint->SendPacket(mConnections.GetConnection(clientId).address,
+                               packet);
+}
+
+void GameNet::ServerNetworkDriver::RemoveClient(uint32_t clientId) {
+  mConnections.Remove(clientId);
+
+  if (mClientDisconnectedHandler) {
+    mClientDisconnectedHandler(clientId);
+  }
+}
@@ -1,12 +1,14 @@
 #include "reliability/ack_range.h"
 
+#include <limits>
+
 bool GameNet::AckRange::MaybePushBack(PacketSequenceNumber sequenceNumber) {
   // Exceeded the max value.
   if (mCount >= std::numeric_limits<uint16_t>::max()) {
     return false;
   }
 
-  if (sequenceNumber == mStart + mCount) {
+  if (sequenceNumber == static_cast<PacketSequenceNumber>(mStart + mCount)) {
     ++mCount;
     return true;
   } else {
@@ -20,7 +22,7 @@ void GameNet::AckRange::WriteBitStream(
   bool hasCount = mCount > 1;
   outputStream.Write(hasCount);
   if (hasCount) {
-    outputStream.Write(mCount - 1);
+    outputStream.Write(static_cast<uint16_t>(mCount - 1));
   }
 }
 
@@ -30,6 +32,7 @@ void GameNet::AckRange::ReadBitStream(InputMemoryBitStream& inputStream) {
   inputStream.Read(hasCount);
   if (hasCount) {
     inputStream.Read(mCount);
+    ++mCount;  // written as count - 1.
   } else {
     // default fallback.
     mCount = 1;
@@ -0,0 +1,148 @@
+#include "reliability/delivery_notification_manager.h"
+
+GameNet::DeliveryNotificationManager::DeliveryNotificationManager(
+    bool inShouldSendAcks, bool inShouldProcessAcks, const IClock& inClock)
+    : mNextOutgoingSequenceNumber(0),
+      mNextExpectedSequenceNumber(0),
+      mShouldSendAcks(inShouldSendAcks),
+      mShouldProcessAcks(inShouldProcessAcks),
+      mDeliveredPacketCount(0),
+      mDroppedPacketCount(0),
+      mDispatchedPacketCount(0),
+      mClock(&inClock),
+      mAckTimeout(kDefaultAckTimeout) {}
+
+GameNet::DeliveryNotificationManager::~DeliveryNotificationManager() = default;
+
+GameNet::InFlightPacket*
+GameNet::DeliveryNotificationManager::WriteSequenceNumber(
+    OutputMemoryBitStream& inOutputStream) {
+  const PacketSequenceNumber sequenceNumber = mNextOutgoingSequenceNumber++;
+  inOutputStream.Write(sequenceNumber);
+
+  ++mDispatchedPacketCount;
+
+  if (mShouldProcessAcks) {
+    mInFlightPackets.emplace_back(sequenceNumber, mClock->Now());
+    return &mInFlightPackets.back();
+  }
+  return nullptr;
+}
+
+void GameNet::DeliveryNotificationManager::WriteAckData(
+    OutputMemoryBitStream& inOutputStream) {
+  // One ack range per packet; if more are pending they go out with the
+  // following packets.
+  const bool hasAcks = !mPendingAcks.empty();
+  inOutputStream.Write(hasAcks);
+  if (hasAcks) {
+    mPendingAcks.front().WriteBitStream(inOutputStream);
+    mPendingAcks.pop_front();
+  }
+}
+
+bool GameNet::DeliveryNotificationManager::ProcessSequenceNumber(
+    InputMemoryBitStream& inInputStream) {
+  PacketSequenceNumber sequenceNumber{0};
+  inInputStream.Read(sequenceNumber);
+
+  if (!IsSequenceLessThan(sequenceNumber, mNextExpectedSequenceNumber)) {
+    // In order, or newer with a gap: the skipped packets count as lost.
+    mNextExpectedSequenceNumber =
+        static_cast<PacketSequenceNumber>(sequenceNumber + 1);
+    if (mShouldSendAcks) {
+      AddPendingAck(sequenceNumber);
+    }
+    return true;
+  }
+
+  // Older than expected: drop it silently.
+  return false;
+}
+
+void GameNet::DeliveryNotificationManager::ProcessAcks(
+    InputMemoryBitStream& inInputStream) {
+  bool hasAcks{false};
+  inInputStream.Read(hasAcks);
+  if (!hasAcks) {
+    return;
+  }
+
+  AckRange ackRange;
+  ackRange.ReadBitStream(inInputStream);
+
+  PacketSequenceNumber nextAckdSequenceNumber = ackRange.GetStart();
+  const PacketSequenceNumber onePastAckdSequenceNumber =
+      static_cast<PacketSequenceNumber>(nextAckdSequenceNumber +
+                                        ackRange.GetCount());
+
+  while (IsSequenceLessThan(nextAckdSequenceNumber,
+                            onePastAckdSequenceNumber) &&
+         !mInFlightPackets.empty()) {
+    const InFlightPacket& nextInFlightPacket = mInFlightPackets.front();
+    const PacketSequenceNumber nextInFlightPacketSequenceNumber =
+        nextInFlightPacket.GetSequenceNumber();
+
+    if (IsSequenceLessThan(nextInFlightPacketSequenceNumber,
+                           nextAckdSequenceNumber)) {
+      // Older than the ack range and never acked: it was lost.
+      InFlightPacket copyOfInFlightPacket = nextInFlightPacket;
+      mInFlightPackets.pop_front();
+      HandlePacketDeliveryFailure(copyOfInFlightPacket);
+    } else if (nextInFlightPacketSequenceNumber == nextAckdSequenceNumber) {
+      HandlePacketDeliverySuccess(nextInFlightPacket);
+      mInFlightPackets.pop_front();
+      ++nextAckdSequenceNumber;
+    } else {
+      // Acks for packets no longer in flight (already timed out); skip them.
+      nextAckdSequenceNumber = nextInFlightPacketSequenceNumber;
+    }
+  }
+}
+
+void GameNet::DeliveryNotificationManager::ProcessTimedOutPackets() {
+  const ClockTimePoint timeoutTime = mClock->Now() - mAckTimeout;
+
+  while (!mInFlightPackets.empty()) {
+    const InFlightPacket& nextInFlightPacket = mInFlightPackets.front();
+
+    // In-flight packets are in dispatch order, so stop at the first one
+    // that hasn't timed out yet.
+    if (nextInFlightPacket.GetTimeDispatched() >= timeoutTime) {
+      break;
+    }
+
+    HandlePacketDeliveryFailure(nextInFlightPacket);
+    mInFlightPackets.pop_front();
+  }
+}
+
+void GameNet::DeliveryNotificationManager::Reset() {
+  mNextOutgoingSequenceNumber = 0;
+  mNextExpectedSequenceNumber = 0;
+  mInFlightPackets.clear();
+  mPendingAcks.clear();
+  mDeliveredPacketCount = 0;
+  mDroppedPacketCount = 0;
+  mDispatchedPacketCount = 0;
+}
+
+void GameNet::DeliveryNotificationManager::AddPendingAck(
+    PacketSequenceNumber inSequenceNumber) {
+  if (mPendingAcks.empty() ||
+      !mPendingAcks.back().MaybePushBack(inSequenceNumber)) {
+    mPendingAcks.emplace_back(inSequenceNumber);
+  }
+}
+
+void GameNet::DeliveryNotificationManager::HandlePacketDeliveryFailure(
+    const InFlightPacket& inFlightPacket) {
+  ++mDroppedPacketCount;
+  inFlightPacket.HandleDeliveryFailure(this);
+}
+
+void GameNet::DeliveryNotificationManager::HandlePacketDeliverySuccess(
+    const InFlightPacket& inFlightPacket) {
+  ++mDeliveredPacketCount;
+  inFlightPacket.HandleDeliverySuccess(this);
+}
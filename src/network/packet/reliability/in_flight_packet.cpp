@@ -0,0 +1,52 @@
+#include "reliability/in_flight_packet.h"
+
+#include "logger/logger.h"
+
+GameNet::InFlightPacket::InFlightPacket(PacketSequenceNumber inSequenceNumber,
+                                        ClockTimePoint inTimeDispatched)
+    : mSequenceNumber(inSequenceNumber), mTimeDispatched(inTimeDispatched) {}
+
+void GameNet::InFlightPacket::SetTransmissionData(
+    int inKey, TransmissionDataPtr inTransmissionData) {
+  for (uint8_t i = 0; i < mTransmissionDataCount; ++i) {
+    if (mTransmissionData[i].key == inKey) {
+      mTransmissionData[i].data = std::move(inTransmissionData);
+      return;
+    }
+  }
+
+  if (mTransmissionDataCount == kMaxTransmissionDataCount) {
+    Logger::Log(LOG_SEVERITY_ERROR,
+                "%s error: more than %zu transmission data keys\n",
+                __FUNCTION__, kMaxTransmissionDataCount);
+    return;
+  }
+  mTransmissionData[mTransmissionDataCount++] = {inKey,
+                                                 std::move(inTransmissionData)};
+}
+
+const GameNet::TransmissionDataPtr GameNet::InFlightPacket::GetTransmissionData(
+    int inKey) const {
+  for (uint8_t i = 0; i < mTransmissionDataCount; ++i) {
+    if (mTransmissionData[i].key == inKey) {
+      return mTransmissionData[i].data;
+    }
+  }
+  return nullptr;
+}
+
+void GameNet::InFlightPacket::HandleDeliveryFailure(
+    DeliveryNotificationManager* inDeliveryNotificationManager) const {
+  for (uint8_t i = 0; i < mTransmissionDataCount; ++i) {
+    mTransmissionData[i].data->HandleDeliveryFailure(
+        inDeliveryNotificationManager);
+  }
+}
+
+void GameNet::InFlightPacket::HandleDeliverySuccess(
+    DeliveryNotificationManager* inDeliveryNotificationManager) const {
+  for (uint8_t i = 0; i < mTransmissionDataCount; ++i) {
+    mTransmissionData[i].data->HandleDeliverySuccess(
+        inDeliveryNotificationManager);
+  }
+}
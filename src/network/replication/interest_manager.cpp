@@ -0,0 +1,145 @@
+#include "interest_manager.h"
+
+#include <cmath>
+
+GameNet::InterestManager::InterestManager(
+    const InterestManagerSettings& settings)
+    : mSettings(settings),
+      mInverseCellSize(1.0f / settings.cellSize),
+      mCellsByKey(settings.expectedObjectCount),
+      mViews(settings.maxConnections) {
+  mObjects.reserve(settings.expectedObjectCount);
+}
+
+void GameNet::InterestManager::AddObject(uint32_t inNetworkId,
+                                         const glm::vec3& position) {
+  const uint32_t row = LinkingContext::GetIndex(inNetworkId);
+  if (row >= mObjects.size()) {
+    mObjects.resize(row + 1);
+    mGathered.Resize(mObjects.size());
+  } else if (mObjects[row].cell != kInvalidCell) {
+    // The slot was reused before its previous object was removed.
+    RemoveObject(mObjects[row].networkId);
+  }
+
+  mObjects[row].networkId = inNetworkId;
+  LinkToCell(row, FindOrAddCell(position), position);
+}
+
+void GameNet::InterestManager::MoveObject(uint32_t inNetworkId,
+                                          const glm::vec3& position) {
+  const uint32_t row = FindRow(inNetworkId);
+  if (row == kInvalidRow) {
+    return;
+  }
+
+  const ObjectEntry& object = mObjects[row];
+  Cell& cell = mCells[object.cell];
+  const glm::ivec3 oldCoord =
+      GetCellCoord(cell.entries[object.indexInCell].position);
+  if (GetCellCoord(position) == oldCoord) {
+    cell.entries[object.indexInCell].position = position;
+    return;
+  }
+
+  UnlinkFromCell(row);
+  LinkToCell(row, FindOrAddCell(position), position);
+}
+
+void GameNet::InterestManager::RemoveObject(uint32_t inNetworkId) {
+  const uint32_t row = FindRow(inNetworkId);
+  if (row == kInvalidRow) {
+    return;
+  }
+
+  UnlinkFromCell(row);
+  mObjects[row].networkId = LinkingContext::kInvalidNetworkId;
+  for (View& view : mViews) {
+    if (row < view.visibleRows.Size()) {
+      view.visibleRows.Reset(row);
+    }
+  }
+}
+
+void GameNet::InterestManager::SetView(uint32_t connectionId,
+                                       const glm::vec3& position,
+                                       float radius) {
+  View& view = mViews[connectionId];
+  view.active = true;
+  view.position = position;
+  view.radius = radius;
+}
+
+void GameNet::InterestManager::RemoveView(uint32_t connectionId) {
+  View& view = mViews[connectionId];
+  view.active = false;
+  view.visibleRows.Clear();
+  view.visibleIds.clear();
+}
+
+bool GameNet::InterestManager::IsVisible(uint32_t connectionId,
+                                         uint32_t inNetworkId) const {
+  const View& view = mViews[connectionId];
+  const uint32_t row = FindRow(inNetworkId);
+  return row != kInvalidRow && row < view.visibleRows.Size() &&
+         view.visibleRows.Test(row);
+}
+
+uint64_t GameNet::InterestManager::GetCellKey(int32_t x, int32_t y,
+                                              int32_t z) {
+  // 21 bits per axis: +-1M cells, far beyond any map.
+  constexpr uint64_t kAxisMask = (uint64_t{1} << 21) - 1;
+  return (static_cast<uint64_t>(x) & kAxisMask) |
+         ((static_cast<uint64_t>(y) & kAxisMask) << 21) |
+         ((static_cast<uint64_t>(z) & kAxisMask) << 42);
+}
+
+glm::ivec3 GameNet::InterestManager::GetCellCoord(
+    const glm::vec3& position) const {
+  const auto toCell = [this](float coordinate) {
+    return static_cast<int32_t>(std::floor(coordinate * mInverseCellSize));
+  };
+  return glm::ivec3(toCell(position.x), toCell(position.y), toCell(position.z));
+}
+
+uint32_t GameNet::InterestManager::FindRow(uint32_t inNetworkId) const {
+  const uint32_t row = LinkingContext::GetIndex(inNetworkId);
+  if (row >= mObjects.size() || mObjects[row].networkId != inNetworkId ||
+      inNetworkId == LinkingContext::kInvalidNetworkId) {
+    return kInvalidRow;
+  }
+  return row;
+}
+
+uint32_t GameNet::InterestManager::FindOrAddCell(const glm::vec3& position) {
+  const glm::ivec3 coord = GetCellCoord(position);
+  const auto [cell, inserted] =
+      mCellsByKey.Insert(GetCellKey(coord.x, coord.y, coord.z),
+                         static_cast<uint32_t>(mCells.size()));
+  if (inserted) {
+    // Cells are never freed; an emptied cell keeps its capacity for the
+    // next object to wander in.
+    mCells.emplace_back();
+  }
+  return *cell;
+}
+
+void GameNet::InterestManager::LinkToCell(uint32_t row, uint32_t cell,
+                                          const glm::vec3& position) {
+  std::vector<CellEntry>& entries = mCells[cell].entries;
+  mObjects[row].cell = cell;
+  mObjects[row].indexInCell = static_cast<uint32_t>(entries.size());
+  entries.push_back({position, row});
+}
+
+void GameNet::InterestManager::UnlinkFromCell(uint32_t row) {
+  ObjectEntry& object = mObjects[row];
+  std::vector<CellEntry>& entries = mCells[object.cell].entries;
+
+  // Swap-remove, fixing up the index of the entry that moved.
+  entries[object.indexInCell] = entries.back();
+  mObjects[entries[object.indexInCell].row].indexInCell = object.indexInCell;
+  entries.pop_back();
+
+  object.cell = kInvalidCell;
+}
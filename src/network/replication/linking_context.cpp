@@ -0,0 +1,100 @@
+#include "linking_context.h"
+
+namespace {
+
+constexpr uint32_t kGenerationMask =
+    (1u << (32 - GameNet::LinkingContext::kIndexBits)) - 1;
+
+// Generation 0 is reserved, so ids never collide with kInvalidNetworkId.
+uint32_t NextGeneration(uint32_t generation) {
+  const uint32_t next = (generation + 1) & kGenerationMask;
+  return next != 0 ? next : 1;
+}
+
+}  // namespace
+
+GameNet::LinkingContext::LinkingContext(uint32_t inExpectedObjectCount)
+    : mNetworkIds(inExpectedObjectCount) {
+  mSlots.reserve(inExpectedObjectCount);
+  mFreeIndices.reserve(inExpectedObjectCount);
+}
+
+uint32_t GameNet::LinkingContext::GetNetworkId(const GameObject* inGameObject,
+                                               bool inShouldCreateIfNotFound) {
+  if (const uint32_t* networkId = mNetworkIds.Find(inGameObject)) {
+    return *networkId;
+  }
+  if (!inShouldCreateIfNotFound) {
+    return kInvalidNetworkId;
+  }
+
+  uint32_t index = kMaxObjects;
+  while (!mFreeIndices.empty()) {
+    const uint32_t freeIndex = mFreeIndices.back();
+    mFreeIndices.pop_back();
+    // Taken by AddGameObject() since it was freed.
+    if (mSlots[freeIndex].gameObject == nullptr) {
+      index = freeIndex;
+      break;
+    }
+  }
+  if (index == kMaxObjects) {
+    if (mSlots.size() == kMaxObjects) {
+      return kInvalidNetworkId;
+    }
+    index = static_cast<uint32_t>(mSlots.size());
+    mSlots.emplace_back();
+  }
+
+  Slot& slot = mSlots[index];
+  slot.gameObject = const_cast<GameObject*>(inGameObject);
+  slot.generation = NextGeneration(slot.generation);
+
+  const uint32_t networkId = MakeNetworkId(index, slot.generation);
+  mNetworkIds.Insert(inGameObject, networkId);
+  return networkId;
+}
+
+void GameNet::LinkingContext::AddGameObject(GameObject* inGameObject,
+                                            uint32_t inNetworkId) {
+  const uint32_t generation = GetGeneration(inNetworkId);
+  if (generation == 0) {
+    return;
+  }
+
+  // The object may be re-linked under a new id, and the id's slot may still
+  // hold an object the remote side has since replaced.
+  if (const uint32_t* oldNetworkId = mNetworkIds.Find(inGameObject)) {
+    Unlink(GetIndex(*oldNetworkId));
+  }
+  const uint32_t index = GetIndex(inNetworkId);
+  if (index >= mSlots.size()) {
+    for (uint32_t i = static_cast<uint32_t>(mSlots.size()); i < index; ++i) {
+      mFreeIndices.push_back(i);
+    }
+    mSlots.resize(index + 1);
+  } else if (mSlots[index].gameObject != nullptr) {
+    Unlink(index);
+  }
+
+  Slot& slot = mSlots[index];
+  slot.gameObject = inGameObject;
+  slot.generation = generation;
+  mNetworkIds.Insert(inGameObject, inNetworkId);
+}
+
+void GameNet::LinkingContext::RemoveGameObject(
+    const GameObject* inGameObject) {
+  if (const uint32_t* networkId = mNetworkIds.Find(inGameObject)) {
+    Unlink(GetIndex(*networkId));
+  }
+}
+
+void GameNet::LinkingContext::Unlink(uint32_t inIndex) {
+  Slot& slot = mSlots[inIndex];
+  mNetworkIds.Erase(slot.gameObject);
+  // The generation is kept; the next owner bumps it, which is what turns
+  // stale ids for this slot into misses.
+  slot.gameObject = nullptr;
+  mFreeIndices.push_back(inIndex);
+}
@@ -0,0 +1,210 @@
+#include "replication_manager.h"
+
+#include <algorithm>
+
+GameNet::ReplicationManager::ReplicationManager(
+    const ReplicationManagerSettings& settings)
+    : mSettings(settings), mConnections(settings.maxConnections) {
+  mObjects.reserve(settings.expectedObjectCount);
+  mConnectionIds.reserve(settings.maxConnections);
+}
+
+void GameNet::ReplicationManager::AddConnection(uint32_t connectionId) {
+  ConnectionState& connection = mConnections[connectionId];
+  if (connection.active) {
+    return;
+  }
+  connection.active = true;
+  // Keeps its capacity from a previous connection with the same id.
+  connection.commands.reserve(mSettings.expectedObjectCount);
+  connection.commands.resize(mObjects.size());
+  connection.dirtyObjects.Resize(mObjects.size());
+  connection.replicatedObjects.Resize(mObjects.size());
+  mConnectionIds.push_back(connectionId);
+
+  if (!mSettings.replicateToAllConnections) {
+    return;
+  }
+  for (uint32_t row = 0; row < mObjects.size(); ++row) {
+    if (mObjects[row].alive) {
+      GetCommand(row, connectionId) =
+          ReplicationCommand(mObjects[row].initialDirtyState);
+      connection.dirtyObjects.Set(row);
+      connection.replicatedObjects.Set(row);
+    }
+  }
+}
+
+void GameNet::ReplicationManager::RemoveConnection(uint32_t connectionId) {
+  ConnectionState& connection = mConnections[connectionId];
+  if (!connection.active) {
+    return;
+  }
+  connection.active = false;
+  // Cleared rather than freed, so whoever takes the connection id next
+  // starts clean without allocating.
+  connection.commands.clear();
+  connection.dirtyObjects.Clear();
+  connection.replicatedObjects.Clear();
+  mConnectionIds.erase(
+      std::find(mConnectionIds.begin(), mConnectionIds.end(), connectionId));
+}
+
+void GameNet::ReplicationManager::ReplicateCreate(
+    uint32_t inNetworkId, const ReplicationDirtyState& inInitialDirtyState) {
+  const uint32_t row = EnsureRow(inNetworkId);
+  ObjectEntry& object = mObjects[row];
+  object.networkId = inNetworkId;
+  object.initialDirtyState = inInitialDirtyState;
+  object.alive = true;
+
+  for (const uint32_t connectionId : mConnectionIds) {
+    ConnectionState& connection = mConnections[connectionId];
+    if (mSettings.replicateToAllConnections) {
+      GetCommand(row, connectionId) = ReplicationCommand(inInitialDirtyState);
+      connection.dirtyObjects.Set(row);
+      connection.replicatedObjects.Set(row);
+    } else {
+      // Whatever a previous occupant of the slot left behind.
+      GetCommand(row, connectionId) = ReplicationCommand();
+      connection.dirtyObjects.Reset(row);
+      connection.replicatedObjects.Reset(row);
+    }
+  }
+}
+
+void GameNet::ReplicationManager::ReplicateDestroy(uint32_t inNetworkId) {
+  const uint32_t row = FindRow(inNetworkId);
+  if (row == kInvalidRow || !mObjects[row].alive) {
+    return;
+  }
+  mObjects[row].alive = false;
+
+  for (const uint32_t connectionId : mConnectionIds) {
+    ConnectionState& connection = mConnections[connectionId];
+    connection.replicatedObjects.Reset(row);
+    ReplicationCommand& command = GetCommand(row, connectionId);
+    if (command.GetAction() != RA_MAX) {
+      command.SetDestroy();
+      connection.dirtyObjects.Set(row);
+    }
+  }
+}
+
+void GameNet::ReplicationManager::AddDirtyState(
+    uint32_t inNetworkId, const ReplicationDirtyState& inState) {
+  const uint32_t row = FindRow(inNetworkId);
+  if (row == kInvalidRow || !mObjects[row].alive || !inState.Any()) {
+    return;
+  }
+
+  for (const uint32_t connectionId : mConnectionIds) {
+    ConnectionState& connection = mConnections[connectionId];
+    if (connection.replicatedObjects.Test(row)) {
+      GetCommand(row, connectionId).AddDirtyState(inState);
+      connection.dirtyObjects.Set(row);
+    }
+  }
+}
+
+void GameNet::ReplicationManager::StartReplicating(uint32_t connectionId,
+                                                   uint32_t inNetworkId) {
+  const uint32_t row = FindRow(inNetworkId);
+  if (row == kInvalidRow || !mObjects[row].alive ||
+      !mConnections[connectionId].active) {
+    return;
+  }
+
+  // Also after a StopReplicating() whose destroy is still in flight: the
+  // client replaces the object it has.
+  ConnectionState& connection = mConnections[connectionId];
+  GetCommand(row, connectionId) =
+      ReplicationCommand(mObjects[row].initialDirtyState);
+  connection.dirtyObjects.Set(row);
+  connection.replicatedObjects.Set(row);
+}
+
+void GameNet::ReplicationManager::StopReplicating(uint32_t connectionId,
+                                                  uint32_t inNetworkId) {
+  const uint32_t row = FindRow(inNetworkId);
+  ConnectionState& connection = mConnections[connectionId];
+  if (row == kInvalidRow || !connection.active) {
+    return;
+  }
+
+  connection.replicatedObjects.Reset(row);
+  ReplicationCommand& command = GetCommand(row, connectionId);
+  if (command.GetAction() != RA_MAX) {
+    command.SetDestroy();
+    connection.dirtyObjects.Set(row);
+  }
+}
+
+void GameNet::ReplicationManager::AddDirtyState(
+    uint32_t connectionId, uint32_t inNetworkId,
+    const ReplicationDirtyState& inState) {
+  const uint32_t row = FindRow(inNetworkId);
+  if (row == kInvalidRow || !mConnections[connectionId].active) {
+    return;
+  }
+
+  ReplicationCommand& command = GetCommand(row, connectionId);
+  if (command.GetAction() == RA_MAX) {
+    return;
+  }
+  if (mConnections[connectionId].replicatedObjects.Test(row)) {
+    command.AddDirtyState(inState);
+  } else {
+    command.SetDestroy();
+  }
+  if (command.HasDirtyState()) {
+    mConnections[connectionId].dirtyObjects.Set(row);
+  }
+}
+
+void GameNet::ReplicationManager::HandleCreateAckd(uint32_t connectionId,
+                                                   uint32_t inNetworkId) {
+  const uint32_t row = FindRow(inNetworkId);
+  if (row != kInvalidRow && mConnections[connectionId].active) {
+    GetCommand(row, connectionId).HandleCreateAckd();
+  }
+}
+
+void GameNet::ReplicationManager::HandleDestroyAckd(uint32_t connectionId,
+                                                    uint32_t inNetworkId) {
+  const uint32_t row = FindRow(inNetworkId);
+  if (row == kInvalidRow || !mConnections[connectionId].active) {
+    return;
+  }
+  // StartReplicating() came after the destroy was sent; the new create still
+  // has to go out.
+  if (mConnections[connectionId].replicatedObjects.Test(row)) {
+    return;
+  }
+  GetCommand(row, connectionId) = ReplicationCommand();
+  mConnections[connectionId].dirtyObjects.Reset(row);
+}
+
+uint32_t GameNet::ReplicationManager::FindRow(uint32_t inNetworkId) const {
+  const uint32_t row = LinkingContext::GetIndex(inNetworkId);
+  if (row >= mObjects.size() || mObjects[row].networkId != inNetworkId ||
+      inNetworkId == LinkingContext::kInvalidNetworkId) {
+    return kInvalidRow;
+  }
+  return row;
+}
+
+uint32_t GameNet::ReplicationManager::EnsureRow(uint32_t inNetworkId) {
+  const uint32_t row = LinkingContext::GetIndex(inNetworkId);
+  if (row >= mObjects.size()) {
+    // LinkingContext hands out slots densely, so this grows by one row at a
+    // time and the vectors' doubling keeps it amortized.
+    mObjects.resize(row + 1);
+    for (const uint32_t connectionId : mConnectionIds) {
+      mConnections[connectionId].commands.resize(mObjects.size());
+      mConnections[connectionId].dirtyObjects.Resize(mObjects.size());
+      mConnections[connectionId].replicatedObjects.Resize(mObjects.size());
+    }
+  }
+  return row;
+}
@@ -0,0 +1,40 @@
+#include "replication_payload_cache.h"
+
+#include <bit>
+
+GameNet::ReplicationPayloadCache::ReplicationPayloadCache(
+    uint32_t expectedEntryCount)
+    : mEntries(expectedEntryCount),
+      // Room for the expected entries at a few dozen bytes each.
+      mArena(expectedEntryCount * 32 * 8) {}
+
+void GameNet::ReplicationPayloadCache::BeginTick() {
+  mEntries.Clear();
+  mArena.Reset();
+}
+
+bool GameNet::ReplicationPayloadCache::Write(
+    OutputMemoryBitStream& outStream, uint32_t inNetworkId,
+    const ReplicationDirtyState& inDirtyState, uint32_t inBaseline) const {
+  const Entry* entry =
+      mEntries.Find(Key{inNetworkId, inDirtyState, inBaseline});
+  if (!entry) {
+    return false;
+  }
+  outStream.WriteBitsFrom(mArena.GetBuffer() + entry->byteOffset,
+                          entry->bitCount);
+  return true;
+}
+
+size_t GameNet::ReplicationPayloadCache::KeyHash::operator()(
+    const Key& key) const {
+  // FlatHashMap mixes the result with a Fibonacci multiply; this only has to
+  // fold the fields together without obvious collisions.
+  uint64_t hash = (static_cast<uint64_t>(key.networkId) << 32) ^ key.baseline;
+  key.dirtyState.ForEachSetWord([&](uint32_t wordIndex) {
+    const uint64_t word = key.dirtyState.GetWord(wordIndex);
+    hash = std::rotl(hash, 23) ^ (word * 0x9E3779B97F4A7C15ull + wordIndex);
+  });
+  hash ^= hash >> 29;
+  return static_cast<size_t>(hash);
+}
@@ -0,0 +1,41 @@
+#include "replication_scheduler.h"
+
+GameNet::ReplicationScheduler::ReplicationScheduler(
+    uint32_t maxConnections, ClockTimePoint startTime,
+    const ReplicationSchedulerSettings& settings)
+    : mSettings(settings), mConnections(maxConnections) {
+  for (uint32_t connectionId = 0; connectionId < maxConnections;
+       ++connectionId) {
+    ResetConnection(connectionId, startTime);
+  }
+}
+
+void GameNet::ReplicationScheduler::ResetConnection(uint32_t connectionId,
+                                                    ClockTimePoint currTime) {
+  ConnectionState& connection = mConnections[connectionId];
+  std::fill(connection.priorities.begin(), connection.priorities.end(), 0.0f);
+  // A new connection may send its first packet right away.
+  connection.availableBits = mSettings.burstBits;
+  connection.lastRefillTime = currTime;
+}
+
+uint32_t GameNet::ReplicationScheduler::Refill(ConnectionState& connection,
+                                               ClockTimePoint currTime) {
+  if (currTime > connection.lastRefillTime) {
+    const double elapsedSeconds =
+        std::chrono::duration<double>(currTime - connection.lastRefillTime)
+            .count();
+    connection.availableBits =
+        std::min<double>(connection.availableBits +
+                             elapsedSeconds * mSettings.bandwidthBitsPerSecond,
+                         mSettings.burstBits);
+    connection.lastRefillTime = currTime;
+  }
+
+  if (connection.availableBits <= 0) {
+    return 0;
+  }
+  return std::min<uint32_t>(
+      mSettings.packetBudgetBits,
+      static_cast<uint32_t>(connection.availableBits));
+}
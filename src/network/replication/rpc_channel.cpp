@@ -0,0 +1,106 @@
+#include "rpc_channel.h"
+
+#include <cstddef>
+
+#include "logger/logger.h"
+
+GameNet::RpcChannel::RpcChannel(const RpcChannelSettings& settings)
+    : mSettings(settings), mQueues(settings.maxConnections) {
+  mRegions.push_back(std::make_unique<ArenaRegion>(settings.arenaRegionBytes));
+}
+
+uint32_t GameNet::RpcChannel::WriteBatch(uint32_t connectionId,
+                                         OutputMemoryBitStream& outStream,
+                                         uint32_t maxBits) {
+  ConnectionQueue& queue = mQueues[connectionId];
+  constexpr size_t kMaxBatchCount = (size_t{1} << kRpcCountBits) - 1;
+
+  uint64_t batchBits = kRpcCountBits;
+  size_t end = queue.head;
+  while (end < queue.records.size() && end - queue.head < kMaxBatchCount &&
+         batchBits + queue.records[end].bitCount <= maxBits) {
+    batchBits += queue.records[end].bitCount;
+    ++end;
+  }
+
+  const uint32_t count = static_cast<uint32_t>(end - queue.head);
+  if (count == 0) {
+    return 0;
+  }
+
+  outStream.Write(count, kRpcCountBits);
+  for (size_t i = queue.head; i < end; ++i) {
+    const Record& record = queue.records[i];
+    outStream.WriteBitsFrom(
+        mRegions[record.region]->stream.GetBuffer() + record.byteOffset,
+        record.bitCount);
+  }
+  Release(queue, count);
+  return count;
+}
+
+void GameNet::RpcChannel::ClearConnection(uint32_t connectionId) {
+  ConnectionQueue& queue = mQueues[connectionId];
+  Release(queue, queue.records.size() - queue.head);
+}
+
+GameNet::OutputMemoryBitStream& GameNet::RpcChannel::PrepareArena() {
+  ArenaRegion* region = mRegions[mCurrentRegion].get();
+  if (region->recordCount.load(std::memory_order_relaxed) == 0) {
+    region->stream.Reset();
+  } else if (region->stream.GetByteLength() >= mSettings.arenaRegionBytes) {
+    // Any drained region will do; they are all the same size.
+    uint32_t next = 0;
+    while (next < mRegions.size() &&
+           mRegions[next]->recordCount.load(std::memory_order_relaxed) != 0) {
+      ++next;
+    }
+    if (next == mRegions.size()) {
+      mRegions.push_back(
+          std::make_unique<ArenaRegion>(mSettings.arenaRegionBytes));
+    }
+    mCurrentRegion = next;
+    region = mRegions[next].get();
+    region->stream.Reset();
+  }
+
+  region->stream.AlignToByte();
+  return region->stream;
+}
+
+bool GameNet::RpcChannel::IsSendable(const Record& record) const {
+  if (uint64_t{kRpcCountBits} + record.bitCount > mSettings.maxBatchBits) {
+    Logger::Log(LOG_SEVERITY_ERROR,
+                "%s error: RPC of %u bits doesn't fit a %u-bit batch\n",
+                __FUNCTION__, record.bitCount, mSettings.maxBatchBits);
+    return false;
+  }
+  return true;
+}
+
+void GameNet::RpcChannel::Enqueue(uint32_t connectionId,
+                                  const Record& record) {
+  mQueues[connectionId].records.push_back(record);
+  mRegions[record.region]->recordCount.fetch_add(1,
+                                                 std::memory_order_relaxed);
+}
+
+void GameNet::RpcChannel::Release(ConnectionQueue& queue, size_t count) {
+  for (size_t i = queue.head; i < queue.head + count; ++i) {
+    mRegions[queue.records[i].region]->recordCount.fetch_sub(
+        1, std::memory_order_relaxed);
+  }
+  queue.head += count;
+  // A queue that never drains completely would otherwise keep every record
+  // it ever held. Dropping the prefix once it is the larger half costs at
+  // most one move per released record.
+  if (queue.head == queue.records.size()) {
+    queue.records.clear();
+    queue.head = 0;
+  } else if (queue.head > queue.records.size() / 2) {
+    queue.records.erase(queue.records.begin(),
+                        queue.records.begin() +
+                            static_cast<std::ptrdiff_t>(queue.head));
+    queue.head = 0;
+  }
+}
@@ -0,0 +1,67 @@
+#include "endpoint/loopback_packet_channel.h"
+
+GameNet::LoopbackPacketChannel::LoopbackPacketChannel(size_t capacity)
+    : mPackets(capacity), mFreeBuffers(capacity) {}
+
+bool GameNet::LoopbackPacketChannel::Send(const SocketAddress& source,
+                                          std::span<const uint8_t> payload) {
+  std::vector<uint8_t> buffer = AcquireBuffer();
+  buffer.assign(payload.begin(), payload.end());
+  return Send(source, std::move(buffer));
+}
+
+bool GameNet::LoopbackPacketChannel::Send(
+    const NetworkReceivedPacket& packet) {
+  NetworkReceivedPacket copy;
+  copy.sourceAddress = packet.sourceAddress;
+  copy.payload = AcquireBuffer();
+  copy.payload.assign(packet.payload.begin(), packet.payload.end());
+  copy.kernelTimestamp = packet.kernelTimestamp;
+  copy.kernelDropCount = packet.kernelDropCount;
+  return mPackets.TryPush(std::move(copy));
+}
+
+bool GameNet::LoopbackPacketChannel::Send(const SocketAddress& source,
+                                          std::vector<uint8_t>&& payload) {
+  NetworkReceivedPacket packet;
+  packet.sourceAddress = source;
+  packet.payload = std::move(payload);
+
+  // A full queue behaves like a full socket buffer: the datagram is dropped.
+  return mPackets.TryPush(std::move(packet));
+}
+
+bool GameNet::LoopbackPacketChannel::Poll(NetworkReceivedPacket& outPacket) {
+  return PollBatch(std::span<NetworkReceivedPacket>(&outPacket, 1)) == 1;
+}
+
+size_t GameNet::LoopbackPacketChannel::PollBatch(
+    std::span<NetworkReceivedPacket> outPackets) {
+  size_t index = 0;
+  return mPackets.PopBatch(
+      outPackets.size(), [this, &outPackets, &index](NetworkReceivedPacket& slot) {
+        NetworkReceivedPacket& outPacket = outPackets[index++];
+        outPacket.sourceAddress = slot.sourceAddress;
+        outPacket.payload.swap(slot.payload);
+        outPacket.kernelTimestamp = slot.kernelTimestamp;
+        outPacket.kernelDropCount = slot.kernelDropCount;
+        RecycleBuffer(std::move(slot.payload));
+      });
+}
+
+std::vector<uint8_t> GameNet::LoopbackPacketChannel::AcquireBuffer() {
+  std::vector<uint8_t> buffer;
+  mFreeBuffers.TryPop(buffer);
+  return buffer;
+}
+
+void GameNet::LoopbackPacketChannel::RecycleBuffer(
+    std::vector<uint8_t>&& buffer) {
+  if (buffer.capacity() == 0) {
+    return;
+  }
+
+  buffer.clear();
+  // If the pool is full the buffer is simply freed.
+  mFreeBuffers.TryPush(std::move(buffer));
+}
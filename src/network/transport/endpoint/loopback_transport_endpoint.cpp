@@ -2,68 +2,51 @@
 
 GameNet::LoopbackTransportEndpoint::ConnectedEndpoints
 GameNet::LoopbackTransportEndpoint::CreateConnectedEndpoints(
-    const SocketAddress& clientAddress, const SocketAddress& serverAddress) {
-  auto sharedBuffer = std::make_shared<SharedMemoryBuffer>();
+    const SocketAddress& clientAddress, const SocketAddress& serverAddress,
+    size_t queueCapacity) {
+  auto sharedChannels = std::make_shared<SharedChannels>(queueCapacity);
 
   ConnectedEndpoints connectedEndpoints;
   connectedEndpoints.clientEndpoint =
-      std::unique_ptr<LoopbackTransportEndpoint>(
-          new LoopbackTransportEndpoint(sharedBuffer, EndpointSide::ClientSide,
-                                        clientAddress, serverAddress));
+      std::unique_ptr<LoopbackTransportEndpoint>(new LoopbackTransportEndpoint(
+          sharedChannels, sharedChannels->packetsForClient,
+          sharedChannels->packetsForServer, clientAddress, serverAddress));
 
   connectedEndpoints.serverEndpoint =
-      std::unique_ptr<LoopbackTransportEndpoint>(
-          new LoopbackTransportEndpoint(sharedBuffer, EndpointSide::ServerSide,
-                                        serverAddress, clientAddress));
+      std::unique_ptr<LoopbackTransportEndpoint>(new LoopbackTransportEndpoint(
+          sharedChannels, sharedChannels->packetsForServer,
+          sharedChannels->packetsForClient, serverAddress, clientAddress));
 
   return connectedEndpoints;
 }
 
+GameNet::LoopbackTransportEndpoint::LoopbackTransportEndpoint(
+    std::shared_ptr<SharedChannels> sharedChannels,
+    LoopbackPacketChannel& incomingChannel,
+    LoopbackPacketChannel& outgoingChannel, const SocketAddress& localAddress,
+    const SocketAddress& peerAddress)
+    : mSharedChannels(std::move(sharedChannels)),
+      mIncomingChannel(incomingChannel),
+      mOutgoingChannel(outgoingChannel),
+      mLocalAddress{localAddress},
+      mPeerAddress{peerAddress} {}
+
 bool GameNet::LoopbackTransportEndpoint::SendPacket(
     const SocketAddress& /*unused*/, std::span<const uint8_t> payload) {
-  if (!mSharedBuffer) {
-    Logger::Log(LOG_SEVERITY_ERROR, "%s error: shared memory buffer is null\n");
-    return false;
-  }
-
-  NetworkReceivedPacket packetForPeer;
-  packetForPeer.sourceAddress = mLocalAddress;
-  packetForPeer.payload.assign(payload.begin(), payload.end());
-
-  {
-    std::scoped_lock lock(mSharedBuffer->m);
-    GetPeerIncomingQueueToWrite().push_back(std::move(packetForPeer));
-  }
+  return mOutgoingChannel.Send(mLocalAddress, payload);
+}
 
-  return true;
+bool GameNet::LoopbackTransportEndpoint::SendPacket(
+    const SocketAddress& /*unused*/, std::vector<uint8_t>&& payload) {
+  return mOutgoingChannel.Send(mLocalAddress, std::move(payload));
 }
 
 bool GameNet::LoopbackTransportEndpoint::PollPacket(
     NetworkReceivedPacket& outPacket) {
-  if (!mSharedBuffer) {
-    Logger::Log(LOG_SEVERITY_ERROR, "%s error: shared memory buffer is null\n");
-    return false;
-  }
-
-  std::scoped_lock lock(mSharedBuffer->m);
-  std::deque<NetworkReceivedPacket>& incomingQueue = GetIncomingQueueToRead();
-  if (incomingQueue.empty()) {
-    return false;
-  }
-
-  outPacket = std::move(incomingQueue.front());
-  incomingQueue.pop_front();
-  return true;
-}
-
-std::deque<GameNet::NetworkReceivedPacket>&
-GameNet::LoopbackTransportEndpoint::GetIncomingQueueToRead() {
-  return (mSide == EndpointSide::ClientSide) ? mSharedBuffer->packetsForClient
-                                             : mSharedBuffer->packetsForServer;
+  return mIncomingChannel.Poll(outPacket);
 }
 
-std::deque<GameNet::NetworkReceivedPacket>&
-GameNet::LoopbackTransportEndpoint::GetPeerIncomingQueueToWrite() {
-  return (mSide == EndpointSide::ClientSide) ? mSharedBuffer->packetsForServer
-                                             : mSharedBuffer->packetsForClient;
+size_t GameNet::LoopbackTransportEndpoint::PollPackets(
+    std::span<NetworkReceivedPacket> outPackets) {
+  return mIncomingChannel.PollBatch(outPackets);
 }
@@ -0,0 +1,277 @@
+#include "endpoint/loopback_transport_hub.h"
+
+#include <algorithm>
+
+#include "connection_table.h"
+
+namespace GameNet {
+
+class LoopbackTransportHub::ServerEndpoint final
+    : public INetworkTransportEndpoint {
+ public:
+  explicit ServerEndpoint(std::shared_ptr<LoopbackTransportHub> hub)
+      : mHub(std::move(hub)) {}
+
+  ~ServerEndpoint() override { mHub->DestroyServerEndpoint(); }
+
+  bool SendPacket(const SocketAddress& dest,
+                  std::span<const uint8_t> payload) override {
+    SyncClientSlots();
+    const size_t* slotIndex = mSlotIndexByAddress.Find(dest);
+    if (!slotIndex) {
+      return false;
+    }
+    return mHub->mClientSlots[*slotIndex]->packetsForClient.Send(
+        mHub->mServerAddress, payload);
+  }
+
+  bool PollPacket(NetworkReceivedPacket& outPacket) override {
+    return PollPackets(std::span<NetworkReceivedPacket>(&outPacket, 1)) == 1;
+  }
+
+  size_t PollPackets(std::span<NetworkReceivedPacket> outPackets) override {
+    SyncClientSlots();
+
+    const size_t slotCount = mPolledSlots.size();
+    if (slotCount == 0) {
+      return 0;
+    }
+
+    // Round-robin from where the previous poll stopped so a chatty client
+    // can't starve the others when the batch fills up.
+    size_t count = 0;
+    bool anyDrained = false;
+    for (size_t visited = 0; visited < slotCount && count < outPackets.size();
+         ++visited) {
+      PolledSlot& polled = mPolledSlots[mNextPollSlot];
+      mNextPollSlot = (mNextPollSlot + 1) % slotCount;
+
+      const std::span<NetworkReceivedPacket> space = outPackets.subspan(count);
+      const size_t polledCount = polled.slot->packetsForServer.PollBatch(space);
+      count += polledCount;
+      if (polled.disconnected && polledCount < space.size()) {
+        polled.drained = true;
+        anyDrained = true;
+      }
+    }
+
+    if (anyDrained) {
+      FreeDrainedSlots();
+    }
+    return count;
+  }
+
+  SocketAddress GetLocalSocketAddress() const override {
+    return mHub->mServerAddress;
+  }
+
+ private:
+  struct PolledSlot {
+    ClientSlot* slot;
+    size_t slotIndex;
+    // The client is gone; the slot is polled until its last packets are read.
+    bool disconnected;
+    bool drained;
+  };
+
+  // Rebuilds this endpoint's view of the slots after clients connected or
+  // disconnected. Costs one atomic load when nothing changed.
+  void SyncClientSlots() {
+    if (mHub->mSlotVersion.load(std::memory_order_acquire) == mSyncedVersion) {
+      return;
+    }
+
+    std::scoped_lock lock(mHub->mConnectMutex);
+    mSyncedVersion = mHub->mSlotVersion.load(std::memory_order_relaxed);
+    mSlotIndexByAddress.Clear();
+    mPolledSlots.clear();
+    for (size_t index = 0; index < mHub->mClientSlots.size(); ++index) {
+      ClientSlot* slot = mHub->mClientSlots[index].get();
+      if (!slot || slot->state == SlotState::kFree) {
+        continue;
+      }
+      const bool disconnected = slot->state == SlotState::kDisconnected;
+      if (!disconnected) {
+        mSlotIndexByAddress.Insert(slot->address, index);
+      }
+      mPolledSlots.push_back({slot, index, disconnected, false});
+    }
+    if (mNextPollSlot >= mPolledSlots.size()) {
+      mNextPollSlot = 0;
+    }
+  }
+
+  // Hands the slots of disconnected clients, now empty and no longer sent
+  // to, back to the hub for reuse.
+  void FreeDrainedSlots() {
+    {
+      std::scoped_lock lock(mHub->mConnectMutex);
+      for (const PolledSlot& polled : mPolledSlots) {
+        if (polled.drained) {
+          polled.slot->state = SlotState::kFree;
+        }
+      }
+    }
+    std::erase_if(mPolledSlots,
+                  [](const PolledSlot& polled) { return polled.drained; });
+    if (mNextPollSlot >= mPolledSlots.size()) {
+      mNextPollSlot = 0;
+    }
+  }
+
+  std::shared_ptr<LoopbackTransportHub> mHub;
+  ConnectionTable<size_t> mSlotIndexByAddress;
+  std::vector<PolledSlot> mPolledSlots;
+  uint64_t mSyncedVersion{0};
+  size_t mNextPollSlot{0};
+};
+
+class LoopbackTransportHub::ClientEndpoint final
+    : public INetworkTransportEndpoint {
+ public:
+  ClientEndpoint(std::shared_ptr<LoopbackTransportHub> hub, size_t slotIndex)
+      : mHub(std::move(hub)),
+        mSlot(*mHub->mClientSlots[slotIndex]),
+        mSlotIndex(slotIndex) {}
+
+  ~ClientEndpoint() override { mHub->DisconnectClient(mSlotIndex); }
+
+  bool SendPacket(const SocketAddress& /*unused*/,
+                  std::span<const uint8_t> payload) override {
+    return mSlot.packetsForServer.Send(mSlot.address, payload);
+  }
+
+  bool PollPacket(NetworkReceivedPacket& outPacket) override {
+    return mSlot.packetsForClient.Poll(outPacket);
+  }
+
+  size_t PollPackets(std::span<NetworkReceivedPacket> outPackets) override {
+    return mSlot.packetsForClient.PollBatch(outPackets);
+  }
+
+  SocketAddress GetLocalSocketAddress() const override { return mSlot.address; }
+
+ private:
+  std::shared_ptr<LoopbackTransportHub> mHub;  // keeps mSlot alive.
+  ClientSlot& mSlot;
+  size_t mSlotIndex;
+};
+
+}  // namespace GameNet
+
+std::shared_ptr<GameNet::LoopbackTransportHub>
+GameNet::LoopbackTransportHub::Create(const SocketAddress& serverAddress,
+                                      size_t maximumClientCount,
+                                      size_t queueCapacity) {
+  if (maximumClientCount == 0) {
+    Logger::Log(LOG_SEVERITY_ERROR,
+                "%s error: maximumClientCount must be positive\n",
+                __FUNCTION__);
+    return nullptr;
+  }
+
+  return std::shared_ptr<LoopbackTransportHub>(new LoopbackTransportHub(
+      serverAddress, maximumClientCount, queueCapacity));
+}
+
+GameNet::LoopbackTransportHub::LoopbackTransportHub(
+    const SocketAddress& serverAddress, size_t maximumClientCount,
+    size_t queueCapacity)
+    : mServerAddress{serverAddress},
+      mQueueCapacity(queueCapacity),
+      mClientSlots(maximumClientCount) {}
+
+std::unique_ptr<GameNet::INetworkTransportEndpoint>
+GameNet::LoopbackTransportHub::CreateServerEndpoint() {
+  std::scoped_lock lock(mConnectMutex);
+  if (mHasServerEndpoint) {
+    Logger::Log(LOG_SEVERITY_ERROR,
+                "%s error: the hub already has a server endpoint\n",
+                __FUNCTION__);
+    return nullptr;
+  }
+
+  mHasServerEndpoint = true;
+  return std::make_unique<ServerEndpoint>(shared_from_this());
+}
+
+std::unique_ptr<GameNet::INetworkTransportEndpoint>
+GameNet::LoopbackTransportHub::ConnectClient(
+    const SocketAddress& clientAddress) {
+  std::scoped_lock lock(mConnectMutex);
+
+  const auto addressTaken = [&clientAddress](
+                                const std::unique_ptr<ClientSlot>& slot) {
+    return slot && slot->state == SlotState::kConnected &&
+           slot->address == clientAddress;
+  };
+  if (clientAddress == mServerAddress ||
+      std::any_of(mClientSlots.begin(), mClientSlots.end(), addressTaken)) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: address %s is already in use\n",
+                __FUNCTION__, clientAddress.ToString().c_str());
+    return nullptr;
+  }
+
+  const auto freeSlot = std::find_if(
+      mClientSlots.begin(), mClientSlots.end(),
+      [](const std::unique_ptr<ClientSlot>& slot) {
+        return !slot || slot->state == SlotState::kFree;
+      });
+  if (freeSlot == mClientSlots.end()) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: hub is full (clients=%zu)\n",
+                __FUNCTION__, mClientCount.load(std::memory_order_relaxed));
+    return nullptr;
+  }
+
+  if (!*freeSlot) {
+    *freeSlot = std::make_unique<ClientSlot>(mQueueCapacity);
+  } else {
+    // Whatever the server sent the previous client is not for this one. The
+    // previous client is gone, so this thread may consume the channel.
+    NetworkReceivedPacket stale;
+    while ((*freeSlot)->packetsForClient.Poll(stale)) {
+    }
+  }
+
+  ClientSlot& slot = **freeSlot;
+  slot.address = clientAddress;
+  slot.state = SlotState::kConnected;
+  mClientCount.fetch_add(1, std::memory_order_relaxed);
+  // Publish the slot to the server thread.
+  mSlotVersion.fetch_add(1, std::memory_order_release);
+
+  return std::make_unique<ClientEndpoint>(
+      shared_from_this(),
+      static_cast<size_t>(freeSlot - mClientSlots.begin()));
+}
+
+void GameNet::LoopbackTransportHub::DisconnectClient(size_t slotIndex) {
+  std::scoped_lock lock(mConnectMutex);
+  ClientSlot& slot = *mClientSlots[slotIndex];
+  // Without a server endpoint nobody can be sending to the slot, and the
+  // next server endpoint must not see the client's leftover packets.
+  if (mHasServerEndpoint) {
+    slot.state = SlotState::kDisconnected;
+  } else {
+    NetworkReceivedPacket stale;
+    while (slot.packetsForServer.Poll(stale)) {
+    }
+    slot.state = SlotState::kFree;
+  }
+  mClientCount.fetch_sub(1, std::memory_order_relaxed);
+  mSlotVersion.fetch_add(1, std::memory_order_release);
+}
+
+void GameNet::LoopbackTransportHub::DestroyServerEndpoint() {
+  std::scoped_lock lock(mConnectMutex);
+  for (const std::unique_ptr<ClientSlot>& slot : mClientSlots) {
+    if (slot && slot->state == SlotState::kDisconnected) {
+      NetworkReceivedPacket stale;
+      while (slot->packetsForServer.Poll(stale)) {
+      }
+      slot->state = SlotState::kFree;
+    }
+  }
+  mHasServerEndpoint = false;
+  mSlotVersion.fetch_add(1, std::memory_order_release);
+}
@@ -1,14 +1,251 @@
 #include "endpoint/network_transport_simulation_proxy.h"
 
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+
+namespace {
+
+using Settings = GameNet::NetworkTransportSimulationSettings;
+
+std::string_view TrimWhitespace(std::string_view text) {
+  const size_t first = text.find_first_not_of(" \t\r\n");
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  const size_t last = text.find_last_not_of(" \t\r\n");
+  return text.substr(first, last - first + 1);
+}
+
+template <typename T>
+bool ParseValue(std::string_view text, T& outValue) {
+  const char* end = text.data() + text.size();
+  auto [ptr, ec] = std::from_chars(text.data(), end, outValue);
+  return ec == std::errc{} && ptr == end;
+}
+
+bool ApplySetting(Settings& settings, std::string_view key,
+                  std::string_view value) {
+  if (key == "profile") {
+    std::optional<Settings> profile = Settings::FromProfile(value);
+    if (!profile) {
+      return false;
+    }
+    settings = *profile;
+    return true;
+  }
+
+  struct DoubleField {
+    std::string_view name;
+    double Settings::*member;
+  };
+  static constexpr DoubleField kDoubleFields[] = {
+      {"baseLatency", &Settings::baseLatency},
+      {"jitter", &Settings::jitter},
+      {"packetLossProbability", &Settings::packetLossProbability},
+      {"burstEnterProbability", &Settings::burstEnterProbability},
+      {"burstExitProbability", &Settings::burstExitProbability},
+      {"burstLossProbability", &Settings::burstLossProbability},
+      {"duplicateProbability", &Settings::duplicateProbability},
+      {"reorderProbability", &Settings::reorderProbability},
+      {"reorderDelay", &Settings::reorderDelay},
+      {"bandwidth", &Settings::bandwidth},
+  };
+
+  for (const DoubleField& field : kDoubleFields) {
+    if (field.name == key) {
+      return ParseValue(value, settings.*field.member);
+    }
+  }
+
+  if (key == "maximumQueuedBytes") {
+    return ParseValue(value, settings.maximumQueuedBytes);
+  }
+  if (key == "randomSeed") {
+    return ParseValue(value, settings.randomSeed);
+  }
+  return false;
+}
+
+}  // namespace
+
+std::optional<GameNet::NetworkTransportSimulationSettings>
+GameNet::NetworkTransportSimulationSettings::FromProfile(
+    std::string_view profileName) {
+  Settings settings;
+  if (profileName == "lan") {
+    settings.baseLatency = 1.0;
+    settings.jitter = 0.5;
+  } else if (profileName == "wifi") {
+    settings.baseLatency = 5.0;
+    settings.jitter = 3.0;
+    settings.packetLossProbability = 0.005;
+  } else if (profileName == "wifi-congested") {
+    settings.baseLatency = 25.0;
+    settings.jitter = 20.0;
+    settings.packetLossProbability = 0.02;
+    settings.burstEnterProbability = 0.01;
+    settings.burstExitProbability = 0.3;
+    settings.burstLossProbability = 0.6;
+    settings.reorderProbability = 0.01;
+    settings.reorderDelay = 10.0;
+    settings.bandwidth = 8000.0;
+    settings.maximumQueuedBytes = 64 * 1024;
+  } else if (profileName == "lte") {
+    settings.baseLatency = 45.0;
+    settings.jitter = 15.0;
+    settings.packetLossProbability = 0.01;
+    settings.burstEnterProbability = 0.005;
+    settings.burstExitProbability = 0.25;
+    settings.burstLossProbability = 0.5;
+    settings.bandwidth = 20000.0;
+    settings.maximumQueuedBytes = 256 * 1024;
+  } else if (profileName == "3g") {
+    settings.baseLatency = 120.0;
+    settings.jitter = 40.0;
+    settings.packetLossProbability = 0.02;
+    settings.duplicateProbability = 0.001;
+    settings.reorderProbability = 0.02;
+    settings.reorderDelay = 30.0;
+    settings.bandwidth = 1500.0;
+    settings.maximumQueuedBytes = 32 * 1024;
+  } else if (profileName == "satellite") {
+    settings.baseLatency = 300.0;
+    settings.jitter = 10.0;
+    settings.packetLossProbability = 0.01;
+    settings.bandwidth = 10000.0;
+  } else {
+    return std::nullopt;
+  }
+  return settings;
+}
+
+std::optional<GameNet::NetworkTransportSimulationSettings>
+GameNet::NetworkTransportSimulationSettings::Parse(
+    std::string_view text, const NetworkTransportSimulationSettings& baseSettings) {
+  Settings settings = baseSettings;
+
+  while (!text.empty()) {
+    const size_t lineEnd = text.find('\n');
+    std::string_view line = TrimWhitespace(text.substr(0, lineEnd));
+    text = (lineEnd == std::string_view::npos) ? std::string_view{}
+                                               : text.substr(lineEnd + 1);
+
+    if (line.empty() || line.front() == '#') {
+      continue;
+    }
+
+    const size_t separator = line.find('=');
+    if (separator == std::string_view::npos) {
+      Logger::Log(LOG_SEVERITY_ERROR, "%s error: expected key = value\n",
+                  __FUNCTION__);
+      return std::nullopt;
+    }
+
+    const std::string_view key = TrimWhitespace(line.substr(0, separator));
+    const std::string_view value = TrimWhitespace(line.substr(separator + 1));
+    if (!ApplySetting(settings, key, value)) {
+      Logger::Log(LOG_SEVERITY_ERROR, "%s error: bad setting '%.*s'\n",
+                  __FUNCTION__, static_cast<int>(line.size()), line.data());
+      return std::nullopt;
+    }
+  }
+
+  return settings;
+}
+
+std::optional<GameNet::NetworkTransportSimulationSettings>
+GameNet::NetworkTransportSimulationSettings::Parse(std::string_view text) {
+  return Parse(text, NetworkTransportSimulationSettings{});
+}
+
+std::optional<GameNet::NetworkTransportSimulationSettings>
+GameNet::NetworkTransportSimulationSettings::LoadProfile(
+    const std::string& filePath, std::string_view profileName) {
+  std::ifstream file(filePath);
+  if (!file) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: cannot open %s\n", __FUNCTION__,
+                filePath.c_str());
+    return std::nullopt;
+  }
+
+  // Collect the body of the requested section.
+  std::string sectionBody;
+  bool inSection = false;
+  bool foundSection = false;
+  std::string line;
+  while (std::getline(file, line)) {
+    const std::string_view trimmed = TrimWhitespace(line);
+    if (!trimmed.empty() && trimmed.front() == '[') {
+      inSection = trimmed.size() >= 2 && trimmed.back() == ']' &&
+                  trimmed.substr(1, trimmed.size() - 2) == profileName;
+      foundSection = foundSection || inSection;
+      continue;
+    }
+    if (inSection) {
+      sectionBody.append(trimmed).push_back('\n');
+    }
+  }
+
+  if (!foundSection) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: no profile [%.*s] in %s\n",
+                __FUNCTION__, static_cast<int>(profileName.size()),
+                profileName.data(), filePath.c_str());
+    return std::nullopt;
+  }
+
+  return Parse(sectionBody);
+}
+
+void GameNet::NetworkTransportSimulationProxy::PacketSchedule::Push(
+    steady_clock::time_point dueTime, const SocketAddress& address,
+    std::span<const uint8_t> payload) {
+  uint32_t packetIndex;
+  if (!mFreePacketIndices.empty()) {
+    packetIndex = mFreePacketIndices.back();
+    mFreePacketIndices.pop_back();
+  } else {
+    packetIndex = static_cast<uint32_t>(mPackets.size());
+    mPackets.emplace_back();
+  }
+
+  NetworkReceivedPacket& packet = mPackets[packetIndex];
+  packet.sourceAddress = address;
+  packet.payload.assign(payload.begin(), payload.end());
+
+  mHeap.push_back(Entry{dueTime, mNextOrder++, packetIndex});
+  std::push_heap(mHeap.begin(), mHeap.end());
+}
+
+void GameNet::NetworkTransportSimulationProxy::PacketSchedule::PopInto(
+    NetworkReceivedPacket& outPacket) {
+  std::pop_heap(mHeap.begin(), mHeap.end());
+  const uint32_t packetIndex = mHeap.back().packetIndex;
+  mHeap.pop_back();
+
+  // Swap so the caller's old buffer stays in the pool.
+  NetworkReceivedPacket& packet = mPackets[packetIndex];
+  outPacket.sourceAddress = packet.sourceAddress;
+  outPacket.payload.swap(packet.payload);
+  mFreePacketIndices.push_back(packetIndex);
+}
+
 GameNet::NetworkTransportSimulationProxy::NetworkTransportSimulationProxy(
     std::unique_ptr<INetworkTransportEndpoint> endpoint,
-    NetworkTransportSimulationSettings settings)
+    NetworkTransportSimulationSettings settings, const IClock& clock)
     : mEndpoint(std::move(endpoint)),
       mSettings(settings),
+      mClock(&clock),
+      mPumpBatch(64),
       mProbabilityDistribution(0.0, 1.0),
       mJitterDistribution(-settings.jitter, settings.jitter) {
-  std::random_device randomDevice;
-  mRandomNumberGenerator = std::mt19937(randomDevice());
+  if (mSettings.randomSeed != 0) {
+    mRandomNumberGenerator.seed(mSettings.randomSeed);
+  } else {
+    std::random_device randomDevice;
+    mRandomNumberGenerator.seed(
+        (static_cast<uint64_t>(randomDevice()) << 32) | randomDevice());
+  }
 
   if (!mEndpoint) {
     Logger::Log(LOG_SEVERITY_ERROR, "%s error: endpoint is null\n",
@@ -16,13 +253,24 @@ GameNet::NetworkTransportSimulationProxy::NetworkTransportSimulationProxy(
   }
 
   // Clamp settings to sensible ranges.
-  mSettings.packetLossProbability =
-      std::clamp(mSettings.packetLossProbability, 0.0, 1.0);
+  auto clampProbability = [](double& probability) {
+    probability = std::clamp(probability, 0.0, 1.0);
+  };
+  clampProbability(mSettings.packetLossProbability);
+  clampProbability(mSettings.burstEnterProbability);
+  clampProbability(mSettings.burstExitProbability);
+  clampProbability(mSettings.burstLossProbability);
+  clampProbability(mSettings.duplicateProbability);
+  clampProbability(mSettings.reorderProbability);
 
   mSettings.baseLatency = std::max(0.0, mSettings.baseLatency);
 
   mSettings.jitter = std::max(0.0, mSettings.jitter);
 
+  mSettings.reorderDelay = std::max(0.0, mSettings.reorderDelay);
+
+  mSettings.bandwidth = std::max(0.0, mSettings.bandwidth);
+
   mJitterDistribution = std::uniform_real_distribution<double>(
       -mSettings.jitter, mSettings.jitter);
 }
@@ -37,97 +285,106 @@ bool GameNet::NetworkTransportSimulationProxy::SendPacket(
 
   FlushScheduledOutgoingPackets();
 
-  if (ShouldDropPacket()) {
-    return true;  // Packet is intentionally dropped.
-  }
-
-  ScheduledOutgoingPacket packet;
-  packet.sendTime = ComputeDeliveryTimePoint();
-  packet.dest = dest;
-  packet.payload.assign(payload.begin(), payload.end());
-
-  mScheduledOutgoingPackets.push_back(std::move(packet));
+  // Dropped packets still count as accepted, like a real lossy link.
+  Impair(mOutgoing, dest, payload);
 
   return true;
 }
 
 bool GameNet::NetworkTransportSimulationProxy::PollPacket(
     NetworkReceivedPacket& recvPacket) {
+  return PollPackets(std::span<NetworkReceivedPacket>(&recvPacket, 1)) == 1;
+}
+
+size_t GameNet::NetworkTransportSimulationProxy::PollPackets(
+    std::span<NetworkReceivedPacket> outPackets) {
   if (!mEndpoint) {
     Logger::Log(LOG_SEVERITY_ERROR, "%s error: endpoint is null\n",
                 __FUNCTION__);
-    return false;
+    return 0;
   }
 
   FlushScheduledOutgoingPackets();
   PumpUnderlyingIncomingPackets();
 
-  if (mScheduledIncomingPackets.empty()) {
-    return false;
-  }
-
   const steady_clock::time_point currTime = GetCurrentTimePoint();
-  if (mScheduledIncomingPackets.front().deliverTime > currTime) {
-    return false;
+  size_t count = 0;
+  while (count < outPackets.size() && mIncoming.schedule.HasDue(currTime)) {
+    mIncoming.schedule.PopInto(outPackets[count++]);
   }
-
-  recvPacket = std::move(mScheduledIncomingPackets.front().recvPacket);
-  mScheduledIncomingPackets.pop_front();
-  return true;
+  return count;
 }
 
 void GameNet::NetworkTransportSimulationProxy::FlushScheduledOutgoingPackets() {
   const steady_clock::time_point currTime = GetCurrentTimePoint();
 
-  // Sort by send time to ensure deterministic delivery if entries were pushed
-  // out-of-order due to jitter.
-  std::sort(mScheduledOutgoingPackets.begin(), mScheduledOutgoingPackets.end(),
-            [](const ScheduledOutgoingPacket& left,
-               const ScheduledOutgoingPacket& right) {
-              return left.sendTime < right.sendTime;
-            });
-
-  while (!mScheduledOutgoingPackets.empty() &&
-         mScheduledOutgoingPackets.front().sendTime <= currTime) {
-    ScheduledOutgoingPacket packet =
-        std::move(mScheduledOutgoingPackets.front());
-    mScheduledOutgoingPackets.pop_front();
-    mEndpoint->SendPacket(packet.dest, packet.payload);
+  // The heap hands packets out in due-time order, so jitter-driven
+  // reordering is preserved without sorting.
+  while (mOutgoing.schedule.HasDue(currTime)) {
+    mOutgoing.schedule.PopInto(mFlushPacket);
+    mEndpoint->SendPacket(mFlushPacket.sourceAddress, mFlushPacket.payload);
   }
 }
 
 void GameNet::NetworkTransportSimulationProxy::PumpUnderlyingIncomingPackets() {
   // Pull all currently available packets from the underlying endpoint and
   // schedule them for delivery.
-  NetworkReceivedPacket recvPacket;
-  while (mEndpoint->PollPacket(recvPacket)) {
-    if (ShouldDropPacket()) {
-      continue;
+  size_t count;
+  do {
+    count = mEndpoint->PollPackets(mPumpBatch);
+    for (size_t i = 0; i < count; ++i) {
+      Impair(mIncoming, mPumpBatch[i].sourceAddress, mPumpBatch[i].payload);
     }
+  } while (count == mPumpBatch.size());
+}
 
-    ScheduledIncomingPacket incomingPacket;
-    incomingPacket.deliverTime = ComputeDeliveryTimePoint();
-    incomingPacket.recvPacket = std::move(recvPacket);
+void GameNet::NetworkTransportSimulationProxy::Impair(
+    Direction& direction, const SocketAddress& address,
+    std::span<const uint8_t> payload) {
+  if (ShouldDropPacket(direction)) {
+    return;
+  }
+
+  const steady_clock::time_point currTime = GetCurrentTimePoint();
+  steady_clock::time_point departureTime = currTime;
+
+  if (mSettings.bandwidth > 0.0) {
+    // Model a single bottleneck queue: the packet leaves once everything
+    // queued before it has been serialized onto the link.
+    const double bytesPerSecond = mSettings.bandwidth * 1000.0 / 8.0;
+    departureTime = std::max(currTime, direction.linkFreeTime);
+
+    if (mSettings.maximumQueuedBytes != 0) {
+      const double backlogSeconds =
+          std::chrono::duration<double>(departureTime - currTime).count();
+      const double queuedBytes = backlogSeconds * bytesPerSecond;
+      if (queuedBytes + static_cast<double>(payload.size()) >
+          static_cast<double>(mSettings.maximumQueuedBytes)) {
+        return;  // Tail drop.
+      }
+    }
 
-    mScheduledIncomingPackets.push_back(std::move(incomingPacket));
-    recvPacket = NetworkReceivedPacket{};
+    const auto transmitTime = std::chrono::duration<double>(
+        static_cast<double>(payload.size()) / bytesPerSecond);
+    departureTime +=
+        std::chrono::duration_cast<steady_clock::duration>(transmitTime);
+    direction.linkFreeTime = departureTime;
   }
 
-  // Sort by delivery time to allow jitter-driven reordering.
-  std::sort(mScheduledIncomingPackets.begin(), mScheduledIncomingPackets.end(),
-            [](const ScheduledIncomingPacket& left,
-               const ScheduledIncomingPacket& right) {
-              return left.deliverTime < right.deliverTime;
-            });
+  direction.schedule.Push(departureTime + ComputeDelay(), address, payload);
+
+  if (RollProbability(mSettings.duplicateProbability)) {
+    direction.schedule.Push(departureTime + ComputeDelay(), address, payload);
+  }
 }
 
 GameNet::NetworkTransportSimulationProxy::steady_clock::time_point
 GameNet::NetworkTransportSimulationProxy::GetCurrentTimePoint() const {
-  return steady_clock::now();
+  return mClock->Now();
 }
 
-GameNet::NetworkTransportSimulationProxy::steady_clock::time_point
-GameNet::NetworkTransportSimulationProxy::ComputeDeliveryTimePoint() {
+GameNet::NetworkTransportSimulationProxy::steady_clock::duration
+GameNet::NetworkTransportSimulationProxy::ComputeDelay() {
   const double jitterOffset = (mSettings.jitter != 0.0)
                                   ? mJitterDistribution(mRandomNumberGenerator)
                                   : 0.0;
@@ -138,13 +395,36 @@ GameNet::NetworkTransportSimulationProxy::ComputeDeliveryTimePoint() {
     totalDelay = 0.0;
   }
 
+  if (RollProbability(mSettings.reorderProbability)) {
+    totalDelay += mSettings.reorderDelay;
+  }
+
   const auto delay = std::chrono::duration<double, std::milli>(totalDelay);
-  return GetCurrentTimePoint() +
-         std::chrono::duration_cast<steady_clock::duration>(delay);
+  return std::chrono::duration_cast<steady_clock::duration>(delay);
 }
 
-bool GameNet::NetworkTransportSimulationProxy::ShouldDropPacket() {
-  const double randomProbability =
-      mProbabilityDistribution(mRandomNumberGenerator);
-  return randomProbability < mSettings.packetLossProbability;
+bool GameNet::NetworkTransportSimulationProxy::ShouldDropPacket(
+    Direction& direction) {
+  if (mSettings.burstEnterProbability > 0.0) {
+    // Advance the two-state Markov chain once per packet.
+    direction.inBurstLoss =
+        direction.inBurstLoss
+            ? !RollProbability(mSettings.burstExitProbability)
+            : RollProbability(mSettings.burstEnterProbability);
+  }
+
+  const double lossProbability = direction.inBurstLoss
+                                     ? mSettings.burstLossProbability
+                                     : mSettings.packetLossProbability;
+  return RollProbability(lossProbability);
+}
+
+bool GameNet::NetworkTransportSimulationProxy::RollProbability(
+    double probability) {
+  if (probability <= 0.0) {
+    // Don't consume a random number, so enabling an unrelated knob doesn't
+    // change the sequence of an existing seeded run.
+    return false;
+  }
+  return mProbabilityDistribution(mRandomNumberGenerator) < probability;
 }
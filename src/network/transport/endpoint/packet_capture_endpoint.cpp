@@ -0,0 +1,118 @@
+#include "endpoint/packet_capture_endpoint.h"
+
+#if !defined(_WIN32)
+
+GameNet::PacketCaptureEndpoint::PacketCaptureEndpoint(
+    std::unique_ptr<INetworkTransportEndpoint> endpoint,
+    std::unique_ptr<PacketCaptureWriter> writer, const IClock& clock)
+    : mEndpoint(std::move(endpoint)),
+      mWriter(std::move(writer)),
+      mClock(&clock),
+      mStartTime(clock.Now()) {}
+
+bool GameNet::PacketCaptureEndpoint::SendPacket(
+    const SocketAddress& dest, std::span<const uint8_t> payload) {
+  if (!mEndpoint->SendPacket(dest, payload)) {
+    return false;
+  }
+
+  Record(PacketCaptureDirection::Sent, dest, payload, GetElapsedTime());
+  return true;
+}
+
+bool GameNet::PacketCaptureEndpoint::PollPacket(
+    NetworkReceivedPacket& outPacket) {
+  if (!mEndpoint->PollPacket(outPacket)) {
+    return false;
+  }
+
+  Record(PacketCaptureDirection::Received, outPacket.sourceAddress,
+         outPacket.payload, GetElapsedTime());
+  return true;
+}
+
+size_t GameNet::PacketCaptureEndpoint::PollPackets(
+    std::span<NetworkReceivedPacket> outPackets) {
+  const size_t count = mEndpoint->PollPackets(outPackets);
+  if (count == 0) {
+    return 0;
+  }
+
+  // One clock read per batch; the datagrams arrived together anyway.
+  const ClockDuration elapsedTime = GetElapsedTime();
+  for (size_t i = 0; i < count; ++i) {
+    Record(PacketCaptureDirection::Received, outPackets[i].sourceAddress,
+           outPackets[i].payload, elapsedTime);
+  }
+  return count;
+}
+
+void GameNet::PacketCaptureEndpoint::Record(PacketCaptureDirection direction,
+                                            const SocketAddress& address,
+                                            std::span<const uint8_t> payload,
+                                            ClockDuration timestamp) {
+  if (!mWriter->Append(direction, address, payload, timestamp)) {
+    Logger::Log(LOG_SEVERITY_ERROR,
+                "%s error: failed to record a packet (address=%s, size=%zu)\n",
+                __FUNCTION__, address.ToString().c_str(), payload.size());
+  }
+}
+
+GameNet::PacketReplayEndpoint::PacketReplayEndpoint(
+    std::unique_ptr<PacketCaptureReader> reader, PacketReplaySpeed speed,
+    const IClock& clock)
+    : mReader(std::move(reader)), mSpeed(speed), mClock(&clock) {
+  Rewind();
+}
+
+bool GameNet::PacketReplayEndpoint::SendPacket(
+    const SocketAddress& /*dest*/, std::span<const uint8_t> /*payload*/) {
+  // Nobody is listening; the server only needs the send to succeed.
+  ++mSentPacketCount;
+  return true;
+}
+
+bool GameNet::PacketReplayEndpoint::PollPacket(
+    NetworkReceivedPacket& outPacket) {
+  if (!mHasNextRecord) {
+    return false;
+  }
+
+  if (mSpeed == PacketReplaySpeed::Recorded) {
+    const ClockTimePoint currTime = mClock->Now();
+    if (!mStarted) {
+      // The recorded timeline starts with the first poll.
+      mStarted = true;
+      mStartTime = currTime - mNextRecord.timestamp;
+    }
+    if (currTime - mStartTime < mNextRecord.timestamp) {
+      return false;
+    }
+  }
+
+  outPacket.sourceAddress = mNextRecord.address;
+  outPacket.payload.assign(mNextRecord.payload.begin(),
+                           mNextRecord.payload.end());
+
+  mHasNextRecord = LoadNextReceivedRecord();
+  mFinished = !mHasNextRecord;
+  return true;
+}
+
+void GameNet::PacketReplayEndpoint::Rewind() {
+  mReader->Rewind();
+  mStarted = false;
+  mHasNextRecord = LoadNextReceivedRecord();
+  mFinished = !mHasNextRecord;
+}
+
+bool GameNet::PacketReplayEndpoint::LoadNextReceivedRecord() {
+  while (mReader->Next(mNextRecord)) {
+    if (mNextRecord.direction == PacketCaptureDirection::Received) {
+      return true;
+    }
+  }
+  return false;
+}
+
+#endif
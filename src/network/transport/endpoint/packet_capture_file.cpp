@@ -0,0 +1,269 @@
+#include "endpoint/packet_capture_file.h"
+
+#if !defined(_WIN32)
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+
+#include "socket/socket_util.h"
+
+namespace {
+
+constexpr uint32_t kCaptureMagic = 0x50434E47;  // "GNCP"
+constexpr uint32_t kCaptureVersion = 1;
+constexpr size_t kRecordAlignment = 8;
+
+struct EncodedAddress {
+  uint16_t port;
+  uint8_t family;
+  uint8_t reserved;
+  uint8_t address[16];  // IPv4 in the first 4 bytes, network byte order.
+};
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t recordCount;
+  uint64_t dataEnd;  // file offset one past the last complete record.
+  EncodedAddress localAddress;
+};
+
+struct RecordHeader {
+  uint64_t timestampNs;
+  uint32_t payloadSize;
+  uint8_t direction;
+  uint8_t reserved[3];
+  EncodedAddress address;
+};
+
+constexpr size_t AlignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+EncodedAddress Encode(const GameNet::SocketAddress& address) {
+  EncodedAddress encoded{};
+  encoded.port = address.GetPort();
+  encoded.family = address.IsIPv6() ? 6 : 4;
+  if (address.IsIPv6()) {
+    address.GetIPv6Address(encoded.address);
+  } else {
+    const uint32_t ip = htonl(address.GetIPv4Address());
+    memcpy(encoded.address, &ip, sizeof(ip));
+  }
+  return encoded;
+}
+
+GameNet::SocketAddress Decode(const EncodedAddress& encoded) {
+  if (encoded.family == 6) {
+    return GameNet::SocketAddress(encoded.address, encoded.port);
+  }
+
+  uint32_t ip;
+  memcpy(&ip, encoded.address, sizeof(ip));
+  return GameNet::SocketAddress(ntohl(ip), encoded.port);
+}
+
+}  // namespace
+
+std::unique_ptr<GameNet::PacketCaptureWriter> GameNet::PacketCaptureWriter::Create(
+    const std::string& path, const SocketAddress& localAddress,
+    size_t growSize) {
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: cannot create %s (error=%d)\n",
+                __FUNCTION__, path.c_str(), SocketUtil::GetLastError());
+    return nullptr;
+  }
+
+  std::unique_ptr<PacketCaptureWriter> writer(new PacketCaptureWriter(
+      fd, std::max(growSize, AlignUp(sizeof(FileHeader), kRecordAlignment))));
+  if (!writer->Map(writer->mGrowSize)) {
+    return nullptr;
+  }
+
+  FileHeader header{};
+  header.magic = kCaptureMagic;
+  header.version = kCaptureVersion;
+  header.dataEnd = AlignUp(sizeof(FileHeader), kRecordAlignment);
+  header.localAddress = Encode(localAddress);
+  memcpy(writer->mMapping, &header, sizeof(header));
+  writer->mWriteOffset = header.dataEnd;
+
+  return writer;
+}
+
+GameNet::PacketCaptureWriter::PacketCaptureWriter(int fileDescriptor,
+                                                  size_t growSize)
+    : mFileDescriptor(fileDescriptor), mGrowSize(growSize) {}
+
+GameNet::PacketCaptureWriter::~PacketCaptureWriter() {
+  if (mMapping != nullptr) {
+    munmap(mMapping, mMappedSize);
+    if (ftruncate(mFileDescriptor, static_cast<off_t>(mWriteOffset)) != 0) {
+      Logger::Log(LOG_SEVERITY_WARNING, "%s: failed to trim capture file\n",
+                  __FUNCTION__);
+    }
+  }
+  close(mFileDescriptor);
+}
+
+bool GameNet::PacketCaptureWriter::Append(PacketCaptureDirection direction,
+                                          const SocketAddress& address,
+                                          std::span<const uint8_t> payload,
+                                          ClockDuration timestamp) {
+  const size_t recordSize =
+      AlignUp(sizeof(RecordHeader) + payload.size(), kRecordAlignment);
+  if (mWriteOffset + recordSize > mMappedSize) {
+    const size_t newSize =
+        std::max(mMappedSize + mGrowSize, mWriteOffset + recordSize);
+    if (!Map(newSize)) {
+      return false;
+    }
+  }
+
+  RecordHeader record{};
+  record.timestampNs = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp).count());
+  record.payloadSize = static_cast<uint32_t>(payload.size());
+  record.direction = static_cast<uint8_t>(direction);
+  record.address = Encode(address);
+
+  uint8_t* dst = mMapping + mWriteOffset;
+  memcpy(dst, &record, sizeof(record));
+  if (!payload.empty()) {
+    memcpy(dst + sizeof(record), payload.data(), payload.size());
+  }
+  mWriteOffset += recordSize;
+
+  // Commit the record only after its bytes are in place.
+  FileHeader* header = reinterpret_cast<FileHeader*>(mMapping);
+  header->recordCount += 1;
+  header->dataEnd = mWriteOffset;
+
+  return true;
+}
+
+uint64_t GameNet::PacketCaptureWriter::GetRecordCount() const {
+  return reinterpret_cast<const FileHeader*>(mMapping)->recordCount;
+}
+
+bool GameNet::PacketCaptureWriter::Map(size_t size) {
+  if (mMapping != nullptr) {
+    munmap(mMapping, mMappedSize);
+    mMapping = nullptr;
+    mMappedSize = 0;
+  }
+
+  if (ftruncate(mFileDescriptor, static_cast<off_t>(size)) != 0) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: ftruncate failed (error=%d)\n",
+                __FUNCTION__, SocketUtil::GetLastError());
+    return false;
+  }
+
+  void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                       mFileDescriptor, 0);
+  if (mapping == MAP_FAILED) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: mmap failed (error=%d)\n",
+                __FUNCTION__, SocketUtil::GetLastError());
+    return false;
+  }
+
+  mMapping = static_cast<uint8_t*>(mapping);
+  mMappedSize = size;
+  return true;
+}
+
+std::unique_ptr<GameNet::PacketCaptureReader> GameNet::PacketCaptureReader::Open(
+    const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: cannot open %s (error=%d)\n",
+                __FUNCTION__, path.c_str(), SocketUtil::GetLastError());
+    return nullptr;
+  }
+
+  struct stat status;
+  if (fstat(fd, &status) != 0 ||
+      static_cast<size_t>(status.st_size) < sizeof(FileHeader)) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: %s is not a capture file\n",
+                __FUNCTION__, path.c_str());
+    close(fd);
+    return nullptr;
+  }
+
+  const size_t size = static_cast<size_t>(status.st_size);
+  void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps the file alive.
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: mmap failed (error=%d)\n",
+                __FUNCTION__, SocketUtil::GetLastError());
+    return nullptr;
+  }
+
+  FileHeader header;
+  memcpy(&header, mapping, sizeof(header));
+  if (header.magic != kCaptureMagic || header.version != kCaptureVersion ||
+      header.dataEnd > size) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: %s is not a capture file\n",
+                __FUNCTION__, path.c_str());
+    munmap(mapping, size);
+    return nullptr;
+  }
+
+  // Captures are read front to back.
+  madvise(mapping, size, MADV_SEQUENTIAL);
+
+  return std::unique_ptr<PacketCaptureReader>(
+      new PacketCaptureReader(static_cast<const uint8_t*>(mapping), size));
+}
+
+GameNet::PacketCaptureReader::PacketCaptureReader(const uint8_t* mapping,
+                                                  size_t mappedSize)
+    : mMapping(mapping), mMappedSize(mappedSize) {
+  FileHeader header;
+  memcpy(&header, mMapping, sizeof(header));
+  mDataEnd = header.dataEnd;
+  mRecordCount = header.recordCount;
+  mLocalAddress = Decode(header.localAddress);
+  Rewind();
+}
+
+GameNet::PacketCaptureReader::~PacketCaptureReader() {
+  munmap(const_cast<uint8_t*>(mMapping), mMappedSize);
+}
+
+bool GameNet::PacketCaptureReader::Next(PacketCaptureRecord& outRecord) {
+  if (mReadOffset + sizeof(RecordHeader) > mDataEnd) {
+    return false;
+  }
+
+  RecordHeader record;
+  memcpy(&record, mMapping + mReadOffset, sizeof(record));
+
+  const size_t payloadOffset = mReadOffset + sizeof(record);
+  if (payloadOffset + record.payloadSize > mDataEnd) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: truncated record\n",
+                __FUNCTION__);
+    mReadOffset = mDataEnd;
+    return false;
+  }
+
+  outRecord.timestamp = std::chrono::duration_cast<ClockDuration>(
+      std::chrono::nanoseconds(record.timestampNs));
+  outRecord.direction = static_cast<PacketCaptureDirection>(record.direction);
+  outRecord.address = Decode(record.address);
+  outRecord.payload = {mMapping + payloadOffset, record.payloadSize};
+
+  mReadOffset +=
+      AlignUp(sizeof(record) + record.payloadSize, kRecordAlignment);
+  return true;
+}
+
+void GameNet::PacketCaptureReader::Rewind() {
+  mReadOffset = AlignUp(sizeof(FileHeader), kRecordAlignment);
+}
+
+#endif
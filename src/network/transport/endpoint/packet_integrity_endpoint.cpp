@@ -0,0 +1,107 @@
+#include "endpoint/packet_integrity_endpoint.h"
+
+#include <cstring>
+#include <utility>
+
+#include "core/hash/crc32c.h"
+
+namespace {
+
+// Trailer bytes are little-endian on every platform.
+void StoreTrailer(uint8_t* dst, uint32_t crc) {
+  dst[0] = static_cast<uint8_t>(crc);
+  dst[1] = static_cast<uint8_t>(crc >> 8);
+  dst[2] = static_cast<uint8_t>(crc >> 16);
+  dst[3] = static_cast<uint8_t>(crc >> 24);
+}
+
+uint32_t LoadTrailer(const uint8_t* src) {
+  return static_cast<uint32_t>(src[0]) |
+         (static_cast<uint32_t>(src[1]) << 8) |
+         (static_cast<uint32_t>(src[2]) << 16) |
+         (static_cast<uint32_t>(src[3]) << 24);
+}
+
+}  // namespace
+
+GameNet::PacketIntegrityEndpoint::PacketIntegrityEndpoint(
+    std::unique_ptr<INetworkTransportEndpoint> endpoint, uint64_t protocolId)
+    : mEndpoint(std::move(endpoint)) {
+  uint8_t protocolIdBytes[sizeof(protocolId)];
+  for (size_t i = 0; i < sizeof(protocolId); ++i) {
+    protocolIdBytes[i] = static_cast<uint8_t>(protocolId >> (8 * i));
+  }
+  mSeed = Crc32c(protocolIdBytes, sizeof(protocolIdBytes));
+}
+
+bool GameNet::PacketIntegrityEndpoint::SendPacket(
+    const SocketAddress& dest, std::span<const uint8_t> payload) {
+  if (payload.empty()) {
+    // No need to process empty payload.
+    return true;
+  }
+
+  mSendBuffer.resize(payload.size() + kTrailerSize);
+  std::memcpy(mSendBuffer.data(), payload.data(), payload.size());
+  StoreTrailer(mSendBuffer.data() + payload.size(),
+               Crc32c(payload.data(), payload.size(), mSeed));
+
+  return mEndpoint->SendPacket(dest, mSendBuffer);
+}
+
+bool GameNet::PacketIntegrityEndpoint::PollPacket(
+    NetworkReceivedPacket& outPacket) {
+  while (mEndpoint->PollPacket(outPacket)) {
+    if (Verify(outPacket)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t GameNet::PacketIntegrityEndpoint::PollPackets(
+    std::span<NetworkReceivedPacket> outPackets) {
+  // Callers take a short count to mean the endpoint is drained, so refill
+  // the slots of rejected packets until the span is full or the inner
+  // endpoint is. Otherwise a few bad datagrams would stall receiving.
+  size_t validCount = 0;
+  while (validCount < outPackets.size()) {
+    const std::span<NetworkReceivedPacket> remaining =
+        outPackets.subspan(validCount);
+    const size_t count = mEndpoint->PollPackets(remaining);
+
+    // Compact the valid packets to the front. Swapping keeps every payload
+    // buffer in the caller's span, so none is freed or reallocated.
+    for (size_t i = 0; i < count; ++i) {
+      if (!Verify(remaining[i])) {
+        continue;
+      }
+      if (&remaining[i] != &outPackets[validCount]) {
+        std::swap(outPackets[validCount], remaining[i]);
+      }
+      ++validCount;
+    }
+
+    if (count < remaining.size()) {
+      break;
+    }
+  }
+  return validCount;
+}
+
+bool GameNet::PacketIntegrityEndpoint::Verify(NetworkReceivedPacket& packet) {
+  if (packet.payload.size() <= kTrailerSize) {
+    ++mRejectedPacketCount;
+    return false;
+  }
+
+  const size_t payloadSize = packet.payload.size() - kTrailerSize;
+  const uint32_t expected = LoadTrailer(packet.payload.data() + payloadSize);
+  if (Crc32c(packet.payload.data(), payloadSize, mSeed) != expected) {
+    ++mRejectedPacketCount;
+    return false;
+  }
+
+  packet.payload.resize(payloadSize);
+  return true;
+}
@@ -0,0 +1,96 @@
+#include "endpoint/sharded_udp_transport_endpoint.h"
+
+std::unique_ptr<GameNet::ShardedUDPTransportEndpoint>
+GameNet::ShardedUDPTransportEndpoint::Create(const SocketAddress& address,
+                                             int shardCount,
+                                             bool steerFlowsByAddress,
+                                             int maximumPacketSize,
+                                             const UDPTransportOptions& options,
+                                             const IClock& clock) {
+  if (shardCount <= 0) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: shardCount must be positive\n",
+                __FUNCTION__);
+    return nullptr;
+  }
+
+  if (maximumPacketSize <= 0) {
+    Logger::Log(LOG_SEVERITY_ERROR,
+                "%s error: maximumPacketSize must be positive\n", __FUNCTION__);
+    return nullptr;
+  }
+
+  if (address.GetPort() == 0) {
+    // Every bind to port 0 would pick a different ephemeral port.
+    Logger::Log(LOG_SEVERITY_ERROR,
+                "%s error: sharded endpoints need an explicit port\n",
+                __FUNCTION__);
+    return nullptr;
+  }
+
+  std::vector<std::unique_ptr<UDPTransportEndpoint>> shards;
+  shards.reserve(static_cast<size_t>(shardCount));
+
+  for (int i = 0; i < shardCount; ++i) {
+    UDPSocketPtr socket = UDPSocket::Create(address.GetFamily());
+    if (!socket) {
+      Logger::Log(LOG_SEVERITY_ERROR,
+                  "%s error: failed to create UDP socket (shard=%d)\n",
+                  __FUNCTION__, i);
+      return nullptr;
+    }
+
+    int err = socket->SetReusePort(true);
+    if (err != NO_ERROR) {
+      return nullptr;
+    }
+
+    UDPTransportEndpoint::ApplyOptions(*socket, options);
+
+    err = socket->Bind(address);
+    if (err != NO_ERROR) {
+      Logger::Log(LOG_SEVERITY_ERROR,
+                  "%s error: failed to bind UDP socket (address=%s, shard=%d, "
+                  "error=%d)\n",
+                  __FUNCTION__, address.ToString().c_str(), i, err);
+      return nullptr;
+    }
+
+    err = socket->SetNonBlockingMode(true);
+    if (err != NO_ERROR) {
+      Logger::Log(LOG_SEVERITY_ERROR,
+                  "%s error: failed to set non-blocking mode (error=%d)\n",
+                  __FUNCTION__, err);
+      return nullptr;
+    }
+
+    shards.push_back(std::unique_ptr<UDPTransportEndpoint>(
+        new UDPTransportEndpoint(std::move(socket), address,
+                                 maximumPacketSize, clock)));
+  }
+
+  // The program indexes the group in bind order, so attach it once every
+  // shard has joined. Without it the kernel falls back to its own 4-tuple
+  // hash, which reshuffles clients whenever the group changes.
+  if (steerFlowsByAddress && shardCount > 1 && !address.IsIPv4()) {
+    Logger::Log(LOG_SEVERITY_WARNING,
+                "%s warning: flow steering supports IPv4 only\n",
+                __FUNCTION__);
+  } else if (steerFlowsByAddress && shardCount > 1) {
+    const int err = shards.front()->mSocket->AttachReusePortFlowSteering(
+        static_cast<uint32_t>(shardCount));
+    if (err != NO_ERROR) {
+      Logger::Log(LOG_SEVERITY_WARNING,
+                  "%s warning: flow steering unavailable, using kernel "
+                  "hashing (error=%d)\n",
+                  __FUNCTION__, err);
+    }
+  }
+
+  return std::unique_ptr<ShardedUDPTransportEndpoint>(
+      new ShardedUDPTransportEndpoint(std::move(shards), address));
+}
+
+GameNet::ShardedUDPTransportEndpoint::ShardedUDPTransportEndpoint(
+    std::vector<std::unique_ptr<UDPTransportEndpoint>> shards,
+    const SocketAddress& address)
+    : mShards(std::move(shards)), mAddress{address} {}
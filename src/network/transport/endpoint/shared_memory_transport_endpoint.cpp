@@ -0,0 +1,353 @@
+#include "endpoint/shared_memory_transport_endpoint.h"
+
+#if defined(__linux__)
+
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <new>
+
+#include "core/container/cache_line.h"
+#include "socket/socket_util.h"
+
+namespace {
+
+constexpr uint32_t kSegmentMagic = 0x474E534D;  // "GNSM"
+constexpr uint32_t kSegmentVersion = 1;
+// bit_ceil() of anything larger doesn't fit a uint32_t.
+constexpr uint32_t kMaximumSlotCount = uint32_t{1} << 31;
+
+constexpr uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "ring indices are shared between processes");
+
+// Not FUTEX_PRIVATE_FLAG: the waiter and the waker are different processes.
+long Futex(std::atomic<uint32_t>& word, int op, uint32_t value,
+           const timespec* timeout) {
+  return syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), op, value,
+                 timeout, nullptr, 0);
+}
+
+}  // namespace
+
+// Indices are free-running and masked on use. Each sits on its own cache
+// line so producer and consumer never write the same line.
+struct GameNet::SharedMemoryTransportEndpoint::Ring {
+  alignas(kCacheLineSize) std::atomic<uint32_t> head;  // producer
+  alignas(kCacheLineSize) std::atomic<uint32_t> tail;  // consumer
+  // Set while the consumer sleeps on the head futex.
+  alignas(kCacheLineSize) std::atomic<uint32_t> waiting;
+};
+
+struct GameNet::SharedMemoryTransportEndpoint::SegmentHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t slotCount;
+  uint32_t slotStride;
+  uint32_t maximumPacketSize;
+  // Indexed by side: the creator's address, then the attacher's.
+  SocketAddress addresses[2];
+  // Ring i carries datagrams sent by side i.
+  Ring rings[2];
+};
+
+std::unique_ptr<GameNet::SharedMemoryTransportEndpoint>
+GameNet::SharedMemoryTransportEndpoint::Create(
+    const SocketAddress& localAddress, const SocketAddress& remoteAddress,
+    uint32_t slotCount, int maximumPacketSize) {
+  if (maximumPacketSize <= 0 || slotCount == 0 ||
+      slotCount > kMaximumSlotCount) {
+    Logger::Log(LOG_SEVERITY_ERROR,
+                "%s error: maximumPacketSize must be positive and slotCount "
+                "in [1, %u]\n",
+                __FUNCTION__, kMaximumSlotCount);
+    return nullptr;
+  }
+
+  slotCount = std::bit_ceil(slotCount);
+  // Each slot is a uint32_t length followed by the payload.
+  const uint64_t slotStride = AlignUp(
+      sizeof(uint32_t) + static_cast<uint64_t>(maximumPacketSize),
+      kCacheLineSize);
+  size_t segmentSize = 0;
+  if (slotStride > std::numeric_limits<uint32_t>::max() ||
+      !GetSegmentSize(slotCount, static_cast<uint32_t>(slotStride),
+                      segmentSize) ||
+      segmentSize > static_cast<uint64_t>(std::numeric_limits<off_t>::max())) {
+    Logger::Log(LOG_SEVERITY_ERROR,
+                "%s error: segment too large (slotCount=%u, "
+                "maximumPacketSize=%d)\n",
+                __FUNCTION__, slotCount, maximumPacketSize);
+    return nullptr;
+  }
+
+  int fd = memfd_create("gamenet-shared-memory-endpoint", MFD_CLOEXEC);
+  if (fd < 0) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: memfd_create failed (error=%d)\n",
+                __FUNCTION__, SocketUtil::GetLastError());
+    return nullptr;
+  }
+
+  if (ftruncate(fd, static_cast<off_t>(segmentSize)) != 0) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: ftruncate failed (error=%d)\n",
+                __FUNCTION__, SocketUtil::GetLastError());
+    close(fd);
+    return nullptr;
+  }
+
+  void* segment =
+      mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (segment == MAP_FAILED) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: mmap failed (error=%d)\n",
+                __FUNCTION__, SocketUtil::GetLastError());
+    close(fd);
+    return nullptr;
+  }
+
+  SegmentHeader* header = new (segment) SegmentHeader{};
+  header->slotCount = slotCount;
+  header->slotStride = static_cast<uint32_t>(slotStride);
+  header->maximumPacketSize = static_cast<uint32_t>(maximumPacketSize);
+  header->addresses[0] = localAddress;
+  header->addresses[1] = remoteAddress;
+  // Publish the magic last; Attach() checks it before anything else.
+  header->version = kSegmentVersion;
+  std::atomic_thread_fence(std::memory_order_release);
+  header->magic = kSegmentMagic;
+
+  return std::unique_ptr<SharedMemoryTransportEndpoint>(
+      new SharedMemoryTransportEndpoint(
+          fd, static_cast<uint8_t*>(segment), segmentSize, 0, slotCount,
+          header->slotStride, header->maximumPacketSize));
+}
+
+std::unique_ptr<GameNet::SharedMemoryTransportEndpoint>
+GameNet::SharedMemoryTransportEndpoint::Attach(int fileDescriptor) {
+  struct stat status;
+  if (fstat(fileDescriptor, &status) != 0 ||
+      static_cast<size_t>(status.st_size) < sizeof(SegmentHeader)) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: not a shared memory segment\n",
+                __FUNCTION__);
+    close(fileDescriptor);
+    return nullptr;
+  }
+
+  const size_t segmentSize = static_cast<size_t>(status.st_size);
+  void* segment = mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, fileDescriptor, 0);
+  if (segment == MAP_FAILED) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: mmap failed (error=%d)\n",
+                __FUNCTION__, SocketUtil::GetLastError());
+    close(fileDescriptor);
+    return nullptr;
+  }
+
+  // Read each field once: the peer may still be writing to the segment.
+  const SegmentHeader* header = static_cast<const SegmentHeader*>(segment);
+  const uint32_t slotCount = header->slotCount;
+  const uint32_t slotStride = header->slotStride;
+  const uint32_t maximumPacketSize = header->maximumPacketSize;
+  size_t requiredSize = 0;
+  const bool valid =
+      header->magic == kSegmentMagic && header->version == kSegmentVersion &&
+      std::has_single_bit(slotCount) &&
+      slotStride >= sizeof(uint32_t) + static_cast<uint64_t>(maximumPacketSize) &&
+      GetSegmentSize(slotCount, slotStride, requiredSize) &&
+      requiredSize <= segmentSize;
+  if (!valid) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: invalid segment header\n",
+                __FUNCTION__);
+    munmap(segment, segmentSize);
+    close(fileDescriptor);
+    return nullptr;
+  }
+
+  return std::unique_ptr<SharedMemoryTransportEndpoint>(
+      new SharedMemoryTransportEndpoint(
+          fileDescriptor, static_cast<uint8_t*>(segment), segmentSize, 1,
+          slotCount, slotStride, maximumPacketSize));
+}
+
+GameNet::SharedMemoryTransportEndpoint::SharedMemoryTransportEndpoint(
+    int fileDescriptor, uint8_t* segment, size_t segmentSize, int side,
+    uint32_t slotCount, uint32_t slotStride, uint32_t maximumPacketSize)
+    : mFileDescriptor(fileDescriptor),
+      mSegment(segment),
+      mSegmentSize(segmentSize),
+      mSide(side),
+      mHeader(reinterpret_cast<SegmentHeader*>(segment)) {
+  mSlotMask = slotCount - 1;
+  mSlotStride = slotStride;
+  mMaximumPacketSize = maximumPacketSize;
+  mLocalAddress = mHeader->addresses[side];
+  mRemoteAddress = mHeader->addresses[1 - side];
+
+  const size_t ringSize = static_cast<size_t>(slotCount) * mSlotStride;
+  uint8_t* slots = segment + AlignUp(sizeof(SegmentHeader), kCacheLineSize);
+
+  mSendRing = &mHeader->rings[side];
+  mReceiveRing = &mHeader->rings[1 - side];
+  mSendSlots = slots + side * ringSize;
+  mReceiveSlots = slots + (1 - side) * ringSize;
+}
+
+GameNet::SharedMemoryTransportEndpoint::~SharedMemoryTransportEndpoint() {
+  munmap(mSegment, mSegmentSize);
+  close(mFileDescriptor);
+}
+
+bool GameNet::SharedMemoryTransportEndpoint::SendPacket(
+    const SocketAddress& dest, std::span<const uint8_t> payload) {
+  if (!(dest == mRemoteAddress)) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: %s is not the linked peer\n",
+                __FUNCTION__, dest.ToString().c_str());
+    return false;
+  }
+
+  if (payload.empty()) {
+    // No need to process empty payload.
+    return true;
+  }
+
+  if (payload.size() > mMaximumPacketSize) {
+    Logger::Log(LOG_SEVERITY_ERROR,
+                "%s error: payload too large (size=%zu, maximum=%u)\n",
+                __FUNCTION__, payload.size(), mMaximumPacketSize);
+    return false;
+  }
+
+  const std::span<uint8_t> slot = ReserveSend();
+  if (slot.empty()) {
+    // The peer is not keeping up; like a full socket buffer.
+    return false;
+  }
+
+  memcpy(slot.data(), payload.data(), payload.size());
+  return CommitSend(payload.size());
+}
+
+bool GameNet::SharedMemoryTransportEndpoint::PollPacket(
+    NetworkReceivedPacket& outPacket) {
+  const std::span<const uint8_t> payload = PeekPacket();
+  if (payload.empty()) {
+    return false;
+  }
+
+  outPacket.sourceAddress = mRemoteAddress;
+  outPacket.payload.assign(payload.begin(), payload.end());
+  ReleasePacket();
+  return true;
+}
+
+std::span<uint8_t> GameNet::SharedMemoryTransportEndpoint::ReserveSend() {
+  const uint32_t head = mSendRing->head.load(std::memory_order_relaxed);
+  const uint32_t tail = mSendRing->tail.load(std::memory_order_acquire);
+  if (head - tail > mSlotMask) {
+    return {};
+  }
+
+  uint8_t* slot =
+      mSendSlots + static_cast<size_t>(head & mSlotMask) * mSlotStride;
+  return {slot + sizeof(uint32_t), mMaximumPacketSize};
+}
+
+bool GameNet::SharedMemoryTransportEndpoint::CommitSend(size_t length) {
+  if (length == 0 || length > mMaximumPacketSize) {
+    Logger::Log(LOG_SEVERITY_ERROR,
+                "%s error: invalid length (length=%zu, maximum=%u)\n",
+                __FUNCTION__, length, mMaximumPacketSize);
+    return false;
+  }
+
+  const uint32_t head = mSendRing->head.load(std::memory_order_relaxed);
+  uint8_t* slot =
+      mSendSlots + static_cast<size_t>(head & mSlotMask) * mSlotStride;
+  const uint32_t slotLength = static_cast<uint32_t>(length);
+  memcpy(slot, &slotLength, sizeof(slotLength));
+
+  // Sequentially consistent so the store to head and the load of waiting
+  // cannot be reordered against the consumer's store to waiting and load of
+  // head; otherwise both could miss each other and the consumer would sleep.
+  mSendRing->head.store(head + 1, std::memory_order_seq_cst);
+  if (mSendRing->waiting.load(std::memory_order_seq_cst) != 0) {
+    Futex(mSendRing->head, FUTEX_WAKE, 1, nullptr);
+  }
+
+  return true;
+}
+
+std::span<const uint8_t> GameNet::SharedMemoryTransportEndpoint::PeekPacket() {
+  for (;;) {
+    const uint32_t tail = mReceiveRing->tail.load(std::memory_order_relaxed);
+    const uint32_t head = mReceiveRing->head.load(std::memory_order_acquire);
+    if (head == tail) {
+      return {};
+    }
+
+    const uint8_t* slot =
+        mReceiveSlots + static_cast<size_t>(tail & mSlotMask) * mSlotStride;
+    uint32_t length;
+    memcpy(&length, slot, sizeof(length));
+    if (length != 0 && length <= mMaximumPacketSize) {
+      return {slot + sizeof(length), length};
+    }
+
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: corrupt slot (length=%u)\n",
+                __FUNCTION__, length);
+    mReceiveRing->tail.store(tail + 1, std::memory_order_release);
+  }
+}
+
+void GameNet::SharedMemoryTransportEndpoint::ReleasePacket() {
+  const uint32_t tail = mReceiveRing->tail.load(std::memory_order_relaxed);
+  if (mReceiveRing->head.load(std::memory_order_acquire) != tail) {
+    mReceiveRing->tail.store(tail + 1, std::memory_order_release);
+  }
+}
+
+bool GameNet::SharedMemoryTransportEndpoint::WaitForPacket(int timeoutMs) {
+  const uint32_t tail = mReceiveRing->tail.load(std::memory_order_relaxed);
+  if (mReceiveRing->head.load(std::memory_order_acquire) != tail) {
+    return true;
+  }
+
+  mReceiveRing->waiting.store(1, std::memory_order_seq_cst);
+  const uint32_t head = mReceiveRing->head.load(std::memory_order_seq_cst);
+  if (head == tail) {
+    timespec timeout;
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_nsec = static_cast<long>(timeoutMs % 1000) * 1000000;
+    // Returns at once if head already moved past the value we saw.
+    Futex(mReceiveRing->head, FUTEX_WAIT, head,
+          timeoutMs < 0 ? nullptr : &timeout);
+  }
+  mReceiveRing->waiting.store(0, std::memory_order_relaxed);
+
+  return mReceiveRing->head.load(std::memory_order_acquire) != tail;
+}
+
+bool GameNet::SharedMemoryTransportEndpoint::GetSegmentSize(
+    uint32_t slotCount, uint32_t slotStride, size_t& outSegmentSize) {
+  constexpr size_t kHeaderSize = AlignUp(sizeof(SegmentHeader), kCacheLineSize);
+  constexpr size_t kMaximumRingsSize =
+      std::numeric_limits<size_t>::max() - kHeaderSize;
+  if (slotStride != 0 &&
+      static_cast<size_t>(slotCount) > kMaximumRingsSize / 2 / slotStride) {
+    return false;
+  }
+
+  outSegmentSize = kHeaderSize + 2 * static_cast<size_t>(slotCount) * slotStride;
+  return true;
+}
+
+#endif
@@ -0,0 +1,118 @@
+#include "endpoint/threaded_transport_endpoint.h"
+
+#include <algorithm>
+
+namespace {
+
+// Pulled from the outgoing queue per pass, so a burst of sends can't keep
+// the I/O thread from receiving.
+constexpr size_t kSendBatchSize = 256;
+
+}  // namespace
+
+GameNet::ThreadedTransportEndpoint::ThreadedTransportEndpoint(
+    std::unique_ptr<INetworkTransportEndpoint> endpoint,
+    const ThreadedTransportSettings& settings)
+    : mEndpoint(std::move(endpoint)),
+      mSettings(settings),
+      mLocalAddress(mEndpoint->GetLocalSocketAddress()),
+      mOutgoing(settings.queueCapacity),
+      mIncoming(settings.queueCapacity) {
+  mReceiveBatch.resize(std::max<size_t>(mSettings.receiveBatchSize, 1));
+  mThread = std::thread([this] { Run(); });
+}
+
+GameNet::ThreadedTransportEndpoint::~ThreadedTransportEndpoint() {
+  mRunning.store(false, std::memory_order_release);
+  if (mThread.joinable()) {
+    mThread.join();
+  }
+}
+
+bool GameNet::ThreadedTransportEndpoint::SendPacket(
+    const SocketAddress& dest, std::span<const uint8_t> payload) {
+  if (!mOutgoing.Send(dest, payload)) {
+    mDroppedOutgoingPacketCount.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+bool GameNet::ThreadedTransportEndpoint::PollPacket(
+    NetworkReceivedPacket& outPacket) {
+  return mIncoming.Poll(outPacket);
+}
+
+size_t GameNet::ThreadedTransportEndpoint::PollPackets(
+    std::span<NetworkReceivedPacket> outPackets) {
+  return mIncoming.PollBatch(outPackets);
+}
+
+GameNet::ThreadedTransportStats GameNet::ThreadedTransportEndpoint::GetStats()
+    const {
+  ThreadedTransportStats stats;
+  stats.sentPacketCount = mSentPacketCount.load(std::memory_order_relaxed);
+  stats.receivedPacketCount =
+      mReceivedPacketCount.load(std::memory_order_relaxed);
+  stats.droppedOutgoingPacketCount =
+      mDroppedOutgoingPacketCount.load(std::memory_order_relaxed);
+  stats.droppedIncomingPacketCount =
+      mDroppedIncomingPacketCount.load(std::memory_order_relaxed);
+  stats.failedSendCount = mFailedSendCount.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void GameNet::ThreadedTransportEndpoint::Run() {
+  while (mRunning.load(std::memory_order_acquire)) {
+    if (!Pump()) {
+      std::this_thread::sleep_for(mSettings.idleSleep);
+    }
+  }
+
+  // Whatever the simulation thread queued before shutting down still goes
+  // out.
+  while (mOutgoing.Poll(mOutgoingPacket)) {
+    mEndpoint->SendPacket(mOutgoingPacket.sourceAddress,
+                          mOutgoingPacket.payload);
+  }
+}
+
+bool GameNet::ThreadedTransportEndpoint::Pump() {
+  size_t sentCount = 0;
+  size_t failedCount = 0;
+  while (sentCount < kSendBatchSize && mOutgoing.Poll(mOutgoingPacket)) {
+    if (!mEndpoint->SendPacket(mOutgoingPacket.sourceAddress,
+                               mOutgoingPacket.payload)) {
+      ++failedCount;
+    }
+    ++sentCount;
+  }
+
+  const size_t receivedCount = mEndpoint->PollPackets(mReceiveBatch);
+  size_t droppedCount = 0;
+  for (size_t i = 0; i < receivedCount; ++i) {
+    // Forwarded with its kernel timestamp, which still dates the datagram
+    // after the hop to the simulation thread.
+    if (!mIncoming.Send(mReceiveBatch[i])) {
+      ++droppedCount;
+    }
+  }
+
+  // One atomic update per pass rather than per packet.
+  if (sentCount != 0) {
+    mSentPacketCount.fetch_add(sentCount - failedCount,
+                               std::memory_order_relaxed);
+    if (failedCount != 0) {
+      mFailedSendCount.fetch_add(failedCount, std::memory_order_relaxed);
+    }
+  }
+  if (receivedCount != 0) {
+    mReceivedPacketCount.fetch_add(receivedCount, std::memory_order_relaxed);
+    if (droppedCount != 0) {
+      mDroppedIncomingPacketCount.fetch_add(droppedCount,
+                                            std::memory_order_relaxed);
+    }
+  }
+
+  return sentCount != 0 || receivedCount != 0;
+}
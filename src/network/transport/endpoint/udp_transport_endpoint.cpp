@@ -1,20 +1,26 @@
 #include "endpoint/udp_transport_endpoint.h"
 
+#include <algorithm>
+
 std::unique_ptr<GameNet::UDPTransportEndpoint>
 GameNet::UDPTransportEndpoint::Create(const SocketAddress& address,
-                                      int maximumPacketSize) {
+                                      int maximumPacketSize,
+                                      const UDPTransportOptions& options,
+                                      const IClock& clock) {
   if (maximumPacketSize <= 0) {
     Logger::Log(LOG_SEVERITY_ERROR,
                 "%s error: maximumPacketSize must be positive\n", __FUNCTION__);
     return nullptr;
   }
 
-  UDPSocketPtr socket = UDPSocket::Create(INET);
+  UDPSocketPtr socket = UDPSocket::Create(address.GetFamily());
   if (!socket) {
     Logger::Log(LOG_SEVERITY_ERROR, "%s error: failed to create UDP socket\n");
     return nullptr;
   }
 
+  ApplyOptions(*socket, options);
+
   int err = socket->Bind(address);
   if (err != NO_ERROR) {
     Logger::Log(LOG_SEVERITY_ERROR,
@@ -32,14 +38,48 @@ GameNet::UDPTransportEndpoint::Create(const SocketAddress& address,
   }
 
   return std::unique_ptr<UDPTransportEndpoint>(
-      new UDPTransportEndpoint(std::move(socket), address, maximumPacketSize));
+      new UDPTransportEndpoint(std::move(socket), address, maximumPacketSize,
+                               clock));
+}
+
+void GameNet::UDPTransportEndpoint::ApplyOptions(
+    UDPSocket& socket, const UDPTransportOptions& options) {
+  // Set before bind, so no datagram arrives while the defaults apply.
+  if (options.receiveBufferSize > 0 &&
+      socket.SetReceiveBufferSize(options.receiveBufferSize) != NO_ERROR) {
+    Logger::Log(LOG_SEVERITY_WARNING,
+                "%s warning: failed to set receive buffer size to %d\n",
+                __FUNCTION__, options.receiveBufferSize);
+  }
+  if (options.sendBufferSize > 0 &&
+      socket.SetSendBufferSize(options.sendBufferSize) != NO_ERROR) {
+    Logger::Log(LOG_SEVERITY_WARNING,
+                "%s warning: failed to set send buffer size to %d\n",
+                __FUNCTION__, options.sendBufferSize);
+  }
+#if defined(__linux__)
+  if (options.kernelTimestamps &&
+      socket.EnableReceiveTimestamps(true) != NO_ERROR) {
+    Logger::Log(LOG_SEVERITY_WARNING,
+                "%s warning: kernel receive timestamps are unavailable\n",
+                __FUNCTION__);
+  }
+  if (options.kernelDropCounter &&
+      socket.EnableDropCounter(true) != NO_ERROR) {
+    Logger::Log(LOG_SEVERITY_WARNING,
+                "%s warning: kernel drop counter is unavailable\n",
+                __FUNCTION__);
+  }
+#endif
 }
 
 GameNet::UDPTransportEndpoint::UDPTransportEndpoint(
-    UDPSocketPtr socket, const SocketAddress& address, int maximumPacketSize)
+    UDPSocketPtr socket, const SocketAddress& address, int maximumPacketSize,
+    const IClock& clock)
     : mSocket(std::move(socket)),
       mAddress{address},
-      mReceivedBuffer(static_cast<size_t>(maximumPacketSize)) {}
+      mReceivedBuffer(static_cast<size_t>(maximumPacketSize)),
+      mClock(&clock) {}
 
 bool GameNet::UDPTransportEndpoint::SendPacket(
     const SocketAddress& dest, std::span<const uint8_t> payload) {
@@ -60,8 +100,10 @@ bool GameNet::UDPTransportEndpoint::SendPacket(
   if (bytesSent < 0) {
     Logger::Log(LOG_SEVERITY_ERROR, "%s error: sendto failed (error=%d)\n",
                 __FUNCTION__, -bytesSent);
+    ++mStats.sendErrorCount;
     return false;
   }
+  ++mStats.sentPacketCount;
 
   if (bytesSent != payloadSize) {
     // UDP should either send all or fail; partial send is unexpected.
@@ -81,22 +123,41 @@ bool GameNet::UDPTransportEndpoint::PollPacket(NetworkReceivedPacket& outPacket)
   }
 
   SocketAddress sourceAddress;
-  const int bytesReceived = mSocket->ReceiveFrom(
+  UDPReceiveInfo receiveInfo;
+  const int bytesReceived = mSocket->ReceiveMessage(
       mReceivedBuffer.data(), static_cast<int>(mReceivedBuffer.size()),
-      sourceAddress);
+      sourceAddress, receiveInfo);
   if (bytesReceived <= 0) {
     // 0 indicates no data (would-block), negative indicates error.
     if (bytesReceived < 0) {
       Logger::Log(LOG_SEVERITY_ERROR, "%s error: recvfrom failed (error=%d)\n",
                   -bytesReceived);
+      ++mStats.receiveErrorCount;
     }
     return false;
   }
+  ++mStats.receivedPacketCount;
 
   outPacket.sourceAddress = sourceAddress;
   outPacket.payload.resize(static_cast<size_t>(bytesReceived));
   std::memcpy(outPacket.payload.data(), mReceivedBuffer.data(),
               static_cast<size_t>(bytesReceived));
 
+  outPacket.kernelTimestamp = ClockTimePoint{};
+  if (receiveInfo.hasKernelTimestamp) {
+    // The kernel stamps with the realtime clock; carry the age of the
+    // datagram over to our clock, which may be a ManualClock in tests.
+    const auto age = std::chrono::system_clock::now().time_since_epoch() -
+                     receiveInfo.kernelTimestamp;
+    outPacket.kernelTimestamp =
+        mClock->Now() -
+        std::max(std::chrono::duration_cast<ClockDuration>(age),
+                 ClockDuration::zero());
+  }
+  if (receiveInfo.hasDropCount) {
+    mStats.kernelDropCount = receiveInfo.dropCount;
+  }
+  outPacket.kernelDropCount = mStats.kernelDropCount;
+
   return true;
 }
@@ -0,0 +1,204 @@
+#include "endpoint/unix_datagram_transport_endpoint.h"
+
+#if !defined(_WIN32)
+
+#include <sys/un.h>
+
+#include "socket/socket_address_factory.h"
+#include "socket/socket_util.h"
+
+namespace {
+
+constexpr const char* kSocketFilePrefix = "gamenet-";
+constexpr const char* kSocketFileSuffix = ".sock";
+
+bool ToSockAddrUn(const std::string& path, sockaddr_un& outAddress) {
+  memset(&outAddress, 0, sizeof(outAddress));
+  outAddress.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(outAddress.sun_path)) {
+    return false;
+  }
+
+  memcpy(outAddress.sun_path, path.c_str(), path.size() + 1);
+  return true;
+}
+
+// Whether the socket file at address has no live owner, i.e. was left
+// behind by a process that crashed. Connecting to it is refused then.
+bool IsStaleSocketFile(const sockaddr_un& address) {
+  SOCKET probe = socket(AF_UNIX, SOCK_DGRAM, 0);
+  if (probe == INVALID_SOCKET) {
+    return false;
+  }
+
+  const bool isStale =
+      connect(probe, reinterpret_cast<const sockaddr*>(&address),
+              sizeof(address)) != 0 &&
+      GameNet::SocketUtil::GetLastError() == ECONNREFUSED;
+  close(probe);
+  return isStale;
+}
+
+}  // namespace
+
+std::unique_ptr<GameNet::UnixDatagramTransportEndpoint>
+GameNet::UnixDatagramTransportEndpoint::Create(const SocketAddress& address,
+                                               const std::string& directory,
+                                               int maximumPacketSize) {
+  if (maximumPacketSize <= 0) {
+    Logger::Log(LOG_SEVERITY_ERROR,
+                "%s error: maximumPacketSize must be positive\n", __FUNCTION__);
+    return nullptr;
+  }
+
+  const std::string path = GetSocketPath(directory, address);
+  sockaddr_un bindAddress;
+  if (!ToSockAddrUn(path, bindAddress)) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: socket path is too long (%s)\n",
+                __FUNCTION__, path.c_str());
+    return nullptr;
+  }
+
+  SOCKET s = socket(AF_UNIX, SOCK_DGRAM, 0);
+  if (s == INVALID_SOCKET) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: failed to create socket\n",
+                __FUNCTION__);
+    return nullptr;
+  }
+
+  const auto bindToPath = [&] {
+    return bind(s, reinterpret_cast<const sockaddr*>(&bindAddress),
+                sizeof(bindAddress)) == 0
+               ? NO_ERROR
+               : SocketUtil::GetLastError();
+  };
+
+  // The path stays in use while its socket file exists. Like UDP, refuse
+  // an address another endpoint is bound to, but take over the file of
+  // one that crashed.
+  int err = bindToPath();
+  if (err == EADDRINUSE && IsStaleSocketFile(bindAddress)) {
+    unlink(path.c_str());
+    err = bindToPath();
+  }
+
+  if (err != NO_ERROR) {
+    Logger::Log(LOG_SEVERITY_ERROR,
+                "%s error: failed to bind (path=%s, error=%d)\n", __FUNCTION__,
+                path.c_str(), err);
+    close(s);
+    return nullptr;
+  }
+
+  int flags = fcntl(s, F_GETFL, 0);
+  if (fcntl(s, F_SETFL, flags | O_NONBLOCK) == SOCKET_ERROR) {
+    Logger::Log(LOG_SEVERITY_ERROR,
+                "%s error: failed to set non-blocking mode (error=%d)\n",
+                __FUNCTION__, SocketUtil::GetLastError());
+    close(s);
+    unlink(path.c_str());
+    return nullptr;
+  }
+
+  return std::unique_ptr<UnixDatagramTransportEndpoint>(
+      new UnixDatagramTransportEndpoint(s, address, directory,
+                                        maximumPacketSize));
+}
+
+GameNet::UnixDatagramTransportEndpoint::UnixDatagramTransportEndpoint(
+    SOCKET socket, const SocketAddress& address, const std::string& directory,
+    int maximumPacketSize)
+    : mSocket(socket),
+      mAddress{address},
+      mDirectory(directory),
+      mPath(GetSocketPath(directory, address)),
+      mReceivedBuffer(static_cast<size_t>(maximumPacketSize)) {}
+
+GameNet::UnixDatagramTransportEndpoint::~UnixDatagramTransportEndpoint() {
+  close(mSocket);
+  unlink(mPath.c_str());
+}
+
+bool GameNet::UnixDatagramTransportEndpoint::SendPacket(
+    const SocketAddress& dest, std::span<const uint8_t> payload) {
+  if (payload.empty()) {
+    // No need to process empty payload.
+    return true;
+  }
+
+  sockaddr_un destAddress;
+  if (!ToSockAddrUn(GetSocketPath(mDirectory, dest), destAddress)) {
+    return false;
+  }
+
+  const ssize_t bytesSent =
+      sendto(mSocket, payload.data(), payload.size(), 0,
+             reinterpret_cast<const sockaddr*>(&destAddress),
+             sizeof(destAddress));
+  if (bytesSent < 0) {
+    const int err = SocketUtil::GetLastError();
+    if (err == ENOENT || err == ECONNREFUSED) {
+      // Nobody is bound there; UDP would drop the datagram just as silently.
+      return true;
+    }
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: sendto failed (error=%d)\n",
+                __FUNCTION__, err);
+    return false;
+  }
+
+  return true;
+}
+
+bool GameNet::UnixDatagramTransportEndpoint::PollPacket(
+    NetworkReceivedPacket& outPacket) {
+  for (;;) {
+    sockaddr_un sourceAddress;
+    socklen_t sourceAddressLength = sizeof(sourceAddress);
+    const ssize_t bytesReceived =
+        recvfrom(mSocket, mReceivedBuffer.data(), mReceivedBuffer.size(), 0,
+                 reinterpret_cast<sockaddr*>(&sourceAddress),
+                 &sourceAddressLength);
+    if (bytesReceived <= 0) {
+      if (bytesReceived < 0 && SocketUtil::GetLastError() != WSAEWOULDBLOCK) {
+        Logger::Log(LOG_SEVERITY_ERROR,
+                    "%s error: recvfrom failed (error=%d)\n", __FUNCTION__,
+                    SocketUtil::GetLastError());
+      }
+      return false;
+    }
+
+    // Recover the sender's SocketAddress from its socket file name.
+    const std::string_view path(sourceAddress.sun_path,
+                                strnlen(sourceAddress.sun_path,
+                                        sizeof(sourceAddress.sun_path)));
+    const size_t nameStart = path.rfind(kSocketFilePrefix);
+    const size_t suffixLength = strlen(kSocketFileSuffix);
+    if (nameStart == std::string_view::npos ||
+        path.size() < nameStart + strlen(kSocketFilePrefix) + suffixLength) {
+      // Unbound or foreign sender; it cannot be answered, so drop it.
+      continue;
+    }
+
+    const size_t addressStart = nameStart + strlen(kSocketFilePrefix);
+    SocketAddressOpt source = SocketAddressFactory::CreateFromNumericString(
+        std::string(path.substr(addressStart,
+                                path.size() - addressStart - suffixLength)));
+    if (!source) {
+      continue;
+    }
+
+    outPacket.sourceAddress = *source;
+    outPacket.payload.resize(static_cast<size_t>(bytesReceived));
+    std::memcpy(outPacket.payload.data(), mReceivedBuffer.data(),
+                static_cast<size_t>(bytesReceived));
+    return true;
+  }
+}
+
+std::string GameNet::UnixDatagramTransportEndpoint::GetSocketPath(
+    const std::string& directory, const SocketAddress& address) {
+  return directory + "/" + kSocketFilePrefix + address.ToString() +
+         kSocketFileSuffix;
+}
+
+#endif
@@ -1,20 +1,25 @@
 #include "socket/socket_address.h"
 
 std::string GameNet::SocketAddress::ToString() const {
-  const sockaddr_in* s = GetAsSockAddrIn();
-  char destBuff[128];
+  const void* rawAddress =
+      IsIPv6() ? static_cast<const void*>(&GetAsSockAddrIn6()->sin6_addr)
+               : static_cast<const void*>(&GetAsSockAddrIn()->sin_addr);
+  char destBuff[INET6_ADDRSTRLEN];
 
 #if _WIN32
   // InetNtop is the Windows variant of inet_ntop
-  if (InetNtopA(s->sin_family, const_cast<in_addr*>(&s->sin_addr), destBuff,
+  if (InetNtopA(mSockAddr.ss_family, const_cast<void*>(rawAddress), destBuff,
                 static_cast<DWORD>(sizeof(destBuff))) == nullptr) {
     return {};
   }
 #else
-  if (inet_ntop(s->sin_family, &s->sin_addr, destBuff, sizeof(destBuff)) ==
-      nullptr) {
+  if (inet_ntop(mSockAddr.ss_family, rawAddress, destBuff,
+                sizeof(destBuff)) == nullptr) {
     return {};
   }
 #endif
-  return std::format("{}:{}", destBuff, ntohs(s->sin_port));
+  if (IsIPv6()) {
+    return std::format("[{}]:{}", destBuff, GetPort());
+  }
+  return std::format("{}:{}", destBuff, GetPort());
 }
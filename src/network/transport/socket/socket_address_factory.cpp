@@ -1,44 +1,111 @@
 #include "socket/socket_address_factory.h"
 
+#include <charconv>
+
 GameNet::SocketAddressOpt GameNet::SocketAddressFactory::CreateIPv4FromString(
     const std::string& str) {
-  auto pos = str.find_last_of(':');
-  std::string host, service;
-  if (pos != std::string::npos) {
-    host = str.substr(0, pos);
-    service = str.substr(pos + 1);
-  } else {
-    host = str;
-    service = "0";
+  return CreateFromString(str, INET);
+}
+
+GameNet::SocketAddressOpt GameNet::SocketAddressFactory::CreateFromString(
+    const std::string& str, int family) {
+  // Literal addresses never need the resolver.
+  if (SocketAddressOpt numeric = CreateFromNumericString(str, family)) {
+    return numeric;
   }
 
+  std::string host, service;
+  SplitHostAndService(str, host, service);
+
   addrinfo hint;
   memset(&hint, 0, sizeof(hint));
-  hint.ai_family = AF_INET;
+  hint.ai_family = family;
+  hint.ai_socktype = SOCK_DGRAM;
 
   // Convert domain name to IP address.
   // getaddrinfo() blocks the operation until it
   // receives the resolved IP addresses from the DNS server.
   addrinfo* result{nullptr};
   int err = getaddrinfo(host.c_str(), service.c_str(), &hint, &result);
-  if (err != 0 && result != nullptr) {
-    Logger::Log(LOG_SEVERITY_ERROR, "%s error: getaddrinfo failed\n",
-                __FUNCTION__);
-    freeaddrinfo(result);
+  if (err != 0 || result == nullptr) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: getaddrinfo failed (%s)\n",
+                __FUNCTION__, str.c_str());
+    if (result != nullptr) {
+      freeaddrinfo(result);
+    }
     return std::nullopt;
   }
 
-  while (!result->ai_addr && result->ai_next) {
-    result = result->ai_next;
+  addrinfo* info = result;
+  while (!info->ai_addr && info->ai_next) {
+    info = info->ai_next;
   }
 
-  if (!result->ai_addr) {
+  if (!info->ai_addr) {
     freeaddrinfo(result);
     return std::nullopt;
   }
 
-  auto toRet = std::make_optional<SocketAddress>(*result->ai_addr);
+  auto toRet = std::make_optional<SocketAddress>(*info->ai_addr);
 
   freeaddrinfo(result);
   return toRet;
-}
\ No newline at end of file
+}
+
+GameNet::SocketAddressOpt
+GameNet::SocketAddressFactory::CreateFromNumericString(const std::string& str,
+                                                      int family) {
+  std::string host, service;
+  SplitHostAndService(str, host, service);
+
+  uint16_t port = 0;
+  const char* serviceEnd = service.data() + service.size();
+  auto [ptr, ec] = std::from_chars(service.data(), serviceEnd, port);
+  if (ec != std::errc{} || ptr != serviceEnd) {
+    return std::nullopt;
+  }
+
+  if (family != AF_INET6) {
+    in_addr address4;
+    if (inet_pton(AF_INET, host.c_str(), &address4) == 1) {
+      return SocketAddress(ntohl(address4.s_addr), port);
+    }
+  }
+
+  if (family != AF_INET) {
+    uint8_t address6[16];
+    if (inet_pton(AF_INET6, host.c_str(), address6) == 1) {
+      return SocketAddress(address6, port);
+    }
+  }
+
+  return std::nullopt;
+}
+
+void GameNet::SocketAddressFactory::SplitHostAndService(
+    const std::string& str, std::string& outHost, std::string& outService) {
+  outService = "0";
+
+  if (!str.empty() && str.front() == '[') {
+    // "[v6 address]:port"
+    const auto closing = str.find(']');
+    if (closing == std::string::npos) {
+      outHost = str.substr(1);
+      return;
+    }
+    outHost = str.substr(1, closing - 1);
+    if (closing + 1 < str.size() && str[closing + 1] == ':') {
+      outService = str.substr(closing + 2);
+    }
+    return;
+  }
+
+  auto pos = str.find_last_of(':');
+  if (pos != std::string::npos && str.find(':') == pos) {
+    outHost = str.substr(0, pos);
+    outService = str.substr(pos + 1);
+  } else {
+    // No port, or a bare IPv6 address.
+    outHost = str;
+  }
+}
@@ -0,0 +1,259 @@
+#include "socket/socket_address_resolver.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+
+#include "socket/socket_address_factory.h"
+
+namespace {
+
+std::string ToLower(std::string str) {
+  std::transform(str.begin(), str.end(), str.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return str;
+}
+
+}  // namespace
+
+GameNet::SocketAddressResolver::SocketAddressResolver(const IClock& clock)
+    : SocketAddressResolver(Settings{}, clock) {}
+
+GameNet::SocketAddressResolver::SocketAddressResolver(const Settings& settings,
+                                                     const IClock& clock)
+    : mClock(clock), mSettings(settings) {
+  const size_t workerCount = std::max<size_t>(1, mSettings.workerCount);
+  mWorkers.reserve(workerCount);
+  for (size_t i = 0; i < workerCount; ++i) {
+    mWorkers.emplace_back(&SocketAddressResolver::WorkerLoop, this);
+  }
+}
+
+GameNet::SocketAddressResolver::~SocketAddressResolver() {
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStopping = true;
+  }
+  mWorkAvailable.notify_all();
+  for (std::thread& worker : mWorkers) {
+    worker.join();
+  }
+
+  // Whatever was never picked up still owes its callers an answer.
+  std::unordered_map<std::string, Callbacks> pending;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    pending.swap(mPending);
+  }
+  for (auto& [str, callbacks] : pending) {
+    for (Callback& callback : callbacks) {
+      callback(std::nullopt);
+    }
+  }
+}
+
+std::future<GameNet::SocketAddressOpt> GameNet::SocketAddressResolver::Resolve(
+    const std::string& str) {
+  auto promise = std::make_shared<std::promise<SocketAddressOpt>>();
+  std::future<SocketAddressOpt> future = promise->get_future();
+  Resolve(str, [promise](SocketAddressOpt address) {
+    promise->set_value(std::move(address));
+  });
+  return future;
+}
+
+void GameNet::SocketAddressResolver::Resolve(const std::string& str,
+                                             Callback callback) {
+  // Numeric addresses need neither the lock nor the cache.
+  if (SocketAddressOpt numeric =
+          SocketAddressFactory::CreateFromNumericString(str, mSettings.family)) {
+    callback(numeric);
+    return;
+  }
+
+  SocketAddressOpt address;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!TryResolveImmediately(str, address)) {
+      auto [it, inserted] = mPending.try_emplace(str);
+      it->second.push_back(std::move(callback));
+      if (inserted) {
+        mQueue.push_back(str);
+        mWorkAvailable.notify_one();
+      }
+      return;
+    }
+  }
+
+  callback(std::move(address));
+}
+
+bool GameNet::SocketAddressResolver::TryResolveImmediately(
+    const std::string& str, SocketAddressOpt& outAddress) {
+  if (!mHostEntries.empty()) {
+    std::string host, service;
+    SocketAddressFactory::SplitHostAndService(str, host, service);
+
+    auto entry = mHostEntries.find(ToLower(host));
+    const SocketAddressOpt* hostAddress =
+        entry != mHostEntries.end() ? &SelectHostAddress(entry->second)
+                                    : nullptr;
+    if (hostAddress && *hostAddress) {
+      uint16_t port = 0;
+      const char* serviceEnd = service.data() + service.size();
+      auto [ptr, ec] = std::from_chars(service.data(), serviceEnd, port);
+      if (ec != std::errc{} || ptr != serviceEnd) {
+        outAddress = std::nullopt;
+      } else {
+        outAddress = *hostAddress;
+        outAddress->SetPort(port);
+      }
+      return true;
+    }
+  }
+
+  auto cached = mCache.find(str);
+  if (cached == mCache.end()) {
+    return false;
+  }
+
+  if (mClock.Now() >= cached->second.expiryTime) {
+    mCache.erase(cached);
+    return false;
+  }
+
+  outAddress = cached->second.address;
+  return true;
+}
+
+void GameNet::SocketAddressResolver::WorkerLoop() {
+  for (;;) {
+    std::string str;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mWorkAvailable.wait(lock, [this] { return mStopping || !mQueue.empty(); });
+      if (mStopping) {
+        return;
+      }
+      str = std::move(mQueue.front());
+      mQueue.pop_front();
+    }
+
+    Complete(str, mSettings.resolve
+                      ? mSettings.resolve(str, mSettings.family)
+                      : SocketAddressFactory::CreateFromString(
+                            str, mSettings.family));
+  }
+}
+
+void GameNet::SocketAddressResolver::Complete(const std::string& str,
+                                              SocketAddressOpt address) {
+  Callbacks callbacks;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    const auto timeToLive = address ? mSettings.cacheTimeToLive
+                                    : mSettings.negativeCacheTimeToLive;
+    InsertIntoCache(str, CacheEntry{address, mClock.Now() + timeToLive});
+
+    auto it = mPending.find(str);
+    if (it != mPending.end()) {
+      callbacks = std::move(it->second);
+      mPending.erase(it);
+    }
+  }
+
+  for (Callback& callback : callbacks) {
+    callback(address);
+  }
+}
+
+void GameNet::SocketAddressResolver::InsertIntoCache(const std::string& str,
+                                                     const CacheEntry& entry) {
+  if (mSettings.maximumCacheSize == 0) {
+    return;
+  }
+
+  if (mCache.size() >= mSettings.maximumCacheSize && !mCache.contains(str)) {
+    const ClockTimePoint now = mClock.Now();
+    std::erase_if(mCache, [now](const auto& cached) {
+      return now >= cached.second.expiryTime;
+    });
+    if (mCache.size() >= mSettings.maximumCacheSize) {
+      mCache.erase(std::min_element(
+          mCache.begin(), mCache.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.second.expiryTime < rhs.second.expiryTime;
+          }));
+    }
+  }
+  mCache.insert_or_assign(str, entry);
+}
+
+const GameNet::SocketAddressOpt&
+GameNet::SocketAddressResolver::SelectHostAddress(
+    const HostEntry& entry) const {
+  switch (mSettings.family) {
+    case AF_INET:
+      return entry.ipv4;
+    case AF_INET6:
+      return entry.ipv6;
+    default:
+      return entry.ipv6First ? entry.ipv6 : entry.ipv4;
+  }
+}
+
+bool GameNet::SocketAddressResolver::LoadHostsFile(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s error: cannot open %s\n", __FUNCTION__,
+                path.c_str());
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(file, line)) {
+    line = line.substr(0, line.find('#'));
+
+    std::istringstream fields(line);
+    std::string addressText;
+    if (!(fields >> addressText)) {
+      continue;
+    }
+
+    // Host entries are stored with port 0; "[v6]" brackets are not used here.
+    SocketAddressOpt address = SocketAddressFactory::CreateFromNumericString(
+        addressText.find(':') != std::string::npos ? "[" + addressText + "]"
+                                                   : addressText);
+    if (!address) {
+      Logger::Log(LOG_SEVERITY_WARNING, "%s: skipping invalid address %s\n",
+                  __FUNCTION__, addressText.c_str());
+      continue;
+    }
+
+    std::string host;
+    while (fields >> host) {
+      AddHostEntry(host, *address);
+    }
+  }
+  return true;
+}
+
+void GameNet::SocketAddressResolver::AddHostEntry(const std::string& host,
+                                                  const SocketAddress& address) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  SocketAddress hostAddress = address;
+  hostAddress.SetPort(0);
+
+  auto [entry, inserted] = mHostEntries.try_emplace(ToLower(host));
+  if (inserted) {
+    entry->second.ipv6First = hostAddress.IsIPv6();
+  }
+  (hostAddress.IsIPv6() ? entry->second.ipv6 : entry->second.ipv4) =
+      hostAddress;
+}
+
+void GameNet::SocketAddressResolver::ClearCache() {
+  std::lock_guard<std::mutex> lock(mMutex);
+  mCache.clear();
+}
@@ -15,12 +15,16 @@
 
 typedef int socklen_t;
 #else
+#include <arpa/inet.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 typedef int SOCKET;
@@ -32,6 +36,8 @@ const int SOCKET_ERROR = -1;
 #endif
 
 #include <cassert>
+#include <chrono>
+#include <cstring>
 #include <deque>
 #include <format>
 #include <list>
@@ -0,0 +1,195 @@
+#include "socket/socket_poller.h"
+
+#include "socket/socket_util.h"
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+
+namespace {
+
+uint32_t ToEpollEvents(bool wantWritable, bool wantReadable) {
+  return (wantReadable ? EPOLLIN | EPOLLRDHUP : 0u) |
+         (wantWritable ? EPOLLOUT : 0u);
+}
+
+}  // namespace
+
+GameNet::SocketPoller::~SocketPoller() { close(mEpollFd); }
+
+GameNet::SocketPollerPtr GameNet::SocketPoller::Create() {
+  int epollFd = epoll_create1(EPOLL_CLOEXEC);
+  if (epollFd < 0) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to create epoll instance\n",
+                __FUNCTION__);
+    return nullptr;
+  }
+
+  return SocketPollerPtr(new SocketPoller(epollFd));
+}
+
+int GameNet::SocketPoller::Add(SOCKET socket, void* userData,
+                               bool wantWritable, bool wantReadable) {
+  epoll_event event{};
+  event.events = ToEpollEvents(wantWritable, wantReadable);
+  event.data.ptr = userData;
+  if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, socket, &event) < 0) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to add socket\n", __FUNCTION__);
+    return SocketUtil::GetLastError();
+  }
+
+  return NO_ERROR;
+}
+
+int GameNet::SocketPoller::Modify(SOCKET socket, void* userData,
+                                  bool wantWritable, bool wantReadable) {
+  epoll_event event{};
+  event.events = ToEpollEvents(wantWritable, wantReadable);
+  event.data.ptr = userData;
+  if (epoll_ctl(mEpollFd, EPOLL_CTL_MOD, socket, &event) < 0) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to modify socket\n",
+                __FUNCTION__);
+    return SocketUtil::GetLastError();
+  }
+
+  return NO_ERROR;
+}
+
+int GameNet::SocketPoller::Remove(SOCKET socket) {
+  if (epoll_ctl(mEpollFd, EPOLL_CTL_DEL, socket, nullptr) < 0) {
+    // Closing the socket already dropped it from the epoll set.
+    if (errno == EBADF) {
+      return NO_ERROR;
+    }
+    Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to remove socket\n",
+                __FUNCTION__);
+    return SocketUtil::GetLastError();
+  }
+
+  return NO_ERROR;
+}
+
+int GameNet::SocketPoller::Wait(std::span<SocketPollEvent> outEvents,
+                                int timeoutMs) {
+  constexpr int kMaxEventsPerWait = 256;
+  epoll_event events[kMaxEventsPerWait];
+
+  const int maxEvents =
+      static_cast<int>(std::min<size_t>(outEvents.size(), kMaxEventsPerWait));
+  int count = epoll_wait(mEpollFd, events, maxEvents, timeoutMs);
+  if (count < 0) {
+    int err = SocketUtil::GetLastError();
+    if (err == EINTR) {
+      return 0;
+    }
+    Logger::Log(LOG_SEVERITY_ERROR, "%s: epoll_wait failed\n", __FUNCTION__);
+    return -err;
+  }
+
+  for (int i = 0; i < count; ++i) {
+    outEvents[i].userData = events[i].data.ptr;
+    outEvents[i].readable = (events[i].events & (EPOLLIN | EPOLLRDHUP)) != 0;
+    outEvents[i].writable = (events[i].events & EPOLLOUT) != 0;
+    outEvents[i].error = (events[i].events & (EPOLLERR | EPOLLHUP)) != 0;
+  }
+
+  return count;
+}
+
+#else
+
+namespace {
+
+short ToPollEvents(bool wantWritable, bool wantReadable) {
+  return static_cast<short>((wantReadable ? POLLIN : 0) |
+                            (wantWritable ? POLLOUT : 0));
+}
+
+}  // namespace
+
+GameNet::SocketPoller::~SocketPoller() = default;
+
+GameNet::SocketPollerPtr GameNet::SocketPoller::Create() {
+  return SocketPollerPtr(new SocketPoller());
+}
+
+int GameNet::SocketPoller::Add(SOCKET socket, void* userData,
+                               bool wantWritable, bool wantReadable) {
+  pollfd entry{};
+  entry.fd = socket;
+  entry.events = ToPollEvents(wantWritable, wantReadable);
+  mPollFds.push_back(entry);
+  mUserData.push_back(userData);
+  return NO_ERROR;
+}
+
+int GameNet::SocketPoller::Modify(SOCKET socket, void* userData,
+                                  bool wantWritable, bool wantReadable) {
+  for (size_t i = 0; i < mPollFds.size(); ++i) {
+    if (mPollFds[i].fd == socket) {
+      mPollFds[i].events = ToPollEvents(wantWritable, wantReadable);
+      mUserData[i] = userData;
+      return NO_ERROR;
+    }
+  }
+
+  Logger::Log(LOG_SEVERITY_ERROR, "%s: socket is not registered\n",
+              __FUNCTION__);
+  return SOCKET_ERROR;
+}
+
+int GameNet::SocketPoller::Remove(SOCKET socket) {
+  for (size_t i = 0; i < mPollFds.size(); ++i) {
+    if (mPollFds[i].fd == socket) {
+      // Order does not matter; swap with the last entry.
+      mPollFds[i] = mPollFds.back();
+      mUserData[i] = mUserData.back();
+      mPollFds.pop_back();
+      mUserData.pop_back();
+      return NO_ERROR;
+    }
+  }
+
+  Logger::Log(LOG_SEVERITY_ERROR, "%s: socket is not registered\n",
+              __FUNCTION__);
+  return SOCKET_ERROR;
+}
+
+int GameNet::SocketPoller::Wait(std::span<SocketPollEvent> outEvents,
+                                int timeoutMs) {
+#if _WIN32
+  int ready = WSAPoll(mPollFds.data(), static_cast<ULONG>(mPollFds.size()),
+                      timeoutMs);
+#else
+  int ready = poll(mPollFds.data(), mPollFds.size(), timeoutMs);
+#endif
+  if (ready < 0) {
+    int err = SocketUtil::GetLastError();
+#if !_WIN32
+    if (err == EINTR) {
+      return 0;
+    }
+#endif
+    Logger::Log(LOG_SEVERITY_ERROR, "%s: poll failed\n", __FUNCTION__);
+    return -err;
+  }
+
+  int count = 0;
+  for (size_t i = 0; i < mPollFds.size() && count < ready &&
+                     count < static_cast<int>(outEvents.size());
+       ++i) {
+    const short revents = mPollFds[i].revents;
+    if (revents == 0) {
+      continue;
+    }
+
+    SocketPollEvent& event = outEvents[count++];
+    event.userData = mUserData[i];
+    event.readable = (revents & POLLIN) != 0;
+    event.writable = (revents & POLLOUT) != 0;
+    event.error = (revents & (POLLERR | POLLHUP)) != 0;
+  }
+
+  return count;
+}
+
+#endif
@@ -1,5 +1,7 @@
 #include "socket/tcp_socket.h"
 
+#include <algorithm>
+
 #include "socket/socket_address.h"
 #include "socket/socket_util.h"
 
@@ -22,18 +24,37 @@ GameNet::TCPSocketPtr GameNet::TCPSocket::Create(SocketAddressFamily family) {
   return TCPSocketPtr(new TCPSocket(s));
 }
 
+namespace {
+
+bool IsConnectInProgress(int err) {
+#if _WIN32
+  return err == WSAEWOULDBLOCK;
+#else
+  return err == EINPROGRESS;
+#endif
+}
+
+}  // namespace
+
 int GameNet::TCPSocket::Connect(const SocketAddress& toAddr) {
-  int err = connect(mSocket, &toAddr.mSockAddr, toAddr.GetSockAddrSize());
+  int err =
+      connect(mSocket, toAddr.GetAsSockAddr(), toAddr.GetSockAddrSize());
   if (err < 0) {
+    err = SocketUtil::GetLastError();
+    if (IsConnectInProgress(err)) {
+      // Non-blocking socket: completion is reported as writability.
+      return -WSAEWOULDBLOCK;
+    }
     Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to connect\n", __FUNCTION__);
-    return -SocketUtil::GetLastError();
+    return -err;
   }
 
   return NO_ERROR;
 }
 
 int GameNet::TCPSocket::Bind(const SocketAddress& bindAddr) {
-  int err = bind(mSocket, &bindAddr.mSockAddr, bindAddr.GetSockAddrSize());
+  int err =
+      bind(mSocket, bindAddr.GetAsSockAddr(), bindAddr.GetSockAddrSize());
   if (err != 0) {
     Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to bind\n", __FUNCTION__);
     return SocketUtil::GetLastError();
@@ -53,9 +74,13 @@ int GameNet::TCPSocket::Listen(int backlog) {
 }
 
 GameNet::TCPSocketPtr GameNet::TCPSocket::Accept(SocketAddress& fromAddr) {
-  socklen_t socklen = fromAddr.GetSockAddrSize();
-  SOCKET newSocket = accept(mSocket, &fromAddr.mSockAddr, &socklen);
+  socklen_t socklen = SocketAddress::GetSockAddrCapacity();
+  SOCKET newSocket = accept(mSocket, fromAddr.GetAsSockAddr(), &socklen);
   if (newSocket == INVALID_SOCKET) {
+    if (SocketUtil::GetLastError() == WSAEWOULDBLOCK) {
+      // Non-blocking listener with no pending connection.
+      return nullptr;
+    }
     Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to accept\n", __FUNCTION__);
     return nullptr;
   }
@@ -66,8 +91,12 @@ GameNet::TCPSocketPtr GameNet::TCPSocket::Accept(SocketAddress& fromAddr) {
 int GameNet::TCPSocket::Send(const void* buf, int len) {
   int byteSent = send(mSocket, static_cast<const char*>(buf), len, 0);
   if (byteSent < 0) {
+    int err = SocketUtil::GetLastError();
+    if (err == WSAEWOULDBLOCK) {
+      return -WSAEWOULDBLOCK;
+    }
     Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to send\n", __FUNCTION__);
-    return -SocketUtil::GetLastError();
+    return -err;
   }
 
   return byteSent;
@@ -77,9 +106,145 @@ int GameNet::TCPSocket::Receive(void* buf, int maxLen) {
   int byteRecv = recv(mSocket, static_cast<char*>(buf), maxLen, 0);
 
   if (byteRecv < 0) {
+    int err = SocketUtil::GetLastError();
+    if (err == WSAEWOULDBLOCK) {
+      return -WSAEWOULDBLOCK;
+    }
     Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to receive\n", __FUNCTION__);
-    return -SocketUtil::GetLastError();
+    return -err;
   }
 
   return byteRecv;
 }
+
+int GameNet::TCPSocket::SendV(const std::span<const uint8_t>* segments,
+                              int segmentCount) {
+  segmentCount = std::min(segmentCount, kMaxSegments);
+
+#if _WIN32
+  WSABUF buffers[kMaxSegments];
+  for (int i = 0; i < segmentCount; ++i) {
+    buffers[i].buf = reinterpret_cast<char*>(
+        const_cast<uint8_t*>(segments[i].data()));
+    buffers[i].len = static_cast<ULONG>(segments[i].size());
+  }
+
+  DWORD byteSent = 0;
+  int res = WSASend(mSocket, buffers, segmentCount, &byteSent, 0, nullptr,
+                    nullptr);
+  if (res == SOCKET_ERROR) {
+#else
+  iovec buffers[kMaxSegments];
+  for (int i = 0; i < segmentCount; ++i) {
+    buffers[i].iov_base = const_cast<uint8_t*>(segments[i].data());
+    buffers[i].iov_len = segments[i].size();
+  }
+
+  msghdr message{};
+  message.msg_iov = buffers;
+  message.msg_iovlen = segmentCount;
+
+  int flags = 0;
+#if defined(MSG_NOSIGNAL)
+  // A peer reset must surface as EPIPE, not kill the process.
+  flags |= MSG_NOSIGNAL;
+#endif
+  ssize_t byteSent = sendmsg(mSocket, &message, flags);
+  if (byteSent < 0) {
+#endif
+    int err = SocketUtil::GetLastError();
+    if (err == WSAEWOULDBLOCK) {
+      return -WSAEWOULDBLOCK;
+    }
+    Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to send\n", __FUNCTION__);
+    return -err;
+  }
+
+  return static_cast<int>(byteSent);
+}
+
+int GameNet::TCPSocket::ReceiveV(const std::span<uint8_t>* segments,
+                                 int segmentCount) {
+  segmentCount = std::min(segmentCount, kMaxSegments);
+
+#if _WIN32
+  WSABUF buffers[kMaxSegments];
+  for (int i = 0; i < segmentCount; ++i) {
+    buffers[i].buf = reinterpret_cast<char*>(segments[i].data());
+    buffers[i].len = static_cast<ULONG>(segments[i].size());
+  }
+
+  DWORD byteRecv = 0;
+  DWORD flags = 0;
+  int res = WSARecv(mSocket, buffers, segmentCount, &byteRecv, &flags, nullptr,
+                    nullptr);
+  if (res == SOCKET_ERROR) {
+#else
+  iovec buffers[kMaxSegments];
+  for (int i = 0; i < segmentCount; ++i) {
+    buffers[i].iov_base = segments[i].data();
+    buffers[i].iov_len = segments[i].size();
+  }
+
+  msghdr message{};
+  message.msg_iov = buffers;
+  message.msg_iovlen = segmentCount;
+
+  ssize_t byteRecv = recvmsg(mSocket, &message, 0);
+  if (byteRecv < 0) {
+#endif
+    int err = SocketUtil::GetLastError();
+    if (err == WSAEWOULDBLOCK) {
+      return -WSAEWOULDBLOCK;
+    }
+    Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to receive\n", __FUNCTION__);
+    return -err;
+  }
+
+  return static_cast<int>(byteRecv);
+}
+
+int GameNet::TCPSocket::SetNonBlockingMode(bool nonBlocking) {
+#if _WIN32
+  unsigned long arg = nonBlocking ? 1ul : 0ul;
+  int res = ioctlsocket(mSocket, FIONBIO, &arg);
+#else
+  int flags = fcntl(mSocket, F_GETFL, 0);
+  flags = nonBlocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+  int res = fcntl(mSocket, F_SETFL, flags);
+#endif
+
+  if (res == SOCKET_ERROR) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to set non-blocking mode\n",
+                __FUNCTION__);
+    return SocketUtil::GetLastError();
+  }
+
+  return NO_ERROR;
+}
+
+int GameNet::TCPSocket::SetNoDelay(bool noDelay) {
+  int optionValue = noDelay ? 1 : 0;
+  int res = setsockopt(mSocket, IPPROTO_TCP, TCP_NODELAY,
+                       reinterpret_cast<const char*>(&optionValue),
+                       sizeof(optionValue));
+  if (res == SOCKET_ERROR) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to set TCP_NODELAY\n",
+                __FUNCTION__);
+    return SocketUtil::GetLastError();
+  }
+
+  return NO_ERROR;
+}
+
+int GameNet::TCPSocket::GetPendingError() const {
+  int optionValue = 0;
+  socklen_t optionLength = sizeof(optionValue);
+  int res = getsockopt(mSocket, SOL_SOCKET, SO_ERROR,
+                       reinterpret_cast<char*>(&optionValue), &optionLength);
+  if (res == SOCKET_ERROR) {
+    return SocketUtil::GetLastError();
+  }
+
+  return optionValue;
+}
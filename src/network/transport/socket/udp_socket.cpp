@@ -3,6 +3,10 @@
 #include "socket/socket_address.h"
 #include "socket/socket_util.h"
 
+#if defined(__linux__)
+#include <linux/filter.h>
+#endif
+
 GameNet::UDPSocket::~UDPSocket() {
 #if _WIN32
   closesocket(mSocket);
@@ -23,7 +27,8 @@ GameNet::UDPSocketPtr GameNet::UDPSocket::Create(SocketAddressFamily family) {
 }
 
 int GameNet::UDPSocket::Bind(const SocketAddress& bindAddr) {
-  int err = bind(mSocket, &bindAddr.mSockAddr, bindAddr.GetSockAddrSize());
+  int err =
+      bind(mSocket, bindAddr.GetAsSockAddr(), bindAddr.GetSockAddrSize());
   if (err != 0) {
     Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to bind\n", __FUNCTION__);
     return SocketUtil::GetLastError();
@@ -34,7 +39,7 @@ int GameNet::UDPSocket::Bind(const SocketAddress& bindAddr) {
 
 int GameNet::UDPSocket::SendTo(const void* buf, int len, const SocketAddress& toAddr) {
   int byteSent = sendto(mSocket, static_cast<const char*>(buf), len, 0,
-                        &toAddr.mSockAddr, toAddr.GetSockAddrSize());
+                        toAddr.GetAsSockAddr(), toAddr.GetSockAddrSize());
   if (byteSent < 0) {
     // Return error code as negative number.
     Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to send\n", __FUNCTION__);
@@ -45,16 +50,18 @@ int GameNet::UDPSocket::SendTo(const void* buf, int len, const SocketAddress& to
 }
 
 int GameNet::UDPSocket::ReceiveFrom(void* buf, int maxLen, SocketAddress& fromAddress) {
-  socklen_t fromAddrLen = fromAddress.GetSockAddrSize();
+  socklen_t fromAddrLen = SocketAddress::GetSockAddrCapacity();
 
   int byteRecv = recvfrom(mSocket, static_cast<char*>(buf), maxLen, 0,
-                          &fromAddress.mSockAddr, &fromAddrLen);
+                          fromAddress.GetAsSockAddr(), &fromAddrLen);
   if (byteRecv < 0) {
     int err = SocketUtil::GetLastError();
-#if _WIN32
     if (err == WSAEWOULDBLOCK) {
+      // Nothing to read on a non-blocking socket.
       return 0;
-    } else if (err == WSAECONNRESET) {
+    }
+#if _WIN32
+    if (err == WSAECONNRESET) {
       // This can happen if a client closed and we haven't DC'd yet.
       // This is the ICMP message being sent back saying the port on that
       // computer is closed
@@ -70,6 +77,59 @@ int GameNet::UDPSocket::ReceiveFrom(void* buf, int maxLen, SocketAddress& fromAd
   return byteRecv;
 }
 
+int GameNet::UDPSocket::ReceiveMessage(void* buf, int maxLen,
+                                       SocketAddress& fromAddress,
+                                       UDPReceiveInfo& outInfo) {
+  outInfo = UDPReceiveInfo{};
+#if defined(__linux__)
+  iovec segment{buf, static_cast<size_t>(maxLen)};
+
+  // Room for both control messages.
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(timespec)) +
+                                CMSG_SPACE(sizeof(uint32_t))];
+
+  msghdr message{};
+  message.msg_name = fromAddress.GetAsSockAddr();
+  message.msg_namelen = SocketAddress::GetSockAddrCapacity();
+  message.msg_iov = &segment;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+
+  const ssize_t byteRecv = recvmsg(mSocket, &message, 0);
+  if (byteRecv < 0) {
+    int err = SocketUtil::GetLastError();
+    if (err == WSAEWOULDBLOCK) {
+      // Nothing to read on a non-blocking socket.
+      return 0;
+    }
+    Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to receive\n", __FUNCTION__);
+    return -err;
+  }
+
+  for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr;
+       header = CMSG_NXTHDR(&message, header)) {
+    if (header->cmsg_level != SOL_SOCKET) {
+      continue;
+    }
+    if (header->cmsg_type == SCM_TIMESTAMPNS) {
+      timespec timestamp;
+      memcpy(&timestamp, CMSG_DATA(header), sizeof(timestamp));
+      outInfo.hasKernelTimestamp = true;
+      outInfo.kernelTimestamp = std::chrono::seconds(timestamp.tv_sec) +
+                                std::chrono::nanoseconds(timestamp.tv_nsec);
+    } else if (header->cmsg_type == SO_RXQ_OVFL) {
+      memcpy(&outInfo.dropCount, CMSG_DATA(header), sizeof(outInfo.dropCount));
+      outInfo.hasDropCount = true;
+    }
+  }
+
+  return static_cast<int>(byteRecv);
+#else
+  return ReceiveFrom(buf, maxLen, fromAddress);
+#endif
+}
+
 int GameNet::UDPSocket::SetNonBlockingMode(bool nonBlocking) {
 #if _WIN32
   unsigned long arg = nonBlocking ? 1ul : 0ul;
@@ -88,3 +148,118 @@ int GameNet::UDPSocket::SetNonBlockingMode(bool nonBlocking) {
 
   return NO_ERROR;
 }
+
+int GameNet::UDPSocket::SetReceiveBufferSize(int size) {
+  return SetIntOption(SOL_SOCKET, SO_RCVBUF, size, "SO_RCVBUF");
+}
+
+int GameNet::UDPSocket::SetSendBufferSize(int size) {
+  return SetIntOption(SOL_SOCKET, SO_SNDBUF, size, "SO_SNDBUF");
+}
+
+int GameNet::UDPSocket::EnableReceiveTimestamps(bool enable) {
+#if defined(__linux__)
+  return SetIntOption(SOL_SOCKET, SO_TIMESTAMPNS, enable ? 1 : 0,
+                      "SO_TIMESTAMPNS");
+#else
+  (void)enable;
+  Logger::Log(LOG_SEVERITY_ERROR, "%s: SO_TIMESTAMPNS is not supported\n",
+              __FUNCTION__);
+  return SOCKET_ERROR;
+#endif
+}
+
+int GameNet::UDPSocket::EnableDropCounter(bool enable) {
+#if defined(__linux__)
+  return SetIntOption(SOL_SOCKET, SO_RXQ_OVFL, enable ? 1 : 0, "SO_RXQ_OVFL");
+#else
+  (void)enable;
+  Logger::Log(LOG_SEVERITY_ERROR, "%s: SO_RXQ_OVFL is not supported\n",
+              __FUNCTION__);
+  return SOCKET_ERROR;
+#endif
+}
+
+int GameNet::UDPSocket::SetIntOption(int level, int option, int value,
+                                     const char* name) {
+  int res = setsockopt(mSocket, level, option,
+                       reinterpret_cast<const char*>(&value), sizeof(value));
+  if (res == SOCKET_ERROR) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to set %s\n", __FUNCTION__,
+                name);
+    return SocketUtil::GetLastError();
+  }
+
+  return NO_ERROR;
+}
+
+int GameNet::UDPSocket::SetReusePort(bool reusePort) {
+#if defined(SO_REUSEPORT)
+  int optionValue = reusePort ? 1 : 0;
+  int res = setsockopt(mSocket, SOL_SOCKET, SO_REUSEPORT,
+                       reinterpret_cast<const char*>(&optionValue),
+                       sizeof(optionValue));
+  if (res == SOCKET_ERROR) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to set SO_REUSEPORT\n",
+                __FUNCTION__);
+    return SocketUtil::GetLastError();
+  }
+
+  return NO_ERROR;
+#else
+  (void)reusePort;
+  Logger::Log(LOG_SEVERITY_ERROR, "%s: SO_REUSEPORT is not supported\n",
+              __FUNCTION__);
+  return SOCKET_ERROR;
+#endif
+}
+
+int GameNet::UDPSocket::AttachReusePortFlowSteering(uint32_t groupSize) {
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+  if (groupSize == 0) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s: group size must be positive\n",
+                __FUNCTION__);
+    return SOCKET_ERROR;
+  }
+
+  // The program runs with skb->data at the UDP payload, so the IPv4 and UDP
+  // headers are reached through the SKF_NET_OFF window.
+  // Returns hash(source ip ^ source port) % groupSize.
+  constexpr uint32_t kNetworkHeader = static_cast<uint32_t>(SKF_NET_OFF);
+  sock_filter code[] = {
+      // X = 4 * (ip[0] & 0xf), the IPv4 header length.
+      BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, kNetworkHeader + 0),
+      // A = udp source port, right after the IPv4 header.
+      BPF_STMT(BPF_LD | BPF_H | BPF_IND, kNetworkHeader + 0),
+      BPF_STMT(BPF_MISC | BPF_TAX, 0),
+      // A = ipv4 source address.
+      BPF_STMT(BPF_LD | BPF_W | BPF_ABS, kNetworkHeader + 12),
+      BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),
+      // Fibonacci hashing so neighbouring ports spread out.
+      BPF_STMT(BPF_ALU | BPF_MUL | BPF_K, 0x9E3779B1u),
+      BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 16),
+      BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, groupSize),
+      BPF_STMT(BPF_RET | BPF_A, 0),
+  };
+
+  sock_fprog program{};
+  program.len = static_cast<unsigned short>(std::size(code));
+  program.filter = code;
+
+  int res = setsockopt(mSocket, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF,
+                       &program, sizeof(program));
+  if (res == SOCKET_ERROR) {
+    Logger::Log(LOG_SEVERITY_ERROR,
+                "%s: failed to attach reuseport steering program\n",
+                __FUNCTION__);
+    return SocketUtil::GetLastError();
+  }
+
+  return NO_ERROR;
+#else
+  (void)groupSize;
+  Logger::Log(LOG_SEVERITY_ERROR,
+              "%s: SO_ATTACH_REUSEPORT_CBPF is not supported\n", __FUNCTION__);
+  return SOCKET_ERROR;
+#endif
+}
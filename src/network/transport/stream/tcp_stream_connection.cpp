@@ -0,0 +1,219 @@
+#include "stream/tcp_stream_connection.h"
+
+GameNet::TCPStreamConnection::TCPStreamConnection(
+    TCPSocketPtr socket, const TCPStreamSettings& settings, State state)
+    : mSocket(std::move(socket)),
+      mNativeHandle(mSocket->GetNativeHandle()),
+      mSettings(settings),
+      mState(state),
+      mSendQueue(settings.bufferBlockSize),
+      mReceiveQueue(settings.bufferBlockSize) {}
+
+GameNet::TCPStreamConnectionPtr GameNet::TCPStreamConnection::Connect(
+    const SocketAddress& address, const TCPStreamSettings& settings) {
+  if (!ValidateSettings(settings)) {
+    return nullptr;
+  }
+
+  TCPSocketPtr socket =
+      TCPSocket::Create(static_cast<SocketAddressFamily>(address.GetFamily()));
+  if (socket == nullptr) {
+    return nullptr;
+  }
+
+  if (socket->SetNonBlockingMode(true) != NO_ERROR) {
+    return nullptr;
+  }
+
+  if (settings.noDelay) {
+    socket->SetNoDelay(true);
+  }
+
+  int res = socket->Connect(address);
+  if (res != NO_ERROR && res != -WSAEWOULDBLOCK) {
+    return nullptr;
+  }
+
+  const State state = res == NO_ERROR ? State::Connected : State::Connecting;
+  return TCPStreamConnectionPtr(
+      new TCPStreamConnection(std::move(socket), settings, state));
+}
+
+GameNet::TCPStreamConnectionPtr GameNet::TCPStreamConnection::Adopt(
+    TCPSocketPtr socket, const TCPStreamSettings& settings) {
+  if (socket == nullptr || !ValidateSettings(settings)) {
+    return nullptr;
+  }
+
+  if (socket->SetNonBlockingMode(true) != NO_ERROR) {
+    return nullptr;
+  }
+
+  if (settings.noDelay) {
+    socket->SetNoDelay(true);
+  }
+
+  return TCPStreamConnectionPtr(
+      new TCPStreamConnection(std::move(socket), settings, State::Connected));
+}
+
+bool GameNet::TCPStreamConnection::SendMessage(
+    std::span<const uint8_t> message) {
+  if (message.size() > mSettings.maximumMessageSize) {
+    Logger::Log(LOG_SEVERITY_WARNING, "%s: message of %zu bytes is too large\n",
+                __FUNCTION__, message.size());
+    return false;
+  }
+
+  if (!IsWritable(message.size())) {
+    return false;
+  }
+
+  const uint32_t header = htonl(static_cast<uint32_t>(message.size()));
+  mSendQueue.Write(&header, kMessageHeaderSize);
+  if (!message.empty()) {
+    mSendQueue.Write(message.data(), message.size());
+  }
+
+  return true;
+}
+
+int GameNet::TCPStreamConnection::Flush() {
+  if (mState == State::Connecting && !FinishConnect()) {
+    return mState == State::Closed ? SOCKET_ERROR : 0;
+  }
+
+  if (mState != State::Connected) {
+    return 0;
+  }
+
+  int totalSent = 0;
+  while (!mSendQueue.Empty()) {
+    std::span<const uint8_t> segments[TCPSocket::kMaxSegments];
+    const size_t segmentCount =
+        mSendQueue.PeekSegments(segments, TCPSocket::kMaxSegments);
+
+    int sent = mSocket->SendV(segments, static_cast<int>(segmentCount));
+    if (sent == -WSAEWOULDBLOCK) {
+      break;
+    }
+    if (sent < 0) {
+      Close();
+      return sent;
+    }
+
+    mSendQueue.Discard(static_cast<size_t>(sent));
+    totalSent += sent;
+
+    size_t offered = 0;
+    for (size_t i = 0; i < segmentCount; ++i) {
+      offered += segments[i].size();
+    }
+    if (static_cast<size_t>(sent) < offered) {
+      // Kernel buffer is full; wait for the next writability event.
+      break;
+    }
+  }
+
+  return totalSent;
+}
+
+int GameNet::TCPStreamConnection::Receive() {
+  if (mState != State::Connected) {
+    return 0;
+  }
+
+  if (!WantsReceive()) {
+    return 0;
+  }
+
+  std::span<uint8_t> segments[TCPSocket::kMaxSegments];
+  const size_t segmentCount = mReceiveQueue.ReserveSegments(
+      mSettings.receiveChunkSize, segments, TCPSocket::kMaxSegments);
+
+  int received = mSocket->ReceiveV(segments, static_cast<int>(segmentCount));
+  if (received == -WSAEWOULDBLOCK) {
+    return 0;
+  }
+  if (received < 0) {
+    Close();
+    return received;
+  }
+  if (received == 0) {
+    // Orderly shutdown by the peer.
+    Close();
+    return 0;
+  }
+
+  mReceiveQueue.Commit(static_cast<size_t>(received));
+  return received;
+}
+
+bool GameNet::TCPStreamConnection::PollMessage(
+    std::vector<uint8_t>& outMessage) {
+  uint32_t header = 0;
+  if (!mReceiveQueue.Peek(&header, kMessageHeaderSize)) {
+    return false;
+  }
+
+  const size_t messageSize = ntohl(header);
+  if (messageSize > mSettings.maximumMessageSize) {
+    // The stream can no longer be framed.
+    Logger::Log(LOG_SEVERITY_ERROR, "%s: message of %zu bytes is too large\n",
+                __FUNCTION__, messageSize);
+    Close();
+    return false;
+  }
+
+  if (mReceiveQueue.Size() < kMessageHeaderSize + messageSize) {
+    return false;
+  }
+
+  mReceiveQueue.Discard(kMessageHeaderSize);
+  outMessage.resize(messageSize);
+  if (messageSize > 0) {
+    mReceiveQueue.Peek(outMessage.data(), messageSize);
+    mReceiveQueue.Discard(messageSize);
+  }
+
+  return true;
+}
+
+void GameNet::TCPStreamConnection::Close() {
+  if (mState == State::Closed) {
+    return;
+  }
+
+  mState = State::Closed;
+  mSendQueue.Discard(mSendQueue.Size());
+  mSocket.reset();
+}
+
+bool GameNet::TCPStreamConnection::ValidateSettings(
+    const TCPStreamSettings& settings) {
+  if (settings.maximumMessageSize > UINT32_MAX ||
+      settings.maximumMessageSize + kMessageHeaderSize >
+          settings.sendHighWaterMark) {
+    Logger::Log(LOG_SEVERITY_ERROR,
+                "%s error: sendHighWaterMark (%zu) must fit a message of "
+                "maximumMessageSize (%zu) and its header\n",
+                __FUNCTION__, settings.sendHighWaterMark,
+                settings.maximumMessageSize);
+    return false;
+  }
+
+  return true;
+}
+
+bool GameNet::TCPStreamConnection::FinishConnect() {
+  int err = mSocket->GetPendingError();
+  if (err != NO_ERROR) {
+    Logger::Log(LOG_SEVERITY_ERROR, "%s: failed to connect (%d)\n",
+                __FUNCTION__, err);
+    Close();
+    return false;
+  }
+
+  mState = State::Connected;
+  return true;
+}
@@ -0,0 +1,113 @@
+#include "server_manager.h"
+
+namespace {
+
+std::unique_ptr<GameNet::INetworkTransportEndpoint> MaybeRunOnNetworkThread(
+    std::unique_ptr<GameNet::INetworkTransportEndpoint> endpoint,
+    const GameNet::ServerManagerSettings& settings) {
+  if (!settings.useNetworkThread) {
+    return endpoint;
+  }
+  return std::make_unique<GameNet::ThreadedTransportEndpoint>(
+      std::move(endpoint), settings.networkThread);
+}
+
+}  // namespace
+
+GameNet::ServerManager::ServerManager(
+    std::unique_ptr<INetworkTransportEndpoint> endpoint,
+    const ServerManagerSettings& settings, const IClock& clock)
+    : mNetworkDriver(MaybeRunOnNetworkThread(std::move(endpoint), settings),
+                     settings.network, clock),
+      mJobSystem(JobSystemSettings{settings.workerThreadCount}),
+      mPacketBuildBatchSize(settings.packetBuildBatchSize),
+      mPipelinePacketBuild(settings.pipelinePacketBuild),
+      mPayloadCache(settings.payloadCacheEntryCount),
+      mPacketStreams(settings.network.maxClients) {
+  mPacketTargets.reserve(settings.network.maxClients);
+}
+
+GameNet::ServerManager::~ServerManager() {
+  // The build writes mPacketStreams; nothing is sent any more.
+  if (mPacketBuildJob) {
+    mJobSystem.Wait(mPacketBuildJob);
+  }
+}
+
+void GameNet::ServerManager::Tick() {
+  // Tick time is wall time even when the simulation runs on a ManualClock.
+  const ClockTimePoint startTime = SteadyClock::Get().Now();
+
+  // Before receiving: handlers may touch state the build reads.
+  if (mPipelinePacketBuild) {
+    SendBuiltPackets();
+  }
+
+  mNetworkDriver.ReceivePackets();
+  mNetworkDriver.Update();
+
+  // No build is in flight: a pipelined one was waited for above.
+  mPayloadCache.BeginTick();
+  if (mPacketBuildPrepare) {
+    mPacketBuildPrepare();
+  }
+  StartPacketBuild();
+  if (!mPipelinePacketBuild) {
+    SendBuiltPackets();
+  }
+  ++mTickCount;
+
+  mTickTimes.Record(SteadyClock::Get().Now() - startTime);
+}
+
+void GameNet::ServerManager::StartPacketBuild() {
+  if (!mPacketBuilder) {
+    return;
+  }
+
+  const ServerConnectionManager& connections = mNetworkDriver.GetConnections();
+  mPacketTargets.clear();
+  for (const uint32_t clientId : connections.GetConnectionIds()) {
+    mPacketTargets.push_back(
+        {clientId, connections.GetConnection(clientId).clientSalt});
+  }
+
+  mPacketBuildJob = mJobSystem.CreateJob([this] {
+    mJobSystem.ParallelFor(
+        static_cast<uint32_t>(mPacketTargets.size()), mPacketBuildBatchSize,
+        [this](uint32_t begin, uint32_t end) {
+          for (uint32_t i = begin; i < end; ++i) {
+            const uint32_t clientId = mPacketTargets[i].clientId;
+            OutputMemoryBitStream& stream = mPacketStreams[clientId];
+            stream.Reset();
+            mPacketBuilder(clientId, stream);
+          }
+        });
+  });
+  mJobSystem.Run(mPacketBuildJob);
+}
+
+void GameNet::ServerManager::SendBuiltPackets() {
+  if (!mPacketBuildJob) {
+    return;
+  }
+  mJobSystem.Wait(mPacketBuildJob);
+  mPacketBuildJob = nullptr;
+
+  // Sending touches the endpoint and the driver's buffers, so it stays on
+  // this thread, in the order the clients were built.
+  const ServerConnectionManager& connections = mNetworkDriver.GetConnections();
+  for (const PacketTarget& target : mPacketTargets) {
+    const OutputMemoryBitStream& stream = mPacketStreams[target.clientId];
+    // A pipelined build can outlive its client.
+    if (stream.GetBitLength() == 0 ||
+        !connections.IsConnected(target.clientId) ||
+        connections.GetConnection(target.clientId).clientSalt !=
+            target.clientSalt) {
+      continue;
+    }
+    mNetworkDriver.SendPayload(
+        target.clientId,
+        std::span<const uint8_t>(stream.GetBuffer(), stream.GetByteLength()));
+  }
+}
@@ -0,0 +1,144 @@
+// ConnectionTable lookups by source address at a large connection count.
+//
+// usage: connection_table_bench [connectionCount=10000] [rounds=100]
+//
+// Fills a ConnectionTable with connectionCount addresses, half of them
+// behind one NAT address (same IP, different ports), a quarter on their
+// own IPv4 address and a quarter IPv6, then times lookups of every
+// connection in random order and of as many addresses that aren't
+// connected, as a flood of strangers would cause. The same lookups on a
+// std::unordered_map are timed alongside for comparison.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "connection_table.h"
+
+namespace {
+
+using GameNet::SocketAddress;
+using BenchClock = std::chrono::steady_clock;
+
+SocketAddress MakeAddress(uint32_t i) {
+  switch (i % 4) {
+    case 0:
+    case 1: {
+      // A NAT hands out 32k ports per public address.
+      const uint32_t natIndex = i / 4 * 2 + i % 4;
+      return SocketAddress(0xC0A80001 + (natIndex >> 15),
+                           static_cast<uint16_t>(1024 + (natIndex & 0x7FFF)));
+    }
+    case 2:
+      return SocketAddress(0x0A000000 + i, 27015);
+    default: {
+      uint8_t address[16] = {0x20, 0x01, 0x0d, 0xb8};
+      for (int byte = 0; byte < 4; ++byte) {
+        address[12 + byte] = static_cast<uint8_t>(i >> (8 * (3 - byte)));
+      }
+      return SocketAddress(address, 27015);
+    }
+  }
+}
+
+struct Rates {
+  double hitsPerSecond{0};
+  double missesPerSecond{0};
+};
+
+template <typename Lookup>
+Rates Measure(Lookup&& lookup, const std::vector<SocketAddress>& connected,
+              const std::vector<SocketAddress>& strangers, int rounds) {
+  std::mt19937 random(42);
+  std::vector<uint32_t> order(connected.size());
+  for (uint32_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+
+  double hitSeconds = 0;
+  double missSeconds = 0;
+  uint64_t checksum = 0;
+  for (int round = 0; round < rounds; ++round) {
+    std::shuffle(order.begin(), order.end(), random);
+
+    BenchClock::time_point start = BenchClock::now();
+    for (const uint32_t i : order) {
+      checksum += lookup(connected[i]);
+    }
+    hitSeconds +=
+        std::chrono::duration<double>(BenchClock::now() - start).count();
+
+    start = BenchClock::now();
+    for (const uint32_t i : order) {
+      checksum += lookup(strangers[i]);
+    }
+    missSeconds +=
+        std::chrono::duration<double>(BenchClock::now() - start).count();
+  }
+
+  if (checksum == 1) {
+    std::printf("\n");  // keeps the lookups from being optimized out.
+  }
+  const double lookups = static_cast<double>(connected.size()) * rounds;
+  return {lookups / hitSeconds, lookups / missSeconds};
+}
+
+void Print(const char* name, const Rates& rates) {
+  std::printf("%-16s  %10.1f  %12.1f\n", name, rates.hitsPerSecond / 1e6,
+              rates.missesPerSecond / 1e6);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t connectionCount =
+      argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 10000;
+  const int rounds = argc > 2 ? std::atoi(argv[2]) : 100;
+
+  if (connectionCount == 0 || connectionCount > 100000) {
+    std::printf("connectionCount must be in [1, 100000]\n");
+    return 1;
+  }
+
+  std::vector<SocketAddress> connected;
+  std::vector<SocketAddress> strangers;
+  for (uint32_t i = 0; i < connectionCount; ++i) {
+    connected.push_back(MakeAddress(i));
+    strangers.push_back(MakeAddress(connectionCount + i));
+  }
+
+  std::printf("%u connections, millions of lookups per second\n",
+              connectionCount);
+  std::printf("%-16s  %10s  %12s\n", "table", "connected", "not connected");
+
+  GameNet::ConnectionTable<uint32_t> table(connectionCount);
+  for (uint32_t i = 0; i < connectionCount; ++i) {
+    table.Insert(connected[i], i);
+  }
+  Print("ConnectionTable",
+        Measure(
+            [&](const SocketAddress& address) {
+              const uint32_t* id = table.Find(address);
+              return id ? *id : 0u;
+            },
+            connected, strangers, rounds));
+
+  std::unordered_map<SocketAddress, uint32_t> map;
+  map.reserve(connectionCount);
+  for (uint32_t i = 0; i < connectionCount; ++i) {
+    map.emplace(connected[i], i);
+  }
+  Print("unordered_map",
+        Measure(
+            [&](const SocketAddress& address) {
+              const auto it = map.find(address);
+              return it != map.end() ? it->second : 0u;
+            },
+            connected, strangers, rounds));
+  return 0;
+}
@@ -0,0 +1,139 @@
+// Per-client packet building on the JobSystem by thread count.
+//
+// usage: job_system_bench [maxThreads=hardware_concurrency] [clientCount=256]
+//        [objectCount=4000] [passes=200]
+//
+// For 1, 2, ... maxThreads threads (the owning one plus workers), builds
+// one OutputMemoryBitStream per client with ParallelFor, the way
+// ServerManager does, each from a read-only world of objectCount objects:
+// the client writes every object within range of its own position. The
+// p50 of a pass and the speedup over one thread are printed, with a hash
+// of every stream that must not change with the thread count.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "core/job/job_system.h"
+#include "core/memory-stream/memory_bit_stream.h"
+#include "core/timer/tick_time_histogram.h"
+
+namespace {
+
+struct WorldObject {
+  float x;
+  float y;
+  float heading;
+  uint32_t state;
+};
+
+struct PassResult {
+  GameNet::ClockDuration p50;
+  uint64_t hash;
+};
+
+PassResult MeasurePasses(uint32_t threadCount,
+                         const std::vector<WorldObject>& world,
+                         uint32_t clientCount, int passCount) {
+  using namespace GameNet;
+
+  JobSystem jobSystem(JobSystemSettings{threadCount - 1});
+  std::vector<OutputMemoryBitStream> streams(clientCount);
+  TickTimeHistogram passTimes;
+
+  for (int pass = 0; pass < passCount; ++pass) {
+    const auto startTime = std::chrono::steady_clock::now();
+    jobSystem.ParallelFor(clientCount, 4, [&](uint32_t begin, uint32_t end) {
+      for (uint32_t clientId = begin; clientId < end; ++clientId) {
+        OutputMemoryBitStream& stream = streams[clientId];
+        stream.Reset();
+        const WorldObject& self = world[clientId % world.size()];
+        for (uint32_t i = 0; i < world.size(); ++i) {
+          const WorldObject& object = world[i];
+          const float dx = object.x - self.x;
+          const float dy = object.y - self.y;
+          if (dx * dx + dy * dy > 250.0f * 250.0f) {
+            continue;
+          }
+          stream.Write(i, 20);
+          stream.Write(object.x);
+          stream.Write(object.y);
+          stream.Write(object.heading);
+          stream.Write(object.state, 24);
+        }
+      }
+    });
+    passTimes.Record(std::chrono::steady_clock::now() - startTime);
+  }
+
+  // FNV-1a over every stream in client order.
+  uint64_t hash = 14695981039346656037ull;
+  for (const OutputMemoryBitStream& stream : streams) {
+    for (uint32_t i = 0; i < stream.GetByteLength(); ++i) {
+      hash = (hash ^ stream.GetBuffer()[i]) * 1099511628211ull;
+    }
+  }
+  return {passTimes.GetPercentile(0.5), hash};
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t maxThreads =
+      argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1]))
+               : std::max(std::thread::hardware_concurrency(), 1u);
+  const uint32_t clientCount =
+      argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 256;
+  const uint32_t objectCount =
+      argc > 3 ? static_cast<uint32_t>(std::atoi(argv[3])) : 4000;
+  const int passCount = argc > 4 ? std::atoi(argv[4]) : 200;
+
+  if (maxThreads == 0 || objectCount == 0) {
+    std::printf("maxThreads and objectCount must be positive\n");
+    return 1;
+  }
+
+  // A fixed pseudo-random world on a 2 km square.
+  std::vector<WorldObject> world(objectCount);
+  uint32_t random = 12345;
+  const auto next = [&random] {
+    random = random * 1664525u + 1013904223u;
+    return random;
+  };
+  for (WorldObject& object : world) {
+    object.x = static_cast<float>(next() % 2000);
+    object.y = static_cast<float>(next() % 2000);
+    object.heading = static_cast<float>(next() % 360);
+    object.state = next() & 0xFFFFFF;
+  }
+
+  const auto toMicros = [](GameNet::ClockDuration duration) {
+    return static_cast<long long>(
+        std::chrono::duration_cast<std::chrono::microseconds>(duration)
+            .count());
+  };
+
+  std::printf("threads  p50 us  speedup  hash\n");
+  PassResult baseline{};
+  for (uint32_t threadCount = 1; threadCount <= maxThreads; ++threadCount) {
+    const PassResult result =
+        MeasurePasses(threadCount, world, clientCount, passCount);
+    if (threadCount == 1) {
+      baseline = result;
+    }
+    std::printf("%7u  %6lld  %7.2f  %016llx\n", threadCount,
+                toMicros(result.p50),
+                static_cast<double>(baseline.p50.count()) /
+                    static_cast<double>(std::max<long long>(
+                        result.p50.count(), 1)),
+                static_cast<unsigned long long>(result.hash));
+    if (result.hash != baseline.hash) {
+      std::printf("streams differ from the single-threaded build\n");
+      return 1;
+    }
+  }
+  return 0;
+}
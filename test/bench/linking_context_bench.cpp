@@ -0,0 +1,173 @@
+// LinkingContext lookups at a large live object count.
+//
+// usage: linking_context_bench [objectCount=100000] [rounds=20]
+//
+// Links objectCount objects, then times id -> object and object -> id
+// lookups in random order and a churn pass that removes and re-links a
+// tenth of the objects. The same operations on the pair of unordered_maps
+// LinkingContext used to keep are timed alongside for comparison.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "linking_context.h"
+
+class GameObject {
+ public:
+  uint64_t state{0};
+};
+
+namespace {
+
+using BenchClock = std::chrono::steady_clock;
+
+// The layout LinkingContext had before generation-indexed slots.
+class MapLinkingContext {
+ public:
+  uint32_t GetNetworkId(const GameObject* gameObject) {
+    auto it = mNetworkIds.find(gameObject);
+    if (it != mNetworkIds.end()) {
+      return it->second;
+    }
+    const uint32_t networkId = mNextNetworkId++;
+    mGameObjects[networkId] = const_cast<GameObject*>(gameObject);
+    mNetworkIds[gameObject] = networkId;
+    return networkId;
+  }
+
+  GameObject* GetGameObject(uint32_t networkId) const {
+    auto it = mGameObjects.find(networkId);
+    return it != mGameObjects.end() ? it->second : nullptr;
+  }
+
+  void RemoveGameObject(const GameObject* gameObject) {
+    auto it = mNetworkIds.find(gameObject);
+    if (it != mNetworkIds.end()) {
+      mGameObjects.erase(it->second);
+      mNetworkIds.erase(it);
+    }
+  }
+
+ private:
+  std::unordered_map<uint32_t, GameObject*> mGameObjects;
+  std::unordered_map<const GameObject*, uint32_t> mNetworkIds;
+  uint32_t mNextNetworkId{1};
+};
+
+struct Timings {
+  double idToObjectNs{0};
+  double objectToIdNs{0};
+  double churnNs{0};
+};
+
+template <typename Context, typename GetId>
+Timings Measure(Context& context, GetId&& getId,
+                std::vector<GameObject>& objects, int rounds) {
+  const size_t objectCount = objects.size();
+  std::vector<uint32_t> ids(objectCount);
+  for (size_t i = 0; i < objectCount; ++i) {
+    ids[i] = getId(context, &objects[i]);
+  }
+
+  std::mt19937 random(42);
+  std::vector<uint32_t> order(objectCount);
+  for (uint32_t i = 0; i < objectCount; ++i) {
+    order[i] = i;
+  }
+
+  Timings timings;
+  uint64_t checksum = 0;
+  for (int round = 0; round < rounds; ++round) {
+    std::shuffle(order.begin(), order.end(), random);
+
+    BenchClock::time_point start = BenchClock::now();
+    for (const uint32_t i : order) {
+      checksum += context.GetGameObject(ids[i])->state;
+    }
+    timings.idToObjectNs +=
+        std::chrono::duration<double, std::nano>(BenchClock::now() - start)
+            .count();
+
+    start = BenchClock::now();
+    for (const uint32_t i : order) {
+      checksum += getId(context, &objects[i]);
+    }
+    timings.objectToIdNs +=
+        std::chrono::duration<double, std::nano>(BenchClock::now() - start)
+            .count();
+
+    start = BenchClock::now();
+    const size_t churnCount = objectCount / 10;
+    for (size_t n = 0; n < churnCount; ++n) {
+      context.RemoveGameObject(&objects[order[n]]);
+    }
+    for (size_t n = 0; n < churnCount; ++n) {
+      ids[order[n]] = getId(context, &objects[order[n]]);
+    }
+    timings.churnNs +=
+        std::chrono::duration<double, std::nano>(BenchClock::now() - start)
+            .count();
+  }
+
+  const double lookups = static_cast<double>(objectCount) * rounds;
+  timings.idToObjectNs /= lookups;
+  timings.objectToIdNs /= lookups;
+  timings.churnNs /= static_cast<double>(objectCount / 10) * rounds;
+  if (checksum == 1) {
+    std::printf("\n");  // keeps the lookups from being optimized out.
+  }
+  return timings;
+}
+
+void Print(const char* name, const Timings& timings) {
+  std::printf("%-16s  %12.1f  %12.1f  %15.1f\n", name, timings.idToObjectNs,
+              timings.objectToIdNs, timings.churnNs);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t objectCount =
+      argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 100000;
+  const int rounds = argc > 2 ? std::atoi(argv[2]) : 20;
+
+  if (objectCount < 10 || objectCount > GameNet::LinkingContext::kMaxObjects) {
+    std::printf("objectCount must be in [10, %u]\n",
+                GameNet::LinkingContext::kMaxObjects);
+    return 1;
+  }
+
+  std::vector<GameObject> objects(objectCount);
+  for (uint32_t i = 0; i < objectCount; ++i) {
+    objects[i].state = i;
+  }
+
+  std::printf("%u objects, ns per operation\n", objectCount);
+  std::printf("%-16s  %12s  %12s  %15s\n", "context", "id -> object",
+              "object -> id", "remove + relink");
+
+  GameNet::LinkingContext linkingContext(objectCount);
+  Print("LinkingContext",
+        Measure(
+            linkingContext,
+            [](GameNet::LinkingContext& context, const GameObject* object) {
+              return context.GetNetworkId(object, true);
+            },
+            objects, rounds));
+
+  MapLinkingContext mapContext;
+  Print("unordered_map x2",
+        Measure(
+            mapContext,
+            [](MapLinkingContext& context, const GameObject* object) {
+              return context.GetNetworkId(object);
+            },
+            objects, rounds));
+  return 0;
+}
@@ -0,0 +1,146 @@
+// Server tick cost with many clients over a LoopbackTransportHub.
+//
+// usage: loopback_server_bench [clientCount=1000] [ticks=600]
+//        [payloadBytes=64]
+//
+// Connects clientCount ClientNetworkDrivers to one ServerNetworkDriver, then
+// each tick every client sends a payload and the server receives them all,
+// runs Update() and sends every client a payload back. Only the server's
+// share of the tick is timed, and the heap allocations it makes are counted;
+// after warm-up there should be none.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "client_network_driver.h"
+#include "core/timer/tick_time_histogram.h"
+#include "endpoint/loopback_transport_hub.h"
+#include "logger/logger.h"
+#include "server_network_driver.h"
+
+// GCC pairs the free() below with the replaced operator new rather than the
+// malloc() inside it.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace {
+
+std::atomic<uint64_t> gAllocationCount{0};
+
+}  // namespace
+
+void* operator new(size_t size) {
+  gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void* pointer = std::malloc(size ? size : 1)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { std::free(pointer); }
+
+int main(int argc, char** argv) {
+  using namespace GameNet;
+
+  const uint32_t clientCount =
+      argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 1000;
+  const int tickCount = argc > 2 ? std::atoi(argv[2]) : 600;
+  const size_t payloadBytes =
+      argc > 3 ? static_cast<size_t>(std::atoi(argv[3])) : 64;
+  constexpr int kWarmUpTicks = 60;
+
+  Logger::SetLogLevel(LOG_SEVERITY_ERROR);
+
+  const SocketAddress serverAddress(0x7f000001, 40300);
+  std::shared_ptr<LoopbackTransportHub> hub =
+      LoopbackTransportHub::Create(serverAddress, clientCount);
+
+  ServerNetworkSettings serverSettings;
+  serverSettings.maxClients = clientCount;
+  ServerNetworkDriver server(hub->CreateServerEndpoint(), serverSettings,
+                             SteadyClock::Get());
+
+  std::vector<std::unique_ptr<ClientNetworkDriver>> clients;
+  for (uint32_t i = 0; i < clientCount; ++i) {
+    clients.push_back(std::make_unique<ClientNetworkDriver>(
+        hub->ConnectClient(SocketAddress(0x0a000000 + i, 50000)),
+        ClientNetworkSettings{}, SteadyClock::Get()));
+    clients.back()->Connect(serverAddress);
+  }
+
+  for (int round = 0; server.GetClientCount() < clientCount; ++round) {
+    if (round == 100) {
+      std::printf("only %u of %u clients connected\n",
+                  server.GetClientCount(), clientCount);
+      return 1;
+    }
+    server.ReceivePackets();
+    for (std::unique_ptr<ClientNetworkDriver>& client : clients) {
+      client->Update();
+    }
+  }
+
+  uint64_t clientReceivedCount = 0;
+  for (std::unique_ptr<ClientNetworkDriver>& client : clients) {
+    client->SetPayloadHandler(
+        [&](std::span<const uint8_t>) { ++clientReceivedCount; });
+  }
+  uint64_t serverReceivedCount = 0;
+  server.SetPayloadHandler(
+      [&](uint32_t, std::span<const uint8_t>) { ++serverReceivedCount; });
+
+  const std::vector<uint8_t> payload(payloadBytes, 0xAB);
+  TickTimeHistogram tickTimes;
+  uint64_t allocationCount = 0;
+
+  for (int tick = 0; tick < kWarmUpTicks + tickCount; ++tick) {
+    for (std::unique_ptr<ClientNetworkDriver>& client : clients) {
+      client->SendPayload(payload);
+    }
+
+    const uint64_t allocationsBefore = gAllocationCount.load();
+    const ClockTimePoint startTime = SteadyClock::Get().Now();
+    server.ReceivePackets();
+    server.Update();
+    for (const uint32_t clientId : server.GetConnections().GetConnectionIds()) {
+      server.SendPayload(clientId, payload);
+    }
+    if (tick >= kWarmUpTicks) {
+      tickTimes.Record(SteadyClock::Get().Now() - startTime);
+      allocationCount += gAllocationCount.load() - allocationsBefore;
+    }
+
+    for (std::unique_ptr<ClientNetworkDriver>& client : clients) {
+      client->Update();
+    }
+  }
+
+  const auto toMicros = [](ClockDuration duration) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+        .count();
+  };
+  const DeliveryNotificationManager& serverDelivery =
+      server.GetConnections().GetConnection(0).deliveryNotificationManager;
+
+  std::printf("clients  ticks  p50 us  p99 us  max us  allocations\n");
+  std::printf("%7u  %5d  %6lld  %6lld  %6lld  %11llu\n", clientCount,
+              tickCount,
+              static_cast<long long>(toMicros(tickTimes.GetPercentile(0.5))),
+              static_cast<long long>(toMicros(tickTimes.GetPercentile(0.99))),
+              static_cast<long long>(toMicros(tickTimes.GetMax())),
+              static_cast<unsigned long long>(allocationCount));
+  std::printf("payloads received: server %llu, clients %llu; client 0 "
+              "delivered %u, dropped %u\n",
+              static_cast<unsigned long long>(serverReceivedCount),
+              static_cast<unsigned long long>(clientReceivedCount),
+              serverDelivery.GetDeliveredPacketCount(),
+              serverDelivery.GetDroppedPacketCount());
+  return 0;
+}
@@ -0,0 +1,282 @@
+// ServerManager packet builds with and without the ReplicationPayloadCache.
+//
+// usage: payload_cache_bench [clientCount=256] [objectCount=1000]
+//        [ticks=600] [dirtyPercent=5] [workerThreads=0]
+//
+// Connects clientCount clients to a ServerManager over a LoopbackTransportHub
+// and replicates objectCount objects to all of them. Each tick dirtyPercent
+// of the objects move, and every client's packet gets their changed
+// properties. Without the cache each builder serializes every object itself;
+// with it, PacketBuildPrepare serializes each change once and the builders
+// splice it in. The p50/p99 of ServerManager::Tick() and the serializer
+// runs per tick are printed for both; the second should be per object, not
+// per object and client, and the bytes each client got must match.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "client_network_driver.h"
+#include "endpoint/loopback_transport_hub.h"
+#include "logger/logger.h"
+#include "replication_manager.h"
+#include "server/server_manager.h"
+
+namespace {
+
+using namespace GameNet;
+
+constexpr uint32_t kPacketBudgetBytes = 1000;
+constexpr int kWarmUpTicks = 60;
+
+struct Entity {
+  float x{0};
+  float y{0};
+  float z{0};
+  float yaw{0};
+  uint8_t health{100};
+  uint16_t ammo{0};
+  uint8_t team{0};
+  bool grounded{true};
+};
+
+uint32_t Quantize(float value, float minValue, float maxValue,
+                  uint32_t bitCount) {
+  const float steps = static_cast<float>((1u << bitCount) - 1);
+  const float clamped = std::clamp(value, minValue, maxValue);
+  return static_cast<uint32_t>((clamped - minValue) *
+                                   (steps / (maxValue - minValue)) +
+                               0.5f);
+}
+
+void WriteEntity(OutputMemoryBitStream& outStream, const Entity& inEntity,
+                 const ReplicationDirtyState& inDirtyState) {
+  if (inDirtyState.Test(0)) {
+    outStream.Write(Quantize(inEntity.x, -4096, 4096, 18), 18);
+  }
+  if (inDirtyState.Test(1)) {
+    outStream.Write(Quantize(inEntity.y, -4096, 4096, 18), 18);
+  }
+  if (inDirtyState.Test(2)) {
+    outStream.Write(Quantize(inEntity.z, -512, 512, 14), 14);
+  }
+  if (inDirtyState.Test(3)) {
+    outStream.Write(Quantize(inEntity.yaw, 0, 360, 10), 10);
+  }
+  if (inDirtyState.Test(4)) {
+    outStream.Write(inEntity.health, 7);
+  }
+  if (inDirtyState.Test(5)) {
+    outStream.Write(std::min<uint16_t>(inEntity.ammo, 1000), 10);
+  }
+  if (inDirtyState.Test(6)) {
+    outStream.Write(inEntity.team, 2);
+  }
+  if (inDirtyState.Test(7)) {
+    outStream.Write(inEntity.grounded);
+  }
+}
+
+struct PhaseResult {
+  ClockDuration p50{};
+  ClockDuration p99{};
+  double serializationsPerTick{0};
+  uint64_t bytesSent{0};
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t clientCount =
+      argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 256;
+  const uint32_t objectCount =
+      argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 1000;
+  const int tickCount = argc > 3 ? std::atoi(argv[3]) : 600;
+  const uint32_t dirtyPercent =
+      argc > 4 ? static_cast<uint32_t>(std::atoi(argv[4])) : 5;
+  const uint32_t workerThreads =
+      argc > 5 ? static_cast<uint32_t>(std::atoi(argv[5])) : 0;
+
+  if (objectCount == 0 || objectCount >= LinkingContext::kMaxObjects ||
+      clientCount == 0) {
+    std::printf("objectCount must be in [1, %u) and clientCount positive\n",
+                LinkingContext::kMaxObjects);
+    return 1;
+  }
+
+  Logger::SetLogLevel(LOG_SEVERITY_ERROR);
+
+  const SocketAddress serverAddress(0x7f000001, 40300);
+  std::shared_ptr<LoopbackTransportHub> hub =
+      LoopbackTransportHub::Create(serverAddress, clientCount);
+
+  ServerManagerSettings settings;
+  settings.network.maxClients = clientCount;
+  settings.workerThreadCount = workerThreads;
+  settings.payloadCacheEntryCount = objectCount;
+  ServerManager server(hub->CreateServerEndpoint(), settings);
+
+  std::vector<std::unique_ptr<ClientNetworkDriver>> clients;
+  for (uint32_t i = 0; i < clientCount; ++i) {
+    clients.push_back(std::make_unique<ClientNetworkDriver>(
+        hub->ConnectClient(SocketAddress(0x0a000000 + i, 50000)),
+        ClientNetworkSettings{}, SteadyClock::Get()));
+    clients.back()->Connect(serverAddress);
+  }
+  const auto updateClients = [&] {
+    for (std::unique_ptr<ClientNetworkDriver>& client : clients) {
+      client->Update();
+    }
+  };
+
+  for (int round = 0;
+       server.GetNetworkDriver().GetClientCount() < clientCount; ++round) {
+    if (round == 100) {
+      std::printf("only %u of %u clients connected\n",
+                  server.GetNetworkDriver().GetClientCount(), clientCount);
+      return 1;
+    }
+    server.Tick();
+    updateClients();
+  }
+
+  ReplicationManagerSettings replicationSettings;
+  replicationSettings.maxConnections = clientCount;
+  replicationSettings.expectedObjectCount = objectCount;
+  ReplicationManager replicationManager(replicationSettings);
+  // Slot i, generation 1.
+  const auto networkIdOf = [](uint32_t i) {
+    return (1u << LinkingContext::kIndexBits) | (i + 1);
+  };
+  std::vector<Entity> entities(objectCount);
+  for (uint32_t i = 0; i < objectCount; ++i) {
+    replicationManager.ReplicateCreate(networkIdOf(i),
+                                       ReplicationDirtyState(0xFF));
+  }
+  for (const uint32_t clientId :
+       server.GetNetworkDriver().GetConnections().GetConnectionIds()) {
+    replicationManager.AddConnection(clientId);
+  }
+
+  bool useCache = false;
+  int tick = 0;
+  // Per client, so the builders share nothing they write.
+  std::vector<uint64_t> serializationCounts(clientCount, 0);
+  std::vector<uint64_t> bytesSent(clientCount, 0);
+  uint64_t prepareSerializationCount = 0;
+
+  server.SetPacketBuildPrepare([&] {
+    ReplicationPayloadCache& cache = server.GetPayloadCache();
+    for (uint32_t i = 0; i < objectCount; ++i) {
+      if ((i + static_cast<uint32_t>(tick) * 7u) * 7919u % 100 >=
+          dirtyPercent) {
+        continue;
+      }
+      // x, y and yaw; every tenth also took damage.
+      Entity& entity = entities[i];
+      entity.x += 0.5f;
+      entity.y -= 0.25f;
+      entity.yaw = static_cast<float>((i + tick) % 360);
+      ReplicationDirtyState moved(0xB);
+      if (i % 10 == 0) {
+        entity.health = static_cast<uint8_t>((entity.health + 99) % 101);
+        moved.Set(4);
+      }
+      replicationManager.AddDirtyState(networkIdOf(i), moved);
+      if (useCache) {
+        cache.Add(networkIdOf(i), moved, ReplicationPayloadCache::kNoBaseline,
+                  [&](OutputMemoryBitStream& outStream) {
+                    WriteEntity(outStream, entity, moved);
+                    ++prepareSerializationCount;
+                  });
+      }
+    }
+  });
+
+  server.SetPacketBuilder([&](uint32_t clientId,
+                              OutputMemoryBitStream& outStream) {
+    const ReplicationPayloadCache& cache = server.GetPayloadCache();
+    replicationManager.ForEachDirty(
+        clientId, [&](uint32_t networkId, ReplicationCommand& command) {
+          if (outStream.GetByteLength() >= kPacketBudgetBytes) {
+            return;
+          }
+          const ReplicationDirtyState dirtyState = command.GetDirtyState();
+          outStream.Write(networkId);
+          outStream.Write(static_cast<uint8_t>(dirtyState.GetWord(0)));
+          if (!useCache ||
+              !cache.Write(outStream, networkId, dirtyState,
+                           ReplicationPayloadCache::kNoBaseline)) {
+            WriteEntity(outStream,
+                        entities[LinkingContext::GetIndex(networkId) - 1],
+                        dirtyState);
+            ++serializationCounts[clientId];
+          }
+          // As if every packet arrived.
+          command.HandleCreateAckd();
+          command.ClearDirtyState(dirtyState);
+        });
+    bytesSent[clientId] += outStream.GetByteLength();
+  });
+
+  const auto runPhase = [&] {
+    for (int i = 0; i < kWarmUpTicks; ++i, ++tick) {
+      server.Tick();
+      updateClients();
+    }
+    std::fill(serializationCounts.begin(), serializationCounts.end(), 0);
+    std::fill(bytesSent.begin(), bytesSent.end(), 0);
+    prepareSerializationCount = 0;
+    server.ResetTickTimes();
+    for (int i = 0; i < tickCount; ++i, ++tick) {
+      server.Tick();
+      updateClients();
+    }
+
+    PhaseResult result;
+    result.p50 = server.GetTickTimes().GetPercentile(0.5);
+    result.p99 = server.GetTickTimes().GetPercentile(0.99);
+    uint64_t serializationCount = prepareSerializationCount;
+    for (uint32_t clientId = 0; clientId < clientCount; ++clientId) {
+      serializationCount += serializationCounts[clientId];
+      result.bytesSent += bytesSent[clientId];
+    }
+    result.serializationsPerTick =
+        static_cast<double>(serializationCount) / tickCount;
+    return result;
+  };
+
+  // Both phases start from the same world and tick, so they send the same.
+  const std::vector<Entity> initialEntities = entities;
+  const PhaseResult uncached = runPhase();
+  entities = initialEntities;
+  tick = 0;
+  useCache = true;
+  const PhaseResult cached = runPhase();
+
+  const auto toMicros = [](ClockDuration duration) {
+    return static_cast<long long>(
+        std::chrono::duration_cast<std::chrono::microseconds>(duration)
+            .count());
+  };
+  std::printf("%u clients, %u objects, %u%% dirty, %u workers\n", clientCount,
+              objectCount, dirtyPercent, workerThreads);
+  std::printf("%-8s  %6s  %6s  %17s  %14s\n", "cache", "p50 us", "p99 us",
+              "serializes/tick", "bytes/client");
+  const PhaseResult* results[] = {&uncached, &cached};
+  for (int i = 0; i < 2; ++i) {
+    std::printf("%-8s  %6lld  %6lld  %17.1f  %14.1f\n", i ? "on" : "off",
+                toMicros(results[i]->p50), toMicros(results[i]->p99),
+                results[i]->serializationsPerTick,
+                static_cast<double>(results[i]->bytesSent) / clientCount /
+                    tickCount);
+  }
+  if (uncached.bytesSent != cached.bytesSent) {
+    std::printf("the two phases sent different amounts\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,190 @@
+// auto-gen serializers against hand-written ones for the same component.
+//
+// usage: replicated_serializer_bench [objectCount=1000] [rounds=2000]
+//
+// Writes and reads back objectCount PlayerComponents (see
+// replicated_serializer_component.h) with the generated BitStreamWriter
+// and BitStreamReader, and with a serializer written by hand to the same
+// 80-bit layout, and prints ns per object for full writes, writes of two
+// dirty properties and full reads. The two must produce the same bytes.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "bench/replicated_serializer_component.gen.h"
+
+namespace {
+
+using namespace GameNet;
+using Bench::PlayerComponent;
+using BenchClock = std::chrono::steady_clock;
+
+uint32_t Quantize(float value, float minValue, float maxValue,
+                  uint32_t bitCount) {
+  const float steps = static_cast<float>((1u << bitCount) - 1);
+  const float clamped = std::clamp(value, minValue, maxValue);
+  return static_cast<uint32_t>((clamped - minValue) *
+                                   (steps / (maxValue - minValue)) +
+                               0.5f);
+}
+
+float Dequantize(uint32_t quantized, float minValue, float maxValue,
+                 uint32_t bitCount) {
+  const float steps = static_cast<float>((1u << bitCount) - 1);
+  return minValue +
+         static_cast<float>(quantized) * ((maxValue - minValue) / steps);
+}
+
+void WriteByHand(OutputMemoryBitStream& outStream,
+                 const PlayerComponent& inObject,
+                 const ReplicationDirtyState& inDirtyState) {
+  if (inDirtyState.Test(0)) {
+    outStream.Write(Quantize(inObject.x, -4096, 4096, 18), 18);
+  }
+  if (inDirtyState.Test(1)) {
+    outStream.Write(Quantize(inObject.y, -4096, 4096, 18), 18);
+  }
+  if (inDirtyState.Test(2)) {
+    outStream.Write(Quantize(inObject.z, -512, 512, 14), 14);
+  }
+  if (inDirtyState.Test(3)) {
+    outStream.Write(Quantize(inObject.yaw, 0, 360, 10), 10);
+  }
+  if (inDirtyState.Test(4)) {
+    outStream.Write(inObject.health, 7);
+  }
+  if (inDirtyState.Test(5)) {
+    outStream.Write(
+        static_cast<uint16_t>(std::min<uint16_t>(inObject.ammo, 1000)), 10);
+  }
+  if (inDirtyState.Test(6)) {
+    outStream.Write(inObject.team, 2);
+  }
+  if (inDirtyState.Test(7)) {
+    outStream.Write(inObject.grounded);
+  }
+}
+
+void ReadByHand(InputMemoryBitStream& inStream, PlayerComponent& outObject) {
+  uint32_t quantized = 0;
+  inStream.Read(quantized, 18);
+  outObject.x = Dequantize(quantized, -4096, 4096, 18);
+  quantized = 0;
+  inStream.Read(quantized, 18);
+  outObject.y = Dequantize(quantized, -4096, 4096, 18);
+  quantized = 0;
+  inStream.Read(quantized, 14);
+  outObject.z = Dequantize(quantized, -512, 512, 14);
+  quantized = 0;
+  inStream.Read(quantized, 10);
+  outObject.yaw = Dequantize(quantized, 0, 360, 10);
+  outObject.health = 0;
+  inStream.Read(outObject.health, 7);
+  outObject.ammo = 0;
+  inStream.Read(outObject.ammo, 10);
+  uint8_t team = 0;
+  inStream.Read(team, 2);
+  outObject.team = static_cast<Bench::Team>(team);
+  inStream.Read(outObject.grounded);
+}
+
+template <typename Function>
+double NsPerObject(Function&& function, size_t objectCount, int rounds) {
+  const BenchClock::time_point start = BenchClock::now();
+  for (int round = 0; round < rounds; ++round) {
+    function();
+  }
+  return std::chrono::duration<double, std::nano>(BenchClock::now() - start)
+             .count() /
+         (static_cast<double>(objectCount) * rounds);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t objectCount =
+      argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 1000;
+  const int rounds = argc > 2 ? std::atoi(argv[2]) : 2000;
+
+  std::vector<PlayerComponent> objects(objectCount);
+  for (uint32_t i = 0; i < objectCount; ++i) {
+    PlayerComponent& object = objects[i];
+    object.x = static_cast<float>(i % 8000) - 4000.0f;
+    object.y = static_cast<float>(i * 7 % 8000) - 4000.0f;
+    object.z = static_cast<float>(i % 1000) * 0.5f - 250.0f;
+    object.yaw = static_cast<float>(i % 360);
+    object.health = static_cast<uint8_t>(i % 101);
+    object.ammo = static_cast<uint16_t>(i % 1001);
+    object.team = static_cast<Bench::Team>(i % 3);
+    object.grounded = i % 2 == 0;
+  }
+
+  const ReplicationDirtyState allDirty =
+      ReplicatedProperties<PlayerComponent>::kAllDirtyState;
+  // x and y, as for an object that only moved.
+  const ReplicationDirtyState moved(0x3);
+
+  OutputMemoryBitStream generatedStream(objectCount * 80);
+  OutputMemoryBitStream handStream(objectCount * 80);
+  const auto writeGenerated = [&](const ReplicationDirtyState& dirtyState) {
+    generatedStream.Reset();
+    for (const PlayerComponent& object : objects) {
+      BitStreamWriter<PlayerComponent>()(generatedStream, object, dirtyState);
+    }
+  };
+  const auto writeByHand = [&](const ReplicationDirtyState& dirtyState) {
+    handStream.Reset();
+    for (const PlayerComponent& object : objects) {
+      WriteByHand(handStream, object, dirtyState);
+    }
+  };
+
+  writeGenerated(allDirty);
+  writeByHand(allDirty);
+  if (generatedStream.GetBitLength() != handStream.GetBitLength() ||
+      !std::equal(generatedStream.GetBuffer(),
+                  generatedStream.GetBuffer() +
+                      generatedStream.GetByteLength(),
+                  handStream.GetBuffer())) {
+    std::printf("generated and hand-written output differ\n");
+    return 1;
+  }
+  const std::vector<uint8_t> bytes(
+      generatedStream.GetBuffer(),
+      generatedStream.GetBuffer() + generatedStream.GetByteLength());
+
+  std::vector<PlayerComponent> readBack(objectCount);
+  InputMemoryBitStream inStream(bytes.size() << 3);
+  const auto readGenerated = [&] {
+    inStream.Reset(bytes.data(), static_cast<uint32_t>(bytes.size()));
+    for (PlayerComponent& object : readBack) {
+      inStream.Read(object);
+    }
+  };
+  const auto readByHand = [&] {
+    inStream.Reset(bytes.data(), static_cast<uint32_t>(bytes.size()));
+    for (PlayerComponent& object : readBack) {
+      ReadByHand(inStream, object);
+    }
+  };
+
+  std::printf("%u objects of %u bits, ns per object\n", objectCount,
+              generatedStream.GetBitLength() / objectCount);
+  std::printf("%-12s  %10s  %12s  %9s\n", "serializer", "full write",
+              "x, y written", "full read");
+  std::printf("%-12s  %10.1f  %12.1f  %9.1f\n", "auto-gen",
+              NsPerObject([&] { writeGenerated(allDirty); }, objectCount,
+                          rounds),
+              NsPerObject([&] { writeGenerated(moved); }, objectCount,
+                          rounds),
+              NsPerObject(readGenerated, objectCount, rounds));
+  std::printf("%-12s  %10.1f  %12.1f  %9.1f\n", "hand-written",
+              NsPerObject([&] { writeByHand(allDirty); }, objectCount,
+                          rounds),
+              NsPerObject([&] { writeByHand(moved); }, objectCount, rounds),
+              NsPerObject(readByHand, objectCount, rounds));
+  return 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+#include "network/replication/replicated_property.h"
+
+namespace GameNet::Bench {
+
+enum class Team : uint8_t { Red, Blue, Spectator };
+
+// The annotated side of replicated_serializer_bench.cpp.
+struct PlayerComponent {
+  GAMENET_REPLICATED_CLASS();
+
+  GAMENET_REPLICATED(bits = 18, min = -4096, max = 4096)
+  float x;
+  GAMENET_REPLICATED(bits = 18, min = -4096, max = 4096)
+  float y;
+  GAMENET_REPLICATED(bits = 14, min = -512, max = 512)
+  float z;
+  GAMENET_REPLICATED(bits = 10, min = 0, max = 360)
+  float yaw;
+  GAMENET_REPLICATED(bits = 7)
+  uint8_t health;
+  GAMENET_REPLICATED(bits = 10, min = 0, max = 1000)
+  uint16_t ammo;
+  GAMENET_REPLICATED(bits = 2)
+  Team team;
+  GAMENET_REPLICATED()
+  bool grounded;
+};
+
+}  // namespace GameNet::Bench
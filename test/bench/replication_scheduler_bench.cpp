@@ -0,0 +1,149 @@
+// ReplicationScheduler pass time at a large object and client count.
+//
+// usage: replication_scheduler_bench [objectCount=10000] [clientCount=100]
+//        [ticks=1200] [dirtyPercent=100] [workerThreads=0]
+//
+// Replicates objectCount objects to clientCount connections. Each 60 Hz
+// tick marks dirtyPercent of them dirty, then schedules one packet for
+// every connection, one job per connection on a JobSystem, and the p50/p99
+// of that whole pass are printed with the objects each connection was sent
+// per tick. The pass is O(dirty objects x connections) and splits evenly
+// across threads, so compare workerThreads=0 with one per spare core.
+//
+// Objects get weights from 1 to 8 and mixed sizes, and one in a thousand is
+// larger than a packet, so the longest any object waited to be sent is
+// printed too. With everything dirty every tick, a weight-1 object gets its
+// share every (total weight / objects sent per tick) ticks, which is printed
+// alongside; a much longer wait means something starved. Run for more ticks
+// than that to tell.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "core/job/job_system.h"
+#include "core/timer/tick_time_histogram.h"
+#include "replication_scheduler.h"
+
+int main(int argc, char** argv) {
+  using namespace GameNet;
+
+  const uint32_t objectCount =
+      argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 10000;
+  const uint32_t clientCount =
+      argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 100;
+  const int tickCount = argc > 3 ? std::atoi(argv[3]) : 1200;
+  const uint32_t dirtyPercent =
+      argc > 4 ? static_cast<uint32_t>(std::atoi(argv[4])) : 100;
+  const uint32_t workerThreads =
+      argc > 5 ? static_cast<uint32_t>(std::atoi(argv[5])) : 0;
+  constexpr auto kTickPeriod = std::chrono::microseconds(16667);
+
+  if (objectCount == 0 || objectCount >= LinkingContext::kMaxObjects ||
+      clientCount == 0) {
+    std::printf("objectCount must be in [1, %u) and clientCount positive\n",
+                LinkingContext::kMaxObjects);
+    return 1;
+  }
+
+  ReplicationManagerSettings managerSettings;
+  managerSettings.maxConnections = clientCount;
+  managerSettings.expectedObjectCount = objectCount;
+  ReplicationManager replicationManager(managerSettings);
+
+  ClockTimePoint currTime{};
+  ReplicationScheduler scheduler(clientCount, currTime);
+  for (uint32_t connectionId = 0; connectionId < clientCount; ++connectionId) {
+    replicationManager.AddConnection(connectionId);
+  }
+
+  // Slot i, generation 1.
+  const auto networkIdOf = [](uint32_t i) {
+    return (1u << LinkingContext::kIndexBits) | (i + 1);
+  };
+  for (uint32_t i = 0; i < objectCount; ++i) {
+    replicationManager.ReplicateCreate(networkIdOf(i),
+                                       ReplicationDirtyState(1));
+  }
+
+  const auto weight = [](uint32_t networkId, const ReplicationCommand&) {
+    return 1.0f + static_cast<float>(networkId % 8);
+  };
+  const auto estimateBits = [](uint32_t networkId, const ReplicationCommand&) {
+    const uint32_t index = LinkingContext::GetIndex(networkId);
+    return index % 1000 == 0 ? 20000u : 32u + index % 256;
+  };
+
+  JobSystem jobSystem(JobSystemSettings{workerThreads});
+
+  // Per connection, so the jobs share nothing.
+  std::vector<int> lastSentTick(static_cast<size_t>(objectCount) * clientCount,
+                                -1);
+  std::vector<int> longestWaits(clientCount, 0);
+  std::vector<uint64_t> sentCounts(clientCount, 0);
+  TickTimeHistogram passTimes;
+
+  for (int tick = 0; tick < tickCount; ++tick) {
+    currTime += kTickPeriod;
+    for (uint32_t i = 0; i < objectCount; ++i) {
+      if (i * 7919u % 100 < dirtyPercent) {
+        replicationManager.AddDirtyState(networkIdOf(i),
+                                         ReplicationDirtyState(1));
+      }
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    jobSystem.ParallelFor(clientCount, 1, [&](uint32_t begin, uint32_t end) {
+      for (uint32_t connectionId = begin; connectionId < end; ++connectionId) {
+        scheduler.Schedule(
+            replicationManager, connectionId, currTime, weight, estimateBits,
+            [&](uint32_t networkId, ReplicationCommand& command) {
+              command.HandleCreateAckd();
+              command.ClearDirtyState(command.GetDirtyState());
+              int& sentTick =
+                  lastSentTick[static_cast<size_t>(connectionId) * objectCount +
+                               LinkingContext::GetIndex(networkId) - 1];
+              longestWaits[connectionId] =
+                  std::max(longestWaits[connectionId], tick - sentTick);
+              sentTick = tick;
+              ++sentCounts[connectionId];
+            });
+      }
+    });
+    passTimes.Record(std::chrono::steady_clock::now() - startTime);
+  }
+
+  // Including the objects still waiting, which are dirty every tick.
+  int longestWait = *std::max_element(longestWaits.begin(), longestWaits.end());
+  for (const int sentTick : lastSentTick) {
+    longestWait = std::max(longestWait, tickCount - 1 - sentTick);
+  }
+  uint64_t sentCount = 0;
+  for (const uint64_t count : sentCounts) {
+    sentCount += count;
+  }
+
+  const auto toMicros = [](ClockDuration duration) {
+    return static_cast<long long>(
+        std::chrono::duration_cast<std::chrono::microseconds>(duration)
+            .count());
+  };
+  std::printf("objects  clients  dirty %%  workers  p50 us  p99 us  "
+              "sent/client/tick\n");
+  std::printf("%7u  %7u  %7u  %7u  %6lld  %6lld  %16.1f\n", objectCount,
+              clientCount, dirtyPercent, workerThreads,
+              toMicros(passTimes.GetPercentile(0.5)),
+              toMicros(passTimes.GetPercentile(0.99)),
+              static_cast<double>(sentCount) / clientCount / tickCount);
+  double totalWeight = 0;
+  for (uint32_t i = 0; i < objectCount; ++i) {
+    totalWeight += weight(networkIdOf(i), ReplicationCommand());
+  }
+  std::printf("longest wait: %d ticks of %d; weight 1 expects about %.0f\n",
+              longestWait, tickCount,
+              totalWeight * clientCount * tickCount /
+                  static_cast<double>(std::max<uint64_t>(sentCount, 1)));
+  return 0;
+}
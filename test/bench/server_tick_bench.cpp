@@ -0,0 +1,142 @@
+// ServerManager tick time over UDP, with and without the network thread.
+//
+// usage: server_tick_bench [clientCount=256] [ticks=600] [payloadBytes=64]
+//
+// A client thread connects clientCount ClientNetworkDrivers over loopback
+// UDP and has each send a payload every tick period; the server ticks at
+// 60 Hz, sending every client payloadBytes per tick, and the p50/p99/max of
+// Tick() are printed for both settings of useNetworkThread. The gap between
+// the two is the socket I/O the network thread takes off the tick; give the
+// machine a core per thread to see it.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "client_network_driver.h"
+#include "endpoint/udp_transport_endpoint.h"
+#include "logger/logger.h"
+#include "server/server_manager.h"
+#include "socket/socket_util.h"
+
+namespace {
+
+constexpr uint16_t kPort = 40280;
+constexpr auto kTickPeriod = std::chrono::microseconds(16667);
+
+bool MeasureTickTimes(bool useNetworkThread, uint32_t clientCount,
+                      int tickCount, size_t payloadBytes) {
+  using namespace GameNet;
+
+  const SocketAddress address(0x7f000001, kPort);
+  std::unique_ptr<UDPTransportEndpoint> endpoint =
+      UDPTransportEndpoint::Create(address);
+  if (!endpoint) {
+    std::printf("failed to create the server endpoint\n");
+    return false;
+  }
+
+  ServerManagerSettings settings;
+  settings.network.maxClients = clientCount;
+  settings.useNetworkThread = useNetworkThread;
+  ServerManager server(std::move(endpoint), settings);
+
+  const std::vector<uint8_t> payload(payloadBytes, 0xAB);
+  server.SetPacketBuilder([&](uint32_t, OutputMemoryBitStream& outStream) {
+    outStream.WriteBytes(payload.data(), static_cast<uint32_t>(payload.size()));
+  });
+
+  std::atomic<bool> running{true};
+  std::thread clientThread([&] {
+    std::vector<std::unique_ptr<ClientNetworkDriver>> clients;
+    for (uint32_t i = 0; i < clientCount; ++i) {
+      clients.push_back(std::make_unique<ClientNetworkDriver>(
+          UDPTransportEndpoint::Create(SocketAddress(0x7f000001, 0)),
+          ClientNetworkSettings{}, SteadyClock::Get()));
+      clients.back()->Connect(address);
+    }
+
+    ClockTimePoint nextSendTime = SteadyClock::Get().Now();
+    while (running.load(std::memory_order_relaxed)) {
+      const bool send = SteadyClock::Get().Now() >= nextSendTime;
+      for (std::unique_ptr<ClientNetworkDriver>& client : clients) {
+        client->Update();
+        if (send) {
+          client->SendPayload(payload);
+        }
+      }
+      if (send) {
+        nextSendTime += kTickPeriod;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+
+  ClockTimePoint nextTickTime = SteadyClock::Get().Now();
+  const ClockTimePoint connectDeadline =
+      nextTickTime + std::chrono::seconds(10);
+  int tick = 0;
+  while (tick < tickCount) {
+    server.Tick();
+    if (server.GetNetworkDriver().GetClientCount() < clientCount) {
+      if (SteadyClock::Get().Now() > connectDeadline) {
+        break;
+      }
+      server.ResetTickTimes();
+    } else {
+      ++tick;
+    }
+    nextTickTime += kTickPeriod;
+    std::this_thread::sleep_until(nextTickTime);
+  }
+
+  running = false;
+  clientThread.join();
+
+  if (tick < tickCount) {
+    std::printf("only %u of %u clients connected\n",
+                server.GetNetworkDriver().GetClientCount(), clientCount);
+    return false;
+  }
+
+  const auto toMicros = [](ClockDuration duration) {
+    return static_cast<long long>(
+        std::chrono::duration_cast<std::chrono::microseconds>(duration)
+            .count());
+  };
+  const TickTimeHistogram& tickTimes = server.GetTickTimes();
+  std::printf("%14s  %7u  %6lld  %6lld  %6lld\n",
+              useNetworkThread ? "yes" : "no", clientCount,
+              toMicros(tickTimes.GetPercentile(0.5)),
+              toMicros(tickTimes.GetPercentile(0.99)),
+              toMicros(tickTimes.GetMax()));
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t clientCount =
+      argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 256;
+  const int tickCount = argc > 2 ? std::atoi(argv[2]) : 600;
+  const size_t payloadBytes =
+      argc > 3 ? static_cast<size_t>(std::atoi(argv[3])) : 64;
+
+  GameNet::SocketUtil::StaticInit();
+  Logger::SetLogLevel(LOG_SEVERITY_ERROR);
+
+  std::printf("network thread  clients  p50 us  p99 us  max us\n");
+  for (const bool useNetworkThread : {false, true}) {
+    if (!MeasureTickTimes(useNetworkThread, clientCount, tickCount,
+                          payloadBytes)) {
+      return 1;
+    }
+  }
+
+  GameNet::SocketUtil::StaticCleanUp();
+  return 0;
+}
@@ -0,0 +1,99 @@
+// Receive throughput of ShardedUDPTransportEndpoint by shard count.
+//
+// usage: sharded_udp_bench [maxShards=4] [senderCount=4] [seconds=2]
+//
+// For 1, 2, 4, ... maxShards shards, senderCount threads blast 64-byte
+// datagrams at 127.0.0.1 from their own sockets while one thread per shard
+// drains it, and the received packets per second are printed. Flow steering
+// is on, so each sender lands on one shard; use at least as many senders
+// as shards, and cores for both, to see the scaling.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "endpoint/sharded_udp_transport_endpoint.h"
+#include "endpoint/udp_transport_endpoint.h"
+#include "socket/socket_util.h"
+
+namespace {
+
+constexpr uint16_t kPort = 40260;
+
+double MeasurePacketsPerSecond(int shardCount, int senderCount,
+                               double seconds) {
+  using namespace GameNet;
+
+  const SocketAddress address(0x7f000001, kPort);
+  std::unique_ptr<ShardedUDPTransportEndpoint> server =
+      ShardedUDPTransportEndpoint::Create(address, shardCount);
+  if (!server) {
+    return -1.0;
+  }
+
+  std::atomic<bool> running{true};
+  std::atomic<uint64_t> receivedCount{0};
+
+  std::vector<std::thread> threads;
+  for (int shard = 0; shard < shardCount; ++shard) {
+    threads.emplace_back([&, shard] {
+      UDPTransportEndpoint& endpoint = server->GetShard(shard);
+      NetworkReceivedPacket packet;
+      uint64_t count = 0;
+      while (running.load(std::memory_order_relaxed)) {
+        if (endpoint.PollPacket(packet)) {
+          ++count;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+      receivedCount += count;
+    });
+  }
+
+  for (int sender = 0; sender < senderCount; ++sender) {
+    threads.emplace_back([&] {
+      std::unique_ptr<UDPTransportEndpoint> endpoint =
+          UDPTransportEndpoint::Create(SocketAddress(0x7f000001, 0));
+      const std::vector<uint8_t> payload(64, 0xAB);
+      while (running.load(std::memory_order_relaxed)) {
+        endpoint->SendPacket(address, payload);
+      }
+    });
+  }
+
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  running = false;
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return static_cast<double>(receivedCount.load()) / seconds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int maxShards = argc > 1 ? std::atoi(argv[1]) : 4;
+  const int senderCount = argc > 2 ? std::atoi(argv[2]) : 4;
+  const double seconds = argc > 3 ? std::atof(argv[3]) : 2.0;
+
+  GameNet::SocketUtil::StaticInit();
+  Logger::SetLogLevel(LOG_SEVERITY_ERROR);
+
+  std::printf("shards  senders  received pps\n");
+  for (int shardCount = 1; shardCount <= maxShards; shardCount *= 2) {
+    const double pps =
+        MeasurePacketsPerSecond(shardCount, senderCount, seconds);
+    if (pps < 0) {
+      std::printf("%6d  failed to create the endpoint\n", shardCount);
+      return 1;
+    }
+    std::printf("%6d  %7d  %12.0f\n", shardCount, senderCount, pps);
+  }
+
+  GameNet::SocketUtil::StaticCleanUp();
+  return 0;
+}
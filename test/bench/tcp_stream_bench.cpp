@@ -0,0 +1,168 @@
+// Message throughput of many TCPStreamConnections driven by one thread.
+//
+// usage: tcp_stream_bench [connections=1000] [messageSize=64]
+//                         [messagesPerRound=4] [seconds=2]
+//
+// Opens connections client/server pairs over 127.0.0.1, registers both ends
+// with one SocketPoller, and each round has every client queue
+// messagesPerRound messages, then services every ready socket: Flush() on
+// writability and Receive() + PollMessage() on readability. Prints the
+// messages delivered per second and how many sends the batching saved.
+// Needs about 2 * connections file descriptors; the soft limit is raised
+// to the hard one where possible.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+#include "socket/socket_address.h"
+#include "socket/socket_poller.h"
+#include "socket/socket_util.h"
+#include "socket/tcp_socket.h"
+#include "stream/tcp_stream_connection.h"
+
+namespace {
+
+using namespace GameNet;
+
+constexpr uint16_t kPort = 40261;
+
+struct Peer {
+  TCPStreamConnectionPtr connection;
+  bool wantWritable{false};
+  bool wantReadable{true};
+};
+
+void RaiseFileDescriptorLimit() {
+#if !defined(_WIN32)
+  rlimit limit{};
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+#endif
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int connectionCount = argc > 1 ? std::atoi(argv[1]) : 1000;
+  const size_t messageSize = argc > 2 ? std::atoi(argv[2]) : 64;
+  const int messagesPerRound = argc > 3 ? std::atoi(argv[3]) : 4;
+  const double seconds = argc > 4 ? std::atof(argv[4]) : 2.0;
+
+  SocketUtil::StaticInit();
+  RaiseFileDescriptorLimit();
+
+  const SocketAddress address(0x7f000001, kPort);
+  TCPSocketPtr listener = TCPSocket::Create(INET);
+  if (!listener || listener->Bind(address) != NO_ERROR ||
+      listener->Listen(connectionCount) != NO_ERROR) {
+    std::printf("failed to listen on %s\n", address.ToString().c_str());
+    return 1;
+  }
+
+  SocketPollerPtr poller = SocketPoller::Create();
+  std::vector<Peer> peers(2 * connectionCount);
+  for (int i = 0; i < connectionCount; ++i) {
+    Peer& client = peers[2 * i];
+    Peer& server = peers[2 * i + 1];
+    client.connection = TCPStreamConnection::Connect(address);
+    SocketAddress fromAddress;
+    server.connection =
+        TCPStreamConnection::Adopt(listener->Accept(fromAddress));
+    if (!client.connection || !server.connection) {
+      std::printf("failed to open connection %d\n", i);
+      return 1;
+    }
+    client.wantWritable = true;  // to finish the connect.
+    poller->Add(client.connection->GetNativeHandle(), &client, true);
+    poller->Add(server.connection->GetNativeHandle(), &server, false);
+  }
+
+  const std::vector<uint8_t> message(messageSize, 0xAB);
+  std::vector<uint8_t> received;
+  std::vector<SocketPollEvent> events(256);
+  uint64_t sentCount = 0;
+  uint64_t refusedCount = 0;
+  uint64_t receivedCount = 0;
+  uint64_t flushCount = 0;
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto deadline = start + std::chrono::duration<double>(seconds);
+  while (std::chrono::steady_clock::now() < deadline) {
+    for (int i = 0; i < connectionCount; ++i) {
+      Peer& client = peers[2 * i];
+      for (int m = 0; m < messagesPerRound; ++m) {
+        client.connection->SendMessage(message) ? ++sentCount
+                                                : ++refusedCount;
+      }
+    }
+
+    // Queued data goes out on writability and full receive queues stop
+    // reading; ask for each only where needed.
+    for (Peer& peer : peers) {
+      const bool wantWritable = peer.connection->HasPendingSend();
+      const bool wantReadable = peer.connection->WantsReceive();
+      if (wantWritable != peer.wantWritable ||
+          wantReadable != peer.wantReadable) {
+        peer.wantWritable = wantWritable;
+        peer.wantReadable = wantReadable;
+        poller->Modify(peer.connection->GetNativeHandle(), &peer,
+                       wantWritable, wantReadable);
+      }
+    }
+
+    for (int drained = 0; drained < 2 * connectionCount;) {
+      const int count = poller->Wait(events, 0);
+      if (count <= 0) {
+        break;
+      }
+      drained += count;
+      for (int e = 0; e < count; ++e) {
+        TCPStreamConnection& connection =
+            *static_cast<Peer*>(events[e].userData)->connection;
+        if (events[e].writable) {
+          connection.Flush();
+          ++flushCount;
+        }
+        if (events[e].readable || events[e].error) {
+          connection.Receive();
+          while (connection.PollMessage(received)) {
+            ++receivedCount;
+          }
+        }
+        if (connection.GetState() == TCPStreamConnection::State::Closed) {
+          std::printf("a connection closed unexpectedly\n");
+          return 1;
+        }
+      }
+    }
+  }
+  const double elapsed = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+
+  std::printf("connections %d, %zu-byte messages, %d per round\n",
+              connectionCount, messageSize, messagesPerRound);
+  std::printf("delivered %.0f messages/s (%.1f MB/s)\n",
+              receivedCount / elapsed,
+              receivedCount * (messageSize + 4) / elapsed / 1e6);
+  std::printf("queued %llu, refused by backpressure %llu\n",
+              static_cast<unsigned long long>(sentCount),
+              static_cast<unsigned long long>(refusedCount));
+  std::printf("%.2f messages per gathered send\n",
+              flushCount ? static_cast<double>(sentCount) / flushCount : 0.0);
+
+  for (Peer& peer : peers) {
+    poller->Remove(peer.connection->GetNativeHandle());
+    peer.connection->Close();
+  }
+  SocketUtil::StaticCleanUp();
+  return 0;
+}
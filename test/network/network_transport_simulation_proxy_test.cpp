@@ -0,0 +1,291 @@
+// Tests for NetworkTransportSimulationProxy: scheduling order, seeded
+// reproducibility, burst loss, duplication, reordering, the bandwidth
+// bottleneck and profile loading. Packets go through a loopback pair, the
+// server side wrapped in the proxy, and time is a ManualClock.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "endpoint/loopback_transport_endpoint.h"
+#include "endpoint/network_transport_simulation_proxy.h"
+
+namespace {
+
+using namespace GameNet;
+using std::chrono::milliseconds;
+
+int gFailureCount = 0;
+
+#define CHECK(condition)                                              \
+  do {                                                                \
+    if (!(condition)) {                                               \
+      std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,     \
+                   __LINE__, #condition);                             \
+      ++gFailureCount;                                                \
+    }                                                                 \
+  } while (false)
+
+const SocketAddress kClientAddress(0x7f000001, 5000);
+const SocketAddress kServerAddress(0x7f000001, 6000);
+
+// A client sending raw into a server endpoint behind the proxy, so every
+// packet is impaired once, on the proxy's receive side.
+struct SimulatedLink {
+  explicit SimulatedLink(const NetworkTransportSimulationSettings& settings) {
+    LoopbackTransportEndpoint::ConnectedEndpoints endpoints =
+        LoopbackTransportEndpoint::CreateConnectedEndpoints(kClientAddress,
+                                                            kServerAddress);
+    client = std::move(endpoints.clientEndpoint);
+    proxy = std::make_unique<NetworkTransportSimulationProxy>(
+        std::move(endpoints.serverEndpoint), settings, clock);
+  }
+
+  // Sends packets numbered [first, first + count) of payloadSize bytes.
+  void Send(uint32_t first, uint32_t count, size_t payloadSize = 4) {
+    std::vector<uint8_t> payload(std::max<size_t>(payloadSize, 4));
+    for (uint32_t id = first; id < first + count; ++id) {
+      for (int byte = 0; byte < 4; ++byte) {
+        payload[byte] = static_cast<uint8_t>(id >> (8 * byte));
+      }
+      client->SendPacket(kServerAddress, payload);
+    }
+  }
+
+  // Appends the numbers of every packet due now to outIds.
+  void Receive(std::vector<uint32_t>& outIds) {
+    std::vector<NetworkReceivedPacket> packets(64);
+    size_t count;
+    do {
+      count = proxy->PollPackets(packets);
+      for (size_t i = 0; i < count; ++i) {
+        const std::vector<uint8_t>& payload = packets[i].payload;
+        outIds.push_back(payload[0] | payload[1] << 8 | payload[2] << 16 |
+                         payload[3] << 24);
+      }
+    } while (count == packets.size());
+  }
+
+  ManualClock clock;
+  std::unique_ptr<LoopbackTransportEndpoint> client;
+  std::unique_ptr<NetworkTransportSimulationProxy> proxy;
+};
+
+// Sends packetCount packets in bursts of 100 one tick apart and returns
+// what arrived, in arrival order.
+std::vector<uint32_t> RunTraffic(
+    const NetworkTransportSimulationSettings& settings, uint32_t packetCount) {
+  SimulatedLink link(settings);
+  std::vector<uint32_t> ids;
+  for (uint32_t first = 0; first < packetCount; first += 100) {
+    link.Send(first, std::min(100u, packetCount - first));
+    link.Receive(ids);
+    link.clock.Advance(milliseconds(16));
+  }
+  link.clock.Advance(std::chrono::seconds(10));
+  link.Receive(ids);
+  return ids;
+}
+
+void TestLatencyKeepsOrder() {
+  NetworkTransportSimulationSettings settings;
+  settings.baseLatency = 50.0;
+  SimulatedLink link(settings);
+
+  std::vector<uint32_t> ids;
+  link.Send(0, 3);
+  link.Receive(ids);
+  CHECK(ids.empty());
+
+  link.clock.Advance(milliseconds(49));
+  link.Send(3, 1);
+  link.Receive(ids);
+  CHECK(ids.empty());
+
+  link.clock.Advance(milliseconds(1));
+  link.Receive(ids);
+  CHECK((ids == std::vector<uint32_t>{0, 1, 2}));
+
+  link.clock.Advance(milliseconds(49));
+  link.Receive(ids);
+  CHECK(ids.size() == 4 && ids[3] == 3);
+}
+
+void TestSeedRepeats() {
+  NetworkTransportSimulationSettings settings;
+  settings.baseLatency = 30.0;
+  settings.jitter = 20.0;
+  settings.packetLossProbability = 0.2;
+  settings.randomSeed = 7;
+
+  const std::vector<uint32_t> first = RunTraffic(settings, 2000);
+  const std::vector<uint32_t> second = RunTraffic(settings, 2000);
+  CHECK(first == second);
+  CHECK(first.size() > 1400 && first.size() < 1800);
+  // Jitter wider than the gap between packets reorders them.
+  CHECK(!std::is_sorted(first.begin(), first.end()));
+
+  settings.randomSeed = 8;
+  CHECK(RunTraffic(settings, 2000) != first);
+}
+
+void TestBurstLoss() {
+  NetworkTransportSimulationSettings settings;
+  settings.burstEnterProbability = 0.05;
+  settings.burstExitProbability = 0.2;
+  settings.burstLossProbability = 1.0;
+  settings.randomSeed = 11;
+
+  const uint32_t packetCount = 20000;
+  std::vector<uint32_t> ids = RunTraffic(settings, packetCount);
+  std::sort(ids.begin(), ids.end());
+
+  // The bad state lasts 1 / 0.2 = 5 packets on average and is entered a
+  // fifth of the time, so about 20% is lost in runs of about 5.
+  uint32_t lostCount = 0;
+  uint32_t runCount = 0;
+  uint32_t expected = 0;
+  for (const uint32_t id : ids) {
+    if (id != expected) {
+      lostCount += id - expected;
+      ++runCount;
+    }
+    expected = id + 1;
+  }
+  CHECK(lostCount > packetCount / 10 && lostCount < packetCount * 3 / 10);
+  CHECK(runCount > 0 && lostCount / runCount >= 3);
+
+  // Independent loss at the same rate comes in runs of about 1.25.
+  settings.burstEnterProbability = 0.0;
+  settings.packetLossProbability = 0.2;
+  ids = RunTraffic(settings, packetCount);
+  runCount = 0;
+  expected = 0;
+  for (const uint32_t id : ids) {
+    runCount += id != expected;
+    expected = id + 1;
+  }
+  CHECK(runCount > (packetCount - ids.size()) / 2);
+}
+
+void TestDuplicationAndReordering() {
+  NetworkTransportSimulationSettings settings;
+  settings.baseLatency = 10.0;
+  settings.duplicateProbability = 1.0;
+  settings.randomSeed = 3;
+  std::vector<uint32_t> ids = RunTraffic(settings, 500);
+  CHECK(ids.size() == 1000);
+  std::sort(ids.begin(), ids.end());
+  for (uint32_t id = 0; id < 500; ++id) {
+    CHECK(ids[2 * id] == id && ids[2 * id + 1] == id);
+  }
+
+  // Every reordered packet is held back past the next tick's packets.
+  settings.duplicateProbability = 0.0;
+  settings.reorderProbability = 0.1;
+  settings.reorderDelay = 40.0;
+  ids = RunTraffic(settings, 1000);
+  CHECK(ids.size() == 1000);
+  CHECK(!std::is_sorted(ids.begin(), ids.end()));
+  std::sort(ids.begin(), ids.end());
+  for (uint32_t id = 0; id < 1000; ++id) {
+    CHECK(ids[id] == id);
+  }
+}
+
+void TestBandwidthQueueing() {
+  NetworkTransportSimulationSettings settings;
+  settings.bandwidth = 80.0;  // 10000 bytes per second.
+  SimulatedLink link(settings);
+
+  // 1000 bytes take 100 ms to serialize, one after the other.
+  std::vector<uint32_t> ids;
+  link.Send(0, 5, 1000);
+  link.Receive(ids);
+  CHECK(ids.empty());
+  link.clock.Advance(milliseconds(101));
+  link.Receive(ids);
+  CHECK(ids.size() == 1);
+  link.clock.Advance(milliseconds(100));
+  link.Receive(ids);
+  CHECK(ids.size() == 2);
+  link.clock.Advance(milliseconds(300));
+  link.Receive(ids);
+  CHECK((ids == std::vector<uint32_t>{0, 1, 2, 3, 4}));
+
+  // With room for 2500 queued bytes, the third packet is tail-dropped
+  // and so is everything after it until the queue drains.
+  settings.maximumQueuedBytes = 2500;
+  SimulatedLink limitedLink(settings);
+  ids.clear();
+  limitedLink.Send(0, 5, 1000);
+  limitedLink.Receive(ids);
+  limitedLink.clock.Advance(milliseconds(101));
+  limitedLink.Send(5, 1, 1000);
+  limitedLink.Receive(ids);
+  limitedLink.clock.Advance(std::chrono::seconds(1));
+  limitedLink.Receive(ids);
+  CHECK((ids == std::vector<uint32_t>{0, 1, 5}));
+}
+
+void TestProfiles() {
+  for (const char* name :
+       {"lan", "wifi", "wifi-congested", "lte", "3g", "satellite"}) {
+    CHECK(NetworkTransportSimulationSettings::FromProfile(name));
+  }
+  CHECK(!NetworkTransportSimulationSettings::FromProfile("dial-up"));
+
+  std::optional<NetworkTransportSimulationSettings> settings =
+      NetworkTransportSimulationSettings::Parse(
+          "# inherits lte\n"
+          "profile = lte\n"
+          "\n"
+          "  jitter = 3.5  \n"
+          "randomSeed = 42\n");
+  CHECK(settings && settings->baseLatency == 45.0 &&
+        settings->jitter == 3.5 && settings->randomSeed == 42 &&
+        settings->burstEnterProbability > 0.0);
+
+  CHECK(!NetworkTransportSimulationSettings::Parse("latency = 10"));
+  CHECK(!NetworkTransportSimulationSettings::Parse("jitter"));
+  CHECK(!NetworkTransportSimulationSettings::Parse("jitter = fast"));
+  CHECK(!NetworkTransportSimulationSettings::Parse("profile = dial-up"));
+
+  const std::string path = "network_transport_simulation_proxy_test.ini";
+  std::ofstream(path) << "[soak]\n"
+                         "baseLatency = 80\n"
+                         "[soak-lossy]\n"
+                         "profile = 3g\n"
+                         "packetLossProbability = 0.1\n";
+  settings = NetworkTransportSimulationSettings::LoadProfile(path, "soak");
+  CHECK(settings && settings->baseLatency == 80.0 &&
+        settings->packetLossProbability == 0.0);
+  settings = NetworkTransportSimulationSettings::LoadProfile(path, "soak-lossy");
+  CHECK(settings && settings->baseLatency == 120.0 &&
+        settings->packetLossProbability == 0.1);
+  CHECK(!NetworkTransportSimulationSettings::LoadProfile(path, "missing"));
+  std::remove(path.c_str());
+  CHECK(!NetworkTransportSimulationSettings::LoadProfile(path, "soak"));
+}
+
+}  // namespace
+
+int main() {
+  Logger::SetLogLevel(LOG_SEVERITY_ERROR);
+
+  TestLatencyKeepsOrder();
+  TestSeedRepeats();
+  TestBurstLoss();
+  TestDuplicationAndReordering();
+  TestBandwidthQueueing();
+  TestProfiles();
+
+  if (gFailureCount != 0) {
+    std::fprintf(stderr, "%d check(s) failed\n", gFailureCount);
+    return 1;
+  }
+  return 0;
+}
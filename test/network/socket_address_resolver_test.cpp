@@ -0,0 +1,170 @@
+// Offline tests for SocketAddressResolver: host entries, family selection,
+// request coalescing and the bounded TTL cache. The system resolver is
+// replaced with a fake, so nothing here touches the network.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "socket/socket_address_resolver.h"
+#include "socket/socket_util.h"
+
+namespace {
+
+using namespace GameNet;
+
+int gFailureCount = 0;
+
+#define CHECK(condition)                                              \
+  do {                                                                \
+    if (!(condition)) {                                               \
+      std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,     \
+                   __LINE__, #condition);                             \
+      ++gFailureCount;                                                \
+    }                                                                 \
+  } while (false)
+
+// "ok.test:<port>" resolves to 10.0.0.1, anything else fails.
+std::atomic<int> gResolveCount{0};
+
+SocketAddressOpt FakeResolve(const std::string& str, int /*family*/) {
+  ++gResolveCount;
+  if (str.rfind("ok.test:", 0) == 0) {
+    return SocketAddress(0x0a000001, static_cast<uint16_t>(std::stoi(
+                                         str.substr(sizeof("ok.test:") - 1))));
+  }
+  return std::nullopt;
+}
+
+SocketAddressResolver::Settings FakeSettings() {
+  SocketAddressResolver::Settings settings;
+  settings.workerCount = 1;
+  settings.resolve = &FakeResolve;
+  return settings;
+}
+
+void TestNumericAndHostEntries() {
+  SocketAddressResolver resolver(FakeSettings());
+  gResolveCount = 0;
+
+  SocketAddressOpt numeric = resolver.Resolve("127.0.0.1:80").get();
+  CHECK(numeric && numeric->IsIPv4() && numeric->GetPort() == 80);
+
+  const std::string path = "socket_address_resolver_test.hosts";
+  std::ofstream(path) << "# comment\n"
+                         "10.0.0.7 gameserver gs # alias\n"
+                         "::1 gameserver v6only\n"
+                         "not-an-address broken\n";
+  CHECK(resolver.LoadHostsFile(path));
+  CHECK(!resolver.LoadHostsFile(path + ".missing"));
+  std::remove(path.c_str());
+
+  SocketAddressOpt host = resolver.Resolve("GameServer:7777").get();
+  CHECK(host && host->IsIPv4() && host->GetIPv4Address() == 0x0a000007 &&
+        host->GetPort() == 7777);
+  SocketAddressOpt alias = resolver.Resolve("gs:1").get();
+  CHECK(alias && alias->GetIPv4Address() == 0x0a000007);
+  SocketAddressOpt v6 = resolver.Resolve("v6only:9").get();
+  CHECK(v6 && v6->IsIPv6() && v6->GetPort() == 9);
+  CHECK(!resolver.Resolve("gs:notaport").get());
+  CHECK(gResolveCount == 0);
+}
+
+void TestHostEntriesHonourFamily() {
+  SocketAddressResolver::Settings settings = FakeSettings();
+  settings.family = AF_INET6;
+  SocketAddressResolver resolver(settings);
+  resolver.AddHostEntry("dual", SocketAddress(0x0a000007, 0));
+  uint8_t loopback6[16] = {};
+  loopback6[15] = 1;
+  resolver.AddHostEntry("dual", SocketAddress(loopback6, 0));
+  resolver.AddHostEntry("v4only", SocketAddress(0x0a000007, 0));
+
+  gResolveCount = 0;
+  SocketAddressOpt dual = resolver.Resolve("dual:5").get();
+  CHECK(dual && dual->IsIPv6() && dual->GetPort() == 5);
+  // No IPv6 entry: falls through to the resolver.
+  CHECK(!resolver.Resolve("v4only:5").get());
+  CHECK(gResolveCount == 1);
+}
+
+void TestCoalescingAndTimeToLive() {
+  ManualClock clock;
+  SocketAddressResolver::Settings settings = FakeSettings();
+  settings.cacheTimeToLive = std::chrono::seconds(60);
+  settings.negativeCacheTimeToLive = std::chrono::seconds(5);
+  SocketAddressResolver resolver(settings, clock);
+  gResolveCount = 0;
+
+  std::vector<std::future<SocketAddressOpt>> futures;
+  for (int i = 0; i < 8; ++i) {
+    futures.push_back(resolver.Resolve("ok.test:1"));
+  }
+  for (std::future<SocketAddressOpt>& future : futures) {
+    SocketAddressOpt address = future.get();
+    CHECK(address && address->GetPort() == 1);
+  }
+  // Callers that arrived after the first call finished hit the cache, so
+  // at most one resolver call either way.
+  CHECK(gResolveCount == 1);
+
+  CHECK(!resolver.Resolve("bad.test:1").get());
+  CHECK(gResolveCount == 2);
+
+  clock.Advance(std::chrono::seconds(10));
+  CHECK(resolver.Resolve("ok.test:1").get());
+  CHECK(!resolver.Resolve("bad.test:1").get());
+  CHECK(gResolveCount == 3);  // only the failure expired.
+
+  clock.Advance(std::chrono::seconds(60));
+  CHECK(resolver.Resolve("ok.test:1").get());
+  CHECK(gResolveCount == 4);
+}
+
+void TestCacheIsBounded() {
+  ManualClock clock;
+  SocketAddressResolver::Settings settings = FakeSettings();
+  settings.maximumCacheSize = 4;
+  SocketAddressResolver resolver(settings, clock);
+  gResolveCount = 0;
+
+  for (int port = 1; port <= 4; ++port) {
+    resolver.Resolve("ok.test:" + std::to_string(port)).get();
+    clock.Advance(std::chrono::seconds(1));
+  }
+  CHECK(gResolveCount == 4);
+
+  // A fifth name evicts the entry closest to expiring, port 1.
+  resolver.Resolve("ok.test:5").get();
+  resolver.Resolve("ok.test:2").get();
+  CHECK(gResolveCount == 5);
+  resolver.Resolve("ok.test:1").get();
+  CHECK(gResolveCount == 6);
+
+  // Once everything has expired, inserting clears the lot.
+  clock.Advance(std::chrono::minutes(5));
+  resolver.Resolve("ok.test:6").get();
+  CHECK(gResolveCount == 7);
+}
+
+}  // namespace
+
+int main() {
+  SocketUtil::StaticInit();
+  Logger::SetLogLevel(LOG_SEVERITY_ERROR);
+
+  TestNumericAndHostEntries();
+  TestHostEntriesHonourFamily();
+  TestCoalescingAndTimeToLive();
+  TestCacheIsBounded();
+
+  SocketUtil::StaticCleanUp();
+  if (gFailureCount != 0) {
+    std::fprintf(stderr, "%d check(s) failed\n", gFailureCount);
+    return 1;
+  }
+  return 0;
+}
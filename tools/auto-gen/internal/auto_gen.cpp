@@ -0,0 +1,776 @@
+#include "auto_gen.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <format>
+
+namespace {
+
+using GameNet::AutoGen::ClassAnnotation;
+using GameNet::AutoGen::ParseError;
+using GameNet::AutoGen::ParseResult;
+using GameNet::AutoGen::PropertyAnnotation;
+
+// ReplicationDirtyState has one bit per property and is at most this wide;
+// the generated code checks the configured width.
+constexpr size_t kMaxProperties = 4096;
+
+enum class TokenType { Identifier, Number, Punct };
+
+struct Token {
+  TokenType type;
+  std::string_view text;
+  uint32_t line;
+};
+
+bool IsIdentifierStart(char c) {
+  return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool IsIdentifierChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+class Tokenizer {
+ public:
+  explicit Tokenizer(std::string_view source) : mSource(source) {}
+
+  std::vector<Token> Run() {
+    bool lineStart = true;
+    while (mPos < mSource.size()) {
+      const char c = mSource[mPos];
+      if (c == '\n') {
+        ++mLine;
+        ++mPos;
+        lineStart = true;
+      } else if (std::isspace(static_cast<unsigned char>(c))) {
+        ++mPos;
+      } else if (c == '#' && lineStart) {
+        SkipPreprocessorLine();
+      } else if (StartsWith("//")) {
+        SkipUntil("\n", false);
+      } else if (StartsWith("/*")) {
+        mPos += 2;
+        SkipUntil("*/", true);
+      } else if (c == '"' || c == '\'') {
+        lineStart = false;
+        SkipQuoted(c);
+      } else if (IsIdentifierStart(c)) {
+        lineStart = false;
+        ReadIdentifier();
+      } else if (std::isdigit(static_cast<unsigned char>(c)) ||
+                 (c == '.' && mPos + 1 < mSource.size() &&
+                  std::isdigit(static_cast<unsigned char>(mSource[mPos + 1])))) {
+        lineStart = false;
+        ReadNumber();
+      } else {
+        lineStart = false;
+        const size_t length = StartsWith("::") ? 2 : 1;
+        mTokens.push_back(
+            {TokenType::Punct, mSource.substr(mPos, length), mLine});
+        mPos += length;
+      }
+    }
+    return std::move(mTokens);
+  }
+
+ private:
+  bool StartsWith(std::string_view text) const {
+    return mSource.substr(mPos, text.size()) == text;
+  }
+
+  // Leaves mPos after the terminator, or at the end.
+  void SkipUntil(std::string_view terminator, bool consume) {
+    while (mPos < mSource.size() && !StartsWith(terminator)) {
+      mLine += mSource[mPos] == '\n';
+      ++mPos;
+    }
+    if (consume && mPos < mSource.size()) {
+      mPos += terminator.size();
+    }
+  }
+
+  void SkipPreprocessorLine() {
+    while (mPos < mSource.size() && mSource[mPos] != '\n') {
+      if (mSource[mPos] == '\\' && mPos + 1 < mSource.size() &&
+          mSource[mPos + 1] == '\n') {
+        ++mLine;
+        ++mPos;
+      }
+      ++mPos;
+    }
+  }
+
+  void SkipQuoted(char quote) {
+    ++mPos;
+    while (mPos < mSource.size() && mSource[mPos] != quote) {
+      if (mSource[mPos] == '\\') {
+        ++mPos;
+      }
+      mLine += mPos < mSource.size() && mSource[mPos] == '\n';
+      ++mPos;
+    }
+    ++mPos;
+  }
+
+  void ReadIdentifier() {
+    const size_t start = mPos;
+    while (mPos < mSource.size() && IsIdentifierChar(mSource[mPos])) {
+      ++mPos;
+    }
+    const std::string_view text = mSource.substr(start, mPos - start);
+
+    // Encoding prefixes belong to the literal that follows.
+    if (mPos < mSource.size() && mSource[mPos] == '"' && text.ends_with('R') &&
+        text.size() <= 3) {
+      SkipRawString();
+      return;
+    }
+    if (mPos < mSource.size() &&
+        (mSource[mPos] == '"' || mSource[mPos] == '\'') &&
+        (text == "u8" || text == "u" || text == "U" || text == "L")) {
+      SkipQuoted(mSource[mPos]);
+      return;
+    }
+    mTokens.push_back({TokenType::Identifier, text, mLine});
+  }
+
+  void SkipRawString() {
+    const size_t delimiterStart = ++mPos;
+    while (mPos < mSource.size() && mSource[mPos] != '(') {
+      ++mPos;
+    }
+    const std::string terminator =
+        ")" + std::string(mSource.substr(delimiterStart, mPos - delimiterStart)) +
+        "\"";
+    SkipUntil(terminator, true);
+  }
+
+  void ReadNumber() {
+    const size_t start = mPos;
+    while (mPos < mSource.size()) {
+      const char c = mSource[mPos];
+      const char previous = mSource[mPos - 1];
+      if (IsIdentifierChar(c) || c == '.' || c == '\'' ||
+          ((c == '+' || c == '-') && (previous == 'e' || previous == 'E' ||
+                                      previous == 'p' || previous == 'P'))) {
+        ++mPos;
+      } else {
+        break;
+      }
+    }
+    mTokens.push_back(
+        {TokenType::Number, mSource.substr(start, mPos - start), mLine});
+  }
+
+  std::string_view mSource;
+  size_t mPos{0};
+  uint32_t mLine{1};
+  std::vector<Token> mTokens;
+};
+
+class Parser {
+ public:
+  explicit Parser(std::vector<Token> tokens) : mTokens(std::move(tokens)) {}
+
+  ParseResult Run() {
+    while (mPos < mTokens.size()) {
+      const Token& token = mTokens[mPos];
+      if (token.type == TokenType::Identifier) {
+        ParseIdentifier(token);
+      } else if (IsPunct(mPos, "{")) {
+        mScopes.push_back(mPendingScope.value_or(Scope{}));
+        mPendingScope.reset();
+        mTemplatePending = false;
+        ++mPos;
+      } else if (IsPunct(mPos, "}")) {
+        if (mScopes.empty()) {
+          AddError(token.line, "unbalanced '}'");
+          return std::move(mResult);
+        }
+        mScopes.pop_back();
+        ++mPos;
+      } else {
+        if (IsPunct(mPos, ";")) {
+          mTemplatePending = false;
+        }
+        ++mPos;
+      }
+    }
+    if (!mScopes.empty()) {
+      AddError(mTokens.back().line, "unbalanced '{' at end of file");
+    }
+    return std::move(mResult);
+  }
+
+ private:
+  enum class ScopeKind { Namespace, Class, Other };
+
+  struct Scope {
+    ScopeKind kind{ScopeKind::Other};
+    std::string name;
+    bool isTemplate{false};
+    // Into mResult.classes, for annotated classes.
+    int32_t classIndex{-1};
+  };
+
+  bool IsPunct(size_t pos, std::string_view text) const {
+    return pos < mTokens.size() && mTokens[pos].type == TokenType::Punct &&
+           mTokens[pos].text == text;
+  }
+
+  bool IsIdentifier(size_t pos, std::string_view text) const {
+    return pos < mTokens.size() &&
+           mTokens[pos].type == TokenType::Identifier &&
+           mTokens[pos].text == text;
+  }
+
+  uint32_t LineAt(size_t pos) const {
+    return mTokens[std::min(pos, mTokens.size() - 1)].line;
+  }
+
+  void AddError(uint32_t line, std::string message) {
+    mResult.errors.push_back({line, std::move(message)});
+  }
+
+  // From an opening bracket to just past its match.
+  size_t SkipBalanced(size_t pos, std::string_view open,
+                      std::string_view close) const {
+    int32_t depth = 0;
+    for (; pos < mTokens.size(); ++pos) {
+      if (IsPunct(pos, open)) {
+        ++depth;
+      } else if (IsPunct(pos, close) && --depth == 0) {
+        return pos + 1;
+      }
+    }
+    return pos;
+  }
+
+  void ParseIdentifier(const Token& token) {
+    const std::string_view text = token.text;
+    if (text == "template" && IsPunct(mPos + 1, "<")) {
+      mPos = SkipBalanced(mPos + 1, "<", ">");
+      mTemplatePending = true;
+    } else if (text == "namespace") {
+      ParseNamespace();
+    } else if (text == "enum") {
+      ++mPos;
+      if (IsIdentifier(mPos, "class") || IsIdentifier(mPos, "struct")) {
+        ++mPos;
+      }
+    } else if ((text == "class" || text == "struct" || text == "union") &&
+               !(mPos > 0 && IsIdentifier(mPos - 1, "friend"))) {
+      ParseClassHead();
+    } else if (text == "GAMENET_REPLICATED_CLASS") {
+      ParseClassAnnotation();
+    } else if (text == "GAMENET_REPLICATED") {
+      ParsePropertyAnnotation();
+    } else {
+      ++mPos;
+    }
+  }
+
+  void ParseNamespace() {
+    size_t pos = mPos + 1;
+    std::string name;
+    while (pos < mTokens.size() &&
+           (mTokens[pos].type == TokenType::Identifier || IsPunct(pos, "::"))) {
+      // "inline namespace v1" and C++20 "A::inline B" add nothing to the
+      // name that lookup needs.
+      if (!IsIdentifier(pos, "inline")) {
+        name += mTokens[pos].text;
+      }
+      ++pos;
+    }
+    if (IsPunct(pos, "{")) {
+      mPendingScope = Scope{ScopeKind::Namespace, std::move(name)};
+    }
+    mPos = pos;
+  }
+
+  void ParseClassHead() {
+    const bool isTemplate = mTemplatePending;
+    mTemplatePending = false;
+
+    std::string_view name;
+    bool isSpecialization = false;
+    size_t pos = mPos + 1;
+    while (pos < mTokens.size()) {
+      if (IsPunct(pos, "[") && IsPunct(pos + 1, "[")) {
+        pos = SkipBalanced(pos, "[", "]");
+      } else if (IsIdentifier(pos, "alignas")) {
+        pos = SkipBalanced(pos + 1, "(", ")");
+      } else if (mTokens[pos].type == TokenType::Identifier) {
+        if (mTokens[pos].text != "final") {
+          name = mTokens[pos].text;
+        }
+        ++pos;
+      } else if (IsPunct(pos, "::")) {
+        ++pos;
+      } else if (IsPunct(pos, "<")) {
+        isSpecialization = true;
+        pos = SkipBalanced(pos, "<", ">");
+      } else {
+        break;
+      }
+    }
+
+    if (IsPunct(pos, ":")) {
+      // Base clause; the definition follows it.
+      while (pos < mTokens.size() && !IsPunct(pos, "{") && !IsPunct(pos, ";")) {
+        ++pos;
+      }
+    }
+    if (!IsPunct(pos, "{") || name.empty()) {
+      // A declaration, an elaborated type or a template parameter.
+      mPos = pos;
+      return;
+    }
+
+    mPendingScope = Scope{ScopeKind::Class, std::string(name),
+                          isTemplate || isSpecialization};
+    mPos = pos;
+  }
+
+  void ParseClassAnnotation() {
+    const uint32_t line = LineAt(mPos);
+    mPos += 1;
+    if (!IsPunct(mPos, "(") || !IsPunct(mPos + 1, ")")) {
+      AddError(line, "expected GAMENET_REPLICATED_CLASS()");
+      return;
+    }
+    mPos += 2;
+
+    if (mScopes.empty() || mScopes.back().kind != ScopeKind::Class) {
+      AddError(line, "GAMENET_REPLICATED_CLASS() must be inside a class body");
+      return;
+    }
+    Scope& scope = mScopes.back();
+    if (scope.classIndex >= 0) {
+      AddError(line, "GAMENET_REPLICATED_CLASS() appears twice in this class");
+      return;
+    }
+    if (scope.isTemplate) {
+      AddError(line, "class templates can't be replicated");
+      return;
+    }
+
+    std::string qualifiedName;
+    for (const Scope& outer : mScopes) {
+      if (outer.kind == ScopeKind::Other || outer.name.empty()) {
+        AddError(line,
+                 "replicated classes must be reachable by name: not local, "
+                 "anonymous or in an anonymous namespace");
+        return;
+      }
+      if (outer.isTemplate) {
+        AddError(line, "classes nested in templates can't be replicated");
+        return;
+      }
+      if (!qualifiedName.empty()) {
+        qualifiedName += "::";
+      }
+      qualifiedName += outer.name;
+    }
+
+    scope.classIndex = static_cast<int32_t>(mResult.classes.size());
+    mResult.classes.push_back({std::move(qualifiedName), line, {}});
+  }
+
+  void ParsePropertyAnnotation() {
+    PropertyAnnotation property;
+    property.line = LineAt(mPos);
+    mPos += 1;
+    if (!IsPunct(mPos, "(")) {
+      AddError(property.line, "expected '(' after GAMENET_REPLICATED");
+      return;
+    }
+    const size_t argumentsEnd = SkipBalanced(mPos, "(", ")");
+    const bool argumentsValid =
+        ParseArguments(mPos + 1, argumentsEnd - 1, property);
+    mPos = argumentsEnd;
+
+    if (mScopes.empty() || mScopes.back().classIndex < 0) {
+      AddError(property.line,
+               "GAMENET_REPLICATED must annotate a member of a class with "
+               "GAMENET_REPLICATED_CLASS() before it");
+      return;
+    }
+    if (!ParseMemberName(property) || !argumentsValid) {
+      return;
+    }
+
+    ClassAnnotation& annotated = mResult.classes[mScopes.back().classIndex];
+    if (annotated.properties.size() == kMaxProperties) {
+      AddError(property.line,
+               std::format("more than {} replicated properties in {}",
+                           kMaxProperties, annotated.qualifiedName));
+      return;
+    }
+    annotated.properties.push_back(std::move(property));
+  }
+
+  bool ParseArguments(size_t pos, size_t end, PropertyAnnotation& property) {
+    const uint32_t line = property.line;
+    while (pos < end) {
+      if (mTokens[pos].type != TokenType::Identifier || !IsPunct(pos + 1, "=")) {
+        AddError(line, "expected key = value in GAMENET_REPLICATED(...)");
+        return false;
+      }
+      const std::string_view key = mTokens[pos].text;
+      pos += 2;
+
+      bool negative = false;
+      if (IsPunct(pos, "-") || IsPunct(pos, "+")) {
+        negative = mTokens[pos].text == "-";
+        ++pos;
+      }
+      std::optional<double> value;
+      if (pos < end && mTokens[pos].type == TokenType::Number) {
+        value = ParseNumber(mTokens[pos].text);
+        ++pos;
+      }
+      if (!value) {
+        AddError(line, std::format("expected a number for '{}'", key));
+        return false;
+      }
+      if (negative) {
+        *value = -*value;
+      }
+
+      std::optional<double>* target = nullptr;
+      if (key == "min") {
+        target = &property.minValue;
+      } else if (key == "max") {
+        target = &property.maxValue;
+      } else if (key == "bits") {
+        if (*value < 1 || *value > 64 || *value != std::floor(*value)) {
+          AddError(line, "bits must be a whole number in [1, 64]");
+          return false;
+        }
+        if (property.bitCount) {
+          AddError(line, "'bits' given twice");
+          return false;
+        }
+        property.bitCount = static_cast<uint32_t>(*value);
+      } else {
+        AddError(line, std::format("unknown key '{}'; expected bits, min or max",
+                                   key));
+        return false;
+      }
+      if (target) {
+        if (*target) {
+          AddError(line, std::format("'{}' given twice", key));
+          return false;
+        }
+        *target = *value;
+      }
+
+      if (pos < end && !IsPunct(pos, ",")) {
+        AddError(line, "expected ',' between GAMENET_REPLICATED arguments");
+        return false;
+      }
+      ++pos;
+    }
+
+    if (property.minValue.has_value() != property.maxValue.has_value()) {
+      AddError(line, "min and max go together");
+      return false;
+    }
+    if (property.minValue) {
+      if (!(*property.minValue < *property.maxValue)) {
+        AddError(line, "min must be less than max");
+        return false;
+      }
+      if (!property.bitCount) {
+        AddError(line, "quantizing to [min, max] needs bits");
+        return false;
+      }
+      if (*property.bitCount > 32) {
+        AddError(line, "quantizing to [min, max] takes at most 32 bits");
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static std::optional<double> ParseNumber(std::string_view text) {
+    std::string digits;
+    for (const char c : text) {
+      if (c != '\'') {
+        digits += c;
+      }
+    }
+    // Hex literals end in digits that look like suffixes.
+    const bool hex = digits.starts_with("0x") || digits.starts_with("0X");
+    while (!digits.empty() &&
+           std::string_view(hex ? "uUlL" : "fFuUlL").find(digits.back()) !=
+               std::string_view::npos) {
+      digits.pop_back();
+    }
+    char* end = nullptr;
+    const double value = std::strtod(digits.c_str(), &end);
+    if (digits.empty() || end != digits.c_str() + digits.size()) {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+  // Reads "type name [= init | {init}];" and leaves mPos on the token that
+  // ends the declarator, so initializer braces are still balanced by Run().
+  bool ParseMemberName(PropertyAnnotation& property) {
+    const uint32_t line = property.line;
+    int32_t angleDepth = 0;
+    std::string_view name;
+    for (; mPos < mTokens.size(); ++mPos) {
+      const Token& token = mTokens[mPos];
+      if (token.type == TokenType::Identifier) {
+        if (token.text == "static" || token.text == "using" ||
+            token.text == "typedef" || token.text == "friend") {
+          AddError(line,
+                   "GAMENET_REPLICATED must annotate a non-static data member");
+          return false;
+        }
+        if (angleDepth == 0) {
+          name = token.text;
+        }
+      } else if (IsPunct(mPos, "[") && IsPunct(mPos + 1, "[")) {
+        mPos = SkipBalanced(mPos, "[", "]") - 1;
+      } else if (IsPunct(mPos, "<")) {
+        ++angleDepth;
+      } else if (IsPunct(mPos, ">")) {
+        --angleDepth;
+      } else if (angleDepth > 0) {
+        // Template arguments.
+      } else if (IsPunct(mPos, ";") || IsPunct(mPos, "=") ||
+                 IsPunct(mPos, "{")) {
+        break;
+      } else if (IsPunct(mPos, "[")) {
+        AddError(line, "replicated arrays are not supported; wrap the array "
+                       "in a type with its own BitStreamWriter/Reader");
+        return false;
+      } else if (IsPunct(mPos, ":")) {
+        AddError(line, "bit-fields can't be replicated");
+        return false;
+      } else if (IsPunct(mPos, "(")) {
+        AddError(line, "GAMENET_REPLICATED must annotate a data member");
+        return false;
+      } else if (IsPunct(mPos, ",")) {
+        AddError(line, "declare one member per GAMENET_REPLICATED");
+        return false;
+      } else if (IsPunct(mPos, "}")) {
+        break;
+      }
+    }
+
+    if (!IsPunct(mPos, ";") && !IsPunct(mPos, "=") && !IsPunct(mPos, "{")) {
+      AddError(line, "expected a member declaration after GAMENET_REPLICATED");
+      return false;
+    }
+    if (name.empty()) {
+      AddError(line, "member name not found after GAMENET_REPLICATED");
+      return false;
+    }
+    property.name = std::string(name);
+    return true;
+  }
+
+  std::vector<Token> mTokens;
+  size_t mPos{0};
+  std::vector<Scope> mScopes;
+  std::optional<Scope> mPendingScope;
+  bool mTemplatePending{false};
+  ParseResult mResult;
+};
+
+std::string FormatDouble(double value) {
+  std::string text = std::format("{}", value);
+  if (text.find_first_of(".e") == std::string::npos) {
+    text += ".0";
+  }
+  return text;
+}
+
+std::string FormatBitCount(const PropertyAnnotation& property,
+                           std::string_view type) {
+  if (property.bitCount) {
+    return std::to_string(*property.bitCount);
+  }
+  return std::format("detail::GetDefaultPropertyBitCount<decltype({}::{})>()",
+                     type, property.name);
+}
+
+// Arguments after the value for detail::WriteProperty/ReadProperty.
+std::string FormatCodecArguments(const PropertyAnnotation& property) {
+  return std::format("{}, {}, {}", property.bitCount.value_or(0),
+                     FormatDouble(property.minValue.value_or(0.0)),
+                     FormatDouble(property.maxValue.value_or(0.0)));
+}
+
+// The parser doesn't know member types, so whether bits and min/max suit
+// one is checked where the generated code does; inside
+// ReplicatedProperties<T>, as it can see private members.
+void GenerateAnnotationChecks(const ClassAnnotation& annotated,
+                              std::string& out) {
+  for (const PropertyAnnotation& property : annotated.properties) {
+    if (!property.bitCount) {
+      continue;
+    }
+    const std::string member = std::format(
+        "decltype(::{}::{})", annotated.qualifiedName, property.name);
+    const std::string where =
+        std::format("{}::{}", annotated.qualifiedName, property.name);
+    if (property.minValue) {
+      out += std::format(
+          "  static_assert(detail::CanQuantize<{}>({}, {}, {}),\n"
+          "                \"{}: min and max need a float and at most 32 \"\n"
+          "                \"bits, or an integer that holds [min, max] and \"\n"
+          "                \"bits that hold max - min\");\n",
+          member, *property.bitCount, FormatDouble(*property.minValue),
+          FormatDouble(*property.maxValue), where);
+    } else {
+      out += std::format(
+          "  static_assert(detail::CanSendLowBits<{}>({}),\n"
+          "                \"{}: bits without min and max needs an integer \"\n"
+          "                \"or enum at least that wide\");\n",
+          member, *property.bitCount, where);
+    }
+  }
+}
+
+// Tests the properties in 32-bit blocks of the mask and skips blocks with
+// nothing dirty, so wide masks with a few dirty properties stay cheap.
+void GenerateDirtyDispatch(const std::vector<PropertyAnnotation>& properties,
+                           std::string_view callPrefix, std::string& out) {
+  for (size_t first = 0; first < properties.size(); first += 32) {
+    out += std::format(
+        "    if (const uint32_t dirty = inDirtyState.GetBlock({})) {{\n",
+        first / 32);
+    for (size_t i = first; i < std::min(first + 32, properties.size()); ++i) {
+      out += std::format(
+          "      if (dirty & {:#x}u) {{\n"
+          "        {}{}, {});\n"
+          "      }}\n",
+          1u << (i - first), callPrefix, properties[i].name,
+          FormatCodecArguments(properties[i]));
+    }
+    out += "    }\n";
+  }
+}
+
+void GenerateClass(const ClassAnnotation& annotated, std::string& out) {
+  const std::string type = "::" + annotated.qualifiedName;
+  const std::vector<PropertyAnnotation>& properties = annotated.properties;
+  const bool empty = properties.empty();
+  out += std::format("// {}\n\n", annotated.qualifiedName);
+
+  out += std::format("template <>\nstruct ReplicatedProperties<{}> {{\n", type);
+  out += std::format(
+      "  static constexpr std::array<ReplicatedProperty, {}> kProperties{{{{\n",
+      properties.size());
+  for (size_t i = 0; i < properties.size(); ++i) {
+    const PropertyAnnotation& property = properties[i];
+    out += std::format(
+        "      {{\"{}\", offsetof({}, {}), {}, {}, {}, {}}},\n", property.name,
+        type, property.name, FormatBitCount(property, type),
+        FormatDouble(property.minValue.value_or(0.0)),
+        FormatDouble(property.maxValue.value_or(0.0)), i);
+  }
+  out += "  }};\n";
+  out += std::format(
+      "  static constexpr ReplicationDirtyState kAllDirtyState =\n"
+      "      ReplicationDirtyState::FirstN({});\n",
+      properties.size());
+  GenerateAnnotationChecks(annotated, out);
+  out += "};\n\n";
+  out += std::format(
+      "static_assert({} <= ReplicationDirtyState::kBits,\n"
+      "              \"{} has more replicated properties than \"\n"
+      "              \"GAMENET_REPLICATION_DIRTY_STATE_BITS\");\n\n",
+      properties.size(), annotated.qualifiedName);
+
+  const std::string_view unused = empty ? "[[maybe_unused]] " : "";
+
+  out += std::format("template <>\nstruct BitStreamWriter<{}> {{\n", type);
+  out += std::format(
+      "  void operator()({}OutputMemoryBitStream& outStream,\n"
+      "                  {}const {}& inObject) const {{\n",
+      unused, unused, type);
+  for (const PropertyAnnotation& property : properties) {
+    out += std::format("    detail::WriteProperty(outStream, inObject.{}, {});\n",
+                       property.name, FormatCodecArguments(property));
+  }
+  out += "  }\n\n";
+  out += std::format(
+      "  void operator()({}OutputMemoryBitStream& outStream,\n"
+      "                  {}const {}& inObject,\n"
+      "                  {}const ReplicationDirtyState& inDirtyState) const {{\n",
+      unused, unused, type, unused);
+  GenerateDirtyDispatch(properties, "detail::WriteProperty(outStream, inObject.",
+                        out);
+  out += "  }\n};\n\n";
+
+  out += std::format("template <>\nstruct BitStreamReader<{}> {{\n", type);
+  out += std::format(
+      "  void operator()({}InputMemoryBitStream& inStream,\n"
+      "                  {}{}& outObject) const {{\n",
+      unused, unused, type);
+  for (const PropertyAnnotation& property : properties) {
+    out += std::format("    detail::ReadProperty(inStream, outObject.{}, {});\n",
+                       property.name, FormatCodecArguments(property));
+  }
+  out += "  }\n\n";
+  out += std::format(
+      "  void operator()({}InputMemoryBitStream& inStream,\n"
+      "                  {}{}& outObject,\n"
+      "                  {}const ReplicationDirtyState& inDirtyState) const {{\n",
+      unused, unused, type, unused);
+  GenerateDirtyDispatch(properties, "detail::ReadProperty(inStream, outObject.",
+                        out);
+  out += "  }\n};\n\n";
+}
+
+}  // namespace
+
+GameNet::AutoGen::ParseResult GameNet::AutoGen::ParseHeader(
+    std::string_view source) {
+  return Parser(Tokenizer(source).Run()).Run();
+}
+
+std::string GameNet::AutoGen::GenerateHeader(
+    const std::vector<ClassAnnotation>& classes, std::string_view includePath) {
+  std::string out = std::format(
+      "// Generated by auto-gen from {}. Do not edit.\n"
+      "#pragma once\n"
+      "\n"
+      "#include <array>\n"
+      "#include <cstddef>\n"
+      "\n"
+      "#include \"network/replication/replicated_property.h\"\n"
+      "#include \"{}\"\n"
+      "\n",
+      includePath, includePath);
+
+  // Replicated classes needn't be standard layout; offsetof() is still
+  // well defined in practice for any class without virtual bases.
+  out +=
+      "#if defined(__GNUC__)\n"
+      "#pragma GCC diagnostic push\n"
+      "#pragma GCC diagnostic ignored \"-Winvalid-offsetof\"\n"
+      "#endif\n"
+      "\n"
+      "namespace GameNet {\n\n";
+  for (const ClassAnnotation& annotated : classes) {
+    GenerateClass(annotated, out);
+  }
+  out +=
+      "}  // namespace GameNet\n"
+      "\n"
+      "#if defined(__GNUC__)\n"
+      "#pragma GCC diagnostic pop\n"
+      "#endif\n";
+  return out;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace GameNet::AutoGen {
+
+struct PropertyAnnotation {
+  std::string name;
+  uint32_t line{0};
+  std::optional<uint32_t> bitCount;
+  std::optional<double> minValue;
+  std::optional<double> maxValue;
+};
+
+struct ClassAnnotation {
+  // Fully qualified, without the leading "::".
+  std::string qualifiedName;
+  uint32_t line{0};
+  std::vector<PropertyAnnotation> properties;
+};
+
+struct ParseError {
+  uint32_t line;
+  std::string message;
+};
+
+struct ParseResult {
+  std::vector<ClassAnnotation> classes;
+  std::vector<ParseError> errors;
+};
+
+/**
+ * @brief Finds the classes marked GAMENET_REPLICATED_CLASS() in a header's
+ * source and their GAMENET_REPLICATED(...) data members.
+ *
+ * This is not a C++ parser: it tokenizes, skips comments, literals and
+ * preprocessor lines, and tracks namespace and class scopes by braces. That
+ * is enough for annotated declarations, and anything it doesn't understand
+ * next to an annotation is reported instead of guessed at.
+ */
+ParseResult ParseHeader(std::string_view source);
+
+/**
+ * @brief Emits the ReplicatedProperties, BitStreamWriter and
+ * BitStreamReader specializations for classes declared in the header that
+ * includePath names.
+ */
+std::string GenerateHeader(const std::vector<ClassAnnotation>& classes,
+                           std::string_view includePath);
+
+}  // namespace GameNet::AutoGen
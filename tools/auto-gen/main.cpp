@@ -1,4 +1,81 @@
+// auto-gen: generates replication serializers for annotated headers.
+//
+//   auto-gen --output <file.gen.h> [--include <spelling>] <header>
+//
+// --include is how the generated file includes the header, by default the
+// path as given. Errors are printed as "<header>:<line>: error: ..." so
+// IDEs can jump to them.
 
-int main() {
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "auto_gen.h"
+
+namespace {
+
+int PrintUsage() {
+  std::fprintf(stderr,
+               "usage: auto-gen --output <file> [--include <spelling>] "
+               "<header>\n");
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string inputPath;
+  std::string outputPath;
+  std::string includePath;
+  for (int i = 1; i < argc; ++i) {
+    const std::string argument = argv[i];
+    if (argument == "--output" && i + 1 < argc) {
+      outputPath = argv[++i];
+    } else if (argument == "--include" && i + 1 < argc) {
+      includePath = argv[++i];
+    } else if (!argument.starts_with("--") && inputPath.empty()) {
+      inputPath = argument;
+    } else {
+      return PrintUsage();
+    }
+  }
+  if (inputPath.empty() || outputPath.empty()) {
+    return PrintUsage();
+  }
+  if (includePath.empty()) {
+    includePath = inputPath;
+  }
+
+  std::ifstream input(inputPath, std::ios::binary);
+  if (!input) {
+    std::fprintf(stderr, "auto-gen: cannot read %s\n", inputPath.c_str());
+    return 1;
+  }
+  std::stringstream source;
+  source << input.rdbuf();
+
+  const GameNet::AutoGen::ParseResult result =
+      GameNet::AutoGen::ParseHeader(source.str());
+  for (const GameNet::AutoGen::ParseError& error : result.errors) {
+    std::fprintf(stderr, "%s:%u: error: %s\n", inputPath.c_str(), error.line,
+                 error.message.c_str());
+  }
+  if (!result.errors.empty()) {
+    return 1;
+  }
+
+  const std::filesystem::path outputFile(outputPath);
+  if (outputFile.has_parent_path()) {
+    std::error_code ec;
+    std::filesystem::create_directories(outputFile.parent_path(), ec);
+  }
+  std::ofstream output(outputFile, std::ios::binary | std::ios::trunc);
+  output << GameNet::AutoGen::GenerateHeader(result.classes, includePath);
+  if (!output) {
+    std::fprintf(stderr, "auto-gen: cannot write %s\n", outputPath.c_str());
+    return 1;
+  }
   return 0;
 }